@@ -30,6 +30,7 @@
 #include "Util.h"
 #include "URL.h"
 #include "guilib/TextureManager.h"
+#include "guilib/GUIQuadBatchGL.h"
 #include "cores/IPlayer.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
 #include "cores/AudioEngine/AEFactory.h"
@@ -164,6 +165,7 @@
 #include "peripherals/dialogs/GUIDialogPeripheralSettings.h"
 #include "peripherals/devices/PeripheralImon.h"
 #include "music/infoscanner/MusicInfoScanner.h"
+#include "music/infoscanner/ReplayGainAnalyzer.h"
 
 // Windows includes
 #include "guilib/GUIWindowManager.h"
@@ -440,6 +442,7 @@ CApplication::CApplication(void)
   m_currentStackPosition = 0;
   m_lastFrameTime = 0;
   m_lastRenderTime = 0;
+  memset(&m_frameStats, 0, sizeof(m_frameStats));
   m_bTestMode = false;
 
   m_muted = false;
@@ -2147,6 +2150,8 @@ void CApplication::Render()
   if(!g_Windowing.BeginRender())
     return;
 
+  int64_t renderStart = CurrentHostCounter();
+
   CDirtyRegionList dirtyRegions = g_windowManager.GetDirty();
   if (RenderNoPresent())
     hasRendered = true;
@@ -2162,6 +2167,8 @@ void CApplication::Render()
   g_infoManager.ResetCache();
   lock.Leave();
 
+  int64_t renderEnd = CurrentHostCounter();
+
   unsigned int now = XbmcThreads::SystemClockMillis();
   if (hasRendered)
     m_lastRenderTime = now;
@@ -2177,19 +2184,24 @@ void CApplication::Render()
   //fps limiter, make sure each frame lasts at least singleFrameTime milliseconds
   if (limitFrames || !flip)
   {
+    // if not flipping, loop at 25 fps. Input is polled from this loop, so we can't idle any
+    // longer, but work queued from other threads wakes us early through WakeRenderLoop().
     if (!limitFrames)
-      singleFrameTime = 40; //if not flipping, loop at 25 fps
+      singleFrameTime = 40;
 
     unsigned int frameTime = now - m_lastFrameTime;
     if (frameTime < singleFrameTime)
-      Sleep(singleFrameTime - frameTime);
+      m_renderWakeEvent.WaitMSec(singleFrameTime - frameTime);
   }
   m_lastFrameTime = XbmcThreads::SystemClockMillis();
 
+  int64_t presentStart = CurrentHostCounter();
   if (flip)
     g_graphicsContext.Flip(dirtyRegions);
   CTimeUtils::UpdateFrameTime(flip);
 
+  UpdateFrameStats(renderEnd - renderStart, flip ? CurrentHostCounter() - presentStart : 0, dirtyRegions);
+
   g_renderManager.UpdateResolution();
   g_renderManager.ManageCaptures();
 
@@ -2201,6 +2213,37 @@ void CApplication::Render()
   m_frameCond.notifyAll();
 }
 
+void CApplication::WakeRenderLoop()
+{
+  m_renderWakeEvent.Set();
+}
+
+static inline void SmoothFrameStat(float &stat, float sample)
+{
+  stat += (sample - stat) * 0.1f;
+}
+
+void CApplication::UpdateFrameStats(int64_t renderTicks, int64_t presentTicks, const CDirtyRegionList &dirtyRegions)
+{
+  float msPerTick = 1000.0f / CurrentHostFrequency();
+  SmoothFrameStat(m_frameStats.renderTime, renderTicks * msPerTick);
+  SmoothFrameStat(m_frameStats.presentTime, presentTicks * msPerTick);
+
+  float dirtyArea = 0.0f;
+  float screenArea = (float)g_graphicsContext.GetWidth() * g_graphicsContext.GetHeight();
+  if (screenArea > 0)
+  {
+    for (CDirtyRegionList::const_iterator i = dirtyRegions.begin(); i != dirtyRegions.end(); ++i)
+      dirtyArea += i->Area();
+    dirtyArea = std::min(100.0f, 100.0f * dirtyArea / screenArea);
+  }
+  SmoothFrameStat(m_frameStats.dirtyArea, dirtyArea);
+#if defined(HAS_GL)
+  m_frameStats.drawCalls = CGUIQuadBatchGL::Get().GetDrawCalls();
+  m_frameStats.vertices = CGUIQuadBatchGL::Get().GetVertices();
+#endif
+}
+
 void CApplication::SetStandAlone(bool value)
 {
   g_advancedSettings.m_handleMounting = m_bStandalone = value;
@@ -2776,6 +2819,8 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
   MEASURE_FUNCTION;
 
+  int64_t processStart = CurrentHostCounter();
+
   if (processEvents)
   {
     // currently we calculate the repeat time (ie time from last similar keypress) just global as fps
@@ -2822,6 +2867,8 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
       g_windowManager.Process(CTimeUtils::GetFrameTime());
     g_windowManager.FrameMove();
   }
+
+  SmoothFrameStat(m_frameStats.processTime, 1000.0f * (CurrentHostCounter() - processStart) / CurrentHostFrequency());
 }
 
 bool CApplication::ProcessGamepad(float frameTime)
@@ -3353,6 +3400,7 @@ void CApplication::Stop(int exitCode)
     CJobManager::GetInstance().CancelJobs();
 
     g_alarmClock.StopThread();
+    MUSIC_INFO::CReplayGainAnalyzer::Get().Stop();
 
     if( m_bSystemScreenSaverEnable )
       g_Windowing.EnableSystemScreenSaver(true);
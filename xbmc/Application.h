@@ -24,7 +24,9 @@
 #include "XBApplicationEx.h"
 
 #include "guilib/IMsgTargetCallback.h"
+#include "guilib/DirtyRegion.h"
 #include "threads/Condition.h"
+#include "threads/Event.h"
 #include "utils/GlobalsHandling.h"
 
 #include <map>
@@ -138,6 +140,21 @@ public:
   virtual void FrameMove(bool processEvents, bool processGUI = true);
   virtual void Render();
   virtual bool RenderNoPresent();
+
+  /*! \brief Per-frame cost of the GUI loop, smoothed over recent frames */
+  struct FrameStats
+  {
+    float processTime;          ///< ms spent in FrameMove (input, messages, GUI processing)
+    float renderTime;           ///< ms spent rendering the GUI
+    float presentTime;          ///< ms spent presenting the frame
+    float dirtyArea;            ///< percentage of the screen that was redrawn
+    unsigned int drawCalls;     ///< GUI draw calls issued for the last frame
+    unsigned int vertices;      ///< GUI vertices submitted for the last frame
+  };
+  const FrameStats &GetFrameStats() const { return m_frameStats; };
+
+  /*! \brief Wake the render loop from an idle sleep, e.g. when work was queued from another thread */
+  void WakeRenderLoop();
   virtual void Preflight();
   virtual bool Create();
   virtual bool Cleanup();
@@ -427,6 +444,8 @@ protected:
   bool m_bPresentFrame;
   unsigned int m_lastFrameTime;
   unsigned int m_lastRenderTime;
+  CEvent m_renderWakeEvent;
+  FrameStats m_frameStats;
 
   bool m_bStandalone;
   bool m_bEnableLegacyRes;
@@ -450,6 +469,8 @@ protected:
 
   void VolumeChanged() const;
 
+  void UpdateFrameStats(int64_t renderTicks, int64_t presentTicks, const CDirtyRegionList &dirtyRegions);
+
   PlayBackRet PlayStack(const CFileItem& item, bool bRestart);
   bool ProcessMouse();
   bool ProcessRemote(float frameTime);
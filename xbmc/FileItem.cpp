@@ -56,6 +56,7 @@
 #include "utils/Variant.h"
 #include "music/karaoke/karaokelyricsfactory.h"
 #include "utils/Mime.h"
+#include "threads/SystemClock.h"
 #ifdef HAS_ASAP_CODEC
 #include "cores/paplayer/ASAPCodec.h"
 #endif
@@ -67,6 +68,10 @@ using namespace MUSIC_INFO;
 using namespace PVR;
 using namespace EPG;
 
+// disc caches start with these, bump the version whenever any Archive() format changes
+#define FILEITEMLIST_CACHE_MAGIC   0x49464258 // "XBFI"
+#define FILEITEMLIST_CACHE_VERSION 1
+
 CFileItem::CFileItem(const CSong& song)
 {
   m_musicInfoTag = NULL;
@@ -1737,7 +1742,7 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_sortDetails = itemlist.m_sortDetails;
   m_replaceListing = itemlist.m_replaceListing;
   m_content = itemlist.m_content;
-  m_mapProperties = itemlist.m_mapProperties;
+  m_properties = itemlist.m_properties;
   m_cacheToDisc = itemlist.m_cacheToDisc;
 }
 
@@ -1749,7 +1754,7 @@ bool CFileItemList::Copy(const CFileItemList& items, bool copyItems /* = true */
   // assign the rest of the CFileItemList properties
   m_replaceListing = items.m_replaceListing;
   m_content        = items.m_content;
-  m_mapProperties  = items.m_mapProperties;
+  m_properties  = items.m_properties;
   m_cacheToDisc    = items.m_cacheToDisc;
   m_sortDetails    = items.m_sortDetails;
   m_sortMethod     = items.m_sortMethod;
@@ -2574,9 +2579,24 @@ bool CFileItemList::Load(int windowID)
   if (file.Open(GetDiscFileCache(windowID)))
   {
     CLog::Log(LOGDEBUG,"Loading fileitems [%s]",GetPath().c_str());
+    unsigned int start = XbmcThreads::SystemClockMillis();
     CArchive ar(&file, CArchive::load);
+
+    int magic = 0, version = 0;
+    ar >> magic;
+    ar >> version;
+    if (magic != FILEITEMLIST_CACHE_MAGIC || version != FILEITEMLIST_CACHE_VERSION)
+    {
+      CLog::Log(LOGDEBUG,"  -- discarding cache in an old format (version %i)", magic == FILEITEMLIST_CACHE_MAGIC ? version : 0);
+      ar.Close();
+      file.Close();
+      RemoveDiscCache(windowID);
+      return false;
+    }
+
     ar >> *this;
-    CLog::Log(LOGDEBUG,"  -- items: %i, directory: %s sort method: %i, ascending: %s",Size(),GetPath().c_str(), m_sortMethod, m_sortOrder ? "true" : "false");
+    CLog::Log(LOGDEBUG,"  -- items: %i, directory: %s sort method: %i, ascending: %s, took %u ms",Size(),GetPath().c_str(), m_sortMethod, m_sortOrder ? "true" : "false",
+              XbmcThreads::SystemClockMillis() - start);
     ar.Close();
     file.Close();
     return true;
@@ -2597,6 +2617,8 @@ bool CFileItemList::Save(int windowID)
   if (file.OpenForWrite(GetDiscFileCache(windowID), true)) // overwrite always
   {
     CArchive ar(&file, CArchive::store);
+    ar << (int)FILEITEMLIST_CACHE_MAGIC;
+    ar << (int)FILEITEMLIST_CACHE_VERSION;
     ar << *this;
     CLog::Log(LOGDEBUG,"  -- items: %i, sort method: %i, ascending: %s",iSize,m_sortMethod, m_sortOrder ? "true" : "false");
     ar.Close();
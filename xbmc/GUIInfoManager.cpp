@@ -250,6 +250,10 @@ const infomap system_labels[] =  {{ "hasnetwork",       SYSTEM_ETHERNET_LINK_ACT
                                   { "buildversion",     SYSTEM_BUILD_VERSION },
                                   { "builddate",        SYSTEM_BUILD_DATE },
                                   { "fps",              SYSTEM_FPS },
+                                  { "frameprocesstime", SYSTEM_FRAME_PROCESSTIME },
+                                  { "framerendertime",  SYSTEM_FRAME_RENDERTIME },
+                                  { "framepresenttime", SYSTEM_FRAME_PRESENTTIME },
+                                  { "framedirtyarea",   SYSTEM_FRAME_DIRTYAREA },
                                   { "dvdtraystate",     SYSTEM_DVD_TRAY_STATE },
                                   { "freememory",       SYSTEM_FREE_MEMORY },
                                   { "language",         SYSTEM_LANGUAGE },
@@ -1349,6 +1353,18 @@ CStdString CGUIInfoManager::GetLabel(int info, int contextWindow, CStdString *fa
   case SYSTEM_FPS:
     strLabel.Format("%02.2f", m_fps);
     break;
+  case SYSTEM_FRAME_PROCESSTIME:
+    strLabel.Format("%2.2f ms", g_application.GetFrameStats().processTime);
+    break;
+  case SYSTEM_FRAME_RENDERTIME:
+    strLabel.Format("%2.2f ms", g_application.GetFrameStats().renderTime);
+    break;
+  case SYSTEM_FRAME_PRESENTTIME:
+    strLabel.Format("%2.2f ms", g_application.GetFrameStats().presentTime);
+    break;
+  case SYSTEM_FRAME_DIRTYAREA:
+    strLabel.Format("%2.1f%%", g_application.GetFrameStats().dirtyArea);
+    break;
   case PLAYER_VOLUME:
     strLabel.Format("%2.1f dB", CAEUtil::PercentToGain(g_application.GetVolume(false)));
     break;
@@ -164,6 +164,10 @@ namespace INFO
 #define SYSTEM_HDD_LOCKSTATE        157
 #define SYSTEM_HDD_LOCKKEY          158
 #define SYSTEM_INTERNET_STATE       159
+#define SYSTEM_FRAME_PROCESSTIME    160
+#define SYSTEM_FRAME_RENDERTIME     161
+#define SYSTEM_FRAME_PRESENTTIME    162
+#define SYSTEM_FRAME_DIRTYAREA      163
 #define SYSTEM_ALARM_LESS_OR_EQUAL  180
 #define SYSTEM_PROFILECOUNT         181
 #define SYSTEM_ISFULLSCREEN         182
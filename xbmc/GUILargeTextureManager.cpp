@@ -31,6 +31,13 @@
 
 using namespace std;
 
+// maximum memory held by textures that were preloaded but not yet requested
+#define PRELOAD_MAX_MEMORY (64 * 1024 * 1024)
+// maximum number of preloads in the job queue at any one time
+#define PRELOAD_MAX_QUEUED 48
+// how often (in requests) the preload statistics are logged
+#define STATS_LOG_INTERVAL 1000
+
 
 CImageLoader::CImageLoader(const CStdString &path)
 {
@@ -73,11 +80,16 @@ bool CImageLoader::DoWork()
   return true;
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path)
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path, const void *preloadOwner)
 {
+  bool preload = preloadOwner != NULL;
   m_path = path;
-  m_refCount = 1;
+  m_refCount = preload ? 0 : 1;
   m_timeToDelete = 0;
+  m_preload = preload;
+  m_preloadOwner = preloadOwner;
+  m_memoryUsage = 0;
+  m_requestTime = preload ? 0 : XbmcThreads::SystemClockMillis();
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
@@ -88,6 +100,11 @@ CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
 
 void CGUILargeTextureManager::CLargeTexture::AddRef()
 {
+  if (m_refCount == 0 && m_preload)
+  { // first real request of a preloaded image
+    m_preload = false;
+    m_requestTime = XbmcThreads::SystemClockMillis();
+  }
   m_refCount++;
 }
 
@@ -120,11 +137,21 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
 {
   assert(!m_texture.size());
   if (texture)
+  {
+    m_memoryUsage = texture->GetPitch() * texture->GetRows();
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+  }
+  if (m_refCount == 0)
+    m_timeToDelete = CTimeUtils::GetFrameTime() + PRELOAD_TIME_TO_DELETE;
 }
 
 CGUILargeTextureManager::CGUILargeTextureManager()
 {
+  m_requests = 0;
+  m_hits = 0;
+  m_preloadHits = 0;
+  m_loadedRequests = 0;
+  m_timeToVisible = 0;
 }
 
 CGUILargeTextureManager::~CGUILargeTextureManager()
@@ -157,14 +184,27 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
     if (image->GetPath() == path)
     {
       if (firstRequest)
+      {
+        m_requests++;
+        m_hits++;
+        if (image->IsPreload())
+          m_preloadHits++;
         image->AddRef();
+        if (m_requests % STATS_LOG_INTERVAL == 0)
+          LogStats();
+      }
       texture = image->GetTexture();
       return texture.size() > 0;
     }
   }
 
   if (firstRequest)
+  {
+    m_requests++;
     QueueImage(path);
+    if (m_requests % STATS_LOG_INTERVAL == 0)
+      LogStats();
+  }
 
   return true;
 }
@@ -175,7 +215,7 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
   for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
     CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->GetPath() == path && !image->IsPreload())
     {
       if (image->DecrRef(immediately) && immediately)
         m_allocated.erase(it);
@@ -186,7 +226,7 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
   {
     unsigned int id = it->first;
     CLargeTexture *image = it->second;
-    if (image->GetPath() == path && image->DecrRef(true))
+    if (image->GetPath() == path && !image->IsPreload() && image->DecrRef(true))
     {
       // cancel this job
       CJobManager::GetInstance().CancelJob(id);
@@ -205,6 +245,12 @@ void CGUILargeTextureManager::QueueImage(const CStdString &path)
     CLargeTexture *image = it->second;
     if (image->GetPath() == path)
     {
+      if (image->IsPreload())
+      { // we need it now, so requeue the preload at normal priority
+        m_preloadHits++;
+        CJobManager::GetInstance().CancelJob(it->first);
+        it->first = CJobManager::GetInstance().AddJob(new CImageLoader(path), this, CJob::PRIORITY_NORMAL);
+      }
       image->AddRef();
       return; // already queued
     }
@@ -228,6 +274,11 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       CLargeTexture *image = it->second;
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
+      if (!image->IsPreload())
+      {
+        m_loadedRequests++;
+        m_timeToVisible += XbmcThreads::SystemClockMillis() - image->GetRequestTime();
+      }
       m_queued.erase(it);
       m_allocated.push_back(image);
       return;
@@ -237,3 +288,67 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
 
 
 
+
+bool CGUILargeTextureManager::PreloadImage(const CStdString &path, const void *owner)
+{
+  CSingleLock lock(m_listSection);
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if ((*it)->GetPath() == path)
+      return false;
+  }
+
+  unsigned int preloads = 0;
+  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  {
+    if (it->second->GetPath() == path)
+      return false;
+    if (it->second->IsPreload())
+      preloads++;
+  }
+
+  if (preloads >= PRELOAD_MAX_QUEUED || GetPreloadMemoryUsage() >= PRELOAD_MAX_MEMORY)
+    return false;
+
+  CLargeTexture *image = new CLargeTexture(path, owner);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path), this, CJob::PRIORITY_LOW);
+  m_queued.push_back(make_pair(jobID, image));
+  return true;
+}
+
+void CGUILargeTextureManager::CancelPreloads(const void *owner)
+{
+  CSingleLock lock(m_listSection);
+  queueIterator it = m_queued.begin();
+  while (it != m_queued.end())
+  {
+    CLargeTexture *image = it->second;
+    if (image->IsPreload() && image->GetPreloadOwner() == owner)
+    {
+      CJobManager::GetInstance().CancelJob(it->first);
+      delete image;
+      it = m_queued.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+unsigned int CGUILargeTextureManager::GetPreloadMemoryUsage() const
+{
+  unsigned int memory = 0;
+  for (vector<CLargeTexture *>::const_iterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  {
+    if ((*it)->IsPreload())
+      memory += (*it)->GetMemoryUsage();
+  }
+  return memory;
+}
+
+void CGUILargeTextureManager::LogStats()
+{
+  CLog::Log(LOGDEBUG, "%s - %u requests, hit rate %.1f%% (%u via preload), average time to first visible %u ms, %u kB held by preloads",
+            __FUNCTION__, m_requests, 100.0f * m_hits / m_requests, m_preloadHits,
+            m_loadedRequests ? (unsigned int)(m_timeToVisible / m_loadedRequests) : 0,
+            GetPreloadMemoryUsage() / 1024);
+}
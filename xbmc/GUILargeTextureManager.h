@@ -111,11 +111,35 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Request a texture to be loaded ahead of time at low priority.
+
+   Used by containers to load the artwork of items that are about to scroll into view. Preloaded
+   textures are not referenced; they are kept for a while in case GetImage() asks for them, and are
+   only loaded while the memory held by unrequested preloads stays within budget.
+
+   \param path path of the image to load.
+   \param owner the container asking for the preload, used to cancel it again.
+   \return true if the image was queued, false if it is already loaded/queued or we're over budget.
+   \sa CancelPreloads
+   */
+  bool PreloadImage(const CStdString &path, const void *owner);
+
+  /*!
+   \brief Cancel the preloads of a container that haven't been requested via GetImage() yet.
+
+   Called when the direction of scrolling changes, so that the loader can concentrate on the images
+   the container is actually heading towards. Preloads of other containers are left alone.
+
+   \param owner the container that queued the preloads.
+   */
+  void CancelPreloads(const void *owner);
+
 private:
   class CLargeTexture
   {
   public:
-    CLargeTexture(const CStdString &path);
+    CLargeTexture(const CStdString &path, const void *preloadOwner = NULL);
     virtual ~CLargeTexture();
 
     void AddRef();
@@ -125,17 +149,35 @@ private:
 
     const CStdString &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    bool IsPreload() const { return m_refCount == 0 && m_preload; };
+    const void *GetPreloadOwner() const { return m_preloadOwner; };
+    unsigned int GetMemoryUsage() const { return m_memoryUsage; };
+    unsigned int GetRequestTime() const { return m_requestTime; };
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
+    static const unsigned int PRELOAD_TIME_TO_DELETE = 10000;
 
     unsigned int m_refCount;
     CStdString m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    bool m_preload;
+    const void *m_preloadOwner;
+    unsigned int m_memoryUsage;
+    unsigned int m_requestTime;
   };
 
   void QueueImage(const CStdString &path);
+  unsigned int GetPreloadMemoryUsage() const;
+  void LogStats();
+
+  // statistics for the preloader
+  unsigned int m_requests;        ///< number of first requests for an image
+  unsigned int m_hits;            ///< requests that found the image already loaded
+  unsigned int m_preloadHits;     ///< requests that found the image loaded or loading due to a preload
+  unsigned int m_loadedRequests;  ///< requests that had to wait for the image
+  uint64_t     m_timeToVisible;   ///< total time those requests waited for the image (ms)
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
@@ -23,6 +23,7 @@
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/Crc32.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
@@ -31,14 +32,28 @@
 
 using namespace XFILE;
 
+#define FLUSH_INTERVAL       2000  // ms between writes of the queued updates
+#define STATISTICS_INTERVAL  60000 // ms between logs of the database operations
+#define MAX_CACHED_TEXTURES  20000 // forget the looked up images beyond this
+
+void CTextureCache::CCachedTexture::GetDetails(CTextureDetails &out) const
+{
+  out = details;
+  // images are checked for changes once a day
+  if (!lastCheck.IsValid() || lastCheck + CDateTimeSpan(1,0,0,0) >= CDateTime::GetCurrentDateTime())
+    out.hash.clear();
+}
+
 CTextureCache &CTextureCache::Get()
 {
   static CTextureCache s_cache;
   return s_cache;
 }
 
-CTextureCache::CTextureCache()
+CTextureCache::CTextureCache() : m_flushTimer(this)
 {
+  m_statisticsStart = XbmcThreads::SystemClockMillis();
+  m_lookups = m_reads = m_updates = m_writes = m_transactions = m_dropped = 0;
 }
 
 CTextureCache::~CTextureCache()
@@ -47,16 +62,32 @@ CTextureCache::~CTextureCache()
 
 void CTextureCache::Initialize()
 {
-  CSingleLock lock(m_databaseSection);
-  if (!m_database.IsOpen())
-    m_database.Open();
+  {
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.IsOpen())
+      m_database.Open();
+  }
+  m_flushTimer.Start(FLUSH_INTERVAL, true);
 }
 
 void CTextureCache::Deinitialize()
 {
   CancelJobs();
-  CSingleLock lock(m_databaseSection);
-  m_database.Close();
+  m_flushTimer.Stop(true);
+  Flush();
+  {
+    CSingleLock lock(m_databaseSection);
+    m_database.Close();
+  }
+  // the next database may be another profile's
+  {
+    CSingleLock lock(m_flushSection);
+    m_addedIDs.clear();
+  }
+  CSingleLock lock(m_textureSection);
+  m_textures.clear();
+  CTextureUpdates updates;
+  updates.Swap(m_updateQueue);
 }
 
 bool CTextureCache::IsCachedImage(const CStdString &url) const
@@ -88,7 +119,7 @@ CStdString CTextureCache::GetCachedImage(const CStdString &image, CTextureDetail
   if (GetCachedTexture(url, details))
   {
     if (trackUsage)
-      IncrementUseCount(details);
+      IncrementUseCount(url, details);
     return GetCachedPath(details.file);
   }
   return "";
@@ -222,39 +253,132 @@ void CTextureCache::ClearCachedImage(const CStdString &url, bool deleteSource /*
 
 bool CTextureCache::GetCachedTexture(const CStdString &url, CTextureDetails &details)
 {
+  {
+    CSingleLock lock(m_textureSection);
+    m_lookups++;
+    TextureMap::const_iterator i = m_textures.find(url);
+    if (i != m_textures.end())
+    {
+      i->second.GetDetails(details);
+      return true;
+    }
+  }
+
+  // remember what we read before an invalidation or clear can change it
   CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  CCachedTexture texture;
+  bool cached = m_database.GetCachedTexture(url, texture.details, texture.lastCheck);
+
+  CSingleLock textureLock(m_textureSection);
+  m_reads++;
+  if (!cached)
+    return false;
+  if (m_textures.size() >= MAX_CACHED_TEXTURES)
+    m_textures.clear();
+  // an image added meanwhile is newer than what we read
+  m_textures.insert(std::make_pair(url, texture)).first->second.GetDetails(details);
+  return true;
 }
 
 bool CTextureCache::AddCachedTexture(const CStdString &url, const CTextureDetails &details)
 {
-  CSingleLock lock(m_databaseSection);
-  return m_database.AddCachedTexture(url, details);
+  CSingleLock lock(m_textureSection);
+  m_updates++;
+  if (m_textures.size() >= MAX_CACHED_TEXTURES)
+    m_textures.clear();
+  CCachedTexture &texture = m_textures[url];
+  texture.details = details;
+  texture.details.id = -1;
+  texture.lastCheck = details.updateable ? CDateTime::GetCurrentDateTime() : CDateTime();
+
+  m_updateQueue.AddTexture(url, texture.details);
+  return true;
 }
 
-void CTextureCache::IncrementUseCount(const CTextureDetails &details)
+void CTextureCache::IncrementUseCount(const CStdString &url, const CTextureDetails &details)
 {
-  static const size_t count_before_update = 100;
-  CSingleLock lock(m_useCountSection);
-  m_useCounts.reserve(count_before_update);
-  m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
-  {
-    AddJob(new CTextureUseCountJob(m_useCounts));
-    m_useCounts.clear();
-  }
+  CSingleLock lock(m_textureSection);
+  m_updates++;
+  m_updateQueue.IncrementUseCount(url, details);
 }
 
 bool CTextureCache::SetCachedTextureValid(const CStdString &url, bool updateable)
 {
+  CSingleLock lock(m_textureSection);
+  m_updates++;
+  TextureMap::iterator i = m_textures.find(url);
+  if (i != m_textures.end())
+    i->second.lastCheck = updateable ? CDateTime::GetCurrentDateTime() : CDateTime();
+
+  m_updateQueue.SetTextureValid(url, updateable);
+  return true;
+}
+
+bool CTextureCache::InvalidateCachedImage(const CStdString &url)
+{
+  // write any queued addition first, so there's something to invalidate
+  Flush();
   CSingleLock lock(m_databaseSection);
-  return m_database.SetCachedTextureValid(url, updateable);
+  bool result = m_database.InvalidateCachedTexture(url);
+  CSingleLock textureLock(m_textureSection);
+  m_textures.erase(url);
+  return result;
 }
 
 bool CTextureCache::ClearCachedTexture(const CStdString &url, CStdString &cachedURL)
 {
+  Flush();
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(url, cachedURL);
+  bool result = m_database.ClearCachedTexture(url, cachedURL);
+  CSingleLock textureLock(m_textureSection);
+  m_textures.erase(url);
+  return result;
+}
+
+void CTextureCache::Flush()
+{
+  // one at a time, so use counts find the ids of textures added by the previous one
+  CSingleLock flushLock(m_flushSection);
+  CTextureUpdates updates;
+  {
+    CSingleLock lock(m_textureSection);
+    if (m_updateQueue.IsEmpty())
+      return;
+    updates.Swap(m_updateQueue);
+  }
+
+  unsigned int writes = updates.GetSize();
+  unsigned int dropped;
+  {
+    CSingleLock lock(m_databaseSection);
+    dropped = updates.Write(m_database, m_addedIDs);
+  }
+
+  CSingleLock lock(m_textureSection);
+  m_writes += writes - dropped;
+  m_transactions++;
+  m_dropped += dropped;
+  for (CTextureUpdates::IDMap::const_iterator i = m_addedIDs.begin(); i != m_addedIDs.end(); ++i)
+  { // unless it has been replaced meanwhile
+    TextureMap::iterator texture = m_textures.find(i->first);
+    if (texture != m_textures.end() && texture->second.details.id < 0 && !m_updateQueue.IsAdding(i->first))
+      texture->second.details.id = i->second;
+  }
+}
+
+void CTextureCache::LogStatistics()
+{
+  CSingleLock lock(m_textureSection);
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  float elapsed = (now - m_statisticsStart) / 1000.0f;
+  if (elapsed * 1000 < STATISTICS_INTERVAL)
+    return;
+
+  if (m_lookups || m_updates)
+    CLog::Log(LOGDEBUG, "%s - %.1f lookups/s with %.1f database reads/s, %.1f updates/s with %.1f database writes/s in %.2f transactions/s, %u use counts dropped",
+              __FUNCTION__, m_lookups / elapsed, m_reads / elapsed, m_updates / elapsed, m_writes / elapsed, m_transactions / elapsed, m_dropped);
+  m_statisticsStart = now;
+  m_lookups = m_reads = m_updates = m_writes = m_transactions = m_dropped = 0;
 }
 
 CStdString CTextureCache::GetCacheFile(const CStdString &url)
@@ -297,6 +421,12 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
     AddJob(new CTextureDDSJob(GetCachedPath(job->m_details.file)));
 }
 
+void CTextureCache::OnTimeout()
+{
+  Flush();
+  LogStatistics();
+}
+
 void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
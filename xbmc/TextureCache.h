@@ -20,11 +20,14 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include "utils/StdString.h"
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
 #include "threads/Event.h"
+#include "threads/Timer.h"
+#include "XBDateTime.h"
 
 class CURL;
 class CBaseTexture;
@@ -38,8 +41,13 @@ class CBaseTexture;
  may be periodically checked for updates and may be purged from the cache if
  unused for a set period of time.
 
+ Images that have been looked up are remembered, so the database is queried
+ only once for each. Additions, validations and use counts are written behind:
+ they are queued, merged per image and written every few seconds in a single
+ transaction, so they are lost if we crash before the next write.
+
  */
-class CTextureCache : public CJobQueue
+class CTextureCache : public CJobQueue, public ITimerCallback
 {
 public:
   /*!
@@ -158,6 +166,18 @@ public:
    */
   bool AddCachedTexture(const CStdString &image, const CTextureDetails &details);
 
+  /*! \brief Invalidate a cached image so that it is checked for changes on next load
+   Thread-safe wrapper of CTextureDatabase::InvalidateCachedTexture
+   \param image url of the original image
+   \return true if successful, false otherwise.
+   */
+  bool InvalidateCachedImage(const CStdString &image);
+
+  /*! \brief Write the queued database updates in a single transaction
+   Called periodically and on deinitialization.
+   */
+  void Flush();
+
   /*! \brief Export a (possibly) cached image to a file
    \param image url of the original image
    \param destination url of the destination image, excluding extension.
@@ -205,10 +225,12 @@ private:
   bool ClearCachedTexture(const CStdString &url, CStdString &cacheFile);
 
   /*! \brief Increment the use count of a texture
-   Stores locally before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
-   \sa CUseCountJob, CTextureDatabase::IncrementUseCount
+   Counts locally until the next Flush calls CTextureDatabase::IncrementUseCount
+   \param image url of the original image
+   \param details the texture details
+   \sa Flush, CTextureDatabase::IncrementUseCount
    */
-  void IncrementUseCount(const CTextureDetails &details);
+  void IncrementUseCount(const CStdString &url, const CTextureDetails &details);
 
   /*! \brief Set a previously cached texture as valid in the database
    Thread-safe wrapper of CTextureDatabase::SetCachedTextureValid
@@ -218,6 +240,7 @@ private:
    */
   bool SetCachedTextureValid(const CStdString &url, bool updateable);
 
+  virtual void OnTimeout();
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
   virtual void OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job);
 
@@ -229,12 +252,42 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Log the database operations per second since the last call */
+  void LogStatistics();
+
+  /*! \brief A cached image as stored in the database
+   */
+  class CCachedTexture
+  {
+  public:
+    /*! \brief retrieve the details, the hash is only set once the image needs checking */
+    void GetDetails(CTextureDetails &details) const;
+
+    CTextureDetails details;   ///< details with the stored hash, id is -1 until the texture is written
+    CDateTime       lastCheck; ///< invalid if the image isn't checked for changes
+  };
+
+  typedef std::map<CStdString, CCachedTexture> TextureMap;
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<CStdString> m_processing; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
-  std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
-  CCriticalSection             m_useCountSection;
+
+  CCriticalSection   m_textureSection;  ///< guards the members below, taken after m_databaseSection when both are needed
+  TextureMap         m_textures;        ///< url to cached image of every image looked up or added
+  CTextureUpdates    m_updateQueue;     ///< updates to write on next Flush
+  CCriticalSection   m_flushSection;    ///< flushes one at a time, guards m_addedIDs
+  CTextureUpdates::IDMap m_addedIDs;    ///< ids of the textures added by the last Flush
+  CTimer             m_flushTimer;
+
+  unsigned int m_statisticsStart;
+  unsigned int m_lookups;      ///< GetCachedTexture calls
+  unsigned int m_reads;        ///< of these, the ones that queried the database
+  unsigned int m_updates;      ///< additions, validations and use counts requested
+  unsigned int m_writes;       ///< statements they were written with
+  unsigned int m_transactions;
+  unsigned int m_dropped;      ///< use counts of textures without a known id
 };
 
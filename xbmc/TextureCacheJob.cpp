@@ -25,6 +25,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
+#include "threads/SystemClock.h"
 #include "filesystem/File.h"
 #include "pictures/Picture.h"
 #include "utils/URIUtils.h"
@@ -87,6 +88,7 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
   else if (m_details.hash == m_oldHash)
     return true;
 
+  unsigned int start = XbmcThreads::SystemClockMillis();
   CBaseTexture *texture = LoadImage(image, width, height, additional_info);
   if (texture)
   {
@@ -95,7 +97,10 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     else
       m_details.file = m_cachePath + ".jpg";
 
-    CLog::Log(LOGDEBUG, "%s image '%s' to '%s':", m_oldHash.IsEmpty() ? "Caching" : "Recaching", image.c_str(), m_details.file.c_str());
+    CLog::Log(LOGDEBUG, "%s image '%s' to '%s': decoded %ux%u (original %ux%u) in %u ms",
+              m_oldHash.IsEmpty() ? "Caching" : "Recaching", image.c_str(), m_details.file.c_str(),
+              texture->GetWidth(), texture->GetHeight(), texture->GetOriginalWidth(), texture->GetOriginalHeight(),
+              XbmcThreads::SystemClockMillis() - start);
 
     if (CPicture::CacheTexture(texture, width, height, CTextureCache::GetCachedPath(m_details.file)))
     {
@@ -168,7 +173,7 @@ CBaseTexture *CTextureCacheJob::LoadImage(const CStdString &image, unsigned int
   { // special case for embedded music images
     MUSIC_INFO::EmbeddedArt art;
     if (CMusicThumbLoader::GetEmbeddedThumb(image, art))
-      return CBaseTexture::LoadFromFileInMemory(&art.data[0], art.size, art.mime, width, height);
+      return CBaseTexture::LoadFromFileInMemory(&art.data[0], art.size, art.mime, width, height, true);
   }
 
   // Validate file URL to see if it is an image
@@ -177,7 +182,8 @@ CBaseTexture *CTextureCacheJob::LoadImage(const CStdString &image, unsigned int
       && !file.GetMimeType().Left(6).Equals("image/") && !file.GetMimeType().Equals("application/octet-stream")) // ignore non-pictures
     return NULL;
 
-  CBaseTexture *texture = CBaseTexture::LoadFromFile(image, width, height, CSettings::Get().GetBool("pictures.useexifrotation"));
+  // decode no larger than we're going to cache it at
+  CBaseTexture *texture = CBaseTexture::LoadFromFile(image, width, height, CSettings::Get().GetBool("pictures.useexifrotation"), true);
   if (!texture)
     return NULL;
 
@@ -250,30 +256,69 @@ bool CTextureDDSJob::DoWork()
   return false;
 }
 
-CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureDetails> &textures) : m_textures(textures)
+void CTextureUpdates::AddTexture(const CStdString &url, const CTextureDetails &details)
 {
+  // adding replaces the texture, along with its validity and use count
+  m_adds[url] = details;
+  m_valid.erase(url);
+  m_useCounts.erase(url);
 }
 
-bool CTextureUseCountJob::operator==(const CJob* job) const
+void CTextureUpdates::SetTextureValid(const CStdString &url, bool updateable)
 {
-  if (strcmp(job->GetType(),GetType()) == 0)
-  {
-    const CTextureUseCountJob* useJob = dynamic_cast<const CTextureUseCountJob*>(job);
-    if (useJob && useJob->m_textures == m_textures)
-      return true;
-  }
-  return false;
+  AddMap::iterator add = m_adds.find(url);
+  if (add != m_adds.end())
+    add->second.updateable = updateable;
+  else
+    m_valid[url] = updateable;
 }
 
-bool CTextureUseCountJob::DoWork()
+void CTextureUpdates::IncrementUseCount(const CStdString &url, const CTextureDetails &details)
 {
-  CTextureDatabase db;
-  if (db.Open())
+  UseCountMap::iterator i = m_useCounts.find(url);
+  if (i != m_useCounts.end())
   {
-    db.BeginTransaction();
-    for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
-    db.CommitTransaction();
+    i->second.count++;
+    if (i->second.details.id < 0)
+      i->second.details.id = details.id;
   }
-  return true;
+  else
+  {
+    CUseCount &useCount = m_useCounts[url];
+    useCount.details = details;
+    useCount.count = 1;
+  }
+}
+
+bool CTextureUpdates::IsEmpty() const
+{
+  return m_adds.empty() && m_valid.empty() && m_useCounts.empty();
+}
+
+bool CTextureUpdates::IsAdding(const CStdString &url) const
+{
+  return m_adds.find(url) != m_adds.end();
+}
+
+unsigned int CTextureUpdates::GetSize() const
+{
+  return m_adds.size() + m_valid.size() + m_useCounts.size();
+}
+
+void CTextureUpdates::Swap(CTextureUpdates &updates)
+{
+  m_adds.swap(updates.m_adds);
+  m_valid.swap(updates.m_valid);
+  m_useCounts.swap(updates.m_useCounts);
+}
+
+int CTextureUpdates::GetID(const CStdString &url, const IDMap &ids, const IDMap &previousIDs)
+{
+  IDMap::const_iterator i = ids.find(url);
+  if (i != ids.end())
+    return i->second;
+  i = previousIDs.find(url);
+  if (i != previousIDs.end())
+    return i->second;
+  return -1;
 }
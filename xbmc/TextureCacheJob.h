@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <map>
 #include "utils/StdString.h"
 #include "utils/Job.h"
 
@@ -136,17 +137,85 @@ public:
   CStdString m_original;
 };
 
-/* \brief Job class for storing the use count of textures
+/*!
+ \ingroup textures
+ \brief Texture database updates queued for writing in a single transaction
+
+ Updates are merged per image: adding a texture replaces its earlier
+ validations and use counts, validating a texture that is being added
+ changes the addition, and use counts are summed.
  */
-class CTextureUseCountJob : public CJob
+class CTextureUpdates
 {
 public:
-  CTextureUseCountJob(const std::vector<CTextureDetails> &textures);
+  typedef std::map<CStdString, int> IDMap;
 
-  virtual const char* GetType() const { return "usecount"; };
-  virtual bool operator==(const CJob *job) const;
-  virtual bool DoWork();
+  void AddTexture(const CStdString &url, const CTextureDetails &details);
+  void SetTextureValid(const CStdString &url, bool updateable);
+  void IncrementUseCount(const CStdString &url, const CTextureDetails &details);
+
+  bool IsEmpty() const;
+  bool IsAdding(const CStdString &url) const;
+
+  /*! \brief number of database statements the updates are written with */
+  unsigned int GetSize() const;
+
+  void Swap(CTextureUpdates &updates);
+
+  /*! \brief Write the updates in a single transaction and clear them
+   Use counts of textures that had no id when they were counted take the id
+   of the texture added by this write or, failing that, by the previous one.
+   \param database a CTextureDatabase, or anything with its update methods
+   \param addedIDs [in/out] ids of the textures added by the previous write, replaced by those of this one
+   \return the number of use counts that were dropped as their texture has no known id
+   */
+  template<class Database>
+  unsigned int Write(Database &database, IDMap &addedIDs)
+  {
+    IDMap ids;
+    database.BeginTransaction();
+    for (AddMap::iterator i = m_adds.begin(); i != m_adds.end(); ++i)
+    {
+      if (database.AddCachedTexture(i->first, i->second))
+        ids[i->first] = i->second.id;
+    }
+    for (ValidMap::const_iterator i = m_valid.begin(); i != m_valid.end(); ++i)
+      database.SetCachedTextureValid(i->first, i->second);
+    unsigned int dropped = 0;
+    for (UseCountMap::iterator i = m_useCounts.begin(); i != m_useCounts.end(); ++i)
+    {
+      CTextureDetails &details = i->second.details;
+      if (details.id < 0)
+        details.id = GetID(i->first, ids, addedIDs);
+      if (details.id < 0)
+        dropped++;
+      else
+        database.IncrementUseCount(details, i->second.count);
+    }
+    database.CommitTransaction();
+
+    addedIDs.swap(ids);
+    m_adds.clear();
+    m_valid.clear();
+    m_useCounts.clear();
+    return dropped;
+  }
 
 private:
-  std::vector<CTextureDetails> m_textures;
+  class CUseCount
+  {
+  public:
+    CTextureDetails details;
+    unsigned int    count;
+  };
+
+  static int GetID(const CStdString &url, const IDMap &ids, const IDMap &previousIDs);
+
+  typedef std::map<CStdString, CTextureDetails> AddMap;
+  typedef std::map<CStdString, bool> ValidMap;
+  typedef std::map<CStdString, CUseCount> UseCountMap;
+
+  AddMap      m_adds;
+  ValidMap    m_valid;     ///< whether the textures are updateable
+  UseCountMap m_useCounts;
 };
@@ -140,13 +140,13 @@ bool CTextureDatabase::UpdateOldVersion(int version)
   return true;
 }
 
-bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
+bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details, unsigned int count)
 {
-  CStdString sql = PrepareSQL("UPDATE sizes SET usecount=usecount+1, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", details.id, details.width, details.height);
+  CStdString sql = PrepareSQL("UPDATE sizes SET usecount=usecount+%u, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", count, details.id, details.width, details.height);
   return ExecuteQuery(sql);
 }
 
-bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &details)
+bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &details, CDateTime &lastCheck)
 {
   try
   {
@@ -159,10 +159,9 @@ bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &
     { // have some information
       details.id = m_pDS->fv(0).get_asInt();
       details.file  = m_pDS->fv(1).get_asString();
-      CDateTime lastCheck;
+      lastCheck.Reset();
       lastCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
-      if (lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
-        details.hash = m_pDS->fv(3).get_asString();
+      details.hash = m_pDS->fv(3).get_asString();
       details.width = m_pDS->fv(4).get_asInt();
       details.height = m_pDS->fv(5).get_asInt();
       m_pDS->close();
@@ -184,7 +183,7 @@ bool CTextureDatabase::SetCachedTextureValid(const CStdString &url, bool updatea
   return ExecuteQuery(sql);
 }
 
-bool CTextureDatabase::AddCachedTexture(const CStdString &url, const CTextureDetails &details)
+bool CTextureDatabase::AddCachedTexture(const CStdString &url, CTextureDetails &details)
 {
   try
   {
@@ -197,17 +196,18 @@ bool CTextureDatabase::AddCachedTexture(const CStdString &url, const CTextureDet
     CStdString date = details.updateable ? CDateTime::GetCurrentDateTime().GetAsDBDateTime() : "";
     sql = PrepareSQL("INSERT INTO texture (id, url, cachedurl, imagehash, lasthashcheck) VALUES(NULL, '%s', '%s', '%s', '%s')", url.c_str(), details.file.c_str(), details.hash.c_str(), date.c_str());
     m_pDS->exec(sql.c_str());
-    int textureID = (int)m_pDS->lastinsertid();
+    details.id = (int)m_pDS->lastinsertid();
 
     // set the size information
-    sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 1, 1, CURRENT_TIMESTAMP, %u, %u)", textureID, details.width, details.height);
+    sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 1, 1, CURRENT_TIMESTAMP, %u, %u)", details.id, details.width, details.height);
     m_pDS->exec(sql.c_str());
+    return true;
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "%s failed on url '%s'", __FUNCTION__, url.c_str());
   }
-  return true;
+  return false;
 }
 
 bool CTextureDatabase::ClearCachedTexture(const CStdString &url, CStdString &cacheFile)
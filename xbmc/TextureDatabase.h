@@ -23,6 +23,8 @@
 #include "dbwrappers/Database.h"
 #include "TextureCacheJob.h"
 
+class CDateTime;
+
 class CTextureDatabase : public CDatabase
 {
 public:
@@ -30,11 +32,22 @@ public:
   virtual ~CTextureDatabase();
   virtual bool Open();
 
-  bool GetCachedTexture(const CStdString &originalURL, CTextureDetails &details);
-  bool AddCachedTexture(const CStdString &originalURL, const CTextureDetails &details);
+  /*! \brief Get a cached texture
+   \param url url of the original image
+   \param details [out] the texture details, with the stored hash of the image
+   \param lastCheck [out] when the image was last checked for changes, invalid if it isn't checked
+   \return true if the image is cached, false otherwise
+   */
+  bool GetCachedTexture(const CStdString &originalURL, CTextureDetails &details, CDateTime &lastCheck);
+
+  /*! \brief Add a cached texture, replacing any previous one of the image
+   \param url url of the original image
+   \param details the texture details, the id of the new texture is returned in details.id
+   */
+  bool AddCachedTexture(const CStdString &originalURL, CTextureDetails &details);
   bool SetCachedTextureValid(const CStdString &originalURL, bool updateable);
   bool ClearCachedTexture(const CStdString &originalURL, CStdString &cacheFile);
-  bool IncrementUseCount(const CTextureDetails &details);
+  bool IncrementUseCount(const CTextureDetails &details, unsigned int count = 1);
 
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
@@ -267,7 +267,7 @@ void CUtil::CleanString(const CStdString& strFileName, CStdString& strTitle, CSt
       continue;
     }
     int j=0;
-    if ((j=reTags.RegFind(strTitleAndYear.c_str())) > 0)
+    if ((j=reTags.Match(strTitleAndYear)) > 0)
       strTitleAndYear = strTitleAndYear.Mid(0, j);
   }
 
@@ -518,23 +518,16 @@ bool CUtil::IsPicture(const CStdString& strFile)
   return false;
 }
 
-bool CUtil::ExcludeFileOrFolder(const CStdString& strFileOrFolder, const CStdStringArray& regexps)
+bool CUtil::ExcludeFileOrFolder(const CStdString& strFileOrFolder, const std::vector<CRegExp>& regexps)
 {
   if (strFileOrFolder.IsEmpty())
     return false;
 
-  CRegExp regExExcludes(true);  // case insensitive regex
-
   for (unsigned int i = 0; i < regexps.size(); i++)
   {
-    if (!regExExcludes.RegComp(regexps[i].c_str()))
-    { // invalid regexp - complain in logs
-      CLog::Log(LOGERROR, "%s: Invalid exclude RegExp:'%s'", __FUNCTION__, regexps[i].c_str());
-      continue;
-    }
-    if (regExExcludes.RegFind(strFileOrFolder) > -1)
+    if (regexps[i].Match(strFileOrFolder) > -1)
     {
-      CLog::Log(LOGDEBUG, "%s: File '%s' excluded. (Matches exclude rule RegExp:'%s')", __FUNCTION__, strFileOrFolder.c_str(), regexps[i].c_str());
+      CLog::Log(LOGDEBUG, "%s: File '%s' excluded. (Matches exclude rule RegExp:'%s')", __FUNCTION__, strFileOrFolder.c_str(), regexps[i].GetPattern().c_str());
       return true;
     }
   }
@@ -38,6 +38,7 @@ namespace XFILE
 }
 
 class CFileItem;
+class CRegExp;
 class CFileItemList;
 class CURL;
 
@@ -67,7 +68,7 @@ public:
   static bool IsHTSP(const CStdString& strFile);
   static bool IsLiveTV(const CStdString& strFile);
   static bool IsTVRecording(const CStdString& strFile);
-  static bool ExcludeFileOrFolder(const CStdString& strFileOrFolder, const CStdStringArray& regexps);
+  static bool ExcludeFileOrFolder(const CStdString& strFileOrFolder, const std::vector<CRegExp>& regexps);
   static void GetFileAndProtocol(const CStdString& strURL, CStdString& strDir);
   static int GetDVDIfoTitle(const CStdString& strPathFile);
 
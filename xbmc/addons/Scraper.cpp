@@ -24,6 +24,7 @@
 #include "AddonManager.h"
 #include "utils/ScraperParser.h"
 #include "utils/ScraperUrl.h"
+#include "utils/ScraperCache.h"
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
 #include "music/infoscanner/MusicAlbumInfo.h"
@@ -40,6 +41,7 @@
 #include "music/Artist.h"
 #include "Util.h"
 #include "URL.h"
+#include "threads/Thread.h"
 
 #include <sstream>
 
@@ -58,6 +60,32 @@ typedef struct
   int          pretty;
 } ContentMapping;
 
+/*! \brief Fetches one url of a scraper step in the background */
+class CScraperFetchThread : public CThread
+{
+public:
+  CScraperFetchThread(const CScraperUrl::SUrlEntry &url, std::string &result, const CStdString &cacheContext)
+    : CThread("ScraperFetch"), m_url(url), m_result(result), m_cacheContext(cacheContext), m_success(false)
+  {
+  }
+
+  bool Succeeded() const { return m_success; }
+  void Cancel() { m_http.Cancel(); }
+
+protected:
+  virtual void Process()
+  {
+    m_success = CScraperUrl::Get(m_url, m_result, m_http, m_cacheContext) && !m_result.empty();
+  }
+
+private:
+  const CScraperUrl::SUrlEntry &m_url;
+  std::string &m_result;
+  CStdString m_cacheContext;
+  CCurlFile m_http;
+  bool m_success;
+};
+
 static const ContentMapping content[] =
   {{"unknown",       CONTENT_NONE,          231 },
    {"albums",        CONTENT_ALBUMS,        132 },
@@ -231,6 +259,8 @@ void CScraper::ClearCache()
   }
   else
     CDirectory::Create(strCachePath);
+
+  CScraperCache::Get().Clean();
 }
 
 // returns a vector of strings: the first is the XML output by the function; the rest
@@ -330,12 +360,29 @@ CStdString CScraper::InternalRun(const CStdString& function,
                                  CCurlFile& http,
                                  const vector<CStdString>* extras)
 {
-  // walk the list of input URLs and fetch each into parser parameters
-  unsigned int i;
-  for (i=0;i<scrURL.m_url.size();++i)
+  // fetch the input URLs into parser parameters. They don't depend on each other, so
+  // all but the first are fetched in the background while the first one is fetched on
+  // the given CCurlFile, which can be canceled by the caller.
+  unsigned int i = scrURL.m_url.size();
+  if (i > 0)
   {
-    CStdString strCurrHTML;
-    if (!CScraperUrl::Get(scrURL.m_url[i],m_parser.m_param[i],http,ID()) || m_parser.m_param[i].size() == 0)
+    vector<CScraperFetchThread*> fetchers;
+    for (unsigned int j = 1; j < i; ++j)
+    {
+      fetchers.push_back(new CScraperFetchThread(scrURL.m_url[j], m_parser.m_param[j], ID()));
+      fetchers.back()->Create();
+    }
+
+    bool success = CScraperUrl::Get(scrURL.m_url[0],m_parser.m_param[0],http,ID()) && m_parser.m_param[0].size() > 0;
+    for (vector<CScraperFetchThread*>::iterator it = fetchers.begin(); it != fetchers.end(); ++it)
+    {
+      if (!success)
+        (*it)->Cancel();
+      (*it)->StopThread();
+      success &= (*it)->Succeeded();
+      delete *it;
+    }
+    if (!success)
       return "";
   }
   // put the 'extra' parameterts into the parser parameter list too
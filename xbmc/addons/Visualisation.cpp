@@ -282,7 +282,7 @@ void CVisualisation::OnAudioData(const float* pAudioData, int iAudioDataLength)
     memcpy(m_fFreq, psAudioData, AUDIO_BUFFER_SIZE * sizeof(float));
 
     // FFT the data
-    twochanwithwindow(m_fFreq, AUDIO_BUFFER_SIZE);
+    CFFTPlan::Get(AUDIO_BUFFER_SIZE).TwoChannelWithWindow(m_fFreq);
 
     // Normalize the data
     float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
@@ -37,22 +37,178 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "storage/MediaManager.h"
 
 using namespace MUSIC_INFO;
 using namespace XFILE;
 
+#define CDDARIP_CHUNK_SIZE  (32 * 2352)        // 32 audio sectors, less than CEncoderLame takes at once
+#define CDDARIP_BUFFER_SIZE (64 * 1024 * 1024) // read ahead of all encoders together
+
+static CCriticalSection s_bufferSection;
+static CEvent s_bufferSpace;
+static unsigned int s_bufferSize = 0;
+static unsigned int s_queuedEncoders = 0; // buffers whose encoder hasn't started yet
+
+CCDDARipBuffer::CCDDARipBuffer() :
+  m_size(0), m_writeWait(0), m_readWait(0),
+  m_finished(false), m_success(false), m_aborted(false), m_reading(false)
+{
+  CSingleLock lock(s_bufferSection);
+  s_queuedEncoders++;
+}
+
+CCDDARipBuffer::~CCDDARipBuffer()
+{
+  SetReading();
+  Release(m_size);
+}
+
+bool CCDDARipBuffer::WaitForEncoders(const CJob* job)
+{
+  while (true)
+  {
+    {
+      CSingleLock lock(s_bufferSection);
+      if (s_queuedEncoders == 0)
+        return true;
+    }
+    s_bufferSpace.WaitMSec(100);
+    if (job && job->ShouldCancel(0, 0))
+      return false;
+  }
+}
+
+bool CCDDARipBuffer::Write(std::vector<uint8_t>& chunk, const CJob* job)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  while (true)
+  {
+    {
+      CSingleLock lock(m_section);
+      if (m_aborted)
+        return false;
+    }
+    {
+      CSingleLock lock(s_bufferSection);
+      if (s_bufferSize == 0 || s_bufferSize + chunk.size() <= CDDARIP_BUFFER_SIZE)
+      {
+        s_bufferSize += chunk.size();
+        break;
+      }
+    }
+    s_bufferSpace.WaitMSec(100);
+    if (job && job->ShouldCancel(0, 0))
+      return false;
+  }
+
+  CSingleLock lock(m_section);
+  m_writeWait += XbmcThreads::SystemClockMillis() - start;
+  m_size += chunk.size();
+  m_chunks.push_back(std::vector<uint8_t>());
+  m_chunks.back().swap(chunk);
+  m_readable.Set();
+  return true;
+}
+
+void CCDDARipBuffer::Finish(bool success)
+{
+  CSingleLock lock(m_section);
+  m_finished = true;
+  m_success = success;
+  m_readable.Set();
+}
+
+bool CCDDARipBuffer::Read(std::vector<uint8_t>& chunk, const CJob* job)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  SetReading();
+  while (true)
+  {
+    {
+      CSingleLock lock(m_section);
+      if (!m_chunks.empty())
+      {
+        m_readWait += XbmcThreads::SystemClockMillis() - start;
+        chunk.swap(m_chunks.front());
+        m_chunks.pop_front();
+        m_size -= chunk.size();
+        break;
+      }
+      if (m_finished)
+        return false;
+    }
+    m_readable.WaitMSec(100);
+    if (job && job->ShouldCancel(0, 0))
+      return false;
+  }
+  Release(chunk.size());
+  return true;
+}
+
+void CCDDARipBuffer::Abort()
+{
+  SetReading();
+  CSingleLock lock(m_section);
+  m_aborted = true;
+  m_chunks.clear();
+  Release(m_size);
+  m_size = 0;
+}
+
+bool CCDDARipBuffer::IsComplete() const
+{
+  CSingleLock lock(m_section);
+  return m_finished && m_success;
+}
+
+double CCDDARipBuffer::GetWriteWaitTime() const
+{
+  CSingleLock lock(m_section);
+  return m_writeWait / 1000.0;
+}
+
+double CCDDARipBuffer::GetReadWaitTime() const
+{
+  CSingleLock lock(m_section);
+  return m_readWait / 1000.0;
+}
+
+void CCDDARipBuffer::SetReading()
+{
+  CSingleLock lock(m_section);
+  if (m_reading)
+    return;
+  m_reading = true;
+  CSingleLock bufferLock(s_bufferSection);
+  s_queuedEncoders--;
+  s_bufferSpace.Set();
+}
+
+void CCDDARipBuffer::Release(unsigned int size)
+{
+  if (!size)
+    return;
+  CSingleLock lock(s_bufferSection);
+  s_bufferSize -= size;
+  s_bufferSpace.Set();
+}
+
 CCDDARipJob::CCDDARipJob(const CStdString& input,
                          const CStdString& output,
                          const CMusicInfoTag& tag, 
                          int encoder,
                          bool eject,
                          unsigned int rate,
-                         unsigned int channels, unsigned int bps) : 
+                         unsigned int channels, unsigned int bps,
+                         IJobCallback* encodeCallback) : 
   m_rate(rate), m_channels(channels), m_bps(bps), m_tag(tag),
   m_input(input), m_output(CUtil::MakeLegalPath(output)), m_eject(eject),
-  m_encoder(encoder)
+  m_encoder(encoder), m_encodeCallback(encodeCallback)
 {
 }
 
@@ -65,6 +221,11 @@ bool CCDDARipJob::DoWork()
   CLog::Log(LOGINFO, "Start ripping track %s to %s", m_input.c_str(),
                                                      m_output.c_str());
 
+  // the buffers only drain while their encoders run, so don't read ahead of
+  // an encoder that is still queued
+  if (!CCDDARipBuffer::WaitForEncoders(this))
+    return false;
+
   // if we are ripping to a samba share, rip it to hd first and then copy it it the share
   CFileItem file(m_output, false);
   if (file.IsRemote())
@@ -88,61 +249,54 @@ bool CCDDARipJob::DoWork()
   // setup the progress dialog
   CGUIDialogExtendedProgressBar* pDlgProgress = 
       (CGUIDialogExtendedProgressBar*)g_windowManager.GetWindow(WINDOW_DIALOG_EXT_PROGRESS);
-  CGUIDialogProgressBarHandle* handle = pDlgProgress->GetHandle(g_localizeStrings.Get(605));
-  CStdString strLine0;
-  int iTrack = atoi(m_input.substr(13, m_input.size() - 13 - 5).c_str());
-  strLine0.Format("%02i. %s - %s", iTrack,
-                  StringUtils::Join(m_tag.GetArtist(),
-                              g_advancedSettings.m_musicItemSeparator).c_str(),
-                  m_tag.GetTitle().c_str());
-  handle->SetText(strLine0);
+  CGUIDialogProgressBarHandle* handle = NULL;
+  if (pDlgProgress)
+  {
+    handle = pDlgProgress->GetHandle(g_localizeStrings.Get(605));
+    CStdString strLine0;
+    int iTrack = atoi(m_input.substr(13, m_input.size() - 13 - 5).c_str());
+    strLine0.Format("%02i. %s - %s", iTrack,
+                    StringUtils::Join(m_tag.GetArtist(),
+                                g_advancedSettings.m_musicItemSeparator).c_str(),
+                    m_tag.GetTitle().c_str());
+    handle->SetText(strLine0);
+  }
+
+  // the track is encoded on another worker while it is read, so the next
+  // track can be read while its encoder is still busy
+  unsigned int bytesPerSecond = m_rate * m_channels * m_bps / 8;
+  CCDDARipBufferPtr buffer(new CCDDARipBuffer());
+  CJobManager::GetInstance().AddJob(new CCDDAEncodeJob(m_input, m_output,
+                                                       file.IsRemote() ? file.GetPath() : "",
+                                                       encoder, buffer, reader.GetLength(),
+                                                       bytesPerSecond, handle),
+                                    m_encodeCallback, CJob::PRIORITY_NORMAL);
 
   // start ripping
+  unsigned int start = XbmcThreads::SystemClockMillis();
   int percent=0;
-  int oldpercent=0;
   bool cancelled(false);
   int result;
-  while (!cancelled && (result=RipChunk(reader, encoder, percent)) == 0)
-  {
+  while (!cancelled && (result=RipChunk(reader, *buffer, percent)) == 0)
     cancelled = ShouldCancel(percent,100);
-    if (percent > oldpercent)
-    {
-      oldpercent = percent;
-      handle->SetPercentage(percent);
-    }
-  }
 
-  // close encoder ripper
-  encoder->Close();
-  delete encoder;
+  double elapsed = (XbmcThreads::SystemClockMillis() - start) / 1000.0;
+  int64_t length = reader.GetPosition();
   reader.Close();
-
-  if (file.IsRemote() && !cancelled && result == 2)
-  {
-    // copy the ripped track to the share
-    if (!CFile::Cache(m_output, file.GetPath()))
-    {
-      CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
-                m_output.c_str(), file.GetPath().c_str());
-      CFile::Delete(m_output);
-      return false;
-    }
-    // delete cached file
-    CFile::Delete(m_output);
-  }
+  buffer->Finish(!cancelled && result == 2);
 
   if (cancelled)
-  {
     CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
-    CFile::Delete(m_output);
-  }
   else if (result == 1)
     CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", m_input.c_str());
   else if (result < 0)
-    CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
+    CLog::Log(LOGERROR, "CDDARipper: Stopped ripping %s, its encoder failed", m_input.c_str());
   else
   {
-    CLog::Log(LOGINFO, "Finished ripping %s", m_input.c_str());
+    CLog::Log(LOGINFO, "Finished reading %s: %.1f MB in %.1f s (%.1fx), %.1f s waiting for the encoders",
+              m_input.c_str(), length / 1048576.0, elapsed,
+              elapsed > 0 && bytesPerSecond ? length / elapsed / bytesPerSecond : 0.0,
+              buffer->GetWriteWaitTime());
     if (m_eject)
     {
       CLog::Log(LOGINFO, "Ejecting CD");
@@ -150,26 +304,26 @@ bool CCDDARipJob::DoWork()
     }
   }
 
-  handle->MarkFinished();
-
   return !cancelled && result == 2;
 }
 
-int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
+int CCDDARipJob::RipChunk(CFile& reader, CCDDARipBuffer& buffer, int& percent)
 {
   percent = 0;
 
-  uint8_t stream[1024];
+  std::vector<uint8_t> stream(CDDARIP_CHUNK_SIZE);
 
   // get data
-  int result = reader.Read(stream, 1024);
+  int result = reader.Read(&stream[0], stream.size());
 
   // return if rip is done or on some kind of error
   if (!result)
     return 1;
 
-  // encode data
-  int encres=encoder->Encode(result, stream);
+  // queue data for the encoder
+  stream.resize(result);
+  if (!buffer.Write(stream, this))
+    return -1;
 
   // Get progress indication
   percent = reader.GetPosition()*100/reader.GetLength();
@@ -177,7 +331,7 @@ int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
   if (reader.GetPosition() == reader.GetLength())
     return 2;
 
-  return -(1-encres);
+  return 0;
 }
 
 CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
@@ -260,3 +414,87 @@ bool CCDDARipJob::operator==(const CJob* job) const
   }
   return false;
 }
+
+CCDDAEncodeJob::CCDDAEncodeJob(const CStdString& input,
+                               const CStdString& output,
+                               const CStdString& remote,
+                               CEncoder* encoder,
+                               const CCDDARipBufferPtr& buffer,
+                               int64_t length,
+                               unsigned int bytesPerSecond,
+                               CGUIDialogProgressBarHandle* handle) :
+  m_input(input), m_output(output), m_remote(remote), m_encoder(encoder),
+  m_buffer(buffer), m_length(length), m_bytesPerSecond(bytesPerSecond),
+  m_handle(handle)
+{
+}
+
+CCDDAEncodeJob::~CCDDAEncodeJob()
+{
+  if (m_encoder)
+  {
+    // never ran, stop the reader
+    m_buffer->Abort();
+    m_encoder->Close();
+    delete m_encoder;
+    CFile::Delete(m_output);
+    if (m_handle)
+      m_handle->MarkFinished();
+  }
+}
+
+bool CCDDAEncodeJob::DoWork()
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  int64_t encoded = 0;
+  bool success = true;
+  std::vector<uint8_t> chunk;
+  while (m_buffer->Read(chunk, this))
+  {
+    if (!m_encoder->Encode(chunk.size(), &chunk[0]))
+    {
+      success = false;
+      break;
+    }
+    encoded += chunk.size();
+    if (m_handle && m_length)
+      m_handle->SetPercentage((float)(encoded * 100 / m_length));
+  }
+  double elapsed = (XbmcThreads::SystemClockMillis() - start) / 1000.0;
+
+  bool complete = success && m_buffer->IsComplete();
+  if (!complete)
+    m_buffer->Abort();
+
+  // close encoder
+  m_encoder->Close();
+  delete m_encoder;
+  m_encoder = NULL;
+
+  if (complete && !m_remote.IsEmpty())
+  {
+    // copy the ripped track to the share
+    if (!CFile::Cache(m_output, m_remote))
+    {
+      CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
+                m_output.c_str(), m_remote.c_str());
+      complete = false;
+    }
+  }
+  // delete cached or unfinished file
+  if (!complete || !m_remote.IsEmpty())
+    CFile::Delete(m_output);
+
+  if (!success)
+    CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
+  else if (complete)
+    CLog::Log(LOGINFO, "Finished ripping %s: encoded in %.1f s (%.1fx), %.1f s waiting for the drive",
+              m_input.c_str(), elapsed,
+              elapsed > 0 && m_bytesPerSecond ? encoded / elapsed / m_bytesPerSecond : 0.0,
+              m_buffer->GetReadWaitTime());
+
+  if (m_handle)
+    m_handle->MarkFinished();
+
+  return complete;
+}
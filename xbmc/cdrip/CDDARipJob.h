@@ -22,14 +22,87 @@
 #include "utils/Job.h"
 #include "utils/StdString.h"
 #include "music/tags/MusicInfoTag.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <boost/shared_ptr.hpp>
+#include <deque>
+#include <vector>
 
 class CEncoder;
+class CGUIDialogProgressBarHandle;
 
 namespace XFILE
 {
 class CFile;
 }
 
+//! \brief Audio of a track read from the drive and waiting for its encoder.
+//!
+//! All buffers together hold at most CDDARIP_BUFFER_SIZE bytes, so reading
+//! can run ahead of the encoders without holding a whole CD in memory. A
+//! track isn't read before the encoders of the earlier ones have started, so
+//! a full buffer always has an encoder draining it.
+class CCDDARipBuffer
+{
+public:
+  CCDDARipBuffer();
+  ~CCDDARipBuffer();
+
+  //! \brief Queue audio for the encoder, waits while the buffers are full
+  //! \param chunk The audio, taken over by the buffer
+  //! \param job The reading job, to stop waiting when it is cancelled
+  //! \return false if the encoder gave up or the job was cancelled
+  bool Write(std::vector<uint8_t>& chunk, const CJob* job);
+
+  //! \brief Mark the end of the track
+  //! \param success false if the track was not read completely
+  void Finish(bool success);
+
+  //! \brief Take the next chunk of audio, waits while there is none yet
+  //! \param chunk The audio on return
+  //! \param job The encoding job, to stop waiting when it is cancelled
+  //! \return false at the end of the track, see IsComplete()
+  bool Read(std::vector<uint8_t>& chunk, const CJob* job);
+
+  //! \brief The encoder gave up, any further Write() fails
+  void Abort();
+
+  //! \brief Wait until the encoders of all buffers have started reading
+  //! \param job The reading job, to stop waiting when it is cancelled
+  //! \return false if the job was cancelled
+  static bool WaitForEncoders(const CJob* job);
+
+  //! \brief All of the track was read
+  bool IsComplete() const;
+
+  //! \brief Seconds Write() waited for the encoders
+  double GetWriteWaitTime() const;
+
+  //! \brief Seconds Read() waited for the drive
+  double GetReadWaitTime() const;
+
+private:
+  void SetReading();
+  void Release(unsigned int size);
+
+  std::deque< std::vector<uint8_t> > m_chunks;
+  unsigned int m_size; //< Bytes in m_chunks
+  unsigned int m_writeWait; //< ms
+  unsigned int m_readWait; //< ms
+  bool m_finished;
+  bool m_success;
+  bool m_aborted;
+  bool m_reading; //< The encoder called Read(), or never will
+  CEvent m_readable;
+  mutable CCriticalSection m_section;
+};
+
+typedef boost::shared_ptr<CCDDARipBuffer> CCDDARipBufferPtr;
+
+//! \brief Reads a track from the drive and hands its audio to a
+//! CCDDAEncodeJob, which encodes it on another worker. The next track is
+//! read while the encoders of the previous ones are still busy.
 class CCDDARipJob : public CJob
 {
 public:
@@ -42,10 +115,12 @@ public:
   //! \param rate The sample rate of the input
   //! \param channels Number of audio channels in input
   //! \param bps The bits per sample for input
+  //! \param encodeCallback Told when the track has been encoded
   CCDDARipJob(const CStdString& input, const CStdString& output,
               const MUSIC_INFO::CMusicInfoTag& tag, int encoder,
               bool eject=false, unsigned int rate=44100,
-              unsigned int channels=2, unsigned int bps=16);
+              unsigned int channels=2, unsigned int bps=16,
+              IJobCallback* encodeCallback=NULL);
 
   virtual ~CCDDARipJob();
 
@@ -61,13 +136,13 @@ protected:
 
   //! \brief Rip a chunk of audio
   //! \param reader The input reader
-  //! \param encoder The audio encoder
+  //! \param buffer The buffer of the encoder
   //! \param percent The percentage completed on return
   //! \return 0 (CDDARIP_OK) if everything went okay, or
   //!         a positive error code from the reader, or
-  //!         -1 if the encoder failed
-  //! \sa CCDDARipper::GetData, CEncoder::Encode
-  int RipChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
+  //!         -1 if the encoder gave up
+  //! \sa CCDDARipper::GetData, CCDDARipBuffer::Write
+  int RipChunk(XFILE::CFile& reader, CCDDARipBuffer& buffer, int& percent);
 
   unsigned int m_rate; //< The sample rate of the input file 
   unsigned int m_channels; //< The number of channels in input file
@@ -77,5 +152,39 @@ protected:
   CStdString m_output; //< The output url
   bool m_eject; //< Should we eject tray when we are finished?
   int m_encoder; //< The audio encoder
+  IJobCallback* m_encodeCallback; //< Told when the track has been encoded
 };
 
+//! \brief Encodes the audio a CCDDARipJob reads into its buffer
+class CCDDAEncodeJob : public CJob
+{
+public:
+  //! \brief Construct an encoder job
+  //! \param input The input file url, for logging
+  //! \param output The file the encoder writes
+  //! \param remote The url to copy the output to when it is remote, or empty
+  //! \param encoder The initialized encoder, owned by the job
+  //! \param buffer The audio to encode
+  //! \param length The number of bytes of audio in the track
+  //! \param bytesPerSecond The number of bytes of a second of audio
+  //! \param handle The progress bar of the track, or NULL
+  CCDDAEncodeJob(const CStdString& input, const CStdString& output,
+                 const CStdString& remote, CEncoder* encoder,
+                 const CCDDARipBufferPtr& buffer, int64_t length,
+                 unsigned int bytesPerSecond,
+                 CGUIDialogProgressBarHandle* handle);
+
+  virtual ~CCDDAEncodeJob();
+
+  virtual const char* GetType() const { return "cdripencode"; };
+  virtual bool DoWork();
+protected:
+  CStdString m_input; //< The input url
+  CStdString m_output; //< The output file
+  CStdString m_remote; //< The url to copy the output to
+  CEncoder* m_encoder; //< The audio encoder
+  CCDDARipBufferPtr m_buffer; //< The audio read for the encoder
+  int64_t m_length; //< The length of the track in bytes
+  unsigned int m_bytesPerSecond; //< The bytes of a second of audio
+  CGUIDialogProgressBarHandle* m_handle; //< The progress bar of the track
+};
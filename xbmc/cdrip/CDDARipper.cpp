@@ -56,6 +56,7 @@ CCDDARipper& CCDDARipper::GetInstance()
 }
 
 CCDDARipper::CCDDARipper()
+  : CJobQueue(false, 1, CJob::PRIORITY_NORMAL)
 {
 }
 
@@ -84,7 +85,8 @@ bool CCDDARipper::RipTrack(CFileItem* pItem)
 
   AddJob(new CCDDARipJob(pItem->GetPath(),strFile,
                          *pItem->GetMusicInfoTag(),
-                         CSettings::Get().GetInt("audiocds.encoder")));
+                         CSettings::Get().GetInt("audiocds.encoder"),
+                         false, 44100, 2, 16, this));
 
   return true;
 }
@@ -140,7 +142,8 @@ bool CCDDARipper::RipCD()
                  i == vecItems.Size()-1;
     AddJob(new CCDDARipJob(item->GetPath(),strFile,
                            *item->GetMusicInfoTag(),
-                           CSettings::Get().GetInt("audiocds.encoder"), eject));
+                           CSettings::Get().GetInt("audiocds.encoder"), eject,
+                           44100, 2, 16, this));
   }
 
   return true;
@@ -300,6 +303,7 @@ CStdString CCDDARipper::GetTrackName(CFileItem *item)
   return track;
 }
 
+// called for the jobs reading the tracks and for the jobs encoding them
 void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
   if (success)
@@ -40,6 +40,8 @@ namespace MUSIC_INFO
  for the track file name.
  Format used to encode ripped tracks is defined by the audiocds.encoder user setting, and 
  there are several choices: wav, ogg vorbis and mp3.
+ Tracks are read from the drive one at a time, each is encoded by its own job so the
+ encoders of several tracks can run while the next one is read.
  */
 class CCDDARipper : public CJobQueue
 {
@@ -0,0 +1,161 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cdrip/CDDARipJob.h"
+#include "cdrip/Encoder.h"
+#include "filesystem/File.h"
+#include "music/tags/MusicInfoTag.h"
+#include "test/TestUtils.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/JobManager.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+class TestRipCallback : public IJobCallback
+{
+public:
+  TestRipCallback() : m_success(false) {}
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    m_success = success;
+    m_done.Set();
+  }
+
+  bool m_success;
+  CEvent m_done;
+};
+
+static std::vector<uint8_t> ReadFile(const CStdString &path)
+{
+  std::vector<uint8_t> data;
+  XFILE::CFile file;
+  if (file.Open(path))
+  {
+    data.resize((size_t)file.GetLength());
+    if (!data.empty() && file.Read(&data[0], data.size()) != data.size())
+      data.clear();
+  }
+  return data;
+}
+
+// a file of raw 16 bit stereo audio stands in for the drive
+TEST(TestCDDARipJob, RipToWav)
+{
+  XFILE::CFile *drive = XBMC_CREATETEMPFILE(".cdda");
+  ASSERT_TRUE(drive != NULL);
+
+  // a few chunks and a partial sector
+  std::vector<uint8_t> audio(10 * 32 * 2352 + 1000);
+  for (unsigned int i = 0; i < audio.size(); i++)
+    audio[i] = (uint8_t)(i * 7 + i / 256);
+  EXPECT_EQ((int)audio.size(), drive->Write(&audio[0], audio.size()));
+  drive->Close();
+
+  CStdString input = XBMC_TEMPFILEPATH(drive);
+  CStdString output = input + ".wav";
+  TestRipCallback callback;
+  CCDDARipJob job(input, output, MUSIC_INFO::CMusicInfoTag(), CDDARIP_ENCODER_WAV,
+                  false, 44100, 2, 16, &callback);
+  EXPECT_TRUE(job.DoWork());
+  ASSERT_TRUE(callback.m_done.WaitMSec(10000));
+  EXPECT_TRUE(callback.m_success);
+
+  // the audio follows the wav header
+  std::vector<uint8_t> wav = ReadFile(output);
+  ASSERT_GT(wav.size(), audio.size());
+  EXPECT_TRUE(std::equal(audio.begin(), audio.end(), wav.end() - audio.size()));
+
+  XFILE::CFile::Delete(output);
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(drive));
+}
+
+TEST(TestCDDARipJob, BufferAbort)
+{
+  CCDDARipBuffer buffer;
+  std::vector<uint8_t> chunk(100, 1);
+  EXPECT_TRUE(buffer.Write(chunk, NULL));
+  EXPECT_TRUE(chunk.empty());
+
+  std::vector<uint8_t> read;
+  EXPECT_TRUE(buffer.Read(read, NULL));
+  EXPECT_EQ(100U, read.size());
+
+  // the encoder gave up
+  buffer.Abort();
+  chunk.assign(100, 2);
+  EXPECT_FALSE(buffer.Write(chunk, NULL));
+
+  buffer.Finish(false);
+  EXPECT_FALSE(buffer.Read(read, NULL));
+  EXPECT_FALSE(buffer.IsComplete());
+}
+
+class TestRipWriter : public CThread
+{
+public:
+  TestRipWriter(CCDDARipBuffer &buffer) : CThread("TestRipWriter"), m_buffer(buffer) {}
+
+  virtual void Process()
+  {
+    std::vector<uint8_t> chunk(1024 * 1024, 2);
+    if (m_buffer.Write(chunk, NULL))
+      m_written.Set();
+  }
+
+  CCDDARipBuffer &m_buffer;
+  CEvent m_written;
+};
+
+TEST(TestCDDARipJob, BufferCap)
+{
+  // fill the 64 MB shared by all buffers
+  CCDDARipBuffer full;
+  for (unsigned int i = 0; i < 64; i++)
+  {
+    std::vector<uint8_t> chunk(1024 * 1024, 1);
+    ASSERT_TRUE(full.Write(chunk, NULL));
+  }
+
+  // another track has to wait until an encoder takes some out
+  CCDDARipBuffer next;
+  TestRipWriter writer(next);
+  writer.Create();
+  EXPECT_FALSE(writer.m_written.WaitMSec(500));
+
+  std::vector<uint8_t> read;
+  EXPECT_TRUE(full.Read(read, NULL));
+  EXPECT_TRUE(writer.m_written.WaitMSec(5000));
+  writer.StopThread();
+}
+
+TEST(TestCDDARipJob, WaitForEncoders)
+{
+  // an encoder that reads its track or is dropped unblocks the next track
+  CCDDARipBuffer read, dropped;
+  std::vector<uint8_t> chunk(100, 1);
+  EXPECT_TRUE(read.Write(chunk, NULL));
+  EXPECT_TRUE(read.Read(chunk, NULL));
+  dropped.Abort();
+  EXPECT_TRUE(CCDDARipBuffer::WaitForEncoders(NULL));
+}
@@ -21,21 +21,40 @@
 #include "AudioDecoder.h"
 #include "CodecFactory.h"
 #include "Application.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
+#include "music/MusicDatabase.h"
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include <math.h>
 
 CAudioDecoder::CAudioDecoder()
 {
   m_codec = NULL;
+  m_thread = NULL;
 
   m_eof = false;
 
   m_status = STATUS_NO_FILE;
   m_canPlay = false;
+  m_queuedSize = 0;
+
+  m_fileCache = 0;
+  m_duration = 0;
+  m_seekOffset = 0;
+  m_startOffset = 0;
+  m_libraryReplayGain = false;
+  m_abort = false;
+  m_failed = false;
+
+  m_createTime = 0;
+  m_openTime = 0;
+  m_firstSampleTime = 0;
+  m_underruns = 0;
+  m_starving = false;
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   memset(&m_outputBuffer, 0, OUTPUT_SAMPLES * sizeof(float));
@@ -51,8 +70,22 @@ CAudioDecoder::~CAudioDecoder()
 
 void CAudioDecoder::Destroy()
 {
+  // stop decoding ahead, a thread blocked on the codec has to finish its read first
+  if (m_thread)
+  {
+    StopDecoding();
+    m_thread->StopThread();
+    delete m_thread;
+    m_thread = NULL;
+  }
+  m_abort = false;
+
   CSingleLock lock(m_critSection);
-  m_status = STATUS_NO_FILE;
+  if (!m_path.IsEmpty() && m_openTime)
+    CLog::Log(LOGINFO, "CAudioDecoder: %s - opened after %u ms, first samples after %u ms, %u underruns",
+              m_path.c_str(), m_openTime, m_firstSampleTime, m_underruns);
+  m_path.Empty();
+  SetStatus(STATUS_NO_FILE);
 
   m_pcmBuffer.Destroy();
 
@@ -61,6 +94,13 @@ void CAudioDecoder::Destroy()
   m_codec = NULL;
 
   m_canPlay = false;
+  m_failed = false;
+}
+
+void CAudioDecoder::StopDecoding()
+{
+  m_abort = true;
+  m_wake.Set();
 }
 
 bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
@@ -81,39 +121,142 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
   else if ( file.IsOnLAN() )
     filecache = CSettings::Get().GetInt("cacheaudio.lan");
 
+  m_path = file.GetPath();
+  m_mimeType = file.GetMimeType();
+  m_fileCache = filecache * 1024;
+  m_duration = file.HasMusicInfoTag() ? file.GetMusicInfoTag()->GetDuration() : 0;
+  m_seekOffset = seekOffset;
+  m_startOffset = file.m_lStartOffset;
+  m_libraryReplayGain = !file.IsInternetStream() && g_application.GetReplayGainSettings().iType != REPLAY_GAIN_NONE;
+
+  m_createTime = XbmcThreads::SystemClockMillis();
+  m_openTime = 0;
+  m_firstSampleTime = 0;
+  m_underruns = 0;
+  m_starving = false;
+  lock.Leave();
+
+  // open, seek and decode ahead on our own thread, so playback never waits on other jobs
+  m_thread = new CThread(this, "AudioDecoder");
+  m_thread->Create();
+
+  return true;
+}
+
+bool CAudioDecoder::Open()
+{
+  CSingleLock lock(m_critSection);
+
   // create our codec
-  m_codec=CodecFactory::CreateCodecDemux(file.GetPath(), file.GetMimeType(), filecache * 1024);
+  ICodec *codec = CodecFactory::CreateCodecDemux(m_path, m_mimeType, m_fileCache);
 
-  if (!m_codec || !m_codec->Init(file.GetPath(), filecache * 1024))
+  if (!codec || !codec->Init(m_path, m_fileCache))
   {
-    CLog::Log(LOGERROR, "CAudioDecoder: Unable to Init Codec while loading file %s", file.GetPath().c_str());
-    Destroy();
+    CLog::Log(LOGERROR, "CAudioDecoder: Unable to Init Codec while loading file %s", m_path.c_str());
+    delete codec;
     return false;
   }
-  unsigned int blockSize = (m_codec->m_BitsPerSample >> 3) * m_codec->GetChannelInfo().Count();
+  unsigned int blockSize = (codec->m_BitsPerSample >> 3) * codec->GetChannelInfo().Count();
 
   if (blockSize == 0)
   {
     CLog::Log(LOGERROR, "CAudioDecoder: Codec provided invalid parameters (%d-bit, %u channels)",
-              m_codec->m_BitsPerSample, m_codec->GetChannelInfo().Count());
+              codec->m_BitsPerSample, codec->GetChannelInfo().Count());
+    delete codec;
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  /* allocate the pcmBuffer for the audio we decode ahead, playback can start after 2 seconds of it */
+  m_pcmBuffer.Create(g_advancedSettings.m_audioDecodeAhead * blockSize * codec->m_SampleRate);
+  m_queuedSize = std::min((unsigned int)(m_pcmBuffer.getSize() * 0.9), 2 * blockSize * codec->m_SampleRate);
+
+  // songs without ReplayGain tags may have been analyzed by the library
+  if (m_libraryReplayGain && !(codec->m_tag.HasReplayGainInfo() & (REPLAY_GAIN_HAS_TRACK_INFO | REPLAY_GAIN_HAS_ALBUM_INFO)))
+  {
+    CMusicDatabase database;
+    if (database.Open())
+    {
+      database.GetReplayGain(m_path, m_startOffset, codec->m_tag);
+      database.Close();
+    }
+  }
 
   // set total time from the given tag
-  if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
-    m_codec->SetTotalTime(file.GetMusicInfoTag()->GetDuration());
+  if (m_duration)
+    codec->SetTotalTime(m_duration);
 
-  if (seekOffset)
-    m_codec->Seek(seekOffset);
+  if (m_seekOffset)
+    codec->Seek(m_seekOffset);
 
-  m_status = STATUS_QUEUING;
+  m_codec = codec;
+  m_openTime = std::max(XbmcThreads::SystemClockMillis() - m_createTime, 1u);
+  SetStatus(STATUS_QUEUING);
 
   return true;
 }
 
+void CAudioDecoder::Run()
+{
+  if (!m_abort && !Open())
+    m_failed = true;
+
+  while (!m_abort && !m_failed)
+  {
+    int result = ReadSamples(PACKET_SIZE);
+    if (result == RET_ERROR)
+      m_failed = true;
+    else if (result == RET_SLEEP)
+    {
+      // nothing left to decode
+      int status = GetStatus();
+      if (status == STATUS_ENDING || status == STATUS_ENDED)
+        break;
+
+      // the buffer is full, ReadAhead() wakes us once playback made room
+      m_wake.Wait();
+    }
+  }
+}
+
+int CAudioDecoder::ReadAhead()
+{
+  if (m_failed)
+    return RET_ERROR;
+
+  // wait until a quarter of the buffer is free
+  if (m_codec && m_pcmBuffer.getMaxWriteSize() < m_pcmBuffer.getSize() / 4)
+    return RET_SUCCESS;
+
+  m_wake.Set();
+  return RET_SUCCESS;
+}
+
+bool CAudioDecoder::IsReady()
+{
+  if (m_failed)
+    return true;
+  CSingleLock lock(m_statusSection);
+  return m_status != STATUS_NO_FILE && m_status != STATUS_QUEUING;
+}
+
+void CAudioDecoder::Start()
+{
+  CSingleLock lock(m_statusSection);
+  m_canPlay = true;
+}
+
+int CAudioDecoder::GetStatus()
+{
+  CSingleLock lock(m_statusSection);
+  return m_status;
+}
+
+void CAudioDecoder::SetStatus(int status)
+{
+  CSingleLock lock(m_statusSection);
+  m_status = status;
+}
+
 void CAudioDecoder::GetDataFormat(CAEChannelInfo *channelInfo, unsigned int *samplerate, unsigned int *encodedSampleRate, enum AEDataFormat *dataFormat)
 {
   if (!m_codec)
@@ -127,6 +270,8 @@ void CAudioDecoder::GetDataFormat(CAEChannelInfo *channelInfo, unsigned int *sam
 
 int64_t CAudioDecoder::Seek(int64_t time)
 {
+  // wait for a read that is decoding ahead, its samples are from before the seek
+  CSingleLock lock(m_critSection);
   m_pcmBuffer.Clear();
   if (!m_codec)
     return 0;
@@ -144,11 +289,17 @@ int64_t CAudioDecoder::TotalTime()
 
 unsigned int CAudioDecoder::GetDataSize()
 {
+  CSingleLock lock(m_statusSection);
   if (m_status == STATUS_QUEUING || m_status == STATUS_NO_FILE)
     return 0;
   // check for end of file and end of buffer
   if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() < PACKET_SIZE)
     m_status = STATUS_ENDED;
+  // count the times decoding ahead didn't keep up with playback
+  bool starving = m_status < STATUS_ENDING && m_pcmBuffer.getMaxReadSize() == 0;
+  if (starving && !m_starving)
+    m_underruns++;
+  m_starving = starving;
   return std::min(m_pcmBuffer.getMaxReadSize() / (m_codec->m_BitsPerSample >> 3), (unsigned int)OUTPUT_SAMPLES);
 }
 
@@ -169,6 +320,7 @@ void *CAudioDecoder::GetData(unsigned int samples)
 
   if (m_pcmBuffer.ReadData((char *)m_outputBuffer, size))
   {
+    CSingleLock lock(m_statusSection);
     if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() == 0)
       m_status = STATUS_ENDED;
     
@@ -181,15 +333,20 @@ void *CAudioDecoder::GetData(unsigned int samples)
 
 int CAudioDecoder::ReadSamples(int numsamples)
 {
-  if (m_status == STATUS_NO_FILE || m_status == STATUS_ENDING || m_status == STATUS_ENDED)
-    return RET_SLEEP;             // nothing loaded yet
+  {
+    CSingleLock statusLock(m_statusSection);
+    if (m_status == STATUS_NO_FILE || m_status == STATUS_ENDING || m_status == STATUS_ENDED)
+      return RET_SLEEP;             // nothing loaded yet
 
-  // start playing once we're fully queued and we're ready to go
-  if (m_status == STATUS_QUEUED && m_canPlay)
-    m_status = STATUS_PLAYING;
+    // start playing once we're fully queued and we're ready to go
+    if (m_status == STATUS_QUEUED && m_canPlay)
+      m_status = STATUS_PLAYING;
+  }
 
   // grab a lock to ensure the codec is created at this point.
   CSingleLock lock(m_critSection);
+  if (!m_codec)
+    return RET_SLEEP;
 
   // Read in more data
   int maxsize = std::min<int>(INPUT_SAMPLES, m_pcmBuffer.getMaxWriteSize() / (m_codec->m_BitsPerSample >> 3));
@@ -204,9 +361,12 @@ int CAudioDecoder::ReadSamples(int numsamples)
     {
       // move it into our buffer
       m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
+      if (!m_firstSampleTime)
+        m_firstSampleTime = std::max(XbmcThreads::SystemClockMillis() - m_createTime, 1u);
 
       // update status
-      if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
+      CSingleLock statusLock(m_statusSection);
+      if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() >= m_queuedSize)
       {
         CLog::Log(LOGINFO, "AudioDecoder: File is queued");
         m_status = STATUS_QUEUED;
@@ -231,6 +391,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
     if (result == READ_EOF)
     {
       m_eof = true;
+      CSingleLock statusLock(m_statusSection);
       // setup ending if we're within set time of the end (currently just EOF)
       if (m_status < STATUS_ENDING)
         m_status = STATUS_ENDING;
@@ -23,7 +23,9 @@
 #include "threads/Thread.h"
 #include "ICodec.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "utils/RingBuffer.h"
+#include "utils/StdString.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
 
 class CFileItem;
@@ -50,23 +52,45 @@ class CFileItem;
 #define RET_SUCCESS 0
 #define RET_SLEEP 1
 
-class CAudioDecoder
+/*!
+ \brief Decodes a file ahead of playback into a ring buffer.
+
+ The file is opened, seeked and decoded on a thread of its own, so neither
+ the player thread nor the one queueing the file waits on slow storage, and
+ decoding never waits behind other jobs. The ring buffer holds
+ <audio><decodeahead> seconds of audio and is topped up whenever ReadAhead()
+ finds a quarter of it free.
+ */
+class CAudioDecoder : public IRunnable
 {
 public:
   CAudioDecoder();
   ~CAudioDecoder();
 
+  /*! \brief Start opening and decoding a file on the decoder's thread, see IsReady() */
   bool Create(const CFileItem &file, int64_t seekOffset);
   void Destroy();
 
+  /*! \brief Stop decoding ahead without waiting for the decoder's thread, Destroy() waits for it */
+  void StopDecoding();
+
   int ReadSamples(int numsamples);
 
+  /*! \brief Wake the decoder's thread to keep decoding ahead if the buffer has room
+   \return RET_ERROR if the file failed to open or decode, RET_SUCCESS otherwise.
+   */
+  int ReadAhead();
+
+  /*! \brief Whether the file has been decoded far enough ahead to start playback, or failed to */
+  bool IsReady();
+  bool HasFailed() const { return m_failed; }
+
   bool CanSeek() { if (m_codec) return m_codec->CanSeek(); else return false; };
   int64_t Seek(int64_t time);
   int64_t TotalTime();
-  void Start() { m_canPlay = true;}; // cause a pre-buffered stream to start.
-  int GetStatus() { return m_status; };
-  void SetStatus(int status) { m_status = status; };
+  void Start(); // cause a pre-buffered stream to start.
+  int GetStatus();
+  void SetStatus(int status);
 
   void GetDataFormat(CAEChannelInfo *channelInfo, unsigned int *samplerate, unsigned int *encodedSampleRate, enum AEDataFormat *dataFormat);
   unsigned int GetChannels() { if (m_codec) return m_codec->GetChannelInfo().Count(); else return 0; };
@@ -77,8 +101,12 @@ public:
   float GetReplayGain();
 
 private:
+  bool Open();
+  virtual void Run();
+
   // pcm buffer
   CRingBuffer m_pcmBuffer;
+  unsigned int m_queuedSize; // bytes to buffer before the file is queued
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
@@ -87,7 +115,8 @@ private:
   BYTE m_pcmInputBuffer[INPUT_SIZE];
   float m_inputBuffer[INPUT_SAMPLES];
 
-  // status
+  // status, shared by the player thread and the decoder's thread
+  CCriticalSection m_statusSection;
   bool    m_eof;
   int     m_status;
   bool    m_canPlay;
@@ -95,5 +124,27 @@ private:
   // the codec we're using
   ICodec*          m_codec;
 
+  // the file to open
+  CStdString       m_path;
+  CStdString       m_mimeType;
+  unsigned int     m_fileCache;
+  int              m_duration;
+  int64_t          m_seekOffset;
+  int              m_startOffset;        // of a song in a cue sheet, in frames of 1/75 second
+  bool             m_libraryReplayGain;  // look up the ReplayGain analyzed by the library
+
+  // decoding ahead
+  CThread*         m_thread;
+  CEvent           m_wake;
+  volatile bool    m_abort;
+  volatile bool    m_failed;
+
+  // statistics, in ms since Create()
+  unsigned int     m_createTime;
+  unsigned int     m_openTime;
+  unsigned int     m_firstSampleTime;
+  unsigned int     m_underruns;
+  bool             m_starving;
+
   CCriticalSection m_critSection;
 };
@@ -58,7 +58,8 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_upcomingCrossfadeMS(0),
   m_currentStream      (NULL ),
   m_audioCallback      (NULL ),
-  m_FileItem           (new CFileItem())
+  m_FileItem           (new CFileItem()),
+  m_starved            (false)
 {
   memset(&m_playerGUIData, 0, sizeof(m_playerGUIData));
 }
@@ -177,31 +178,44 @@ void PAPlayer::SoftStop(bool wait/* = false */, bool close/* = true */)
   }
 }
 
+void PAPlayer::CloseQueuedStreams()
+{
+  StreamList queued;
+  {
+    CExclusiveLock lock(m_streamsLock);
+    queued.swap(m_queued);
+  }
+
+  /* outside of the lock, a decoder may still be opening its file */
+  while(!queued.empty())
+  {
+    StreamInfo* si = queued.front();
+    queued.pop_front();
+    si->m_decoder.Destroy();
+    delete si;
+  }
+}
+
 void PAPlayer::CloseAllStreams(bool fade/* = true */)
 {
+  CloseQueuedStreams();
+
   if (!fade) 
   {
-    CExclusiveLock lock(m_streamsLock);
-    while(!m_streams.empty())
+    StreamList streams;
     {
-      StreamInfo* si = m_streams.front();
-      m_streams.pop_front();
-      
-      if (si->m_stream)
-      {
-        CAEFactory::FreeStream(si->m_stream);
-        si->m_stream = NULL;
-      }
-
-      si->m_decoder.Destroy();
-      delete si;
+      CExclusiveLock lock(m_streamsLock);
+      streams.swap(m_streams);
+      streams.splice(streams.end(), m_finishing);
+      m_currentStream = NULL;
     }
 
-    while(!m_finishing.empty())
+    /* outside of the lock, a decoder may still be finishing a read */
+    while(!streams.empty())
     {
-      StreamInfo* si = m_finishing.front();
-      m_finishing.pop_front();
-
+      StreamInfo* si = streams.front();
+      streams.pop_front();
+      
       if (si->m_stream)
       {
         CAEFactory::FreeStream(si->m_stream);
@@ -211,7 +225,6 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
       si->m_decoder.Destroy();
       delete si;
     }
-    m_currentStream = NULL;
   }
   else
   {
@@ -225,6 +238,9 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
 {
   m_defaultCrossfadeMS = CSettings::Get().GetInt("musicplayer.crossfade") * 1000;
 
+  /* whatever was queued next is not going to play */
+  CloseQueuedStreams();
+
   if (m_streams.size() > 1 || !m_defaultCrossfadeMS || m_isPaused)
   {
     CloseAllStreams(!m_isPaused);
@@ -232,7 +248,7 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
     m_isPaused = false; // Make sure to reset the pause state
   }
 
-  if (!QueueNextFileEx(file, false))
+  if (!QueueNextFileEx(file, false, true))
     return false;
 
   CSharedLock lock(m_streamsLock);
@@ -284,48 +300,19 @@ bool PAPlayer::QueueNextFile(const CFileItem &file)
   return QueueNextFileEx(file);
 }
 
-bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
+bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, bool wait/* = false */)
 {
   StreamInfo *si = new StreamInfo();
 
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
-  {
-    CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
-
-    delete si;
-    m_callback.OnQueueNextItem();
-    return false;
-  }
-
-  /* decode until there is data-available */
+  /* open and decode ahead on a worker */
+  si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75);
   si->m_decoder.Start();
-  while(si->m_decoder.GetDataSize() == 0)
-  {
-    int status = si->m_decoder.GetStatus();
-    if (status == STATUS_ENDED   ||
-        status == STATUS_NO_FILE ||
-        si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
-    {
-      CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error reading samples");
-
-      si->m_decoder.Destroy();
-      delete si;
-      m_callback.OnQueueNextItem();
-      return false;
-    }
-
-    /* yield our time so that the main PAP thread doesnt stall */
-    CThread::Sleep(1);
-  }
 
   UpdateCrossfadeTime(file);
 
   /* init the streaminfo struct */
-  si->m_decoder.GetDataFormat(&si->m_channelInfo, &si->m_sampleRate, &si->m_encodedSampleRate, &si->m_dataFormat);
   si->m_startOffset        = file.m_lStartOffset * 1000 / 75;
   si->m_endOffset          = file.m_lEndOffset   * 1000 / 75;
-  si->m_bytesPerSample     = CAEUtil::DataFormatToBits(si->m_dataFormat) >> 3;
-  si->m_bytesPerFrame      = si->m_bytesPerSample * si->m_channelInfo.Count();
   si->m_started            = false;
   si->m_finishing          = false;
   si->m_framesSent         = 0;
@@ -336,37 +323,73 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   si->m_fadeOutTriggered   = false;
   si->m_isSlaved           = false;
 
-  int64_t streamTotalTime = si->m_decoder.TotalTime();
-  if (si->m_endOffset)
-    streamTotalTime = si->m_endOffset - si->m_startOffset;
-  
   si->m_prepareNextAtFrame = 0;
-  if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-    si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
-
   si->m_prepareTriggered = false;
 
   si->m_playNextAtFrame = 0;
   si->m_playNextTriggered = false;
 
+  *m_FileItem = file;
+
+  if (!wait)
+  {
+    /* ProcessStreams adds it once it has been decoded far enough ahead */
+    CExclusiveLock lock(m_streamsLock);
+    m_queued.push_back(si);
+    return true;
+  }
+
+  while(!si->m_decoder.IsReady())
+  {
+    si->m_decoder.ReadAhead();
+    CThread::Sleep(1);
+  }
+
+  CExclusiveLock lock(m_streamsLock);
+  return AddStream(si);
+}
+
+bool PAPlayer::AddStream(StreamInfo *si)
+{
+  if (si->m_decoder.HasFailed() || si->m_decoder.GetDataSize() == 0)
+  {
+    CLog::Log(LOGINFO, "PAPlayer::AddStream - Error reading samples");
+
+    /* ProcessStreams destroys it outside of the lock */
+    si->m_decoder.StopDecoding();
+    m_finishing.push_back(si);
+    m_callback.OnQueueNextItem();
+    return false;
+  }
+
+  si->m_decoder.GetDataFormat(&si->m_channelInfo, &si->m_sampleRate, &si->m_encodedSampleRate, &si->m_dataFormat);
+  si->m_bytesPerSample     = CAEUtil::DataFormatToBits(si->m_dataFormat) >> 3;
+  si->m_bytesPerFrame      = si->m_bytesPerSample * si->m_channelInfo.Count();
+
+  int64_t streamTotalTime = si->m_decoder.TotalTime();
+  if (si->m_endOffset)
+    streamTotalTime = si->m_endOffset - si->m_startOffset;
+
+  /* give the next song the time to decode ahead before it is needed */
+  int64_t prepareTime = TIME_TO_CACHE_NEXT_FILE + g_advancedSettings.m_audioDecodeAhead * 1000 + m_defaultCrossfadeMS;
+  if (streamTotalTime >= prepareTime)
+    si->m_prepareNextAtFrame = (int)((streamTotalTime - prepareTime) * si->m_sampleRate / 1000.0f);
+
   if (!PrepareStream(si))
   {
-    CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error preparing stream");
+    CLog::Log(LOGINFO, "PAPlayer::AddStream - Error preparing stream");
     
-    si->m_decoder.Destroy();
-    delete si;
+    si->m_decoder.StopDecoding();
+    m_finishing.push_back(si);
     m_callback.OnQueueNextItem();
     return false;
   }
 
   /* add the stream to the list */
-  CExclusiveLock lock(m_streamsLock);
   m_streams.push_back(si);
   //update the current stream to start playing the next track at the correct frame.
   UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
 
-  *m_FileItem = file;
-
   return true;
 }
 
@@ -416,23 +439,12 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
     m_currentStream->m_stream->RegisterSlave(si->m_stream);
   }
 
-  /* fill the stream's buffer */
+  /* fill the stream's buffer with what was decoded ahead, ProcessStream tops it up */
   while(si->m_stream->IsBuffering())
   {
-    int status = si->m_decoder.GetStatus();
-    if (status == STATUS_ENDED   ||
-        status == STATUS_NO_FILE ||
-        si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
-    {
-      CLog::Log(LOGINFO, "PAPlayer::PrepareStream - Stream Finished");
-      break;
-    }
-
-    if (!QueueData(si))
+    int framesSent = si->m_framesSent;
+    if (!QueueData(si) || si->m_framesSent == framesSent)
       break;
-
-    /* yield our time so that the main PAP thread doesnt stall */
-    CThread::Sleep(1);
   }
 
   CLog::Log(LOGINFO, "PAPlayer::PrepareStream - Ready");
@@ -487,6 +499,8 @@ void PAPlayer::Process()
     if ((delay < buffer) && delay > watermark)
 #endif
       CThread::Sleep(MathUtils::round_int((delay - watermark) * 1000.0));
+    else if (m_starved)
+      CThread::Sleep(1); /* let the decoders catch up */
 
     GetTimeInternal(); //update for GUI
   }
@@ -499,31 +513,61 @@ void PAPlayer::Process()
 
 inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
 {
+  m_starved = false;
+
+  /* destroy any drained streams, outside of the lock as their decoders may still be finishing a read */
+  StreamList drained;
+  {
+    CExclusiveLock lock(m_streamsLock);
+    for(StreamList::iterator itt = m_finishing.begin(); itt != m_finishing.end();)
+    {
+      StreamInfo* si = *itt;
+      if (!si->m_stream || si->m_stream->IsDrained())
+      {
+        itt = m_finishing.erase(itt);
+        drained.push_back(si);
+      }
+      else
+        ++itt;
+    }
+  }
+
+  while(!drained.empty())
+  {
+    StreamInfo* si = drained.front();
+    drained.pop_front();
+    if (si->m_stream)
+      CAEFactory::FreeStream(si->m_stream);
+    si->m_decoder.Destroy();
+    delete si;
+    CLog::Log(LOGDEBUG, "PAPlayer::ProcessStreams - Stream Freed");
+  }
+
   CSharedLock sharedLock(m_streamsLock);
-  if (m_isFinished && m_streams.empty() && m_finishing.empty())
+  if (m_isFinished && m_streams.empty() && m_finishing.empty() && m_queued.empty())
   {
     m_isPlaying = false;
     delay       = 0;
     return;
   }
 
-  /* destroy any drained streams */
-  for(StreamList::iterator itt = m_finishing.begin(); itt != m_finishing.end();)
+  sharedLock.Leave();
+  CExclusiveLock lock(m_streamsLock);
+
+  /* add the queued streams in order, once they have been decoded far enough ahead */
+  while(!m_queued.empty())
   {
-    StreamInfo* si = *itt;
-    if (si->m_stream->IsDrained())
-    {      
-      itt = m_finishing.erase(itt);
-      CAEFactory::FreeStream(si->m_stream);
-      delete si;
-      CLog::Log(LOGDEBUG, "PAPlayer::ProcessStreams - Stream Freed");
+    StreamInfo* si = m_queued.front();
+    si->m_decoder.ReadAhead();
+    if (!si->m_decoder.IsReady())
+    {
+      m_starved = m_streams.empty();
+      break;
     }
-    else
-      ++itt;
-  }
 
-  sharedLock.Leave();
-  CExclusiveLock lock(m_streamsLock);
+    m_queued.pop_front();
+    AddStream(si);
+  }
 
   for(StreamList::iterator itt = m_streams.begin(); itt != m_streams.end(); ++itt)
   {
@@ -567,7 +611,7 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
 
       /* unregister the audio callback */
       si->m_stream->UnRegisterAudioCallback();
-      si->m_decoder.Destroy();      
+      si->m_decoder.StopDecoding();
       si->m_stream->Drain();
       m_finishing.push_back(si);
       return;
@@ -663,7 +707,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
   int status = si->m_decoder.GetStatus();
   if (status == STATUS_ENDED   ||
       status == STATUS_NO_FILE ||
-      si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR ||
+      si->m_decoder.ReadAhead() == RET_ERROR ||
       ((si->m_endOffset) && (si->m_framesSent / si->m_sampleRate >= (si->m_endOffset - si->m_startOffset) / 1000)))
   {
     CLog::Log(LOGINFO, "PAPlayer::ProcessStream - Stream Finished");
@@ -691,7 +735,11 @@ bool PAPlayer::QueueData(StreamInfo *si)
   unsigned int space   = si->m_stream->GetSpace();
   unsigned int samples = std::min(si->m_decoder.GetDataSize(), space / si->m_bytesPerSample);
   if (!samples)
+  {
+    if (si->m_started && space)
+      m_starved = true;
     return true;
+  }
 
   void* data = si->m_decoder.GetData(samples);
   if (!data)
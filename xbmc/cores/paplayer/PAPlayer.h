@@ -137,8 +137,12 @@ private:
   CSharedSection      m_streamsLock;         /* lock for the stream list */
   StreamList          m_streams;             /* playing streams */  
   StreamList          m_finishing;           /* finishing streams */
+  StreamList          m_queued;              /* streams still opening and decoding ahead */
+  bool                m_starved;             /* if a stream is waiting on its decoder */
 
-  bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true);
+  bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true, bool wait = false);
+  bool AddStream(StreamInfo *si);
+  void CloseQueuedStreams();
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
@@ -105,6 +105,7 @@ CDatabase::CDatabase(void)
   m_openCount = 0;
   m_sqlite = true;
   m_bMultiWrite = false;
+  m_transactionDepth = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -575,6 +576,7 @@ void CDatabase::Close()
   }
 
   m_openCount = 0;
+  m_transactionDepth = 0;
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
@@ -630,16 +632,40 @@ void CDatabase::BeginTransaction()
   try
   {
     if (NULL != m_pDB.get())
-      m_pDB->start_transaction();
+    {
+      // nested transactions are savepoints within the outermost one
+      if (m_transactionDepth > 0)
+        m_pDS->exec(PrepareSQL("SAVEPOINT nested%u", m_transactionDepth).c_str());
+      else
+        m_pDB->start_transaction();
+    }
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "database:begintransaction failed");
   }
+  m_transactionDepth++;
 }
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_transactionDepth > 1)
+  {
+    m_transactionDepth--;
+    try
+    {
+      if (NULL != m_pDB.get())
+        m_pDS->exec(PrepareSQL("RELEASE SAVEPOINT nested%u", m_transactionDepth).c_str());
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "database:committransaction of a nested transaction failed");
+      return false;
+    }
+    return true;
+  }
+  m_transactionDepth = 0;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -655,6 +681,25 @@ bool CDatabase::CommitTransaction()
 
 void CDatabase::RollbackTransaction()
 {
+  if (m_transactionDepth > 1)
+  { // only undo the nested transaction, the outer one goes on
+    m_transactionDepth--;
+    try
+    {
+      if (NULL != m_pDB.get())
+      {
+        m_pDS->exec(PrepareSQL("ROLLBACK TO SAVEPOINT nested%u", m_transactionDepth).c_str());
+        m_pDS->exec(PrepareSQL("RELEASE SAVEPOINT nested%u", m_transactionDepth).c_str());
+      }
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "database:rollbacktransaction of a nested transaction failed");
+    }
+    return;
+  }
+  m_transactionDepth = 0;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -668,7 +713,7 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
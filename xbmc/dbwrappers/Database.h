@@ -66,6 +66,9 @@ public:
 
   bool Open(const DatabaseSettings &db);
 
+  /*! \brief Transactions may be nested, only the outermost commit reaches the database.
+   Nested transactions are savepoints, so rolling one back keeps the outer transaction going.
+   */
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
@@ -173,4 +176,5 @@ private:
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
+  unsigned int m_transactionDepth; /*!< Number of BeginTransaction() calls not yet committed */
 };
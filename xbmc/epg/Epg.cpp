@@ -198,11 +198,12 @@ bool CEpg::InfoTagNow(CEpgInfoTag &tag, bool bUpdateIfNeeded /* = true */)
 
   if (bUpdateIfNeeded)
   {
-    CDateTime lastActiveTag;
-
-    /* one of the first items will always match if the list is sorted */
-    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    /* tags are sorted by start time, so the active tag is the last one that started before now.
+       there might be a gap between the last and next event. just return the last if found */
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(CDateTime::GetUTCDateTime());
+    while (it != m_tags.begin())
     {
+      --it;
       if (it->second->IsActive())
       {
         m_nowActiveStart = it->first;
@@ -210,15 +211,10 @@ bool CEpg::InfoTagNow(CEpgInfoTag &tag, bool bUpdateIfNeeded /* = true */)
         return true;
       }
       else if (it->second->WasActive())
-        lastActiveTag = it->first;
-    }
-
-    /* there might be a gap between the last and next event. just return the last if found */
-    map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.find(lastActiveTag);
-    if (it != m_tags.end())
-    {
-      tag = *it->second;
-      return true;
+      {
+        tag = *it->second;
+        return true;
+      }
     }
   }
 
@@ -241,13 +237,12 @@ bool CEpg::InfoTagNext(CEpgInfoTag &tag)
   else if (Size() > 0)
   {
     /* return the first event that is in the future */
-    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    CSingleLock lock(m_critSection);
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(CDateTime::GetUTCDateTime());
+    if (it != m_tags.end())
     {
-      if (it->second->InTheFuture())
-      {
-        tag = *it->second;
-        return true;
-      }
+      tag = *it->second;
+      return true;
     }
   }
 
@@ -288,9 +283,10 @@ CEpgInfoTagPtr CEpg::GetTag(const CDateTime &StartTime) const
 CEpgInfoTagPtr CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
   CSingleLock lock(m_critSection);
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  /* tags are sorted by start time. a tag ends after it starts, so nothing past endTime can match */
+  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.lower_bound(beginTime); it != m_tags.end() && it->first <= endTime; it++)
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
+    if (it->second->EndAsUTC() <= endTime)
       return it->second;
   }
 
@@ -301,10 +297,21 @@ CEpgInfoTagPtr CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &
 CEpgInfoTagPtr CEpg::GetTagAround(const CDateTime &time) const
 {
   CSingleLock lock(m_critSection);
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  /* start with the last tag that started at or before the given time. tags from some backends
+     overlap, so walk back for as long as the earlier tag overlaps the one after it */
+  map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(time);
+  while (it != m_tags.begin())
   {
-    if ((it->second->StartAsUTC() <= time) && (it->second->EndAsUTC() >= time))
-      return it->second;
+    CEpgInfoTagPtr tag = (--it)->second;
+    if (tag->StartAsUTC() <= time && tag->EndAsUTC() > time)
+      return tag;
+
+    if (it == m_tags.begin())
+      break;
+
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator previous = it;
+    if ((--previous)->second->EndAsUTC() <= tag->StartAsUTC())
+      break;
   }
 
   CEpgInfoTagPtr retVal;
@@ -522,7 +529,17 @@ int CEpg::Get(CFileItemList &results, const EpgSearchFilter &filter) const
 
   CSingleLock lock(m_critSection);
 
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  /* only look at the tags that start in the filter's time window. the window is widened by a
+     day, so local/UTC conversion around DST changes can't drop tags. FilterEntry() does the
+     exact check */
+  map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin();
+  map<CDateTime, CEpgInfoTagPtr>::const_iterator end = m_tags.end();
+  if (filter.m_startDateTime.IsValid())
+    it = m_tags.lower_bound(filter.m_startDateTime.GetAsUTCDateTime() - CDateTimeSpan(1, 0, 0, 0));
+  if (filter.m_endDateTime.IsValid())
+    end = m_tags.upper_bound(filter.m_endDateTime.GetAsUTCDateTime() + CDateTimeSpan(1, 0, 0, 0));
+
+  for (; it != end; it++)
   {
     if (filter.FilterEntry(*it->second))
       results.Add(CFileItemPtr(new CFileItem(*it->second)));
@@ -177,6 +177,9 @@ namespace EPG
 
     /*!
      * @brief Get the event that occurs at the given time.
+     *
+     * If events overlap, the one that started last is returned. Earlier events are only
+     * searched as long as each overlaps the event after it.
      * @param time The time in UTC to find the event for.
      * @return The found tag or NULL if it wasn't found.
      */
@@ -98,7 +98,7 @@ bool EpgSearchFilter::MatchSearchTerm(const CEpgInfoTag &tag) const
 
   if (!m_strSearchTerm.IsEmpty())
   {
-    CTextSearch search(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
+    const CTextSearch &search = GetTextSearch();
     bReturn = search.Search(tag.Title()) ||
         search.Search(tag.PlotOutline());
   }
@@ -147,6 +147,18 @@ int EpgSearchFilter::RemoveDuplicates(CFileItemList &results)
 }
 
 
+const CTextSearch &EpgSearchFilter::GetTextSearch() const
+{
+  if (!m_textSearch || m_strTextSearchTerm != m_strSearchTerm || m_bTextSearchCaseSensitive != m_bIsCaseSensitive)
+  {
+    m_textSearch.reset(new CTextSearch(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR));
+    m_strTextSearchTerm        = m_strSearchTerm;
+    m_bTextSearchCaseSensitive = m_bIsCaseSensitive;
+  }
+
+  return *m_textSearch;
+}
+
 bool EpgSearchFilter::MatchChannelNumber(const CEpgInfoTag &tag) const
 {
   bool bReturn(true);
@@ -22,7 +22,10 @@
 
 #include "XBDateTime.h"
 
+#include <boost/shared_ptr.hpp>
+
 class CFileItemList;
+class CTextSearch;
 
 namespace EPG
 {
@@ -76,5 +79,16 @@ namespace EPG
     int           m_iChannelGroup;            /*!< The group this channel belongs to */
     bool          m_bIgnorePresentTimers;     /*!< True to ignore currently present timers (future recordings), false if not */
     bool          m_bIgnorePresentRecordings; /*!< True to ignore currently active recordings, false if not */
+
+  private:
+    /*!
+     * @brief Get the parsed search term, so it's not parsed again for every tag.
+     * @return The search for m_strSearchTerm.
+     */
+    const CTextSearch &GetTextSearch() const;
+
+    mutable boost::shared_ptr<CTextSearch> m_textSearch;       /*!< Parsed search term, built on first use */
+    mutable CStdString                     m_strTextSearchTerm; /*!< The term m_textSearch was built for */
+    mutable bool                           m_bTextSearchCaseSensitive;
   };
 }
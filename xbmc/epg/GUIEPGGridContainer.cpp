@@ -56,6 +56,7 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float po
   m_blockCursor           = 0;
   m_channelOffset         = 0;
   m_blockOffset           = 0;
+  m_blocks                = 0;
   m_channelScrollOffset   = 0;
   m_channelScrollSpeed    = 0;
   m_channelScrollLastTime = 0;
@@ -90,6 +91,9 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float po
   m_cacheRulerItems       = preloadItems;
   m_cacheProgrammeItems   = preloadItems;
   m_gridIndex             = NULL;
+  m_gridRows              = 0;
+  m_gridStartTime         = 0;
+  m_gridEndTime           = 0;
 }
 
 CGUIEPGGridContainer::~CGUIEPGGridContainer(void)
@@ -375,6 +379,14 @@ void CGUIEPGGridContainer::ProcessProgrammeGrid(unsigned int currentTime, CDirty
   float DrawOffsetB = (chanOffset - cacheBeforeProgramme) * m_channelLayout->Size(m_orientation) - m_channelScrollOffset;
   posB += DrawOffsetB;
 
+  // build the rows just outside of the view as well, so scrolling onto them doesn't stall
+  int cacheBeforeChannel, cacheAfterChannel;
+  GetChannelCacheOffsets(cacheBeforeChannel, cacheAfterChannel);
+  int firstRow = std::max(chanOffset - std::max(cacheBeforeChannel, 1), 0);
+  int lastRow  = std::min(chanOffset + m_channelsPerPage + std::max(cacheAfterChannel, 1), m_gridRows);
+  for (int row = firstRow; row < lastRow; row++)
+    GetGridRow(row);
+
   int channel = chanOffset;
 
   while (posB < endB && m_channelItems.size())
@@ -387,13 +399,14 @@ void CGUIEPGGridContainer::ProcessProgrammeGrid(unsigned int currentTime, CDirty
 
     int block = blockOffset;
     float posA2 = posA;
+    GridItemsPtr *gridRow = GetGridRow(channel);
 
-    CGUIListItemPtr item = m_gridIndex[channel][block].item;
-    if (blockOffset > 0 && item == m_gridIndex[channel][blockOffset-1].item)
+    CGUIListItemPtr item = gridRow[block].item;
+    if (blockOffset > 0 && item == gridRow[blockOffset-1].item)
     {
       /* first program starts before current view */
       int startBlock = blockOffset - 1;
-      while (startBlock >= 0 && m_gridIndex[channel][startBlock].item == item)
+      while (startBlock >= 0 && gridRow[startBlock].item == item)
         startBlock--;
 
       block = startBlock + 1;
@@ -403,27 +416,27 @@ void CGUIEPGGridContainer::ProcessProgrammeGrid(unsigned int currentTime, CDirty
 
     while (posA2 < endA && m_programmeItems.size())   // FOR EACH ITEM ///////////////
     {
-      item = m_gridIndex[channel][block].item;
+      item = gridRow[block].item;
       if (!item || !item.get()->IsFileItem())
         break;
 
-      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == m_gridIndex[m_channelOffset + m_channelCursor][m_blockOffset + m_blockCursor].item);
+      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == GetGridRow(m_channelOffset + m_channelCursor)[m_blockOffset + m_blockCursor].item);
 
       if (m_orientation == VERTICAL)
-        ProcessItem(posA2, posB, item.get(), m_lastChannel, focused, m_programmeLayout, m_focusedProgrammeLayout, currentTime, dirtyregions, m_gridIndex[channel][block].width);
+        ProcessItem(posA2, posB, item.get(), m_lastChannel, focused, m_programmeLayout, m_focusedProgrammeLayout, currentTime, dirtyregions, gridRow[block].width);
       else
-        ProcessItem(posB, posA2, item.get(), m_lastChannel, focused, m_programmeLayout, m_focusedProgrammeLayout, currentTime, dirtyregions, m_gridIndex[channel][block].height);
+        ProcessItem(posB, posA2, item.get(), m_lastChannel, focused, m_programmeLayout, m_focusedProgrammeLayout, currentTime, dirtyregions, gridRow[block].height);
 
       // increment our X position
       if (m_orientation == VERTICAL)
       {
-        posA2 += m_gridIndex[channel][block].width; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].width / m_blockSize);
+        posA2 += gridRow[block].width; // assumes focused & unfocused layouts have equal length
+        block += (int)(gridRow[block].width / m_blockSize);
       }
       else
       {
-        posA2 += m_gridIndex[channel][block].height; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].height / m_blockSize);
+        posA2 += gridRow[block].height; // assumes focused & unfocused layouts have equal length
+        block += (int)(gridRow[block].height / m_blockSize);
       }
     }
 
@@ -471,13 +484,14 @@ void CGUIEPGGridContainer::RenderProgrammeGrid()
 
     int block = blockOffset;
     float posA2 = posA;
+    GridItemsPtr *gridRow = GetGridRow(channel);
 
-    CGUIListItemPtr item = m_gridIndex[channel][block].item;
-    if (blockOffset > 0 && item == m_gridIndex[channel][blockOffset-1].item)
+    CGUIListItemPtr item = gridRow[block].item;
+    if (blockOffset > 0 && item == gridRow[blockOffset-1].item)
     {
       /* first program starts before current view */
       int startBlock = blockOffset - 1;
-      while (startBlock >= 0 && m_gridIndex[channel][startBlock].item == item)
+      while (startBlock >= 0 && gridRow[startBlock].item == item)
         startBlock--;
 
       block = startBlock + 1;
@@ -487,11 +501,11 @@ void CGUIEPGGridContainer::RenderProgrammeGrid()
 
     while (posA2 < endA && m_programmeItems.size())   // FOR EACH ITEM ///////////////
     {
-      item = m_gridIndex[channel][block].item;
+      item = gridRow[block].item;
       if (!item || !item.get()->IsFileItem())
         break;
 
-      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == m_gridIndex[m_channelOffset + m_channelCursor][m_blockOffset + m_blockCursor].item);
+      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == GetGridRow(m_channelOffset + m_channelCursor)[m_blockOffset + m_blockCursor].item);
 
       // render our item
       if (focused)
@@ -507,7 +521,7 @@ void CGUIEPGGridContainer::RenderProgrammeGrid()
           focusedPosY = posA2;
         }
         focusedItem = item;
-        focusedsize = (m_orientation == VERTICAL ?  m_gridIndex[channel][block].width : m_gridIndex[channel][block].height);
+        focusedsize = (m_orientation == VERTICAL ?  gridRow[block].width : gridRow[block].height);
       }
       else
       {
@@ -520,13 +534,13 @@ void CGUIEPGGridContainer::RenderProgrammeGrid()
       // increment our X position
       if (m_orientation == VERTICAL)
       {
-        posA2 += m_gridIndex[channel][block].width; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].width / m_blockSize);
+        posA2 += gridRow[block].width; // assumes focused & unfocused layouts have equal length
+        block += (int)(gridRow[block].width / m_blockSize);
       }
       else
       {
-        posA2 += m_gridIndex[channel][block].height; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].height / m_blockSize);
+        posA2 += gridRow[block].height; // assumes focused & unfocused layouts have equal length
+        block += (int)(gridRow[block].height / m_blockSize);
       }
     }
 
@@ -804,15 +818,10 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
       for (int i = 0; i < items->Size(); i++)
         m_programmeItems.push_back(items->Get(i));
 
+      // rows of the grid are built on demand by GetGridRow()
       ClearGridIndex();
-      m_gridIndex = (struct GridItemsPtr **) calloc(1,m_channelItems.size()*sizeof(struct GridItemsPtr*));
-      if (m_gridIndex != NULL)
-      {
-        for (unsigned int i = 0; i < m_channelItems.size(); i++)
-        {
-          m_gridIndex[i] = (struct GridItemsPtr*) calloc(1,MAXBLOCKS*sizeof(struct GridItemsPtr));
-        }
-      }
+      m_gridRows = (int)m_channelItems.size();
+      m_gridIndex = (struct GridItemsPtr **) calloc(1,m_gridRows*sizeof(struct GridItemsPtr*));
 
       UpdateLayout(true); // true to refresh all items
 
@@ -851,7 +860,10 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
 
 void CGUIEPGGridContainer::UpdateItems()
 {
-  CDateTimeSpan blockDuration, gridDuration;
+  CDateTimeSpan gridDuration;
+
+  // rows already built may be for a different number of blocks
+  FreeGridRows();
 
   /* check for invalid start and end time */
   if (m_gridStart >= m_gridEnd)
@@ -868,6 +880,13 @@ void CGUIEPGGridContainer::UpdateItems()
   if (m_blocks >= MAXBLOCKS)
     m_blocks = MAXBLOCKS;
 
+  // keep the page within the rows, which are only a page long on a short guide
+  if (m_blockOffset > std::max(0, m_blocks - m_blocksPerPage))
+  {
+    m_blockOffset = std::max(0, m_blocks - m_blocksPerPage);
+    m_programmeScrollOffset = m_blockOffset * m_blockSize;
+  }
+
   /* if less than one page, can't display grid */
   if (m_blocks < m_blocksPerPage)
   {
@@ -877,106 +896,132 @@ void CGUIEPGGridContainer::UpdateItems()
     return;
   }
 
-  blockDuration.SetDateTimeSpan(0, 0, MINSPERBLOCK, 0);
+  m_gridStart.GetAsTime(m_gridStartTime);
+  m_gridEnd.GetAsTime(m_gridEndTime);
+
+  m_channels = (int)m_epgItemsPtr.size();
+  m_item = GetItem(m_channelCursor);
+  if (m_item)
+    SetBlock(GetBlock(m_item->item, m_channelCursor));
 
-  long tick(XbmcThreads::SystemClockMillis());
+  SetInvalid();
+}
 
-  for (unsigned int row = 0; row < m_channelItems.size(); ++row)
+GridItemsPtr *CGUIEPGGridContainer::GetGridRow(int row) const
+{
+  if (!m_gridIndex[row])
+    BuildGridRow(row);
+  return m_gridIndex[row];
+}
+
+int CGUIEPGGridContainer::GetGridRowLength() const
+{
+  // the cursor and scrolling look at up to a page of blocks past m_blockOffset, and
+  // one extra block lets the last one be compared with its successor
+  return std::max(m_blocks, m_blocksPerPage) + 1;
+}
+
+void CGUIEPGGridContainer::BuildGridRow(int row) const
+{
+  int length = GetGridRowLength();
+  GridItemsPtr *gridRow = new GridItemsPtr[length];
+  for (int block = 0; block < length; block++)
   {
-    CDateTime gridCursor  = m_gridStart; //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[row].start;
-    unsigned long lastIdx = m_epgItemsPtr[row].stop;
-    int iEpgId            = ((CFileItem *)m_programmeItems[progIdx].get())->GetEPGInfoTag()->EpgID();
+    gridRow[block].width  = 0;
+    gridRow[block].height = 0;
+  }
+  m_gridIndex[row] = gridRow;
 
-    /** FOR EACH BLOCK **********************************************************************/
+  if (row >= (int)m_epgItemsPtr.size())
+    return;
 
-    for (int block = 0; block < m_blocks; block++)
-    {
-      while (progIdx <= lastIdx)
-      {
-        CGUIListItemPtr item = m_programmeItems[progIdx];
-        const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
-        if (tag == NULL)
-          progIdx++;
+  /** FOR EACH PROGRAMME ******************************************************************/
 
-        if (tag->EpgID() != iEpgId)
-          break;
+  /* blocks are MINSPERBLOCK minutes each, counted from m_gridStartTime. Each block belongs
+     to the first programme that ends after the block starts */
+  const time_t blockSecs = MINSPERBLOCK * 60;
+  unsigned long progIdx = m_epgItemsPtr[row].start;
+  unsigned long lastIdx = m_epgItemsPtr[row].stop;
+  int iEpgId            = ((CFileItem *)m_programmeItems[progIdx].get())->GetEPGInfoTag()->EpgID();
+  int block             = 0;
 
-        if (m_gridEnd <= tag->StartAsUTC())
-        {
-          break;
-        }
-        else if (gridCursor >= tag->EndAsUTC())
-        {
-          progIdx++;
-        }
-        else if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[row][block].item = item;
-          break;
-        }
-        else
-        {
-          progIdx++;
-        }
-      }
+  for (; progIdx <= lastIdx && block < m_blocks; progIdx++)
+  {
+    CGUIListItemPtr item = m_programmeItems[progIdx];
+    const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
+    if (tag == NULL)
+      continue;
 
-      gridCursor += blockDuration;
-    }
+    if (tag->EpgID() != iEpgId)
+      break;
+
+    time_t start, end;
+    tag->StartAsUTC().GetAsTime(start);
+    if (start >= m_gridEndTime)
+      break;
+
+    tag->EndAsUTC().GetAsTime(end);
+    int endBlock = (int)((end - m_gridStartTime + blockSecs - 1) / blockSecs);
+    if (endBlock > m_blocks)
+      endBlock = m_blocks;
 
-    /** FOR EACH BLOCK **********************************************************************/
-    int itemSize = 1; // size of the programme in blocks
-    int savedBlock = 0;
+    for (; block < endBlock; block++)
+      gridRow[block].item = item;
+  }
 
-    for (int block = 0; block < m_blocks; block++)
+  /** FOR EACH BLOCK **********************************************************************/
+  int itemSize = 1; // size of the programme in blocks
+  int savedBlock = 0;
+
+  for (block = 0; block < m_blocks; block++)
+  {
+    if (gridRow[block].item != gridRow[block+1].item)
     {
-      if (m_gridIndex[row][block].item != m_gridIndex[row][block+1].item)
+      if (!gridRow[block].item)
       {
-        if (!m_gridIndex[row][block].item)
+        CEpgInfoTag broadcast;
+        CFileItemPtr unknown(new CFileItem(broadcast));
+        for (int i = block ; i > block - itemSize; i--)
         {
-          CEpgInfoTag broadcast;
-          CFileItemPtr unknown(new CFileItem(broadcast));
-          for (int i = block ; i > block - itemSize; i--)
-          {
-            m_gridIndex[row][i].item = unknown;
-          }
+          gridRow[i].item = unknown;
         }
+      }
 
-        CGUIListItemPtr item = m_gridIndex[row][block].item;
-        CFileItem *fileItem = (CFileItem *)item.get();
-
-        m_gridIndex[row][savedBlock].item->SetProperty("GenreType", fileItem->GetEPGInfoTag()->GenreType());
-        if (m_orientation == VERTICAL)
-        {
-          m_gridIndex[row][savedBlock].width   = itemSize*m_blockSize;
-          m_gridIndex[row][savedBlock].height  = m_channelHeight;
-        }
-        else
-        {
-          m_gridIndex[row][savedBlock].width   = m_channelWidth;
-          m_gridIndex[row][savedBlock].height  = itemSize*m_blockSize;
-        }
+      CGUIListItemPtr item = gridRow[block].item;
+      CFileItem *fileItem = (CFileItem *)item.get();
 
-        itemSize = 1;
-        savedBlock = block+1;
+      gridRow[savedBlock].item->SetProperty("GenreType", fileItem->GetEPGInfoTag()->GenreType());
+      if (m_orientation == VERTICAL)
+      {
+        gridRow[savedBlock].width   = itemSize*m_blockSize;
+        gridRow[savedBlock].height  = m_channelHeight;
       }
       else
       {
-        itemSize++;
+        gridRow[savedBlock].width   = m_channelWidth;
+        gridRow[savedBlock].height  = itemSize*m_blockSize;
       }
+
+      itemSize = 1;
+      savedBlock = block+1;
+    }
+    else
+    {
+      itemSize++;
     }
   }
+}
 
-  /******************************************* END ******************************************/
-
-  CLog::Log(LOGDEBUG, "%s completed successfully in %u ms", __FUNCTION__, (unsigned int)(XbmcThreads::SystemClockMillis()-tick));
-
-  m_channels = (int)m_epgItemsPtr.size();
-  m_item = GetItem(m_channelCursor);
-  if (m_item)
-    SetBlock(GetBlock(m_item->item, m_channelCursor));
+void CGUIEPGGridContainer::FreeGridRows()
+{
+  if (!m_gridIndex)
+    return;
 
-  SetInvalid();
+  for (int row = 0; row < m_gridRows; row++)
+  {
+    delete[] m_gridIndex[row];
+    m_gridIndex[row] = NULL;
+  }
 }
 
 void CGUIEPGGridContainer::ChannelScroll(int amount)
@@ -1061,7 +1106,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
     if (m_channelCursor + m_channelOffset < 0 || m_blockOffset < 0)
       return false;
 
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blockOffset].item)
+    if (m_item->item != GetGridRow(m_channelCursor + m_channelOffset)[m_blockOffset].item)
     {
       // this is not first item on page
       m_item = GetPrevItem(m_channelCursor);
@@ -1110,7 +1155,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
   }
   else
   {
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blocksPerPage + m_blockOffset - 1].item)
+    if (m_item->item != GetGridRow(m_channelCursor + m_channelOffset)[m_blocksPerPage + m_blockOffset - 1].item)
     {
       // this is not last item on page
       m_item = GetNextItem(m_channelCursor);
@@ -1316,7 +1361,7 @@ bool CGUIEPGGridContainer::SelectItemFromPoint(const CPoint &point, bool justGri
   if (block < 0) block = 0;
 
   // bail if block isn't occupied
-  if (!m_gridIndex[channel + m_channelOffset][block + m_blockOffset].item)
+  if (!GetGridRow(channel + m_channelOffset)[block + m_blockOffset].item)
     return false;
 
   SetChannel(channel);
@@ -1444,7 +1489,7 @@ int CGUIEPGGridContainer::GetSelectedItem() const
       m_blockCursor + m_blockOffset >= (int)m_programmeItems.size())
     return 0;
 
-  CGUIListItemPtr currentItem = m_gridIndex[m_channelCursor + m_channelOffset][m_blockCursor + m_blockOffset].item;
+  CGUIListItemPtr currentItem = GetGridRow(m_channelCursor + m_channelOffset)[m_blockCursor + m_blockOffset].item;
   if (!currentItem)
     return 0;
 
@@ -1531,9 +1576,9 @@ GridItemsPtr *CGUIEPGGridContainer::GetClosestItem(const int &channel)
   }
 
   if (right <= SHORTGAP && right <= left && m_blockCursor + right < m_blocksPerPage)
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + right + m_blockOffset];
+    return &GetGridRow(channel + m_channelOffset)[m_blockCursor + right + m_blockOffset];
 
-  return &m_gridIndex[channel + m_channelOffset][m_blockCursor - left  + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[m_blockCursor - left  + m_blockOffset];
 }
 
 int CGUIEPGGridContainer::GetItemSize(GridItemsPtr *item)
@@ -1556,7 +1601,7 @@ int CGUIEPGGridContainer::GetRealBlock(const CGUIListItemPtr &item, const int &c
 {
   int block = 0;
 
-  while (m_gridIndex[channel + m_channelOffset][block].item != item && block < m_blocks)
+  while (GetGridRow(channel + m_channelOffset)[block].item != item && block < m_blocks)
     block++;
 
   return block;
@@ -1566,28 +1611,28 @@ GridItemsPtr *CGUIEPGGridContainer::GetNextItem(const int &channel)
 {
   int i = m_blockCursor;
 
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i < m_blocksPerPage)
+  while (GetGridRow(channel + m_channelOffset)[i + m_blockOffset].item == GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset].item && i < m_blocksPerPage)
     i++;
 
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[i + m_blockOffset];
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetPrevItem(const int &channel)
 {
   int i = m_blockCursor;
 
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i > 0)
+  while (GetGridRow(channel + m_channelOffset)[i + m_blockOffset].item == GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset].item && i > 0)
     i--;
 
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[i + m_blockOffset];
 
-//  return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset - 1];
+//  return &GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset - 1];
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetItem(const int &channel)
 {
   if ( (channel >= 0) && (channel < m_channels) )
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset];
+    return &GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset];
   else
     return NULL;
 }
@@ -1770,17 +1815,20 @@ void CGUIEPGGridContainer::ClearGridIndex(void)
 {
   if (m_gridIndex)
   {
-    for (unsigned int i = 0; i < m_channelItems.size(); i++)
+    for (int i = 0; i < m_gridRows; i++)
     {
+      if (!m_gridIndex[i])
+        continue;
       for (int block = 0; block < m_blocks; block++)
       {
         if (m_gridIndex[i][block].item)
           m_gridIndex[i][block].item.get()->ClearProperties();
       }
-      free(m_gridIndex[i]);
     }
+    FreeGridRows();
     free(m_gridIndex);
   }
+  m_gridRows = 0;
 }
 
 void CGUIEPGGridContainer::Reset()
@@ -1811,10 +1859,10 @@ void CGUIEPGGridContainer::GoToEnd()
   int blockOffset = 0; // the block offset to scroll to
   for (int blockIndex = m_blocks; blockIndex >= 0 && (!blocksEnd || !blocksStart); blockIndex--)
   {
-    if (!blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item != NULL)
+    if (!blocksEnd && GetGridRow(m_channelCursor + m_channelOffset)[blockIndex].item != NULL)
       blocksEnd = blockIndex;
-    if (blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blocksEnd].item != 
-                     m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item)
+    if (blocksEnd && GetGridRow(m_channelCursor + m_channelOffset)[blocksEnd].item != 
+                     GetGridRow(m_channelCursor + m_channelOffset)[blockIndex].item)
       blocksStart = blockIndex + 1;
   }
   if (blocksEnd - blocksStart > m_blocksPerPage)
@@ -2006,36 +2054,37 @@ void CGUIEPGGridContainer::FreeProgrammeMemory(int channel, int keepStart, int k
 {
   if (keepStart < keepEnd)
   { // remove before keepStart and after keepEnd
+    GridItemsPtr *gridRow = GetGridRow(channel);
     if (keepStart > 0 && keepStart < m_blocks)
     {
       // if item exist and block is not part of visible item
-      CGUIListItemPtr last = m_gridIndex[channel][keepStart].item;
+      CGUIListItemPtr last = gridRow[keepStart].item;
       for (int i = keepStart - 1 ; i > 0 ; i--)
       {
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
+        if (gridRow[i].item && gridRow[i].item != last)
         {
-          m_gridIndex[channel][i].item->FreeMemory();
+          gridRow[i].item->FreeMemory();
           // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
           // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
           // to avoid calling FreeMemory() multiple times on item that ocupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
+          last = gridRow[i].item;
         }
       }
     }
 
     if (keepEnd > 0 && keepEnd < m_blocks)
     {
-      CGUIListItemPtr last = m_gridIndex[channel][keepEnd].item;
+      CGUIListItemPtr last = gridRow[keepEnd].item;
       for (int i = keepEnd + 1 ; i < m_blocks ; i++)
       {
         // if item exist and block is not part of visible item
-        if (m_gridIndex[channel][i].item && m_gridIndex[channel][i].item != last)
+        if (gridRow[i].item && gridRow[i].item != last)
         {
-          m_gridIndex[channel][i].item->FreeMemory();
+          gridRow[i].item->FreeMemory();
           // FreeMemory() is smart enough to not cause any problems when called multiple times on same item
           // but we can make use of condition needed to not call FreeMemory() on item that is partially visible
           // to avoid calling FreeMemory() multiple times on item that ocupy few blocks in a row
-          last = m_gridIndex[channel][i].item;
+          last = gridRow[i].item;
         }
       }
     }
@@ -112,6 +112,15 @@ namespace EPG
     void Reset();
     void ClearGridIndex(void);
 
+    /*! \brief Get the blocks of a channel's row, building the row on first use
+     \param row index of the channel
+     \return array of GetGridRowLength() blocks, those from m_blocks on are empty
+     */
+    GridItemsPtr *GetGridRow(int row) const;
+    void BuildGridRow(int row) const;
+    int GetGridRowLength() const;
+    void FreeGridRows();
+
     GridItemsPtr *GetItem(const int &channel);
     GridItemsPtr *GetNextItem(const int &channel);
     GridItemsPtr *GetPrevItem(const int &channel);
@@ -211,8 +220,11 @@ namespace EPG
 
     CDateTime m_gridStart;
     CDateTime m_gridEnd;
+    time_t    m_gridStartTime; //! m_gridStart as time_t, base for the block offsets of the programmes
+    time_t    m_gridEndTime;
 
-    struct GridItemsPtr **m_gridIndex;
+    struct GridItemsPtr **m_gridIndex; //! one row per channel, NULL until built by GetGridRow()
+    int m_gridRows;
     GridItemsPtr *m_item;
     CGUIListItem *m_lastItem;
     CGUIListItem *m_lastChannel;
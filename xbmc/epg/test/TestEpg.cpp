@@ -0,0 +1,74 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "epg/Epg.h"
+#include "epg/EpgInfoTag.h"
+#include "XBDateTime.h"
+
+#include "gtest/gtest.h"
+
+using namespace EPG;
+
+static void AddTag(CEpg &epg, const CStdString &strTitle, const CDateTime &start, const CDateTime &end)
+{
+  CEpgInfoTag tag;
+  tag.SetTitle(strTitle);
+  tag.SetStartFromUTC(start);
+  tag.SetEndFromUTC(end);
+  epg.UpdateEntry(tag);
+}
+
+static CStdString TitleAround(const CEpg &epg, const CDateTime &time)
+{
+  CEpgInfoTagPtr tag = epg.GetTagAround(time);
+  return tag ? tag->Title() : "";
+}
+
+TEST(TestEpg, GetTagAround)
+{
+  CEpg epg(1, "test");
+  AddTag(epg, "first",  CDateTime(2013, 1, 1, 10, 0, 0), CDateTime(2013, 1, 1, 11, 0, 0));
+  AddTag(epg, "second", CDateTime(2013, 1, 1, 11, 0, 0), CDateTime(2013, 1, 1, 12, 0, 0));
+  AddTag(epg, "third",  CDateTime(2013, 1, 1, 13, 0, 0), CDateTime(2013, 1, 1, 14, 0, 0));
+
+  EXPECT_STREQ("",       TitleAround(epg, CDateTime(2013, 1, 1,  9, 0, 0)).c_str());
+  EXPECT_STREQ("first",  TitleAround(epg, CDateTime(2013, 1, 1, 10, 0, 0)).c_str());
+  EXPECT_STREQ("first",  TitleAround(epg, CDateTime(2013, 1, 1, 10, 59, 0)).c_str());
+  EXPECT_STREQ("second", TitleAround(epg, CDateTime(2013, 1, 1, 11, 0, 0)).c_str());
+  EXPECT_STREQ("",       TitleAround(epg, CDateTime(2013, 1, 1, 12, 30, 0)).c_str());
+  EXPECT_STREQ("third",  TitleAround(epg, CDateTime(2013, 1, 1, 13, 30, 0)).c_str());
+  EXPECT_STREQ("",       TitleAround(epg, CDateTime(2013, 1, 1, 14, 0, 0)).c_str());
+}
+
+TEST(TestEpg, GetTagAroundOverlapping)
+{
+  /* a long event with a shorter one that starts while it runs */
+  CEpg epg(1, "test");
+  AddTag(epg, "long",  CDateTime(2013, 1, 1, 10, 0, 0), CDateTime(2013, 1, 1, 12, 0, 0));
+  AddTag(epg, "short", CDateTime(2013, 1, 1, 10, 30, 0), CDateTime(2013, 1, 1, 11, 0, 0));
+  AddTag(epg, "next",  CDateTime(2013, 1, 1, 11, 45, 0), CDateTime(2013, 1, 1, 13, 0, 0));
+
+  EXPECT_STREQ("long",  TitleAround(epg, CDateTime(2013, 1, 1, 10, 15, 0)).c_str());
+  EXPECT_STREQ("short", TitleAround(epg, CDateTime(2013, 1, 1, 10, 45, 0)).c_str());
+  EXPECT_STREQ("long",  TitleAround(epg, CDateTime(2013, 1, 1, 11, 30, 0)).c_str());
+  EXPECT_STREQ("next",  TitleAround(epg, CDateTime(2013, 1, 1, 11, 50, 0)).c_str());
+  EXPECT_STREQ("next",  TitleAround(epg, CDateTime(2013, 1, 1, 12, 30, 0)).c_str());
+  EXPECT_STREQ("",      TitleAround(epg, CDateTime(2013, 1, 1, 13, 0, 0)).c_str());
+}
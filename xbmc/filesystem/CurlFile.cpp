@@ -25,9 +25,16 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "File.h"
+#include "FileStatistics.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 
+#include <algorithm>
+#include <map>
 #include <vector>
 #include <climits>
+#include <boost/shared_ptr.hpp>
 
 #ifdef _LINUX
 #include <errno.h>
@@ -41,6 +48,7 @@
 #include "ShoutcastFile.h"
 #include "SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 
 using namespace XFILE;
@@ -51,6 +59,115 @@ using namespace XCURL;
 
 #define dllselect select
 
+#define SEGMENT_MIN      (128 * 1024)
+#define SEGMENT_MAX      (4 * 1024 * 1024)
+#define SEGMENT_DURATION 2 // seconds a segment should take at the measured throughput
+
+/* what recent requests told about a url, to answer stat and exists without asking again */
+struct SStatCacheEntry
+{
+  SStatCacheEntry() : m_timestamp(0), m_exists(false), m_hasHeader(false), m_hasStat(false) {}
+  unsigned int    m_timestamp;
+  bool            m_exists;
+  bool            m_hasHeader;
+  bool            m_hasStat;
+  CHttpHeader     m_header;
+  struct __stat64 m_stat;
+};
+typedef std::map<CStdString, SStatCacheEntry> MAPSTATCACHE;
+
+/* a GET in flight, which identical requests wait for instead of sending their own */
+struct SRequest
+{
+  SRequest() : m_done(true), m_success(false), m_response(-1) {}
+  CEvent      m_done;
+  bool        m_success;
+  long        m_response;
+  CStdString  m_data;
+  CHttpHeader m_header;
+};
+typedef std::map<CStdString, boost::shared_ptr<SRequest> > MAPREQUESTS;
+
+static MAPSTATCACHE     g_statCache;
+static MAPREQUESTS      g_requests;
+static CCriticalSection g_requestSection;
+
+static bool IsStatCacheValid(const SStatCacheEntry &entry, unsigned int now)
+{
+  return now - entry.m_timestamp <= (unsigned int)g_advancedSettings.m_curlStatCacheTime * 1000;
+}
+
+static bool LookupStat(const CURL &url, SStatCacheEntry &entry)
+{
+  if (g_advancedSettings.m_curlStatCacheTime <= 0)
+    return false;
+
+  CSingleLock lock(g_requestSection);
+  MAPSTATCACHE::iterator it = g_statCache.find(url.Get());
+  if (it == g_statCache.end())
+    return false;
+  if (!IsStatCacheValid(it->second, XbmcThreads::SystemClockMillis()))
+  {
+    g_statCache.erase(it);
+    return false;
+  }
+  entry = it->second;
+  return true;
+}
+
+static void StoreStat(const CURL &url, bool exists, const CHttpHeader *header = NULL, const struct __stat64 *buffer = NULL)
+{
+  if (g_advancedSettings.m_curlStatCacheTime <= 0)
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  CSingleLock lock(g_requestSection);
+
+  // most urls are only asked about once, don't let them pile up
+  if (g_statCache.size() >= 1000)
+  {
+    MAPSTATCACHE::iterator it = g_statCache.begin();
+    while (it != g_statCache.end())
+    {
+      if (IsStatCacheValid(it->second, now))
+        it++;
+      else
+        g_statCache.erase(it++);
+    }
+    if (g_statCache.size() >= 1000)
+      g_statCache.clear();
+  }
+
+  // keep what an earlier request told, unless this one knows better
+  SStatCacheEntry &entry = g_statCache[url.Get()];
+  if (!exists || !entry.m_exists || !IsStatCacheValid(entry, now))
+  {
+    entry.m_hasHeader = false;
+    entry.m_hasStat = false;
+  }
+  entry.m_timestamp = now;
+  entry.m_exists = exists;
+  if (exists && header)
+  {
+    entry.m_header = *header;
+    entry.m_hasHeader = true;
+  }
+  if (exists && buffer)
+  {
+    entry.m_stat = *buffer;
+    entry.m_hasStat = true;
+  }
+}
+
+static void FinishRequest(const CStdString &key, const boost::shared_ptr<SRequest> &request)
+{
+  {
+    CSingleLock lock(g_requestSection);
+    g_requests.erase(key);
+  }
+  request->m_done.Set();
+}
+
 
 curl_proxytype proxyType2CUrlProxyType[] = {
   CURLPROXY_HTTP,
@@ -411,6 +528,7 @@ CCurlFile::CCurlFile()
   m_proxytype = PROXY_HTTP;
   m_state = new CReadState();
   m_oldState = NULL;
+  m_segmented = NULL;
   m_skipshout = false;
   m_httpresponse = -1;
 }
@@ -426,6 +544,8 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  delete m_segmented;
+  m_segmented = NULL;
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -511,8 +631,8 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, FALSE);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, FALSE);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -805,18 +925,88 @@ bool CCurlFile::Get(const CStdString& strURL, CStdString& strHTML)
   return Service(strURL, strHTML);
 }
 
+CStdString CCurlFile::GetRequestKey(const CStdString& strURL) const
+{
+  // everything sent along that can change the response
+  CStdString key = strURL + "\n" + m_userAgent + "\n" + m_referer + "\n" + m_cookie + "\n" + m_contentencoding;
+  for (MAPHTTPHEADERS::const_iterator it = m_requestheaders.begin(); it != m_requestheaders.end(); it++)
+    key += "\n" + it->first + ": " + it->second;
+  return key;
+}
+
 bool CCurlFile::Service(const CStdString& strURL, CStdString& strHTML)
 {
-  if (Open(strURL))
+  if (m_postdataset || !m_customrequest.IsEmpty())
+    return DoService(strURL, strHTML);
+
+  // identical GETs at the same time share a single transfer
+  CStdString key = GetRequestKey(strURL);
+  boost::shared_ptr<SRequest> request;
+  bool waiting = false;
   {
-    if (ReadData(strHTML))
+    CSingleLock lock(g_requestSection);
+    MAPREQUESTS::iterator it = g_requests.find(key);
+    if (it != g_requests.end())
     {
-      Close();
-      return true;
+      request = it->second;
+      waiting = true;
+    }
+    else
+    {
+      request.reset(new SRequest());
+      g_requests[key] = request;
     }
   }
+
+  if (waiting)
+  {
+    while (!request->m_done.WaitMSec(100))
+    {
+      if (m_state->m_cancelled)
+        return false;
+    }
+    strHTML = request->m_data;
+    m_state->m_httpheader = request->m_header;
+    m_httpresponse = request->m_response;
+    return request->m_success;
+  }
+
+  bool success;
+  try
+  {
+    success = DoService(strURL, strHTML);
+  }
+  catch (...)
+  {
+    FinishRequest(key, request);
+    throw;
+  }
+
+  request->m_success = success;
+  request->m_response = m_httpresponse;
+  request->m_data = strHTML;
+  request->m_header = m_state->m_httpheader;
+  FinishRequest(key, request);
+  return success;
+}
+
+bool CCurlFile::DoService(const CStdString& strURL, CStdString& strHTML)
+{
+  // web services don't go through CFile, so count them here
+  bool statistics = CFileStatistics::IsEnabled();
+  int64_t start = CFileStatistics::Now();
+  bool success = Open(strURL);
+  if (statistics)
+    CFileStatistics::Get().Record(CURL(strURL), CFileStatistics::OP_OPEN, CFileStatistics::GetElapsed(start), success);
+  if (success)
+  {
+    start = CFileStatistics::Now();
+    success = ReadData(strHTML);
+    if (statistics)
+      CFileStatistics::Get().Record(CURL(strURL), CFileStatistics::OP_READ, CFileStatistics::GetElapsed(start), success, strHTML.size());
+  }
   Close();
-  return false;
+  return success;
 }
 
 bool CCurlFile::ReadData(CStdString& strHTML)
@@ -907,6 +1097,10 @@ bool CCurlFile::Open(const CURL& url)
   SetRequestHeaders(m_state);
   m_state->m_sendRange = m_seekable;
 
+  bool http = url2.GetProtocol().Equals("http") || url2.GetProtocol().Equals("https");
+  if (http)
+    g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_FILETIME, 1);
+
   m_httpresponse = m_state->Connect(m_bufferSize);
   if( m_httpresponse < 0 || m_httpresponse >= 400)
     return false;
@@ -930,7 +1124,7 @@ bool CCurlFile::Open(const CURL& url)
   }
 
   m_multisession = false;
-  if(url2.GetProtocol().Equals("http") || url2.GetProtocol().Equals("https"))
+  if(http)
   {
     m_multisession = true;
     if(m_state->m_httpheader.GetValue("Server").Find("Portable SDK for UPnP devices") >= 0)
@@ -960,9 +1154,86 @@ bool CCurlFile::Open(const CURL& url)
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_EFFECTIVE_URL,&efurl) && efurl)
     m_url = efurl;
 
+  // a stat that follows can be answered from this response
+  if (http && !m_postdataset && m_customrequest.IsEmpty() && m_state->m_fileSize > 0)
+  {
+    struct __stat64 buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.st_size = m_state->m_fileSize;
+    if (m_state->m_httpheader.GetMimeType().Find("text/html") >= 0) //consider html files directories
+      buffer.st_mode = _S_IFDIR;
+    else
+      buffer.st_mode = _S_IFREG;
+    long filetime;
+    if (CURLE_OK == g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_FILETIME, &filetime) && filetime != -1)
+      buffer.st_mtime = filetime;
+    StoreStat(url, true, &m_state->m_httpheader, &buffer);
+  }
+
+  unsigned int segmentSize = g_advancedSettings.m_curlSegmentSize * 1024;
+  if (g_advancedSettings.m_curlSegments > 1 && m_seekable && m_multisession
+  &&  m_state->m_httpheader.GetValue("Accept-Ranges").Equals("bytes")
+  &&  !m_postdataset && m_customrequest.IsEmpty() && m_contentencoding.IsEmpty()
+  &&  m_state->m_fileSize > 2 * (int64_t)segmentSize)
+  {
+    CLog::Log(LOGDEBUG, "CCurlFile::Open - Reading %s through %d connections", m_url.c_str(), g_advancedSettings.m_curlSegments);
+
+    // the segments take over from the initial request
+    int64_t fileSize = m_state->m_fileSize;
+    m_state->Disconnect();
+    m_segmented = new CSegmentedState(*this, fileSize, g_advancedSettings.m_curlSegments, segmentSize,
+                                      g_advancedSettings.m_curlSegmentBuffer * 1024);
+  }
+
   return true;
 }
 
+bool CCurlFile::StopSegmented()
+{
+  int64_t pos = m_segmented->GetPosition();
+  int64_t fileSize = m_segmented->GetLength();
+  delete m_segmented;
+  m_segmented = NULL;
+
+  CLog::Log(LOGNOTICE, "CCurlFile::StopSegmented - Continuing %s at %"PRId64" through a single connection", m_url.c_str(), pos);
+
+  SetCommonOptions(m_state);
+  SetRequestHeaders(m_state);
+
+  m_state->m_filePos = pos;
+  m_state->m_fileSize = fileSize;
+  m_state->m_sendRange = true;
+
+  long response = m_state->Connect(m_bufferSize);
+  if (response < 0 || response >= 400)
+    return false;
+
+  SetCorrectHeaders(m_state);
+  return true;
+}
+
+unsigned int CCurlFile::Read(void* lpBuf, int64_t uiBufSize)
+{
+  if (m_segmented)
+  {
+    unsigned int read = m_segmented->Read(lpBuf, uiBufSize);
+    if (read > 0 || !m_segmented->IsFailed() || !StopSegmented())
+      return read;
+  }
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
+bool CCurlFile::ReadString(char *szLine, int iLineLength)
+{
+  if (m_segmented)
+  {
+    bool result = m_segmented->ReadString(szLine, iLineLength);
+    if (result || !m_segmented->IsFailed() || !StopSegmented())
+      return result;
+  }
+  return m_state->ReadString(szLine, iLineLength);
+}
+
 bool CCurlFile::OpenForWrite(const CURL& url, bool bOverWrite)
 {
   if(m_opened)
@@ -971,6 +1242,8 @@ bool CCurlFile::OpenForWrite(const CURL& url, bool bOverWrite)
   if (Exists(url) && !bOverWrite)
     return false;
 
+  ClearStatCache(url);
+
   CURL url2(url);
   ParseAndCorrectUrl(url2);
 
@@ -1080,6 +1353,14 @@ bool CCurlFile::Exists(const CURL& url)
     return true;
   }
 
+  SStatCacheEntry entry;
+  if (LookupStat(url, entry))
+  {
+    if (!entry.m_exists)
+      errno = ENOENT;
+    return entry.m_exists;
+  }
+
   CURL url2(url);
   ParseAndCorrectUrl(url2);
 
@@ -1103,18 +1384,29 @@ bool CCurlFile::Exists(const CURL& url)
   }
 
   CURLcode result = g_curlInterface.easy_perform(m_state->m_easyHandle);
+  long code = 0;
+  if (result == CURLE_HTTP_RETURNED_ERROR)
+    g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_RESPONSE_CODE, &code);
   g_curlInterface.easy_release(&m_state->m_easyHandle, NULL);
 
   if (result == CURLE_WRITE_ERROR || result == CURLE_OK)
+  {
+    StoreStat(url, true);
     return true;
+  }
 
   if (result == CURLE_HTTP_RETURNED_ERROR)
   {
-    long code;
-    if(g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_RESPONSE_CODE, &code) == CURLE_OK && code != 404 )
+    if (code == 404)
+      StoreStat(url, false);
+    else
       CLog::Log(LOGERROR, "CCurlFile::Exists - Failed: HTTP returned error %ld for %s", code, url.Get().c_str());
   }
-  else if (result != CURLE_REMOTE_FILE_NOT_FOUND && result != CURLE_FTP_COULDNT_RETR_FILE)
+  else if (result == CURLE_REMOTE_FILE_NOT_FOUND || result == CURLE_FTP_COULDNT_RETR_FILE)
+  {
+    StoreStat(url, false);
+  }
+  else
   {
     CLog::Log(LOGERROR, "CCurlFile::Exists - Failed: %s(%d) for %s", g_curlInterface.easy_strerror(result), result, url.Get().c_str());
   }
@@ -1125,7 +1417,8 @@ bool CCurlFile::Exists(const CURL& url)
 
 int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  int64_t nextPos = m_state->m_filePos;
+  int64_t nextPos = m_segmented ? m_segmented->GetPosition() : m_state->m_filePos;
+  int64_t fileSize = m_segmented ? m_segmented->GetLength() : m_state->m_fileSize;
   switch(iWhence)
   {
     case SEEK_SET:
@@ -1135,8 +1428,8 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
       nextPos += iFilePosition;
       break;
     case SEEK_END:
-      if (m_state->m_fileSize)
-        nextPos = m_state->m_fileSize + iFilePosition;
+      if (fileSize)
+        nextPos = fileSize + iFilePosition;
       else
         return -1;
       break;
@@ -1145,7 +1438,14 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   }
 
   // We can't seek beyond EOF
-  if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
+  if (fileSize && nextPos > fileSize) return -1;
+
+  // the segments request whatever is read next
+  if (m_segmented)
+  {
+    m_segmented->Seek(nextPos);
+    return nextPos;
+  }
 
   if(m_state->Seek(nextPos))
     return nextPos;
@@ -1207,12 +1507,14 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 int64_t CCurlFile::GetLength()
 {
   if (!m_opened) return 0;
+  if (m_segmented) return m_segmented->GetLength();
   return m_state->m_fileSize;
 }
 
 int64_t CCurlFile::GetPosition()
 {
   if (!m_opened) return 0;
+  if (m_segmented) return m_segmented->GetPosition();
   return m_state->m_filePos;
 }
 
@@ -1231,6 +1533,20 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
     return 0;
   }
 
+  SStatCacheEntry entry;
+  if (LookupStat(url, entry) && (!entry.m_exists || (entry.m_hasHeader && (entry.m_hasStat || !buffer))))
+  {
+    if (!entry.m_exists)
+    {
+      errno = ENOENT;
+      return -1;
+    }
+    m_state->m_httpheader = entry.m_header;
+    if (buffer)
+      *buffer = entry.m_stat;
+    return 0;
+  }
+
   CURL url2(url);
   ParseAndCorrectUrl(url2);
 
@@ -1259,7 +1575,12 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
   {
     long code;
     if(g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_RESPONSE_CODE, &code) == CURLE_OK && code == 404 )
+    {
+      g_curlInterface.easy_release(&m_state->m_easyHandle, NULL);
+      StoreStat(url, false);
+      errno = ENOENT;
       return -1;
+    }
   }
 
   if(result == CURLE_GOT_NOTHING 
@@ -1343,6 +1664,7 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
     }
   }
   g_curlInterface.easy_release(&m_state->m_easyHandle, NULL);
+  StoreStat(url, true, &m_state->m_httpheader, buffer);
   return 0;
 }
 
@@ -1541,6 +1863,302 @@ void CCurlFile::CReadState::SetReadBuffer(const void* lpBuf, int64_t uiBufSize)
   m_filePos = 0;
 }
 
+CCurlFile::CSegmentedState::CSegmentedState(CCurlFile &file, int64_t fileSize, unsigned int connections, unsigned int segmentSize, unsigned int bufferSize)
+  : m_file(file)
+{
+  CURL url(file.m_url);
+  m_protocol = url.GetProtocol();
+  m_hostName = url.GetHostName();
+  m_multiHandle = g_curlInterface.multi_init();
+  m_filePos = 0;
+  m_fileSize = fileSize;
+  m_nextStart = 0;
+  m_lastPerform = 0;
+  m_connections = connections;
+  // up to twice the connections are buffered, so that's what bounds the size of a segment
+  m_maxSegmentSize = std::max((unsigned int)SEGMENT_MIN, std::min((unsigned int)SEGMENT_MAX, bufferSize / (2 * connections))) & ~0xffff;
+  m_segmentSize = std::min(segmentSize, m_maxSegmentSize);
+  m_failed = false;
+}
+
+CCurlFile::CSegmentedState::~CSegmentedState()
+{
+  Restart(0);
+
+  // the multi handle has to go before the easy handles that were in it
+  g_curlInterface.multi_cleanup(m_multiHandle);
+  for (std::vector<CReadState*>::iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+    delete *it;
+}
+
+int64_t CCurlFile::CSegmentedState::GetReceived(const Segment &segment) const
+{
+  return segment.m_state->m_filePos + segment.m_state->m_buffer.getMaxReadSize();
+}
+
+void CCurlFile::CSegmentedState::StartSegments()
+{
+  unsigned int running = 0;
+  for (Segments::const_iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if (!it->m_done)
+      running++;
+  }
+
+  // finished segments wait in memory until they are read, so don't get too far ahead
+  while (running < m_connections && m_segments.size() < 2 * m_connections && m_nextStart < m_fileSize)
+  {
+    Segment segment;
+    if (m_idle.empty())
+    {
+      segment.m_state = new CReadState();
+      g_curlInterface.easy_aquire(m_protocol, m_hostName, &segment.m_state->m_easyHandle, NULL);
+    }
+    else
+    {
+      segment.m_state = m_idle.back();
+      m_idle.pop_back();
+    }
+
+    // don't leave a small segment at the end
+    int64_t end = m_nextStart + m_segmentSize;
+    if (end + m_segmentSize / 4 > m_fileSize)
+      end = m_fileSize;
+
+    segment.m_start = m_nextStart;
+    segment.m_retries = 0;
+    segment.m_done = false;
+    segment.m_state->m_filePos = m_nextStart;
+    segment.m_state->m_fileSize = end;
+    segment.m_state->m_buffer.Create((unsigned int)(end - m_nextStart));
+    Request(segment, m_nextStart);
+
+    m_segments.push_back(segment);
+    m_nextStart = end;
+    running++;
+  }
+}
+
+void CCurlFile::CSegmentedState::Request(Segment &segment, int64_t from)
+{
+  CReadState* state = segment.m_state;
+  m_file.SetCommonOptions(state);
+  m_file.SetRequestHeaders(state);
+
+  CStdString range;
+  range.Format("%"PRId64"-%"PRId64, from, state->m_fileSize - 1);
+  g_curlInterface.easy_setopt(state->m_easyHandle, CURLOPT_RANGE, range.c_str());
+
+  state->m_headerdone = false;
+  state->m_multiHandle = m_multiHandle;
+  g_curlInterface.multi_add_handle(m_multiHandle, state->m_easyHandle);
+
+  segment.m_requested = from;
+  segment.m_started = CurrentHostCounter();
+  segment.m_verified = false;
+}
+
+bool CCurlFile::CSegmentedState::Verify(Segment &segment)
+{
+  if (segment.m_verified || GetReceived(segment) == segment.m_requested)
+    return true;
+
+  // a server that ignores the range sends the whole file instead
+  long response;
+  if (g_curlInterface.easy_getinfo(segment.m_state->m_easyHandle, CURLINFO_RESPONSE_CODE, &response) == CURLE_OK && response != 206)
+  {
+    CLog::Log(LOGWARNING, "CCurlFile::CSegmentedState::Verify - Range request answered with %ld", response);
+    m_failed = true;
+    return false;
+  }
+  segment.m_verified = true;
+  return true;
+}
+
+bool CCurlFile::CSegmentedState::Complete(Segment &segment, int result)
+{
+  if (!Verify(segment))
+    return false;
+
+  g_curlInterface.multi_remove_handle(m_multiHandle, segment.m_state->m_easyHandle);
+
+  if (result == CURLE_OK && GetReceived(segment) == segment.m_state->m_fileSize)
+  {
+    segment.m_done = true;
+    Adapt(segment);
+    return true;
+  }
+
+  if (result != CURLE_OK)
+    CLog::Log(LOGERROR, "CCurlFile::CSegmentedState::Complete - Failed: %s(%d)", g_curlInterface.easy_strerror((CURLcode)result), result);
+
+  if (++segment.m_retries > g_advancedSettings.m_curlretries)
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CSegmentedState::Complete - Reconnect failed!");
+    m_failed = true;
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CCurlFile::CSegmentedState::Complete - Reconnect, (re)try %i", segment.m_retries);
+  Request(segment, GetReceived(segment));
+  return true;
+}
+
+void CCurlFile::CSegmentedState::Adapt(const Segment &segment)
+{
+  int64_t elapsed = CurrentHostCounter() - segment.m_started;
+  if (elapsed <= 0)
+    return;
+
+  // the time a request takes includes the round trip, which larger segments spread over more data
+  double rate = (double)(segment.m_state->m_fileSize - segment.m_requested) * CurrentHostFrequency() / elapsed;
+  int64_t size = ((int64_t)m_segmentSize + (int64_t)(rate * SEGMENT_DURATION)) / 2;
+  size = std::max((int64_t)SEGMENT_MIN, std::min((int64_t)m_maxSegmentSize, size)) & ~(int64_t)0xffff;
+  if (size != (int64_t)m_segmentSize)
+    CLog::Log(LOGDEBUG, "CCurlFile::CSegmentedState::Adapt - %.0f kB/s per connection, segments of %"PRId64" kB", rate / 1024, size / 1024);
+  m_segmentSize = (unsigned int)size;
+}
+
+void CCurlFile::CSegmentedState::Recycle(Segment &segment)
+{
+  // stops the request if it's still running, the handle keeps its session
+  segment.m_state->Disconnect();
+  segment.m_state->m_multiHandle = NULL;
+  segment.m_state->m_buffer.Destroy();
+  m_idle.push_back(segment.m_state);
+}
+
+void CCurlFile::CSegmentedState::Restart(int64_t pos)
+{
+  for (Segments::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    Recycle(*it);
+  m_segments.clear();
+  m_nextStart = pos;
+}
+
+bool CCurlFile::CSegmentedState::Process(bool wait)
+{
+  if (m_file.m_state->m_cancelled)
+    return false;
+
+  StartSegments();
+
+  int running;
+  CURLMcode result;
+  while ((result = g_curlInterface.multi_perform(m_multiHandle, &running)) == CURLM_CALL_MULTI_PERFORM);
+  m_lastPerform = CurrentHostCounter();
+  if (result != CURLM_OK)
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CSegmentedState::Process - Multi perform failed with code %d, aborting", result);
+    m_failed = true;
+    return false;
+  }
+
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    CURL_HANDLE* easy = msg->easy_handle;
+    CURLcode code = msg->data.result;
+    for (Segments::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    {
+      if (it->m_state->m_easyHandle == easy)
+      {
+        if (!Complete(*it, code))
+          return false;
+        break;
+      }
+    }
+  }
+
+  for (Segments::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if (!it->m_done && !Verify(*it))
+      return false;
+  }
+
+  if (!wait)
+    return true;
+
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  int maxfd = -1;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+  g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+  long timeout = 0;
+  if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout == -1)
+    timeout = 200;
+
+  struct timeval t = { timeout / 1000, (timeout % 1000) * 1000 };
+  if (SOCKET_ERROR == dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t))
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CSegmentedState::Process - Failed with socket error");
+    m_failed = true;
+    return false;
+  }
+  return true;
+}
+
+unsigned int CCurlFile::CSegmentedState::Read(void* lpBuf, int64_t uiBufSize)
+{
+  if (m_failed || m_filePos >= m_fileSize)
+    return 0;
+
+  // drop what has been read, and start over when seeking outside of the segments
+  while (!m_segments.empty() && m_segments.front().m_state->m_fileSize <= m_filePos)
+  {
+    Recycle(m_segments.front());
+    m_segments.pop_front();
+  }
+  if (m_segments.empty() || m_segments.front().m_start > m_filePos || m_segments.front().m_state->m_filePos > m_filePos)
+    Restart(m_filePos);
+
+  StartSegments();
+  while (GetReceived(m_segments.front()) <= m_filePos)
+  {
+    if (!Process(true))
+      return 0;
+  }
+
+  CReadState* state = m_segments.front().m_state;
+  if (state->m_filePos < m_filePos)
+  {
+    state->m_buffer.SkipBytes((int)(m_filePos - state->m_filePos));
+    state->m_filePos = m_filePos;
+  }
+
+  unsigned int want = (unsigned int)XMIN((int64_t)state->m_buffer.getMaxReadSize(), uiBufSize);
+  if (!state->m_buffer.ReadData((char *)lpBuf, want))
+    return 0;
+  state->m_filePos += want;
+  m_filePos += want;
+
+  // keep the other requests going while the data at hand is read
+  if (CurrentHostCounter() - m_lastPerform > CurrentHostFrequency() / 100)
+    Process(false);
+
+  return want;
+}
+
+bool CCurlFile::CSegmentedState::ReadString(char *szLine, int iLineLength)
+{
+  char* pLine = szLine;
+  while (pLine - szLine < iLineLength - 1 && Read(pLine, 1) == 1)
+  {
+    if (*pLine++ == '\n')
+      break;
+  }
+  pLine[0] = 0;
+  return pLine > szLine;
+}
+
 void CCurlFile::ClearRequestHeaders()
 {
   m_requestheaders.clear();
@@ -1559,6 +2177,12 @@ void CCurlFile::SetRequestHeader(CStdString header, long value)
 }
 
 /* STATIC FUNCTIONS */
+void CCurlFile::ClearStatCache(const CURL &url)
+{
+  CSingleLock lock(g_requestSection);
+  g_statCache.erase(url.Get());
+}
+
 bool CCurlFile::GetHttpHeader(const CURL &url, CHttpHeader &headers)
 {
   try
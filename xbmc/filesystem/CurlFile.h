@@ -21,7 +21,9 @@
 
 #include "IFile.h"
 #include "utils/RingBuffer.h"
+#include <deque>
 #include <map>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -57,8 +59,8 @@ namespace XFILE
       virtual int64_t  GetLength();
       virtual int  Stat(const CURL& url, struct __stat64* buffer);
       virtual void Close();
-      virtual bool ReadString(char *szLine, int iLineLength)     { return m_state->ReadString(szLine, iLineLength); }
-      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize)  { return m_state->Read(lpBuf, uiBufSize); }
+      virtual bool ReadString(char *szLine, int iLineLength);
+      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize);
       virtual int Write(const void* lpBuf, int64_t uiBufSize);
       virtual CStdString GetMimeType()                           { return m_state->m_httpheader.GetMimeType(); }
       virtual int IoControl(EIoControl request, void* param);
@@ -95,6 +97,9 @@ namespace XFILE
       static bool GetHttpHeader(const CURL &url, CHttpHeader &headers);
       static bool GetMimeType(const CURL &url, CStdString &content, CStdString useragent="");
 
+      /* forget what recent requests told about a url, after changing it */
+      static void ClearStatCache(const CURL &url);
+
       class CReadState
       {
       public:
@@ -140,16 +145,82 @@ namespace XFILE
           void         Disconnect();
       };
 
+      /*!
+       \brief Reads a file through parallel range requests.
+
+       Keeps up to <network><curlsegments> requests for consecutive ranges in
+       flight ahead of the read position, all on a multi handle of its own, and
+       hands out their data in order. Segments start at <network><curlsegmentsize>
+       and are resized after each one to take about two seconds at the throughput
+       measured, so a slow link gets fewer, smaller requests. Twice the connections
+       are buffered at most, in no more than <network><curlsegmentbuffer> together.
+       */
+      class CSegmentedState
+      {
+      public:
+        CSegmentedState(CCurlFile &file, int64_t fileSize, unsigned int connections, unsigned int segmentSize, unsigned int bufferSize);
+        ~CSegmentedState();
+
+        unsigned int Read(void* lpBuf, int64_t uiBufSize);
+        bool         ReadString(char *szLine, int iLineLength);
+        void         Seek(int64_t pos)   { m_filePos = pos; }
+        int64_t      GetPosition() const { return m_filePos; }
+        int64_t      GetLength() const   { return m_fileSize; }
+        bool         IsFailed() const    { return m_failed; }
+
+      private:
+        struct Segment
+        {
+          CReadState*  m_state;      // m_filePos is the read position, m_fileSize the end of the segment
+          int64_t      m_start;
+          int64_t      m_requested;  // where the running request started
+          int64_t      m_started;    // when the running request was sent
+          int          m_retries;
+          bool         m_verified;
+          bool         m_done;
+        };
+        typedef std::deque<Segment> Segments;
+
+        int64_t      GetReceived(const Segment &segment) const;
+        void         StartSegments();
+        void         Request(Segment &segment, int64_t from);
+        bool         Verify(Segment &segment);
+        bool         Complete(Segment &segment, int result);
+        void         Adapt(const Segment &segment);
+        void         Recycle(Segment &segment);
+        void         Restart(int64_t pos);
+        bool         Process(bool wait);
+
+        CCurlFile&               m_file;
+        CStdString               m_protocol;
+        CStdString               m_hostName;
+        XCURL::CURLM*            m_multiHandle;
+        Segments                 m_segments;
+        std::vector<CReadState*> m_idle;
+        int64_t                  m_filePos;
+        int64_t                  m_fileSize;
+        int64_t                  m_nextStart;
+        int64_t                  m_lastPerform;
+        unsigned int             m_connections;
+        unsigned int             m_segmentSize;
+        unsigned int             m_maxSegmentSize;
+        bool                     m_failed;
+      };
+
     protected:
       void ParseAndCorrectUrl(CURL &url);
       void SetCommonOptions(CReadState* state);
       void SetRequestHeaders(CReadState* state);
       void SetCorrectHeaders(CReadState* state);
       bool Service(const CStdString& strURL, CStdString& strHTML);
+      bool DoService(const CStdString& strURL, CStdString& strHTML);
+      CStdString GetRequestKey(const CStdString& strURL) const;
+      bool StopSegmented();
 
     protected:
       CReadState*     m_state;
       CReadState*     m_oldState;
+      CSegmentedState* m_segmented;
       unsigned int    m_bufferSize;
       int64_t         m_writeOffset;
 
@@ -124,6 +124,7 @@ bool CDAVFile::Delete(const CURL& url)
   }
 
   dav.Close();
+  ClearStatCache(url);
 
   return true;
 }
@@ -150,6 +151,8 @@ bool CDAVFile::Rename(const CURL& url, const CURL& urlnew)
   }
 
   dav.Close();
+  ClearStatCache(url);
+  ClearStatCache(urlnew);
 
   return true;
 }
@@ -26,6 +26,7 @@
 #include "utils/TimeUtils.h"
 
 #include <assert.h>
+#include <climits>
 
 using namespace XCURL;
 
@@ -83,38 +84,88 @@ void DllLibCurlGlobal::Unload()
 #endif
 }
 
-void DllLibCurlGlobal::CheckIdle()
+/* sessions idle for longer than this are closed */
+#define SESSION_IDLE_TIME      30000
+/* idle sessions kept around per host, each holding on to a connection */
+#define IDLE_SESSIONS_PER_HOST 4
+
+static CStdString GetSessionKey(const char *protocol, const char *hostname)
 {
-  /* avoid locking section here, to avoid stalling gfx thread on loads*/
-  if(g_curlReferences == 0)
-    return;
+  CStdString key = protocol;
+  key += "://";
+  key += hostname;
+  return key;
+}
 
-  CSingleLock lock(m_critSection);
-  /* 20 seconds idle time before closing handle */
-  const unsigned int idletime = 30000;
+void DllLibCurlGlobal::CloseSession(SSession &session)
+{
+  CLog::Log(LOGINFO, "%s - Closing session to %s://%s (easy=%p, multi=%p)\n", __FUNCTION__, session.m_protocol.c_str(), session.m_hostname.c_str(), (void*)session.m_easy, (void*)session.m_multi);
 
-  VEC_CURLSESSIONS::iterator it = m_sessions.begin();
-  while(it != m_sessions.end())
+  // It's important to clean up multi *before* cleaning up easy, because the multi cleanup
+  // code accesses stuff in the easy's structure.
+  if(session.m_multi)
+    multi_cleanup(session.m_multi);
+  if(session.m_easy)
   {
-    if( !it->m_busy && (XbmcThreads::SystemClockMillis() - it->m_idletimestamp) > idletime )
-    {
-      CLog::Log(LOGINFO, "%s - Closing session to %s://%s (easy=%p, multi=%p)\n", __FUNCTION__, it->m_protocol.c_str(), it->m_hostname.c_str(), (void*)it->m_easy, (void*)it->m_multi);
+    m_handles.erase(session.m_easy);
+    easy_cleanup(session.m_easy);
+  }
 
-      // It's important to clean up multi *before* cleaning up easy, because the multi cleanup
-      // code accesses stuff in the easy's structure.
-      if(it->m_multi)
-        multi_cleanup(it->m_multi);
-      if(it->m_easy)
-        easy_cleanup(it->m_easy);
+  Unload();
+}
 
-      Unload();
+void DllLibCurlGlobal::CloseIdle(VEC_CURLSESSIONS &sessions, unsigned int keep, unsigned int idletime)
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  unsigned int idle = 0;
 
-      it = m_sessions.erase(it);
+  VEC_CURLSESSIONS::iterator it = sessions.begin();
+  while(it != sessions.end())
+  {
+    if( !it->m_busy && now - it->m_idletimestamp > idletime )
+    {
+      CloseSession(*it);
+      it = sessions.erase(it);
       continue;
     }
+    if( !it->m_busy )
+      idle++;
     it++;
   }
 
+  /* beyond that, close the sessions that have been idle the longest */
+  while(idle > keep)
+  {
+    VEC_CURLSESSIONS::iterator oldest = sessions.end();
+    for(it = sessions.begin(); it != sessions.end(); it++)
+    {
+      if( !it->m_busy && (oldest == sessions.end() || now - it->m_idletimestamp > now - oldest->m_idletimestamp) )
+        oldest = it;
+    }
+    CloseSession(*oldest);
+    sessions.erase(oldest);
+    idle--;
+  }
+}
+
+void DllLibCurlGlobal::CheckIdle()
+{
+  /* avoid locking section here, to avoid stalling gfx thread on loads*/
+  if(g_curlReferences == 0)
+    return;
+
+  CSingleLock lock(m_critSection);
+
+  MAP_CURLSESSIONS::iterator it = m_sessions.begin();
+  while(it != m_sessions.end())
+  {
+    CloseIdle(it->second, UINT_MAX, SESSION_IDLE_TIME);
+    if(it->second.empty())
+      m_sessions.erase(it++);
+    else
+      it++;
+  }
+
   /* check if we should unload the dll */
 #if(0) // we never unload libcurl, since libssl can break when python unloads then
   if(g_curlReferences == 1 && XbmcThreads::SystemClockMillis() - g_curlTimeout > idletime)
@@ -128,35 +179,43 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
 
   CSingleLock lock(m_critSection);
 
-  VEC_CURLSESSIONS::iterator it;
-  for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+  /* allow reuse of requester is trying to connect to same host */
+  /* curl will take care of any differences in username/password */
+  CStdString key = GetSessionKey(protocol, hostname);
+  VEC_CURLSESSIONS &sessions = m_sessions[key];
+
+  /* the session released last is the most likely to still have its connection open */
+  VEC_CURLSESSIONS::iterator it, newest = sessions.end();
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  for(it = sessions.begin(); it != sessions.end(); it++)
   {
-    if( !it->m_busy )
+    if( !it->m_busy && (newest == sessions.end() || now - it->m_idletimestamp < now - newest->m_idletimestamp) )
+      newest = it;
+  }
+
+  if(newest != sessions.end())
+  {
+    newest->m_busy = true;
+    if(easy_handle)
     {
-      /* allow reuse of requester is trying to connect to same host */
-      /* curl will take care of any differences in username/password */
-      if( it->m_protocol.compare(protocol) == 0 && it->m_hostname.compare(hostname) == 0)
+      if(!newest->m_easy)
       {
-        it->m_busy = true;
-        if(easy_handle)
-        {
-          if(!it->m_easy)
-            it->m_easy = easy_init();
-
-          *easy_handle = it->m_easy;
-        }
+        newest->m_easy = easy_init();
+        m_handles[newest->m_easy] = key;
+      }
 
-        if(multi_handle)
-        {
-          if(!it->m_multi)
-            it->m_multi = multi_init();
+      *easy_handle = newest->m_easy;
+    }
 
-          *multi_handle = it->m_multi;
-        }
+    if(multi_handle)
+    {
+      if(!newest->m_multi)
+        newest->m_multi = multi_init();
 
-        return;
-      }
+      *multi_handle = newest->m_multi;
     }
+
+    return;
   }
 
   SSession session = {};
@@ -171,6 +230,7 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
   {
     session.m_easy = easy_init();
     *easy_handle = session.m_easy;
+    m_handles[session.m_easy] = key;
   }
 
   if(multi_handle)
@@ -179,7 +239,7 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
     *multi_handle = session.m_multi;
   }
 
-  m_sessions.push_back(session);
+  sessions.push_back(session);
 
 
   CLog::Log(LOGINFO, "%s - Created session to %s://%s\n", __FUNCTION__, protocol, hostname);
@@ -207,8 +267,13 @@ void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_han
     *multi_handle = NULL;
   }
 
+  MAP_CURLHANDLES::iterator handle = m_handles.find(easy);
+  if(handle == m_handles.end())
+    return;
+
+  VEC_CURLSESSIONS &sessions = m_sessions[handle->second];
   VEC_CURLSESSIONS::iterator it;
-  for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+  for(it = sessions.begin(); it != sessions.end(); it++)
   {
     if( it->m_easy == easy && (multi == NULL || it->m_multi == multi) )
     {
@@ -217,6 +282,8 @@ void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_han
       easy_reset(easy);
       it->m_busy = false;
       it->m_idletimestamp = XbmcThreads::SystemClockMillis();
+
+      CloseIdle(sessions, IDLE_SESSIONS_PER_HOST, SESSION_IDLE_TIME);
       return;
     }
   }
@@ -226,16 +293,23 @@ CURL_HANDLE* DllLibCurlGlobal::easy_duphandle(CURL_HANDLE* easy_handle)
 {
   CSingleLock lock(m_critSection);
 
-  VEC_CURLSESSIONS::iterator it;
-  for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+  MAP_CURLHANDLES::iterator handle = m_handles.find(easy_handle);
+  if(handle != m_handles.end())
   {
-    if( it->m_easy == easy_handle )
+    CStdString key = handle->second;
+    VEC_CURLSESSIONS &sessions = m_sessions[key];
+    VEC_CURLSESSIONS::iterator it;
+    for(it = sessions.begin(); it != sessions.end(); it++)
     {
-      SSession session = *it;
-      session.m_easy = DllLibCurl::easy_duphandle(easy_handle);
-      Load();
-      m_sessions.push_back(session);
-      return session.m_easy;
+      if( it->m_easy == easy_handle )
+      {
+        SSession session = *it;
+        session.m_easy = DllLibCurl::easy_duphandle(easy_handle);
+        Load();
+        sessions.push_back(session);
+        m_handles[session.m_easy] = key;
+        return session.m_easy;
+      }
     }
   }
   return DllLibCurl::easy_duphandle(easy_handle);
@@ -251,14 +325,23 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HAND
   if(multi_out && multi)
     *multi_out = DllLibCurl::multi_init();
 
+  MAP_CURLHANDLES::iterator handle = m_handles.find(easy);
+  if(handle == m_handles.end())
+    return;
+
+  CStdString key = handle->second;
+  VEC_CURLSESSIONS &sessions = m_sessions[key];
   VEC_CURLSESSIONS::iterator it;
-  for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+  for(it = sessions.begin(); it != sessions.end(); it++)
   {
     if( it->m_easy == easy )
     {
       SSession session = *it;
       if(easy_out && easy)
+      {
         session.m_easy = *easy_out;
+        m_handles[session.m_easy] = key;
+      }
       else
         session.m_easy = NULL;
 
@@ -268,7 +351,7 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HAND
         session.m_multi = NULL;
 
       Load();
-      m_sessions.push_back(session);
+      sessions.push_back(session);
       return;
     }
   }
@@ -22,6 +22,9 @@
 #include "DynamicDll.h"
 #include "threads/CriticalSection.h"
 
+#include <map>
+#include <vector>
+
 /* put types of curl in namespace to avoid namespace pollution */
 namespace XCURL
 {
@@ -132,8 +135,17 @@ namespace XCURL
 
     typedef std::vector<SSession> VEC_CURLSESSIONS;
 
-    VEC_CURLSESSIONS m_sessions;
+    /* sessions per protocol://hostname, and the host each easy handle belongs to */
+    typedef std::map<CStdString, VEC_CURLSESSIONS> MAP_CURLSESSIONS;
+    typedef std::map<CURL_HANDLE*, CStdString> MAP_CURLHANDLES;
+
+    MAP_CURLSESSIONS m_sessions;
+    MAP_CURLHANDLES  m_handles;
     CCriticalSection m_critSection;
+
+  private:
+    void CloseSession(SSession &session);
+    void CloseIdle(VEC_CURLSESSIONS &sessions, unsigned int keep, unsigned int idletime);
   };
 }
 
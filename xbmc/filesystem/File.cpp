@@ -28,6 +28,7 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/BitstreamStats.h"
+#include "FileStatistics.h"
 #include "Util.h"
 #include "URL.h"
 
@@ -50,6 +51,7 @@ CFile::CFile()
   m_pBuffer = NULL;
   m_flags = 0;
   m_bitStreamStats = NULL;
+  m_statistics = NULL;
 }
 
 //*********************************************************************************************
@@ -61,6 +63,7 @@ CFile::~CFile()
     SAFE_DELETE(m_pBuffer);
   if (m_bitStreamStats)
     SAFE_DELETE(m_bitStreamStats);
+  SAFE_DELETE(m_statistics);
 }
 
 //*********************************************************************************************
@@ -210,6 +213,26 @@ bool CFile::Cache(const CStdString& strFileName, const CStdString& strDest, XFIL
 
 //*********************************************************************************************
 bool CFile::Open(const CStdString& strFileName, unsigned int flags)
+{
+  SAFE_DELETE(m_statistics);
+  if (!CFileStatistics::IsEnabled())
+    return DoOpen(strFileName, flags);
+
+  int64_t start = CFileStatistics::Now();
+  bool opened = DoOpen(strFileName, flags);
+
+  // cached and special:// files read through a file of their own, which is counted instead
+  CURL url(URIUtils::SubstitutePath(strFileName));
+  if ((m_flags & READ_CACHED) || !CFileStatistics::IsEnabled(url))
+    return opened;
+
+  CFileStatistics::Get().Record(url, CFileStatistics::OP_OPEN, CFileStatistics::GetElapsed(start), opened);
+  if (opened)
+    m_statistics = new CFileCounters(CFileStatistics::Get(), url);
+  return opened;
+}
+
+bool CFile::DoOpen(const CStdString& strFileName, unsigned int flags)
 {
   m_flags = flags;
   try
@@ -344,10 +367,14 @@ bool CFile::Exists(const CStdString& strFileName, bool bUseCache /* = true */)
     if (strFileName.IsEmpty())
       return false;
 
+    bool statistics = CFileStatistics::IsEnabled(url);
     if (bUseCache)
     {
       bool bPathInCache;
-      if (g_directoryCache.FileExists(url.Get(), bPathInCache) )
+      bool exists = g_directoryCache.FileExists(url.Get(), bPathInCache);
+      if (statistics)
+        CFileStatistics::Get().RecordCacheLookup(url, exists || bPathInCache);
+      if (exists)
         return true;
       if (bPathInCache)
         return false;
@@ -357,7 +384,11 @@ bool CFile::Exists(const CStdString& strFileName, bool bUseCache /* = true */)
     if (!pFile.get())
       return false;
 
-    return pFile->Exists(url);
+    int64_t start = CFileStatistics::Now();
+    bool exists = pFile->Exists(url);
+    if (statistics)
+      CFileStatistics::Get().Record(url, CFileStatistics::OP_STAT, CFileStatistics::GetElapsed(start), true);
+    return exists;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -418,7 +449,12 @@ int CFile::Stat(const CStdString& strFileName, struct __stat64* buffer)
     auto_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
     if (!pFile.get())
       return -1;
-    return pFile->Stat(url, buffer);
+
+    int64_t start = CFileStatistics::Now();
+    int result = pFile->Stat(url, buffer);
+    if (CFileStatistics::IsEnabled(url))
+      CFileStatistics::Get().Record(url, CFileStatistics::OP_STAT, CFileStatistics::GetElapsed(start), result == 0);
+    return result;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -461,23 +497,32 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
   if (!m_pFile)
     return 0;
 
+  int64_t start = m_statistics ? CFileStatistics::Now() : 0;
+  bool failed = false;
+  unsigned int nBytes = DoRead(lpBuf, uiBufSize, failed);
+  if (m_bitStreamStats && nBytes>0)
+    m_bitStreamStats->AddSampleBytes(nBytes);
+  // reads at the end of the file aren't counted, they would only water down the latencies
+  if (m_statistics && failed)
+    m_statistics->Record(CFileStatistics::OP_READ, start, false);
+  else if (m_statistics && nBytes > 0)
+    m_statistics->Record(CFileStatistics::OP_READ, start, true, nBytes);
+  return nBytes;
+}
+
+unsigned int CFile::DoRead(void *lpBuf, int64_t uiBufSize, bool &failed)
+{
   if(m_pBuffer)
   {
     if(m_flags & READ_TRUNCATED)
     {
-      unsigned int nBytes = m_pBuffer->sgetn(
+      return m_pBuffer->sgetn(
         (char *)lpBuf, min<streamsize>((streamsize)uiBufSize,
                                                   m_pBuffer->in_avail()));
-      if (m_bitStreamStats && nBytes>0)
-        m_bitStreamStats->AddSampleBytes(nBytes);
-      return nBytes;
     }
     else
     {
-      unsigned int nBytes = m_pBuffer->sgetn((char*)lpBuf, uiBufSize);
-      if (m_bitStreamStats && nBytes>0)
-        m_bitStreamStats->AddSampleBytes(nBytes);
-      return nBytes;
+      return m_pBuffer->sgetn((char*)lpBuf, uiBufSize);
     }
   }
 
@@ -485,10 +530,9 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
   {
     if(m_flags & READ_TRUNCATED)
     {
-      unsigned int nBytes = m_pFile->Read(lpBuf, uiBufSize);
-      if (m_bitStreamStats && nBytes>0)
-        m_bitStreamStats->AddSampleBytes(nBytes);
-      return nBytes;
+      unsigned int done = m_pFile->Read(lpBuf, uiBufSize);
+      failed = (int)done < 0;
+      return done;
     }
     else
     {
@@ -497,12 +541,14 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
       {
         int curr = m_pFile->Read((char*)lpBuf+done, uiBufSize-done);
         if(curr<=0)
+        {
+          // a short read is returned as is, the error shows on the next one
+          failed = curr < 0 && done == 0;
           break;
+        }
 
         done+=curr;
       }
-      if (m_bitStreamStats && done > 0)
-        m_bitStreamStats->AddSampleBytes(done);
       return done;
     }
   }
@@ -511,6 +557,7 @@ unsigned int CFile::Read(void *lpBuf, int64_t uiBufSize)
   {
     CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
   }
+  failed = true;
   return 0;
 }
 
@@ -524,6 +571,7 @@ void CFile::Close()
 
     SAFE_DELETE(m_pBuffer);
     SAFE_DELETE(m_pFile);
+    SAFE_DELETE(m_statistics);
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch(...)
@@ -554,6 +602,15 @@ int64_t CFile::Seek(int64_t iFilePosition, int iWhence)
   if (!m_pFile)
     return -1;
 
+  int64_t start = m_statistics ? CFileStatistics::Now() : 0;
+  int64_t position = DoSeek(iFilePosition, iWhence);
+  if (m_statistics)
+    m_statistics->Record(CFileStatistics::OP_SEEK, start, position >= 0);
+  return position;
+}
+
+int64_t CFile::DoSeek(int64_t iFilePosition, int iWhence)
+{
   if (m_pBuffer)
   {
     if(iWhence == SEEK_CUR)
@@ -41,6 +41,7 @@ namespace XFILE
 {
 
 class IFile;
+class CFileCounters;
 
 class IFileCallback
 {
@@ -114,10 +115,15 @@ public:
   static bool SetHidden(const CStdString& fileName, bool hidden);
 
 private:
+  bool DoOpen(const CStdString& strFileName, unsigned int flags);
+  unsigned int DoRead(void* lpBuf, int64_t uiBufSize, bool &failed);
+  int64_t DoSeek(int64_t iFilePosition, int iWhence);
+
   unsigned int m_flags;
   IFile* m_pFile;
   CFileStreamBuffer* m_pBuffer;
   BitstreamStats* m_bitStreamStats;
+  CFileCounters* m_statistics;
 };
 
 // streambuf for file io, only supports buffered input currently
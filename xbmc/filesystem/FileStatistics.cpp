@@ -0,0 +1,288 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileStatistics.h"
+#include "PlatformDefs.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using namespace XFILE;
+
+static const char *OperationNames[] = { "open", "stat", "read", "seek" };
+
+static const uint64_t LatencyBounds[] = { 100, 1000, 10000, 100000, 1000000 };
+
+CFileStatistics::Counters::Counters()
+{
+  memset(calls, 0, sizeof(calls));
+  memset(failures, 0, sizeof(failures));
+  memset(time, 0, sizeof(time));
+  memset(latency, 0, sizeof(latency));
+  bytesRead = 0;
+  cacheHits = 0;
+  cacheMisses = 0;
+}
+
+void CFileStatistics::Counters::Add(Operation op, uint64_t duration, bool success, uint64_t bytes)
+{
+  calls[op]++;
+  if (!success)
+    failures[op]++;
+  time[op] += duration;
+
+  int bucket = 0;
+  while (bucket < LATENCY_BUCKETS - 1 && duration >= LatencyBounds[bucket])
+    bucket++;
+  latency[op][bucket]++;
+
+  bytesRead += bytes;
+}
+
+void CFileStatistics::Counters::Add(const Counters &counters)
+{
+  for (int op = 0; op < OP_COUNT; op++)
+  {
+    calls[op] += counters.calls[op];
+    failures[op] += counters.failures[op];
+    time[op] += counters.time[op];
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+      latency[op][bucket] += counters.latency[op][bucket];
+  }
+  bytesRead += counters.bytesRead;
+  cacheHits += counters.cacheHits;
+  cacheMisses += counters.cacheMisses;
+}
+
+CFileCounters::CFileCounters(CFileStatistics &statistics, const CURL &url)
+  : m_statistics(statistics)
+{
+  m_key = CFileStatistics::GetKey(url);
+  m_path = url.GetWithoutUserDetails();
+  m_lastMerge = CFileStatistics::Now();
+}
+
+CFileCounters::~CFileCounters()
+{
+  m_statistics.Add(m_key, m_counters);
+}
+
+void CFileCounters::Record(CFileStatistics::Operation op, int64_t start, bool success, uint64_t bytes)
+{
+  int64_t now = CFileStatistics::Now();
+  uint64_t duration = (now - start) * 1000000 / CurrentHostFrequency();
+  m_counters.Add(op, duration, success, bytes);
+  m_statistics.Trace(m_key, m_path, op, duration, success, bytes);
+
+  // keep the totals of long running playback up to date
+  if (now - m_lastMerge > CurrentHostFrequency())
+  {
+    m_statistics.Add(m_key, m_counters);
+    m_counters = CFileStatistics::Counters();
+    m_lastMerge = now;
+  }
+}
+
+CFileStatistics::CFileStatistics()
+{
+  m_trace = NULL;
+  m_traceOpened = false;
+  m_traceStart = Now();
+}
+
+CFileStatistics::~CFileStatistics()
+{
+  if (m_trace)
+    fclose(m_trace);
+}
+
+CFileStatistics &CFileStatistics::Get()
+{
+  static CFileStatistics statistics;
+  return statistics;
+}
+
+bool CFileStatistics::IsEnabled()
+{
+  return g_advancedSettings.m_vfsStatistics;
+}
+
+bool CFileStatistics::IsEnabled(const CURL &url)
+{
+  return IsEnabled() && url.GetProtocol() != "special";
+}
+
+int64_t CFileStatistics::Now()
+{
+  return CurrentHostCounter();
+}
+
+uint64_t CFileStatistics::GetElapsed(int64_t start)
+{
+  return (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency();
+}
+
+CStdString CFileStatistics::GetKey(const CURL &url)
+{
+  CStdString protocol = url.GetProtocol();
+  if (protocol.IsEmpty())
+    protocol = "file";
+  return protocol + "://" + url.GetHostName();
+}
+
+void CFileStatistics::Record(const CURL &url, Operation op, uint64_t duration, bool success, uint64_t bytes)
+{
+  CStdString key = GetKey(url);
+  {
+    CSingleLock lock(m_critSection);
+    m_counters[key].Add(op, duration, success, bytes);
+  }
+  Trace(key, url.GetWithoutUserDetails(), op, duration, success, bytes);
+}
+
+void CFileStatistics::RecordCacheLookup(const CURL &url, bool hit)
+{
+  CSingleLock lock(m_critSection);
+  Counters &counters = m_counters[GetKey(url)];
+  if (hit)
+    counters.cacheHits++;
+  else
+    counters.cacheMisses++;
+}
+
+void CFileStatistics::Add(const CStdString &key, const Counters &counters)
+{
+  CSingleLock lock(m_critSection);
+  m_counters[key].Add(counters);
+}
+
+bool CFileStatistics::GetCounters(const CStdString &key, Counters &counters) const
+{
+  CSingleLock lock(m_critSection);
+  CountersMap::const_iterator it = m_counters.find(key);
+  if (it == m_counters.end())
+    return false;
+  counters = it->second;
+  return true;
+}
+
+void CFileStatistics::GetStatistics(CVariant &result, bool reset)
+{
+  result = CVariant(CVariant::VariantTypeArray);
+
+  CSingleLock lock(m_critSection);
+  for (CountersMap::const_iterator it = m_counters.begin(); it != m_counters.end(); ++it)
+  {
+    const Counters &counters = it->second;
+    CVariant entry(CVariant::VariantTypeObject);
+    size_t separator = it->first.find("://");
+    entry["protocol"] = it->first.substr(0, separator);
+    entry["host"] = it->first.substr(separator + 3);
+    entry["bytesread"] = counters.bytesRead;
+    entry["cachehits"] = counters.cacheHits;
+    entry["cachemisses"] = counters.cacheMisses;
+    for (int op = 0; op < OP_COUNT; op++)
+    {
+      CVariant operation(CVariant::VariantTypeObject);
+      operation["calls"] = counters.calls[op];
+      operation["failures"] = counters.failures[op];
+      operation["time"] = counters.time[op] / 1000;
+      operation["latency"] = CVariant(CVariant::VariantTypeArray);
+      for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+        operation["latency"].push_back(counters.latency[op][bucket]);
+      entry["operations"][OperationNames[op]] = operation;
+    }
+    result.push_back(entry);
+  }
+
+  if (reset)
+    m_counters.clear();
+}
+
+static bool SortByTime(const pair<uint64_t, CStdString> &left, const pair<uint64_t, CStdString> &right)
+{
+  return left.first > right.first;
+}
+
+CStdString CFileStatistics::GetSummary(unsigned int count) const
+{
+  CSingleLock lock(m_critSection);
+  vector< pair<uint64_t, CStdString> > keys;
+  for (CountersMap::const_iterator it = m_counters.begin(); it != m_counters.end(); ++it)
+  {
+    uint64_t time = 0;
+    for (int op = 0; op < OP_COUNT; op++)
+      time += it->second.time[op];
+    keys.push_back(make_pair(time, it->first));
+  }
+  sort(keys.begin(), keys.end(), SortByTime);
+
+  CStdString summary;
+  for (unsigned int i = 0; i < keys.size() && i < count; i++)
+  {
+    const Counters &counters = m_counters.find(keys[i].second)->second;
+    if (!summary.IsEmpty())
+      summary += "\n";
+    summary.AppendFormat("VFS: %s - %.1f s - %"PRIu64" opens, %"PRIu64" stats, %"PRIu64" reads (%.1f MB), %"PRIu64" seeks",
+                         keys[i].second.c_str(), keys[i].first / 1000000.0,
+                         counters.calls[OP_OPEN], counters.calls[OP_STAT], counters.calls[OP_READ],
+                         counters.bytesRead / 1048576.0, counters.calls[OP_SEEK]);
+  }
+  return summary;
+}
+
+void CFileStatistics::Reset()
+{
+  CSingleLock lock(m_critSection);
+  m_counters.clear();
+}
+
+void CFileStatistics::Trace(const CStdString &key, const CStdString &path, Operation op, uint64_t duration, bool success, uint64_t bytes)
+{
+  if (g_advancedSettings.m_vfsTraceFile.IsEmpty())
+    return;
+
+  CSingleLock lock(m_traceSection);
+  if (!m_traceOpened)
+  { // opened directly, going through CFile would trace the trace
+    m_traceOpened = true;
+    CStdString traceFile = CSpecialProtocol::TranslatePath(g_advancedSettings.m_vfsTraceFile);
+    m_trace = fopen(traceFile.c_str(), "w");
+    if (m_trace)
+      fprintf(m_trace, "# seconds operation source microseconds result bytes path\n");
+    else
+      CLog::Log(LOGERROR, "%s - unable to open trace file %s", __FUNCTION__, traceFile.c_str());
+  }
+  if (!m_trace)
+    return;
+
+  fprintf(m_trace, "%.6f %s %s %"PRIu64" %s %"PRIu64" %s\n",
+          (double)(Now() - m_traceStart) / CurrentHostFrequency(), OperationNames[op], key.c_str(),
+          duration, success ? "ok" : "failed", bytes, path.c_str());
+}
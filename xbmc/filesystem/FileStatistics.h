@@ -0,0 +1,160 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+
+class CURL;
+class CVariant;
+
+namespace XFILE
+{
+  /*!
+   \brief Counts the I/O done through CFile, per protocol and host.
+
+   Opens, stats, reads and seeks are counted with their time and a latency
+   histogram, along with the bytes read and how often the directory cache
+   answered an exists check. Reads that return no data at the end of a file
+   aren't counted, reads that fail count as failures. An open file counts into counters of its own
+   without any locking and merges them into the totals at most once a second
+   and when it is closed. Every operation can also be written to the trace
+   file set in advancedsettings.xml (<vfsstatistics><tracefile>) for offline
+   analysis.
+   */
+  class CFileStatistics
+  {
+  public:
+    enum Operation
+    {
+      OP_OPEN = 0,
+      OP_STAT,
+      OP_READ,
+      OP_SEEK,
+      OP_COUNT
+    };
+
+    /*! \brief Latency buckets, bounded by 0.1ms, 1ms, 10ms, 100ms and 1s */
+    enum { LATENCY_BUCKETS = 6 };
+
+    struct Counters
+    {
+      Counters();
+      void Add(Operation op, uint64_t duration, bool success, uint64_t bytes);
+      void Add(const Counters &counters);
+
+      uint64_t calls[OP_COUNT];
+      uint64_t failures[OP_COUNT];
+      uint64_t time[OP_COUNT]; // microseconds
+      uint64_t latency[OP_COUNT][LATENCY_BUCKETS];
+      uint64_t bytesRead;
+      uint64_t cacheHits;
+      uint64_t cacheMisses;
+    };
+
+    CFileStatistics();
+    ~CFileStatistics();
+
+    /*! \brief The statistics of all files */
+    static CFileStatistics &Get();
+
+    /*! \brief Whether CFile records its operations, see <vfsstatistics><enabled> */
+    static bool IsEnabled();
+
+    /*! \brief Whether CFile records the operations on a url.
+     special:// paths are counted as the file they resolve to instead.
+     */
+    static bool IsEnabled(const CURL &url);
+
+    /*! \brief The current time, to pass as the start of an operation */
+    static int64_t Now();
+
+    /*! \brief Microseconds passed since start */
+    static uint64_t GetElapsed(int64_t start);
+
+    /*! \brief The protocol and host a url is counted under */
+    static CStdString GetKey(const CURL &url);
+
+    /*! \brief Record a single operation
+     \param url the file operated on.
+     \param op the operation.
+     \param duration the time it took in microseconds.
+     \param success whether it succeeded.
+     \param bytes the bytes read.
+     */
+    void Record(const CURL &url, Operation op, uint64_t duration, bool success, uint64_t bytes = 0);
+
+    /*! \brief Record whether the directory cache could answer an exists check */
+    void RecordCacheLookup(const CURL &url, bool hit);
+
+    /*! \brief Add counters to the totals of a protocol and host */
+    void Add(const CStdString &key, const Counters &counters);
+
+    /*! \brief Get the totals of a protocol and host
+     \return false if nothing was recorded for it.
+     */
+    bool GetCounters(const CStdString &key, Counters &counters) const;
+
+    /*! \brief Get the totals of every protocol and host
+     \param result [out] array with an object per protocol and host.
+     \param reset whether to clear the totals after getting them.
+     */
+    void GetStatistics(CVariant &result, bool reset = false);
+
+    /*! \brief One line for each of the protocols and hosts that took the most time */
+    CStdString GetSummary(unsigned int count) const;
+
+    void Reset();
+
+  private:
+    friend class CFileCounters;
+    void Trace(const CStdString &key, const CStdString &path, Operation op, uint64_t duration, bool success, uint64_t bytes);
+
+    typedef std::map<CStdString, Counters> CountersMap;
+    CountersMap m_counters;
+    mutable CCriticalSection m_critSection;
+
+    FILE *m_trace;
+    bool m_traceOpened;
+    int64_t m_traceStart;
+    CCriticalSection m_traceSection;
+  };
+
+  /*! \brief Counters of an open file, see CFileStatistics */
+  class CFileCounters
+  {
+  public:
+    CFileCounters(CFileStatistics &statistics, const CURL &url);
+    ~CFileCounters();
+
+    void Record(CFileStatistics::Operation op, int64_t start, bool success, uint64_t bytes = 0);
+
+  private:
+    CFileStatistics &m_statistics;
+    CStdString m_key;
+    CStdString m_path;
+    CFileStatistics::Counters m_counters;
+    int64_t m_lastMerge;
+  };
+}
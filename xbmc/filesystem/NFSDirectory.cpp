@@ -109,6 +109,7 @@ bool CNFSDirectory::GetServerList(CFileItemList &items)
 bool CNFSDirectory::ResolveSymlink( const CStdString &dirName, struct nfsdirent *dirent, CURL &resolvedUrl)
 {
   CSingleLock lock(gNfsConnection); 
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
   int ret = 0;  
   bool retVal = true;
   CStdString fullpath = dirName;
@@ -215,6 +216,7 @@ bool CNFSDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items
   struct nfsdir *nfsdir = NULL;
   struct nfsdirent *nfsdirent = NULL;
 
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
   ret = gNfsConnection.GetImpl()->nfs_opendir(gNfsConnection.GetNfsContext(), strDirName.c_str(), &nfsdir);
 
   if(ret != 0)
@@ -222,6 +224,7 @@ bool CNFSDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items
     CLog::Log(LOGERROR, "Failed to open(%s) %s\n", strDirName.c_str(), gNfsConnection.GetImpl()->nfs_get_error(gNfsConnection.GetNfsContext()));
     return false;
   }
+  contextLock.Leave();
   lock.Leave();
   
   while((nfsdirent = gNfsConnection.GetImpl()->nfs_readdir(gNfsConnection.GetNfsContext(), nfsdir)) != NULL) 
@@ -305,6 +308,7 @@ bool CNFSDirectory::Create(const char* strPath)
   if(!gNfsConnection.Connect(url,folderName))
     return false;
   
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
   ret = gNfsConnection.GetImpl()->nfs_mkdir(gNfsConnection.GetNfsContext(), folderName.c_str());
 
   success = (ret == 0 || -EEXIST == ret);
@@ -326,6 +330,7 @@ bool CNFSDirectory::Remove(const char* strPath)
   if(!gNfsConnection.Connect(url,folderName))
     return false;
   
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
   ret = gNfsConnection.GetImpl()->nfs_rmdir(gNfsConnection.GetNfsContext(), folderName.c_str());
 
   if(ret != 0 && errno != ENOENT)
@@ -349,6 +354,7 @@ bool CNFSDirectory::Exists(const char* strPath)
   if(!gNfsConnection.Connect(url,folderName))
     return false;
   
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
   struct stat info;
   ret = gNfsConnection.GetImpl()->nfs_stat(gNfsConnection.GetNfsContext(), folderName.c_str(), &info);
   
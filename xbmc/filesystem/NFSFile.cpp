@@ -31,12 +31,19 @@
 #include "utils/URIUtils.h"
 #include "network/DNSNameCache.h"
 #include "threads/SystemClock.h"
+#include "settings/AdvancedSettings.h"
 
 #include <nfsc/libnfs-raw-mount.h>
 
+#include <algorithm>
+#include <vector>
+
 #ifdef TARGET_WINDOWS
 #include <fcntl.h>
 #include <sys\stat.h>
+#define poll WSAPoll
+#else
+#include <poll.h>
 #endif
 
 //KEEP_ALIVE_TIMEOUT is decremented every half a second
@@ -53,6 +60,11 @@
 #define CONTEXT_NEW      1    //new context created
 #define CONTEXT_CACHED   2    //context cached and therefore already mounted (no new mount needed)
 
+//give up on a read request when the server hasn't answered for 30s
+#define NFS_READ_TIMEOUT 30000
+//smallest read request sent to the server
+#define NFS_MIN_READ_SIZE 65536
+
 using namespace XFILE;
 
 CNfsConnection::CNfsConnection()
@@ -127,6 +139,7 @@ void CNfsConnection::clearMembers()
     m_writeChunkSize = 0;
     m_readChunkSize = 0;  
     m_pNfsContext = NULL;
+    m_pContextLock.reset();
     m_KeepAliveTimeouts.clear();
 }
 
@@ -140,7 +153,7 @@ void CNfsConnection::destroyOpenContexts()
   m_openContextMap.clear();
 }
 
-struct nfs_context *CNfsConnection::getContextFromMap(const CStdString &exportname, bool forceCacheHit/* = false*/)
+struct nfs_context *CNfsConnection::getContextFromMap(const CStdString &exportname, bool forceCacheHit/* = false*/, ContextLockPtr *pLock/* = NULL*/)
 {
   struct nfs_context *pRet = NULL;
   CSingleLock lock(openContextLock);
@@ -159,12 +172,15 @@ struct nfs_context *CNfsConnection::getContextFromMap(const CStdString &exportna
         CLog::Log(LOGDEBUG, "NFS: Refreshing context for %s, old: %"PRId64", new: %"PRId64, exportname.c_str(), it->second.lastAccessedTime, now);
       it->second.lastAccessedTime = now;
       pRet = it->second.pContext;
+      if (pLock)
+        *pLock = it->second.pLock;
     }
     else 
     {
       //context is timed out
       //destroy it and return NULL
       CLog::Log(LOGDEBUG, "NFS: Old context timed out - destroying it");
+      CSingleLock contextLock(*it->second.pLock);
       m_pLibNfs->nfs_destroy_context(it->second.pContext);
     }
   }
@@ -179,7 +195,7 @@ int CNfsConnection::getContextForExport(const CStdString &exportname)
   {
     clearMembers();  
     
-    m_pNfsContext = getContextFromMap(exportname);
+    m_pNfsContext = getContextFromMap(exportname, false, &m_pContextLock);
 
     if(!m_pNfsContext)
     {
@@ -195,6 +211,8 @@ int CNfsConnection::getContextForExport(const CStdString &exportname)
         struct contextTimeout tmp;
         CSingleLock lock(openContextLock);        
         tmp.pContext = m_pNfsContext;
+        tmp.pLock.reset(new CCriticalSection);
+        m_pContextLock = tmp.pLock;
         tmp.lastAccessedTime = XbmcThreads::SystemClockMillis();
         m_openContextMap[exportname] = tmp; //add context to list of all contexts      
         ret = CONTEXT_NEW;
@@ -388,13 +406,20 @@ void CNfsConnection::keepAlive(std::string _exportPath, struct nfsfh  *_pFileHan
   // true forces a cachehit regardless the context is timedout
   // on this call we are sure its not timedout even if the last accessed
   // time suggests it.
-  struct nfs_context *pContext = getContextFromMap(_exportPath, true);
+  ContextLockPtr pContextLock;
+  struct nfs_context *pContext = getContextFromMap(_exportPath, true, &pContextLock);
   
   if (!pContext)// this should normally never happen - paranoia
+  {
     pContext = m_pNfsContext;
+    pContextLock = m_pContextLock;
+  }
+  if (!pContextLock)
+    return;
   
   CLog::Log(LOGNOTICE, "NFS: sending keep alive after %i s.",KEEP_ALIVE_TIMEOUT/2);
   CSingleLock lock(*this);
+  CSingleLock contextLock(*pContextLock);
   m_pLibNfs->nfs_lseek(pContext, _pFileHandle, 0, SEEK_CUR, &offset);
   m_pLibNfs->nfs_read(pContext, _pFileHandle, 32, buffer);
   m_pLibNfs->nfs_lseek(pContext, _pFileHandle, offset, SEEK_SET, &offset);
@@ -460,10 +485,35 @@ void CNfsConnection::AddIdleConnection()
 
 CNfsConnection gNfsConnection;
 
+//an asynchronous read of a chunk of the file, owned by the file
+//until it is orphaned, after that by the callback
+struct CNFSFile::ReadRequest
+{
+  ReadRequest(uint64_t _offset, uint64_t _size)
+  : offset(_offset), size(_size), consumed(0), result(0), done(false), abandoned(false), orphaned(false) {}
+
+  uint64_t offset;
+  uint64_t size;
+  std::vector<char> data;
+  size_t consumed;
+  int result;//bytes read or negative error
+  bool done;
+  bool abandoned;//the data isn't wanted anymore
+  bool orphaned;//the file is closed, the callback frees the request
+};
+
 CNFSFile::CNFSFile()
 : m_fileSize(0)
+, m_position(0)
 , m_pFileHandle(NULL)
 , m_pNfsContext(NULL)
+, m_readAheadOffset(0)
+, m_readChunkSize(0)
+, m_readAhead(0)
+, m_bytesRead(0)
+, m_readTime(0)
+, m_readRequestsIssued(0)
+, m_maxReadsInFlight(0)
 {
   gNfsConnection.AddActiveConnection();
 }
@@ -476,19 +526,8 @@ CNFSFile::~CNFSFile()
 
 int64_t CNFSFile::GetPosition()
 {
-  int ret = 0;
-  uint64_t offset = 0;
-  CSingleLock lock(gNfsConnection);
-  
-  if (gNfsConnection.GetNfsContext() == NULL || m_pFileHandle == NULL) return 0;
-  
-  ret = (int)gNfsConnection.GetImpl()->nfs_lseek(gNfsConnection.GetNfsContext(), m_pFileHandle, 0, SEEK_CUR, &offset);
-  
-  if (ret < 0) 
-  {
-    CLog::Log(LOGERROR, "NFS: Failed to lseek(%s)",gNfsConnection.GetImpl()->nfs_get_error(gNfsConnection.GetNfsContext()));
-  }
-  return offset;
+  if (m_pFileHandle == NULL) return 0;
+  return m_position;
 }
 
 int64_t CNFSFile::GetLength()
@@ -517,20 +556,27 @@ bool CNFSFile::Open(const CURL& url)
     return false;
   
   m_pNfsContext = gNfsConnection.GetNfsContext(); 
+  m_pContextLock = gNfsConnection.GetContextLock();
   m_exportPath = gNfsConnection.GetContextMapId();
+  m_readChunkSize = gNfsConnection.GetMaxReadChunkSize();
+  if (m_readChunkSize == 0)
+    m_readChunkSize = 32768;
   
+  CSingleLock contextLock(*m_pContextLock);
   ret = gNfsConnection.GetImpl()->nfs_open(m_pNfsContext, filename.c_str(), O_RDONLY, &m_pFileHandle);
   
   if (ret != 0) 
   {
     CLog::Log(LOGINFO, "CNFSFile::Open: Unable to open file : '%s'  error : '%s'", url.GetFileName().c_str(), gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
     m_pNfsContext = NULL;
+    m_pContextLock.reset();
     m_exportPath.clear();
     return false;
   } 
   
   CLog::Log(LOGDEBUG,"CNFSFile::Open - opened %s",url.GetFileName().c_str());
   m_url=url;
+  m_position = 0;
   
   struct __stat64 tmpBuffer;
 
@@ -567,6 +613,7 @@ int CNFSFile::Stat(const CURL& url, struct __stat64* buffer)
   if(!gNfsConnection.Connect(url,filename))
     return -1;
    
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
 
   struct stat tmpBuffer = {0};
 
@@ -601,24 +648,235 @@ int CNFSFile::Stat(const CURL& url, struct __stat64* buffer)
 
 unsigned int CNFSFile::Read(void *lpBuf, int64_t uiBufSize)
 {
-  int numberOfBytesRead = 0;
-  CSingleLock lock(gNfsConnection);
+  int64_t numberOfBytesRead = 0;
   
   if (m_pFileHandle == NULL || m_pNfsContext == NULL ) return 0;
 
-  numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  CSingleLock lock(*m_pContextLock);
+
+  //the file may have grown since it was opened, read past the known size directly
+  if (g_advancedSettings.m_nfsReadRequests > 0 && m_position < m_fileSize)
+    numberOfBytesRead = ReadPipelined((char *)lpBuf, uiBufSize);
+  else
+  {
+    numberOfBytesRead = gNfsConnection.GetImpl()->nfs_pread(m_pNfsContext, m_pFileHandle, m_position, uiBufSize, (char *)lpBuf);
 
-  lock.Leave();//no need to keep the connection lock after that
+    //something went wrong ...
+    if (numberOfBytesRead < 0) 
+    {
+      CLog::Log(LOGERROR, "%s - Error( %d, %s )", __FUNCTION__, (int)numberOfBytesRead, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+      numberOfBytesRead = 0;
+    }
+    m_position += numberOfBytesRead;
+    if (m_position > m_fileSize)
+      m_fileSize = m_position;
+  }
+
+  lock.Leave();//no need to keep the context lock after that
   
   gNfsConnection.resetKeepAlive(m_exportPath, m_pFileHandle);//triggers keep alive timer reset for this filehandle
-  
-  //something went wrong ...
-  if (numberOfBytesRead < 0) 
+
+  m_bytesRead += numberOfBytesRead;
+  m_readTime += XbmcThreads::SystemClockMillis() - start;
+  return (unsigned int)numberOfBytesRead;
+}
+
+int64_t CNFSFile::ReadPipelined(char *buffer, int64_t size)
+{
+  unsigned int window = g_advancedSettings.m_nfsReadRequests;
+  int64_t copied = 0;
+
+  if (!m_readRequests.empty())
   {
-    CLog::Log(LOGERROR, "%s - Error( %d, %s )", __FUNCTION__, numberOfBytesRead, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
-    return 0;
+    const ReadRequest *head = m_readRequests.front();
+    if (head->offset + head->consumed != (uint64_t)m_position)
+    { //we've seen a seek - what's in flight is of no use anymore
+      DiscardReadRequests();
+      m_readAhead = 0;
+    }
+    else if (m_readAhead + 1 < window)
+      m_readAhead++;//sequential read, look further ahead
   }
-  return (unsigned int)numberOfBytesRead;
+  if (m_readRequests.empty())
+    m_readAheadOffset = m_position;
+
+  while (copied < size && m_position < m_fileSize)
+  {
+    //keep the chunks covering this read plus the read ahead in flight
+    uint64_t wanted = m_position + (size - copied) + m_readAhead * m_readChunkSize;
+    while (m_readAheadOffset < (uint64_t)m_fileSize && m_readAheadOffset < wanted &&
+           m_readRequests.size() < window)
+    {
+      //until the file is read sequentially only fetch what is asked for, probing
+      //a few headers shouldn't pull in whole chunks
+      uint64_t chunkSize = m_readChunkSize;
+      if (m_readAhead == 0)
+        chunkSize = std::min(chunkSize, std::max(wanted - m_readAheadOffset, (uint64_t)NFS_MIN_READ_SIZE));
+      if (!IssueRead(m_readAheadOffset, chunkSize))
+        break;
+    }
+    if (m_readRequests.empty())
+      break;
+
+    ReadRequest *request = m_readRequests.front();
+    if (!WaitForRequest(request, NFS_READ_TIMEOUT))
+    {
+      DiscardReadRequests();
+      break;
+    }
+    if (request->result <= 0)
+    {
+      if (request->result < 0)
+        CLog::Log(LOGERROR, "%s - Error( %d, %s )", __FUNCTION__, request->result, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+      DiscardReadRequests();
+      break;
+    }
+
+    size_t length = std::min((int64_t)(request->result - request->consumed), size - copied);
+    memcpy(buffer + copied, &request->data[request->consumed], length);
+    request->consumed += length;
+    copied += length;
+    m_position += length;
+
+    if (request->consumed == (size_t)request->result)
+    {
+      bool shortRead = (uint64_t)request->result < request->size;
+      m_readRequests.pop_front();
+      delete request;
+      if (shortRead)//the following requests don't line up with the position anymore
+        DiscardReadRequests();
+    }
+  }
+  return copied;
+}
+
+bool CNFSFile::IssueRead(uint64_t offset, uint64_t size)
+{
+  size = std::min(size, (uint64_t)m_fileSize - offset);
+  ReadRequest *request = new ReadRequest(offset, size);
+
+  if (gNfsConnection.GetImpl()->nfs_pread_async(m_pNfsContext, m_pFileHandle, offset, size, ReadCallback, request) != 0)
+  {
+    CLog::Log(LOGERROR, "%s - Error( %s )", __FUNCTION__, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+    delete request;
+    return false;
+  }
+
+  m_readRequests.push_back(request);
+  m_readAheadOffset = offset + size;
+  m_readRequestsIssued++;
+  if (m_readRequests.size() > m_maxReadsInFlight)
+    m_maxReadsInFlight = m_readRequests.size();
+  return true;
+}
+
+void CNFSFile::ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data)
+{
+  ReadRequest *request = (ReadRequest *)private_data;
+  if (request->orphaned)
+  {
+    delete request;
+    return;
+  }
+
+  request->result = err;
+  if (err > 0 && !request->abandoned)
+    request->data.assign((char *)data, (char *)data + err);
+  request->done = true;
+}
+
+//runs the event loop of the context until the request completes. Replies to
+//other files using the same context are handled along the way.
+bool CNFSFile::WaitForRequest(const ReadRequest *request, unsigned int timeoutMs)
+{
+  DllLibNfs *pLibNfs = gNfsConnection.GetImpl();
+  XbmcThreads::EndTime timeout(timeoutMs);
+
+  while (!request->done)
+  {
+    struct pollfd pfd;
+    pfd.fd = pLibNfs->nfs_get_fd(m_pNfsContext);
+    pfd.events = pLibNfs->nfs_which_events(m_pNfsContext);
+    pfd.revents = 0;
+
+    int ret = poll(&pfd, 1, 500);
+    if (ret < 0)
+    {
+      CLog::Log(LOGERROR, "%s - poll failed (%d)", __FUNCTION__, errno);
+      return false;
+    }
+    if (ret == 0)
+    {
+      if (timeout.IsTimePast())
+      {
+        CLog::Log(LOGERROR, "%s - timed out reading %s", __FUNCTION__, m_url.GetFileName().c_str());
+        return false;
+      }
+      continue;
+    }
+    if (pLibNfs->nfs_service(m_pNfsContext, pfd.revents) < 0)
+    {
+      CLog::Log(LOGERROR, "%s - Error( %s )", __FUNCTION__, pLibNfs->nfs_get_error(m_pNfsContext));
+      return false;
+    }
+  }
+  return true;
+}
+
+void CNFSFile::DiscardReadRequests()
+{
+  for (std::deque<ReadRequest*>::iterator it = m_readRequests.begin(); it != m_readRequests.end(); ++it)
+  {
+    //requests still in flight are kept until their reply, which refers to the file handle
+    if ((*it)->done)
+      delete *it;
+    else
+    {
+      (*it)->abandoned = true;
+      m_abandonedRequests.push_back(*it);
+    }
+  }
+  m_readRequests.clear();
+  m_readAheadOffset = m_position;
+
+  for (std::deque<ReadRequest*>::iterator it = m_abandonedRequests.begin(); it != m_abandonedRequests.end();)
+  {
+    if ((*it)->done)
+    {
+      delete *it;
+      it = m_abandonedRequests.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+//waits for the replies to the abandoned requests, the file handle may only be
+//closed once there are none left
+bool CNFSFile::DrainReadRequests()
+{
+  XbmcThreads::EndTime timeout(NFS_READ_TIMEOUT);
+  while (!m_abandonedRequests.empty())
+  {
+    ReadRequest *request = m_abandonedRequests.front();
+    if (!request->done && !WaitForRequest(request, timeout.MillisLeft()))
+      break;
+    m_abandonedRequests.pop_front();
+    delete request;
+  }
+  if (m_abandonedRequests.empty())
+    return true;
+
+  for (std::deque<ReadRequest*>::iterator it = m_abandonedRequests.begin(); it != m_abandonedRequests.end(); ++it)
+  {
+    if ((*it)->done)
+      delete *it;
+    else
+      (*it)->orphaned = true;
+  }
+  m_abandonedRequests.clear();
+  return false;
 }
 
 int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
@@ -626,9 +884,15 @@ int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
   int ret = 0;
   uint64_t offset = 0;
 
-  CSingleLock lock(gNfsConnection);  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
+  CSingleLock lock(*m_pContextLock);
   
+  //reads don't move the offset of the file handle
+  if (iWhence == SEEK_CUR)
+  {
+    iFilePosition += m_position;
+    iWhence = SEEK_SET;
+  }
  
   ret = (int)gNfsConnection.GetImpl()->nfs_lseek(m_pNfsContext, m_pFileHandle, iFilePosition, iWhence, &offset);
   if (ret < 0) 
@@ -636,6 +900,7 @@ int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
     CLog::Log(LOGERROR, "%s - Error( seekpos: %"PRId64", whence: %i, fsize: %"PRId64", %s)", __FUNCTION__, iFilePosition, iWhence, m_fileSize, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
     return -1;
   }
+  m_position = (int64_t)offset;
   return (int64_t)offset;
 }
 
@@ -643,8 +908,8 @@ int CNFSFile::Truncate(int64_t iSize)
 {
   int ret = 0;
   
-  CSingleLock lock(gNfsConnection);  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
+  CSingleLock lock(*m_pContextLock);
   
   
   ret = (int)gNfsConnection.GetImpl()->nfs_ftruncate(m_pNfsContext, m_pFileHandle, iSize);
@@ -658,25 +923,41 @@ int CNFSFile::Truncate(int64_t iSize)
 
 void CNFSFile::Close()
 {
-  CSingleLock lock(gNfsConnection);
-  
   if (m_pFileHandle != NULL && m_pNfsContext != NULL)
   {
     int ret = 0;
     CLog::Log(LOGDEBUG,"CNFSFile::Close closing file %s", m_url.GetFileName().c_str());
+    if (m_bytesRead > 0)
+      CLog::Log(LOGDEBUG, "CNFSFile::Close read %"PRIu64" bytes in %u ms (%.1f MB/s), %u async requests, at most %u in flight",
+                m_bytesRead, m_readTime, m_readTime ? (double)m_bytesRead / m_readTime / 1000.0 : 0.0,
+                m_readRequestsIssued, m_maxReadsInFlight);
     // remove it from keep alive list before closing
     // so keep alive code doens't process it anymore
     gNfsConnection.removeFromKeepAliveList(m_pFileHandle);
-    ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
-        
+
+    CSingleLock lock(*m_pContextLock);
+    DiscardReadRequests();
+    if (DrainReadRequests())
+      ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
+    else //replies that may still come write to the file handle, so it has to stay
+      CLog::Log(LOGWARNING, "CNFSFile::Close reads of %s didn't complete, leaving its file handle open", m_url.GetFileName().c_str());
+
 	  if (ret < 0) 
     {
       CLog::Log(LOGERROR, "Failed to close(%s) - %s\n", m_url.GetFileName().c_str(), gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
     }
+    lock.Leave();
     m_pFileHandle = NULL;
     m_pNfsContext = NULL;    
+    m_pContextLock.reset();
     m_fileSize = 0;
+    m_position = 0;
     m_exportPath.clear();
+    m_readAhead = 0;
+    m_bytesRead = 0;
+    m_readTime = 0;
+    m_readRequestsIssued = 0;
+    m_maxReadsInFlight = 0;
   }
 }
 
@@ -691,9 +972,8 @@ int CNFSFile::Write(const void* lpBuf, int64_t uiBufSize)
   //clamp max write chunksize to 32kb - fixme - this might be superfluious with future libnfs versions
   int64_t chunkSize = gNfsConnection.GetMaxWriteChunkSize() > 32768 ? 32768 : gNfsConnection.GetMaxWriteChunkSize();
   
-  CSingleLock lock(gNfsConnection);
-  
   if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
+  CSingleLock lock(*m_pContextLock);
   
   //write as long as some bytes are left to be written
   while( leftBytes )
@@ -719,6 +999,7 @@ int CNFSFile::Write(const void* lpBuf, int64_t uiBufSize)
       CLog::Log(LOGERROR, "Failed to pwrite(%s) %s\n", m_url.GetFileName().c_str(), gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));        
       break;
     }     
+    m_position += writtenBytes;
   }
   //return total number of written bytes
   return numberOfBytesWritten;
@@ -733,7 +1014,7 @@ bool CNFSFile::Delete(const CURL& url)
   if(!gNfsConnection.Connect(url, filename))
     return false;
   
-  
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
   ret = gNfsConnection.GetImpl()->nfs_unlink(gNfsConnection.GetNfsContext(), filename.c_str());
   
   if(ret != 0)
@@ -756,6 +1037,7 @@ bool CNFSFile::Rename(const CURL& url, const CURL& urlnew)
   CStdString strDummy;
   gNfsConnection.splitUrlIntoExportAndPath(urlnew, strDummy, strFileNew);
   
+  CSingleLock contextLock(*gNfsConnection.GetContextLock());
   ret = gNfsConnection.GetImpl()->nfs_rename(gNfsConnection.GetNfsContext() , strFile.c_str(), strFileNew.c_str());
   
   if(ret != 0)
@@ -780,8 +1062,13 @@ bool CNFSFile::OpenForWrite(const CURL& url, bool bOverWrite)
     return false;
   
   m_pNfsContext = gNfsConnection.GetNfsContext();
+  m_pContextLock = gNfsConnection.GetContextLock();
   m_exportPath = gNfsConnection.GetContextMapId();
+  m_readChunkSize = gNfsConnection.GetMaxReadChunkSize();
+  if (m_readChunkSize == 0)
+    m_readChunkSize = 32768;
   
+  CSingleLock contextLock(*m_pContextLock);
   if (bOverWrite)
   {
     CLog::Log(LOGWARNING, "FileNFS::OpenForWrite() called with overwriting enabled! - %s", filename.c_str());
@@ -802,10 +1089,12 @@ bool CNFSFile::OpenForWrite(const CURL& url, bool bOverWrite)
     // write error to logfile
     CLog::Log(LOGERROR, "CNFSFile::Open: Unable to open file : '%s' error : '%s'", filename.c_str(), gNfsConnection.GetImpl()->nfs_get_error(gNfsConnection.GetNfsContext()));
     m_pNfsContext = NULL;
+    m_pContextLock.reset();
     m_exportPath.clear();
     return false;
   }
   m_url=url;
+  m_position = 0;
   
   struct __stat64 tmpBuffer = {0};
 
@@ -27,7 +27,9 @@
 #include "threads/CriticalSection.h"
 #include <list>
 #include "SectionLoader.h"
+#include <deque>
 #include <map>
+#include <boost/shared_ptr.hpp>
 
 #ifdef TARGET_WINDOWS
 #define S_IRGRP 0
@@ -57,9 +59,12 @@ public:
   };
   typedef std::map<struct nfsfh  *, struct keepAliveStruct> tFileKeepAliveMap;  
 
+  typedef boost::shared_ptr<CCriticalSection> ContextLockPtr;
+
   struct contextTimeout
   {
     struct nfs_context *pContext;
+    ContextLockPtr pLock;//serializes all calls on pContext
     uint64_t lastAccessedTime;
   };
 
@@ -69,6 +74,10 @@ public:
   ~CNfsConnection();
   bool Connect(const CURL &url, CStdString &relativePath);
   struct nfs_context *GetNfsContext(){return m_pNfsContext;}
+  //lock that has to be held while using the context returned by GetNfsContext.
+  //Files keep a reference and only take this lock for their I/O, so contexts
+  //of different exports don't block each other.
+  ContextLockPtr    GetContextLock(){return m_pContextLock;}
   uint64_t          GetMaxReadChunkSize(){return m_readChunkSize;}
   uint64_t          GetMaxWriteChunkSize(){return m_writeChunkSize;} 
   DllLibNfs        *GetImpl(){return m_pLibNfs;}
@@ -98,6 +107,7 @@ public:
 
 private:
   struct nfs_context *m_pNfsContext;//current nfs context
+  ContextLockPtr m_pContextLock;//lock of the current nfs context
   CStdString m_exportPath;//current connected export path
   CStdString m_hostName;//current connected host
   CStdString m_resolvedHostName;//current connected host - as ip
@@ -114,7 +124,7 @@ private:
   CCriticalSection openContextLock;
  
   void clearMembers();
-  struct nfs_context *getContextFromMap(const CStdString &exportname, bool forceCacheHit = false);
+  struct nfs_context *getContextFromMap(const CStdString &exportname, bool forceCacheHit = false, ContextLockPtr *pLock = NULL);
   int  getContextForExport(const CStdString &exportname);//get context for given export and add to open contexts map - sets m_pNfsContext (my return a already mounted cached context)
   void destroyOpenContexts();
   void resolveHost(const CURL &url);//resolve hostname by dnslookup
@@ -151,12 +161,36 @@ namespace XFILE
     virtual bool Delete(const CURL& url);
     virtual bool Rename(const CURL& url, const CURL& urlnew);    
   protected:
+    struct ReadRequest;
+
     CURL m_url;
     bool IsValidFile(const CStdString& strFileName);
+    //read through a window of asynchronous read requests, context lock held
+    int64_t ReadPipelined(char *buffer, int64_t size);
+    bool IssueRead(uint64_t offset, uint64_t size);
+    bool WaitForRequest(const ReadRequest *request, unsigned int timeoutMs);
+    void DiscardReadRequests();
+    bool DrainReadRequests();
+    static void ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data);
+
     int64_t m_fileSize;
+    int64_t m_position;
     struct nfsfh  *m_pFileHandle;
     struct nfs_context *m_pNfsContext;//current nfs context
+    CNfsConnection::ContextLockPtr m_pContextLock;
     std::string m_exportPath;
+
+    std::deque<ReadRequest*> m_readRequests;//requests in flight or not yet consumed, in file order
+    std::deque<ReadRequest*> m_abandonedRequests;//discarded requests still in flight
+    uint64_t m_readAheadOffset;//offset after the last requested chunk
+    uint64_t m_readChunkSize;
+    unsigned int m_readAhead;//chunks requested beyond the current read, grows while reading sequentially
+
+    //throughput statistics, logged on close
+    uint64_t m_bytesRead;
+    unsigned int m_readTime;
+    unsigned int m_readRequestsIssued;
+    unsigned int m_maxReadsInFlight;
   };
 }
 #endif // FILENFS_H_
@@ -131,11 +131,14 @@ bool CPluginDirectory::StartScript(const CStdString& strPath, bool retrievingDir
   bool success = false;
 #ifdef HAS_PYTHON
   CStdString file = m_addon->LibPath();
+  unsigned int startTime = XbmcThreads::SystemClockMillis();
   int id = g_pythonParser.evalFile(file, argv,m_addon);
   if (id >= 0)
   { // wait for our script to finish
     CStdString scriptName = m_addon->Name();
     success = WaitOnScriptResult(file, id, scriptName, retrievingDir);
+    CLog::Log(LOGDEBUG, "%s - plugin %s returned %d items in %u ms", __FUNCTION__, m_addon->Name().c_str(),
+              m_listItems->Size(), XbmcThreads::SystemClockMillis() - startTime);
   }
   else
 #endif
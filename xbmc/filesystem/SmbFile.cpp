@@ -28,12 +28,15 @@
 #include "SMBDirectory.h"
 #include "Util.h"
 #include <libsmbclient.h>
+#include <algorithm>
+#include <limits.h>
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/TimeUtils.h"
+#include "utils/JobManager.h"
 #include "commons/Exception.h"
 
 using namespace XFILE;
@@ -56,6 +59,111 @@ SMBCSRV* xb_smbc_cache(SMBCCTX* c, const char* server, const char* share, const
   return orig_cache(c, server, share, workgroup, username);
 }
 
+/* samba 3.2 replaced the function pointers of a context by accessors */
+#ifdef DEPRECATED_SMBC_INTERFACE
+#define SMBC_FUNCTION(context, name, member) smbc_getFunction##name(context)
+#else
+#define SMBC_FUNCTION(context, name, member) context->member
+#endif
+
+/* largest read that is safe on every server, see CSMBContext::Read */
+#define SMB_SAFE_READ_SIZE (64*1024-2)
+
+CSMBContext::CSMBContext(SMBCCTX *context, CCriticalSection *section)
+{
+  m_context = context;
+  m_section = section;
+  m_readSize = std::max(g_advancedSettings.m_sambaReadSize * 1024, SMB_SAFE_READ_SIZE);
+}
+
+CSMBContext::~CSMBContext()
+{
+  if (!m_section)
+  {
+    CSingleLock lock(smb);
+    smbc_free_context(m_context, 1);
+  }
+}
+
+SMBCFILE *CSMBContext::Open(const CStdString &url, int flags, mode_t mode)
+{
+  CSingleLock lock(GetLock());
+  return SMBC_FUNCTION(m_context, Open, open)(m_context, url.c_str(), flags, mode);
+}
+
+SMBCFILE *CSMBContext::Create(const CStdString &url, mode_t mode)
+{
+  CSingleLock lock(GetLock());
+  return SMBC_FUNCTION(m_context, Creat, creat)(m_context, url.c_str(), mode);
+}
+
+void CSMBContext::Close(SMBCFILE *file)
+{
+  CSingleLock lock(GetLock());
+  SMBC_FUNCTION(m_context, Close, close_fn)(m_context, file);
+}
+
+int CSMBContext::Read(SMBCFILE *file, int64_t offset, void *buffer, unsigned int size, int64_t length)
+{
+  CSingleLock lock(GetLock());
+  if (size > m_readSize)
+    size = m_readSize;
+
+  if (SMBC_FUNCTION(m_context, Lseek, lseek)(m_context, file, offset, SEEK_SET) < 0)
+    return -1;
+
+  int bytesRead = SMBC_FUNCTION(m_context, Read, read)(m_context, file, buffer, size);
+  if (bytesRead < 0 && errno == EINVAL)
+  {
+    CLog::Log(LOGERROR, "%s - Error( %d, %d, %s ) - Retrying", __FUNCTION__, bytesRead, errno, strerror(errno));
+    bytesRead = SMBC_FUNCTION(m_context, Read, read)(m_context, file, buffer, size);
+  }
+
+  /* work around stupid bug in samba */
+  /* some samba servers has a bug in it where the */
+  /* 17th bit will be ignored in a request of data */
+  /* this can lead to a very small return of data */
+  /* also worse, a request of exactly 64k will return */
+  /* as if eof. stick to smaller reads once a server */
+  /* returns less than asked before the end of file */
+  if (bytesRead >= 0 && (unsigned int)bytesRead < size && size > SMB_SAFE_READ_SIZE && offset + bytesRead < length)
+  {
+    CLog::Log(LOGNOTICE, "%s - short read of %d bytes at %"PRId64", limiting reads to %d bytes", __FUNCTION__, bytesRead, offset, SMB_SAFE_READ_SIZE);
+    m_readSize = SMB_SAFE_READ_SIZE;
+    if (bytesRead == 0 && SMBC_FUNCTION(m_context, Lseek, lseek)(m_context, file, offset, SEEK_SET) >= 0)
+      bytesRead = SMBC_FUNCTION(m_context, Read, read)(m_context, file, buffer, m_readSize);
+  }
+
+  return bytesRead;
+}
+
+int CSMBContext::Write(SMBCFILE *file, int64_t offset, const void *buffer, unsigned int size)
+{
+  CSingleLock lock(GetLock());
+  if (SMBC_FUNCTION(m_context, Lseek, lseek)(m_context, file, offset, SEEK_SET) < 0)
+    return -1;
+  // buffer can be safely casted to void* since smbc_write will only read from it.
+  return SMBC_FUNCTION(m_context, Write, write)(m_context, file, (void*)buffer, size);
+}
+
+int64_t CSMBContext::Seek(SMBCFILE *file, int64_t offset, int whence)
+{
+  CSingleLock lock(GetLock());
+  return SMBC_FUNCTION(m_context, Lseek, lseek)(m_context, file, offset, whence);
+}
+
+int CSMBContext::Stat(SMBCFILE *file, struct stat *buffer)
+{
+  CSingleLock lock(GetLock());
+  return SMBC_FUNCTION(m_context, Fstat, fstat)(m_context, file, buffer);
+}
+
+int CSMBContext::Stat(const CStdString &url, struct stat *buffer)
+{
+  CSingleLock lock(GetLock());
+  return SMBC_FUNCTION(m_context, Stat, stat)(m_context, url.c_str(), buffer);
+}
+
 CSMB::CSMB()
 {
 #ifdef TARGET_POSIX
@@ -73,6 +181,9 @@ void CSMB::Deinit()
 {
   CSingleLock lock(*this);
 
+  /* contexts of their own are freed once the last file using them is closed */
+  m_contexts.clear();
+
   /* samba goes loco if deinited while it has some files opened */
   if (m_context)
   {
@@ -144,6 +255,11 @@ void CSMB::Init()
     }
 #endif
 
+#ifdef HAVE_SMBC_THREAD_POSIX
+    // has to be set up before any context is created
+    smbc_thread_posix();
+#endif
+
     // reads smb.conf so this MUST be after we create smb.conf
     // multiple smbc_init calls are ignored by libsmbclient.
     smbc_init(xb_smbc_auth, 0);
@@ -154,29 +270,8 @@ void CSMB::Init()
 #endif
 
     // setup our context
-    m_context = smbc_new_context();
-#ifdef DEPRECATED_SMBC_INTERFACE
-    smbc_setDebug(m_context, (g_advancedSettings.m_extraLogLevels & LOGSAMBA)?10:0);
-    smbc_setFunctionAuthData(m_context, xb_smbc_auth);
-    orig_cache = smbc_getFunctionGetCachedServer(m_context);
-    smbc_setFunctionGetCachedServer(m_context, xb_smbc_cache);
-    smbc_setOptionOneSharePerServer(m_context, false);
-    smbc_setOptionBrowseMaxLmbCount(m_context, 0);
-    smbc_setTimeout(m_context, g_advancedSettings.m_sambaclienttimeout * 1000);
-    smbc_setUser(m_context, strdup("guest"));
-#else
-    m_context->debug = (g_advancedSettings.m_extraLogLevels & LOGSAMBA?10:0);
-    m_context->callbacks.auth_fn = xb_smbc_auth;
-    orig_cache = m_context->callbacks.get_cached_srv_fn;
-    m_context->callbacks.get_cached_srv_fn = xb_smbc_cache;
-    m_context->options.one_share_per_server = false;
-    m_context->options.browse_max_lmb_count = 0;
-    m_context->timeout = g_advancedSettings.m_sambaclienttimeout * 1000;
-    m_context->user = strdup("guest");
-#endif
-
-    // initialize samba and do some hacking into the settings
-    if (smbc_init_context(m_context))
+    m_context = CreateContext();
+    if (m_context)
     {
       /* setup old interface to use this context */
       smbc_set_context(m_context);
@@ -197,17 +292,71 @@ void CSMB::Init()
         lp_do_parameter( -1, "dos charset", "CP850");
 #endif
     }
-    else
-    {
-      smbc_free_context(m_context, 1);
-      m_context = NULL;
-    }
   }
 #ifdef TARGET_POSIX
   m_IdleTimeout = 180;
 #endif
 }
 
+SMBCCTX *CSMB::CreateContext()
+{
+  SMBCCTX *context = smbc_new_context();
+#ifdef DEPRECATED_SMBC_INTERFACE
+  smbc_setDebug(context, (g_advancedSettings.m_extraLogLevels & LOGSAMBA)?10:0);
+  smbc_setFunctionAuthData(context, xb_smbc_auth);
+  orig_cache = smbc_getFunctionGetCachedServer(context);
+  smbc_setFunctionGetCachedServer(context, xb_smbc_cache);
+  smbc_setOptionOneSharePerServer(context, false);
+  smbc_setOptionBrowseMaxLmbCount(context, 0);
+  smbc_setTimeout(context, g_advancedSettings.m_sambaclienttimeout * 1000);
+  smbc_setUser(context, strdup("guest"));
+#else
+  context->debug = (g_advancedSettings.m_extraLogLevels & LOGSAMBA?10:0);
+  context->callbacks.auth_fn = xb_smbc_auth;
+  orig_cache = context->callbacks.get_cached_srv_fn;
+  context->callbacks.get_cached_srv_fn = xb_smbc_cache;
+  context->options.one_share_per_server = false;
+  context->options.browse_max_lmb_count = 0;
+  context->timeout = g_advancedSettings.m_sambaclienttimeout * 1000;
+  context->user = strdup("guest");
+#endif
+
+  // initialize samba and do some hacking into the settings
+  if (!smbc_init_context(context))
+  {
+    smbc_free_context(context, 1);
+    return NULL;
+  }
+  return context;
+}
+
+SMBContextPtr CSMB::GetContext(const CURL& url)
+{
+  CSingleLock lock(*this);
+  CStdString key;
+#ifdef HAVE_SMBC_THREAD_POSIX
+  key = url.GetHostName() + "/" + url.GetShareName();
+  key.ToLower();
+#endif
+
+  std::map<CStdString, SMBContextPtr>::const_iterator it = m_contexts.find(key);
+  if (it != m_contexts.end())
+    return it->second;
+
+  SMBContextPtr context;
+#ifdef HAVE_SMBC_THREAD_POSIX
+  SMBCCTX *shareContext = CreateContext();
+  if (shareContext)
+    context.reset(new CSMBContext(shareContext, NULL));
+#else
+  if (m_context)
+    context.reset(new CSMBContext(m_context, this));
+#endif
+  if (context)
+    m_contexts.insert(std::make_pair(key, context));
+  return context;
+}
+
 void CSMB::Purge()
 {
 #ifdef TARGET_WINDOWS
@@ -347,10 +496,74 @@ void CSMB::AddIdleConnection()
 
 CSMB smb;
 
+class CSmbFile::CReadAheadJob : public CJob
+{
+public:
+  CReadAheadJob(const ReadAheadPtr &readAhead) : m_readAhead(readAhead)
+  {
+  }
+
+  virtual const char *GetType() const { return "smbreadahead"; }
+
+  virtual bool DoWork()
+  {
+    ReadAhead &state = *m_readAhead;
+    for (;;)
+    {
+      // the file is closed holding the context lock, so check it's still open under it
+      CSingleLock contextLock(state.context->GetLock());
+      int64_t offset;
+      unsigned int generation;
+      {
+        CSingleLock lock(state.section);
+        if (state.cancelled || state.eof || state.blocks.size() >= (size_t)g_advancedSettings.m_sambaReadAhead)
+        {
+          state.running = false;
+          state.ready.Set();
+          return true;
+        }
+        offset = state.offset;
+        generation = state.generation;
+        state.reading = true;
+      }
+
+      std::string data;
+      data.resize(state.context->GetReadSize());
+      int bytesRead = state.context->Read(state.file, offset, &data[0], data.size(), state.length);
+      contextLock.Leave();
+
+      CSingleLock lock(state.section);
+      state.reading = false;
+      if (generation == state.generation)
+      {
+        if (bytesRead > 0)
+        {
+          data.resize(bytesRead);
+          state.blocks.push_back(ReadAhead::Block());
+          state.blocks.back().offset = offset;
+          state.blocks.back().data.swap(data);
+          state.offset += bytesRead;
+        }
+        else // end of file or an error, which the next read runs into itself
+          state.eof = true;
+      }
+      state.ready.Set();
+    }
+  }
+
+private:
+  ReadAheadPtr m_readAhead;
+};
+
 CSmbFile::CSmbFile()
 {
   smb.Init();
-  m_fd = -1;
+  m_fileSize = 0;
+  m_position = 0;
+  m_lastReadEnd = -1;
+  m_bytesRead = 0;
+  m_bytesReadAhead = 0;
+  m_file = NULL;
 #ifdef TARGET_POSIX
   smb.AddActiveConnection();
 #endif
@@ -366,18 +579,13 @@ CSmbFile::~CSmbFile()
 
 int64_t CSmbFile::GetPosition()
 {
-  if (m_fd == -1) return 0;
-  smb.Init();
-  CSingleLock lock(smb);
-  int64_t pos = smbc_lseek(m_fd, 0, SEEK_CUR);
-  if ( pos < 0 )
-    return 0;
-  return pos;
+  if (m_file == NULL) return 0;
+  return m_position;
 }
 
 int64_t CSmbFile::GetLength()
 {
-  if (m_fd == -1) return 0;
+  if (m_file == NULL) return 0;
   return m_fileSize;
 }
 
@@ -399,10 +607,10 @@ bool CSmbFile::Open(const CURL& url)
   // listed, which will create lot's of open sessions.
 
   CStdString strFileName;
-  m_fd = OpenFile(url, strFileName);
+  m_file = OpenFile(url, strFileName);
 
-  CLog::Log(LOGDEBUG,"CSmbFile::Open - opened %s, fd=%d",url.GetFileName().c_str(), m_fd);
-  if (m_fd == -1)
+  CLog::Log(LOGDEBUG,"CSmbFile::Open - opened %s, file=%p",url.GetFileName().c_str(), m_file);
+  if (m_file == NULL)
   {
     // write error to logfile
 #ifdef TARGET_WINDOWS
@@ -414,28 +622,25 @@ bool CSmbFile::Open(const CURL& url)
     return false;
   }
 
-  CSingleLock lock(smb);
-#ifdef TARGET_WINDOWS
-  struct __stat64 tmpBuffer = {0};
-#else
   struct stat tmpBuffer;
-#endif
-  if (smbc_stat(strFileName, &tmpBuffer) < 0)
+  if (m_context->Stat(m_file, &tmpBuffer) < 0)
   {
-    smbc_close(m_fd);
-    m_fd = -1;
+    Close();
     return false;
   }
 
   m_fileSize = tmpBuffer.st_size;
+  m_position = 0;
+  m_lastReadEnd = -1;
 
-  int64_t ret = smbc_lseek(m_fd, 0, SEEK_SET);
-  if ( ret < 0 )
+  if (g_advancedSettings.m_sambaReadAhead > 0)
   {
-    smbc_close(m_fd);
-    m_fd = -1;
-    return false;
+    m_readAhead.reset(new ReadAhead);
+    m_readAhead->context = m_context;
+    m_readAhead->file = m_file;
+    m_readAhead->length = m_fileSize;
   }
+
   // We've successfully opened the file!
   return true;
 }
@@ -466,23 +671,20 @@ int CSmbFile::OpenFile(CStdString& strAuth)
 }
 */
 
-int CSmbFile::OpenFile(const CURL &url, CStdString& strAuth)
+SMBCFILE *CSmbFile::OpenFile(const CURL &url, CStdString& strAuth)
 {
-  int fd = -1;
   smb.Init();
 
   strAuth = GetAuthenticatedPath(url);
-  CStdString strPath = strAuth;
-
-  {
-    CSingleLock lock(smb);
-    fd = smbc_open(strPath.c_str(), O_RDONLY, 0);
-  }
+  m_context = smb.GetContext(url);
+  if (!m_context)
+    return NULL;
 
-  if (fd >= 0)
-    strAuth = strPath;
+  SMBCFILE *file = m_context->Open(strAuth, O_RDONLY, 0);
+  if (file == NULL)
+    m_context.reset();
 
-  return fd;
+  return file;
 }
 
 bool CSmbFile::Exists(const CURL& url)
@@ -493,15 +695,12 @@ bool CSmbFile::Exists(const CURL& url)
 
   smb.Init();
   CStdString strFileName = GetAuthenticatedPath(url);
+  SMBContextPtr context = smb.GetContext(url);
+  if (!context)
+    return false;
 
-#ifdef TARGET_WINDOWS
-  struct __stat64 info;
-#else
   struct stat info;
-#endif
-
-  CSingleLock lock(smb);
-  int iResult = smbc_stat(strFileName, &info);
+  int iResult = context->Stat(strFileName, &info);
 
   if (iResult < 0) return false;
   return true;
@@ -509,17 +708,11 @@ bool CSmbFile::Exists(const CURL& url)
 
 int CSmbFile::Stat(struct __stat64* buffer)
 {
-  if (m_fd == -1)
+  if (m_file == NULL)
     return -1;
 
-#ifdef TARGET_WINDOWS
-  struct __stat64 tmpBuffer = {0};
-#else
   struct stat tmpBuffer = {0};
-#endif
-
-  CSingleLock lock(smb);
-  int iResult = smbc_fstat(m_fd, &tmpBuffer);
+  int iResult = m_context->Stat(m_file, &tmpBuffer);
 
   memset(buffer, 0, sizeof(struct __stat64));
   buffer->st_dev = tmpBuffer.st_dev;
@@ -541,14 +734,12 @@ int CSmbFile::Stat(const CURL& url, struct __stat64* buffer)
 {
   smb.Init();
   CStdString strFileName = GetAuthenticatedPath(url);
-  CSingleLock lock(smb);
+  SMBContextPtr context = smb.GetContext(url);
+  if (!context)
+    return -1;
 
-#ifdef TARGET_WINDOWS
-  struct __stat64 tmpBuffer = {0};
-#else
   struct stat tmpBuffer = {0};
-#endif
-  int iResult = smbc_stat(strFileName, &tmpBuffer);
+  int iResult = context->Stat(strFileName, &tmpBuffer);
 
   memset(buffer, 0, sizeof(struct __stat64));
   buffer->st_dev = tmpBuffer.st_dev;
@@ -568,7 +759,7 @@ int CSmbFile::Stat(const CURL& url, struct __stat64* buffer)
 
 int CSmbFile::Truncate(int64_t size)
 {
-  if (m_fd == -1) return 0;
+  if (m_file == NULL) return 0;
 /* 
  * This would force us to be dependant on SMBv3.2 which is GPLv3
  * This is only used by the TagLib writers, which are not currently in use
@@ -587,29 +778,25 @@ int CSmbFile::Truncate(int64_t size)
 
 unsigned int CSmbFile::Read(void *lpBuf, int64_t uiBufSize)
 {
-  if (m_fd == -1) return 0;
-  CSingleLock lock(smb); // Init not called since it has to be "inited" by now
+  if (m_file == NULL) return 0;
 #ifdef TARGET_POSIX
   smb.SetActivityTime();
 #endif
-  /* work around stupid bug in samba */
-  /* some samba servers has a bug in it where the */
-  /* 17th bit will be ignored in a request of data */
-  /* this can lead to a very small return of data */
-  /* also worse, a request of exactly 64k will return */
-  /* as if eof, client has a workaround for windows */
-  /* thou it seems other servers are affected too */
-  if( uiBufSize >= 64*1024-2 )
-    uiBufSize = 64*1024-2;
-
-  int bytesRead = smbc_read(m_fd, lpBuf, (int)uiBufSize);
+  unsigned int size = (unsigned int)std::min(uiBufSize, (int64_t)INT_MAX);
 
-  if ( bytesRead < 0 && errno == EINVAL )
+  if (m_readAhead)
   {
-    CLog::Log(LOGERROR, "%s - Error( %d, %d, %s ) - Retrying", __FUNCTION__, bytesRead, errno, strerror(errno));
-    bytesRead = smbc_read(m_fd, lpBuf, (int)uiBufSize);
+    unsigned int bytesRead = ReadBuffered(lpBuf, size);
+    if (bytesRead > 0)
+    {
+      m_position += bytesRead;
+      m_lastReadEnd = m_position;
+      m_bytesReadAhead += bytesRead;
+      return bytesRead;
+    }
   }
 
+  int bytesRead = m_context->Read(m_file, m_position, lpBuf, size, m_fileSize);
   if ( bytesRead < 0 )
   {
 #ifdef TARGET_WINDOWS
@@ -620,18 +807,89 @@ unsigned int CSmbFile::Read(void *lpBuf, int64_t uiBufSize)
     return 0;
   }
 
+  // only read ahead once the file is read sequentially, not while it is probed
+  bool sequential = m_position == m_lastReadEnd;
+  m_position += bytesRead;
+  m_lastReadEnd = m_position;
+  m_bytesRead += bytesRead;
+  if (m_readAhead && sequential && bytesRead > 0)
+    StartReadAhead(m_position);
+
   return (unsigned int)bytesRead;
 }
 
+unsigned int CSmbFile::ReadBuffered(void* lpBuf, unsigned int uiBufSize)
+{
+  ReadAhead &state = *m_readAhead;
+  CSingleLock lock(state.section);
+  for (;;)
+  {
+    while (!state.blocks.empty() && state.blocks.front().offset + (int64_t)state.blocks.front().data.size() <= m_position)
+      state.blocks.pop_front();
+
+    if (!state.blocks.empty())
+    {
+      ReadAhead::Block &block = state.blocks.front();
+      if (block.offset > m_position)
+        return 0;
+
+      unsigned int start = (unsigned int)(m_position - block.offset);
+      unsigned int size = std::min(uiBufSize, (unsigned int)block.data.size() - start);
+      memcpy(lpBuf, block.data.data() + start, size);
+      if (start + size == block.data.size())
+      {
+        state.blocks.pop_front();
+        QueueReadAhead();
+      }
+      return size;
+    }
+
+    // wait for the block at our position if it is being read, otherwise read it ourself
+    if (!state.reading || state.offset != m_position)
+      return 0;
+
+    lock.Leave();
+    state.ready.Wait();
+    lock.Enter();
+  }
+}
+
+void CSmbFile::StartReadAhead(int64_t offset)
+{
+  CSingleLock lock(m_readAhead->section);
+  m_readAhead->blocks.clear();
+  m_readAhead->offset = offset;
+  m_readAhead->generation++;
+  m_readAhead->eof = false;
+  QueueReadAhead();
+}
+
+void CSmbFile::QueueReadAhead()
+{
+  CSingleLock lock(m_readAhead->section);
+  if (m_readAhead->running || m_readAhead->eof || m_readAhead->cancelled ||
+      m_readAhead->blocks.size() >= (size_t)g_advancedSettings.m_sambaReadAhead)
+    return;
+
+  m_readAhead->running = true;
+  CJobManager::GetInstance().AddJob(new CReadAheadJob(m_readAhead), NULL, CJob::PRIORITY_HIGH);
+}
+
 int64_t CSmbFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  if (m_fd == -1) return -1;
+  if (m_file == NULL) return -1;
 
-  CSingleLock lock(smb); // Init not called since it has to be "inited" by now
 #ifdef TARGET_POSIX
   smb.SetActivityTime();
 #endif
-  int64_t pos = smbc_lseek(m_fd, iFilePosition, iWhence);
+  // reads are done at m_position, so only the end of the file needs the server
+  int64_t pos;
+  if (iWhence == SEEK_SET)
+    pos = iFilePosition;
+  else if (iWhence == SEEK_CUR)
+    pos = m_position + iFilePosition;
+  else
+    pos = m_context->Seek(m_file, iFilePosition, iWhence);
 
   if ( pos < 0 )
   {
@@ -643,31 +901,44 @@ int64_t CSmbFile::Seek(int64_t iFilePosition, int iWhence)
     return -1;
   }
 
-  return (int64_t)pos;
+  m_position = pos;
+  return m_position;
 }
 
 void CSmbFile::Close()
 {
-  if (m_fd != -1)
+  if (m_file != NULL)
   {
-    CLog::Log(LOGDEBUG,"CSmbFile::Close closing fd %d", m_fd);
-    CSingleLock lock(smb);
-    smbc_close(m_fd);
+    CLog::Log(LOGDEBUG,"CSmbFile::Close closing file %p", m_file);
+    if (m_bytesReadAhead > 0)
+      CLog::Log(LOGDEBUG, "CSmbFile::Close - %"PRId64" bytes read ahead, %"PRId64" bytes read directly", m_bytesReadAhead, m_bytesRead);
+
+    CSingleLock lock(m_context->GetLock());
+    if (m_readAhead)
+    {
+      // a job still running finds the file closed and drops its block
+      CSingleLock readAheadLock(m_readAhead->section);
+      m_readAhead->cancelled = true;
+      m_readAhead->blocks.clear();
+    }
+    m_context->Close(m_file);
   }
-  m_fd = -1;
+  m_file = NULL;
+  m_readAhead.reset();
+  m_context.reset();
+  m_bytesRead = 0;
+  m_bytesReadAhead = 0;
 }
 
 int CSmbFile::Write(const void* lpBuf, int64_t uiBufSize)
 {
-  if (m_fd == -1) return -1;
-  DWORD dwNumberOfBytesWritten = 0;
+  if (m_file == NULL) return -1;
 
-  // lpBuf can be safely casted to void* since xmbc_write will only read from it.
-  smb.Init();
-  CSingleLock lock(smb);
-  dwNumberOfBytesWritten = smbc_write(m_fd, (void*)lpBuf, (DWORD)uiBufSize);
+  int bytesWritten = m_context->Write(m_file, m_position, lpBuf, (unsigned int)uiBufSize);
+  if (bytesWritten > 0)
+    m_position += bytesWritten;
 
-  return (int)dwNumberOfBytesWritten;
+  return bytesWritten;
 }
 
 bool CSmbFile::Delete(const CURL& url)
@@ -719,20 +990,23 @@ bool CSmbFile::OpenForWrite(const CURL& url, bool bOverWrite)
   if (!IsValidFile(url.GetFileName())) return false;
 
   CStdString strFileName = GetAuthenticatedPath(url);
-  CSingleLock lock(smb);
+  m_context = smb.GetContext(url);
+  if (!m_context)
+    return false;
 
   if (bOverWrite)
   {
     CLog::Log(LOGWARNING, "FileSmb::OpenForWrite() called with overwriting enabled! - %s", strFileName.c_str());
-    m_fd = smbc_creat(strFileName.c_str(), 0);
+    m_file = m_context->Create(strFileName, 0);
   }
   else
   {
-    m_fd = smbc_open(strFileName.c_str(), O_RDWR, 0);
+    m_file = m_context->Open(strFileName, O_RDWR, 0);
   }
 
-  if (m_fd == -1)
+  if (m_file == NULL)
   {
+    m_context.reset();
     // write error to logfile
 #ifdef TARGET_WINDOWS
     int nt_error = map_nt_error_from_unix(errno);
@@ -743,6 +1017,7 @@ bool CSmbFile::OpenForWrite(const CURL& url, bool bOverWrite)
     return false;
   }
 
+  m_position = 0;
   // We've successfully opened the file!
   return true;
 }
@@ -40,6 +40,11 @@
 #include "IFile.h"
 #include "URL.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <deque>
+#include <map>
+#include <boost/shared_ptr.hpp>
 
 #define NT_STATUS_CONNECTION_REFUSED long(0xC0000000 | 0x0236)
 #define NT_STATUS_INVALID_HANDLE long(0xC0000000 | 0x0008)
@@ -51,6 +56,56 @@
 
 struct _SMBCCTX;
 typedef _SMBCCTX SMBCCTX;
+struct _SMBCFILE;
+typedef _SMBCFILE SMBCFILE;
+
+/*!
+ \brief A libsmbclient context files are opened and read with.
+
+ A context can only be used by one thread at a time, so every call on it is made
+ holding its lock. When libsmbclient is thread safe each share gets a context of
+ its own, letting files on different shares and directory listings (which go
+ through the global context) proceed concurrently. Otherwise all files share the
+ global context and its lock.
+ */
+class CSMBContext
+{
+public:
+  /*!
+   \param context the libsmbclient context.
+   \param section lock of the global context when it is shared, NULL for a context of its own that is freed with this object.
+   */
+  CSMBContext(SMBCCTX *context, CCriticalSection *section);
+  ~CSMBContext();
+
+  CCriticalSection &GetLock() { return m_section ? *m_section : m_ownSection; }
+
+  SMBCFILE *Open(const CStdString &url, int flags, mode_t mode);
+  SMBCFILE *Create(const CStdString &url, mode_t mode);
+  void Close(SMBCFILE *file);
+  /*! \brief Read at an offset
+   Reads larger than 64k are split by the server when it supports them. A server
+   that returns less than asked in the middle of a file is assumed not to, and the
+   reads on this context are limited to 64k from then on.
+   \param length length of the file, used to tell a short read from the end of file.
+   */
+  int Read(SMBCFILE *file, int64_t offset, void *buffer, unsigned int size, int64_t length);
+  int Write(SMBCFILE *file, int64_t offset, const void *buffer, unsigned int size);
+  int64_t Seek(SMBCFILE *file, int64_t offset, int whence);
+  int Stat(SMBCFILE *file, struct stat *buffer);
+  int Stat(const CStdString &url, struct stat *buffer);
+
+  /*! \brief The largest read sent to the server at once */
+  unsigned int GetReadSize() const { return m_readSize; }
+
+private:
+  SMBCCTX *m_context;
+  CCriticalSection *m_section;
+  CCriticalSection m_ownSection;
+  unsigned int m_readSize;
+};
+
+typedef boost::shared_ptr<CSMBContext> SMBContextPtr;
 
 class CSMB : public CCriticalSection
 {
@@ -61,6 +116,8 @@ public:
   void Deinit();
   void Purge();
   void PurgeEx(const CURL& url);
+  /*! \brief Get the context files on the share of a url are opened with */
+  SMBContextPtr GetContext(const CURL& url);
 #ifdef _LINUX
   void CheckIfIdle();
   void SetActivityTime();
@@ -72,7 +129,10 @@ public:
 
   DWORD ConvertUnixToNT(int error);
 private:
+  SMBCCTX *CreateContext();
+
   SMBCCTX *m_context;
+  std::map<CStdString, SMBContextPtr> m_contexts;
   CStdString m_strLastHost;
   CStdString m_strLastShare;
 #ifdef _LINUX
@@ -89,7 +149,7 @@ class CSmbFile : public IFile
 {
 public:
   CSmbFile();
-  int OpenFile(const CURL &url, CStdString& strAuth);
+  SMBCFILE *OpenFile(const CURL &url, CStdString& strAuth);
   virtual ~CSmbFile();
   virtual void Close();
   virtual int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET);
@@ -109,11 +169,49 @@ public:
   virtual int  GetChunkSize() {return 1;}
 
 protected:
+  class CReadAheadJob;
+
+  /*! \brief Blocks read ahead of the position of a file, shared with the job reading them */
+  struct ReadAhead
+  {
+    struct Block
+    {
+      int64_t offset;
+      std::string data;
+    };
+
+    ReadAhead() : file(NULL), length(0), offset(0), generation(0), running(false), reading(false), eof(false), cancelled(false) {}
+
+    SMBContextPtr context;
+    SMBCFILE *file;
+    int64_t length;
+    std::deque<Block> blocks;
+    int64_t offset;          // where the next block is read from
+    unsigned int generation; // bumped when the blocks are dropped
+    bool running;            // a job is queued or reading
+    bool reading;            // the block at offset is being read
+    bool eof;
+    bool cancelled;
+    CEvent ready;
+    CCriticalSection section;
+  };
+  typedef boost::shared_ptr<ReadAhead> ReadAheadPtr;
+
+  unsigned int ReadBuffered(void* lpBuf, unsigned int uiBufSize);
+  void StartReadAhead(int64_t offset);
+  void QueueReadAhead();
+
   CURL m_url;
   bool IsValidFile(const CStdString& strFileName);
   CStdString GetAuthenticatedPath(const CURL &url);
   int64_t m_fileSize;
-  int m_fd;
+  int64_t m_position;
+  int64_t m_lastReadEnd;
+  int64_t m_bytesRead;
+  int64_t m_bytesReadAhead;
+  SMBContextPtr m_context;
+  SMBCFILE *m_file;
+  ReadAheadPtr m_readAhead;
 };
 }
 
@@ -31,6 +31,7 @@
 #include "Key.h"
 #include "utils/MathUtils.h"
 #include "utils/XBMCTinyXML.h"
+#include "GUILargeTextureManager.h"
 
 using namespace std;
 
@@ -38,6 +39,7 @@ using namespace std;
 #define HOLD_TIME_END   3000
 #define SCROLLING_GAP   200U
 #define SCROLLING_THRESHOLD 300U
+#define PRELOAD_MAX_PAGES   3
 
 
 IGUIContainer::IGUIContainer(int parentID, int controlID, float posX, float posY, float width, float height)
@@ -70,6 +72,10 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_layout = NULL;
   m_focusedLayout = NULL;
   m_cacheItems = preloadItems;
+  m_preloadOffset = 0;
+  m_preloadItem = 0;
+  m_preloadDirection = 0;
+  m_preloadEnd = 0;
   m_scrollItemsPerFrame = 0.0f;
   m_type = VIEW_TYPE_NONE;
 }
@@ -107,6 +113,8 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   if ((int)m_items.size() > m_itemsPerPage + cacheBefore + cacheAfter)
     FreeMemory(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + m_itemsPerPage + 1 + cacheAfter, 0));
 
+  PreloadArt(offset, CorrectOffset(offset, 0), m_itemsPerPage, m_cacheItems);
+
   CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
   float pos = (m_orientation == VERTICAL) ? origin.y : origin.x;
   float end = (m_orientation == VERTICAL) ? m_posY + m_height : m_posX + m_width;
@@ -1024,6 +1032,10 @@ void CGUIBaseContainer::Reset()
   m_wasReset = true;
   m_items.clear();
   m_lastItem.reset();
+  m_preloadOffset = 0;
+  m_preloadItem = 0;
+  m_preloadDirection = 0;
+  m_preloadEnd = 0;
 }
 
 void CGUIBaseContainer::LoadLayout(TiXmlElement *layout)
@@ -1237,6 +1249,64 @@ void CGUIBaseContainer::GetCacheOffsets(int &cacheBefore, int &cacheAfter)
   }
 }
 
+void CGUIBaseContainer::PreloadArt(int offset, int firstItem, int itemsPerPage, int cacheItems)
+{
+  if (!m_layout || itemsPerPage <= 0 || (int)m_items.size() <= itemsPerPage + cacheItems)
+    return;
+
+  // we only look ahead while moving
+  if (offset == m_preloadOffset)
+    return;
+
+  int direction = (offset > m_preloadOffset) ? 1 : -1;
+  int moved = abs(offset - m_preloadOffset);
+  bool wrapped = (firstItem - m_preloadItem) * direction < 0;
+  float elapsed = m_preloadTimer.IsRunning() ? m_preloadTimer.GetElapsedSeconds() : 0.0f;
+  m_preloadTimer.StartZero();
+  m_preloadOffset = offset;
+  m_preloadItem = firstItem;
+
+  if (direction != m_preloadDirection)
+  { // changed direction - what we were preloading is now behind us
+    if (m_preloadDirection)
+      g_largeTextureManager.CancelPreloads(this);
+    m_preloadDirection = direction;
+    m_preloadEnd = firstItem;
+  }
+  else if (wrapped)
+  { // a wrapping list came round to the other end, keep going from there
+    m_preloadEnd = firstItem;
+  }
+
+  // look further ahead the faster we're moving
+  float pagesPerSecond = (elapsed > 0.0f) ? moved / (elapsed * itemsPerPage) : 0.0f;
+  int pages = std::min(PRELOAD_MAX_PAGES, 1 + (int)pagesPerSecond);
+
+  int start, end;
+  if (direction > 0)
+  {
+    start = std::max(firstItem + itemsPerPage + cacheItems, m_preloadEnd + 1);
+    end = std::min(firstItem + itemsPerPage + cacheItems + pages * itemsPerPage, (int)m_items.size() - 1);
+  }
+  else
+  {
+    start = std::max(firstItem - cacheItems - pages * itemsPerPage, 0);
+    end = std::min(firstItem - cacheItems, m_preloadEnd - 1);
+  }
+  if (start > end)
+    return;
+
+  std::vector<CStdString> images;
+  for (int i = start; i <= end; i++)
+  {
+    images.clear();
+    m_layout->GetBackgroundImages(m_items[i].get(), images);
+    for (std::vector<CStdString>::const_iterator image = images.begin(); image != images.end(); ++image)
+      g_largeTextureManager.PreloadImage(*image, this);
+  }
+  m_preloadEnd = (direction > 0) ? end : start;
+}
+
 void CGUIBaseContainer::SetCursor(int cursor)
 {
   m_cursor = cursor;
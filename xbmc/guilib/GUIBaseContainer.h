@@ -182,6 +182,16 @@ protected:
 
   void UpdateScrollByLetter();
   void GetCacheOffsets(int &cacheBefore, int &cacheAfter);
+
+  /*! \brief Preload the artwork of items we're scrolling towards
+   Looks at the direction and speed the first visible item is moving at, and queues background
+   loading of the art in the next few pages beyond the cached items.
+   \param offset scroll offset in items, not wrapped around, so that wrapping doesn't reverse direction
+   \param firstItem index of the first visible item
+   \param itemsPerPage number of items visible on a page
+   \param cacheItems number of items beyond the page that are already processed (and thus loaded)
+   */
+  void PreloadArt(int offset, int firstItem, int itemsPerPage, int cacheItems);
   int GetCacheCount() const { return m_cacheItems; };
   bool ScrollingDown() const { return m_scroller.IsScrollingDown(); };
   bool ScrollingUp() const { return m_scroller.IsScrollingUp(); };
@@ -210,6 +220,13 @@ private:
   int m_offset;
   int m_cacheItems;
   CStopWatch m_scrollTimer;
+
+  // art preloading
+  int m_preloadOffset;     ///< scroll offset when we last preloaded
+  int m_preloadItem;       ///< first visible item when we last preloaded
+  int m_preloadDirection;  ///< direction we're scrolling in (1 down, -1 up, 0 not yet known)
+  int m_preloadEnd;        ///< furthest item we've preloaded in m_preloadDirection
+  CStopWatch m_preloadTimer;
   CStopWatch m_lastScrollStartTimer;
   CStopWatch m_pageChangeTimer;
 
@@ -22,6 +22,7 @@
 #include "GUIFont.h"
 #include "GUIFontTTFGL.h"
 #include "GUIFontManager.h"
+#include "GUIQuadBatchGL.h"
 #include "Texture.h"
 #include "TextureManager.h"
 #include "GraphicContext.h"
@@ -54,6 +55,10 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0)
   {
+#ifdef HAS_GL
+    // texture quads queued so far must be drawn before we change the GL state
+    CGUIQuadBatchGL::Get().Flush();
+#endif
     if (!m_bTextureLoaded)
     {
       // Have OpenGL generate a texture object handle for us
@@ -145,6 +150,7 @@ void CGUIFontTTFGL::End()
   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
   glDrawArrays(GL_QUADS, 0, m_vertex_count);
   glPopClientAttrib();
+  CGUIQuadBatchGL::Get().CountDraw(m_vertex_count);
 
   glBindTexture(GL_TEXTURE_2D, 0);
   glActiveTexture(GL_TEXTURE0);
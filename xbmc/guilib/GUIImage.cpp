@@ -22,6 +22,7 @@
 #include "TextureManager.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
+#include "URL.h"
 
 using namespace std;
 
@@ -77,6 +78,22 @@ void CGUIImage::UpdateInfo(const CGUIListItem *item)
     SetFileName(m_info.GetLabel(m_parentID, true, &m_currentFallback));
 }
 
+CStdString CGUIImage::GetBackgroundImage(const CGUIListItem *item) const
+{
+  if (m_info.IsConstant() || !item)
+    return "";
+
+  CStdString fallback;
+  CStdString image = m_info.GetItemLabel(item, true, &fallback);
+  if (image.IsEmpty() || !CURL::IsFullPath(image))
+    return "";
+
+  if (m_texture.IsLazyLoaded() || !g_TextureManager.CanLoad(image))
+    return image;
+
+  return "";
+}
+
 void CGUIImage::AllocateOnDemand()
 {
   // if we're hidden, we can free our resources and return
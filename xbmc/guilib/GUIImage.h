@@ -89,6 +89,12 @@ public:
   void SetCrossFade(unsigned int time);
 
   const CStdString& GetFileName() const;
+
+  /*! \brief Get the image this control would load in the background for the given item
+   \param item the list item to evaluate our info against.
+   \return the path of the image, or an empty string if it would not be loaded by the large texture manager.
+   */
+  CStdString GetBackgroundImage(const CGUIListItem *item) const;
   float GetTextureWidth() const;
   float GetTextureHeight() const;
 
@@ -96,6 +96,23 @@ void CGUIListGroup::UpdateVisibility(const CGUIListItem *item)
   m_item = item;
 }
 
+void CGUIListGroup::GetBackgroundImages(const CGUIListItem *item, std::vector<CStdString> &images) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    const CGUIControl *control = *it;
+    if (control->GetControlType() == CGUIControl::GUICONTROL_IMAGE ||
+        control->GetControlType() == CGUIControl::GUICONTROL_BORDEREDIMAGE)
+    {
+      CStdString image = ((const CGUIImage *)control)->GetBackgroundImage(item);
+      if (!image.IsEmpty())
+        images.push_back(image);
+    }
+    else if (control->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+      ((const CGUIListGroup *)control)->GetBackgroundImages(item, images);
+  }
+}
+
 void CGUIListGroup::UpdateInfo(const CGUIListItem *item)
 {
   for (iControls it = m_children.begin(); it != m_children.end(); it++)
@@ -47,6 +47,11 @@ public:
   virtual void UpdateInfo(const CGUIListItem *item);
   virtual void SetInvalid();
 
+  /*! \brief Get the images our controls would load in the background for the given item
+   \sa CGUIImage::GetBackgroundImage
+   */
+  void GetBackgroundImages(const CGUIListItem *item, std::vector<CStdString> &images) const;
+
   void EnlargeWidth(float difference);
   void EnlargeHeight(float difference);
   void SetFocusedItem(unsigned int subfocus);
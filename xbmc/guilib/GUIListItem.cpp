@@ -23,9 +23,111 @@
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/Variant.h"
+#include "threads/SharedSection.h"
+
+#include <algorithm>
+#include <deque>
+#include <string.h>
 
 using namespace std;
 
+namespace
+{
+  struct NoCaseLess
+  {
+    bool operator()(const string &s1, const string &s2) const
+    {
+      return strcasecmp(s1.c_str(), s2.c_str()) < 0;
+    }
+  };
+
+  /*! \brief Process wide table of the names used for properties and art.
+   Each distinct name is stored once and items refer to it by its index. Names
+   are never removed, the number of distinct keys is small and bounded by what
+   the code and skins use.
+   */
+  template<class Compare>
+  class CKeyTable
+  {
+  public:
+    unsigned int Intern(const string &name)
+    {
+      unsigned int key;
+      if (Find(name, key))
+        return key;
+
+      CExclusiveLock lock(m_lock);
+      pair<typename KeyMap::iterator, bool> res = m_keys.insert(make_pair(name, (unsigned int)m_names.size()));
+      if (res.second)
+        m_names.push_back(name);
+      return res.first->second;
+    }
+
+    bool Find(const string &name, unsigned int &key) const
+    {
+      CSharedLock lock(m_lock);
+      typename KeyMap::const_iterator i = m_keys.find(name);
+      if (i == m_keys.end())
+        return false;
+      key = i->second;
+      return true;
+    }
+
+    const string &Name(unsigned int key) const
+    {
+      // deque never moves its elements, so the reference stays valid
+      CSharedLock lock(m_lock);
+      return m_names[key];
+    }
+
+  private:
+    typedef map<string, unsigned int, Compare> KeyMap;
+    KeyMap m_keys;
+    deque<string> m_names;
+    mutable CSharedSection m_lock;
+  };
+
+  // property names are case insensitive, the spelling first seen is the one reported
+  CKeyTable<NoCaseLess> g_propertyKeys;
+  CKeyTable<less<string> > g_artKeys;
+
+  struct KeyLess
+  {
+    template<class T>
+    bool operator()(const pair<unsigned int, T> &entry, unsigned int key) const { return entry.first < key; }
+  };
+
+  template<class T>
+  typename vector<pair<unsigned int, T> >::iterator FindEntry(vector<pair<unsigned int, T> > &list, unsigned int key)
+  {
+    typename vector<pair<unsigned int, T> >::iterator i = lower_bound(list.begin(), list.end(), key, KeyLess());
+    return (i != list.end() && i->first == key) ? i : list.end();
+  }
+
+  template<class T>
+  typename vector<pair<unsigned int, T> >::const_iterator FindEntry(const vector<pair<unsigned int, T> > &list, unsigned int key)
+  {
+    typename vector<pair<unsigned int, T> >::const_iterator i = lower_bound(list.begin(), list.end(), key, KeyLess());
+    return (i != list.end() && i->first == key) ? i : list.end();
+  }
+
+  /*! \brief Set the value for a key, returns false if it already had that value */
+  template<class T>
+  bool SetEntry(vector<pair<unsigned int, T> > &list, unsigned int key, const T &value)
+  {
+    typename vector<pair<unsigned int, T> >::iterator i = lower_bound(list.begin(), list.end(), key, KeyLess());
+    if (i != list.end() && i->first == key)
+    {
+      if (i->second == value)
+        return false;
+      i->second = value;
+    }
+    else
+      list.insert(i, make_pair(key, value));
+    return true;
+  }
+}
+
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
   m_layout = NULL;
@@ -111,23 +213,22 @@ const CStdStringW& CGUIListItem::GetSortLabel() const
 
 void CGUIListItem::SetArt(const std::string &type, const std::string &url)
 {
-  ArtMap::iterator i = m_art.find(type);
-  if (i == m_art.end() || i->second != url)
-  {
-    m_art[type] = url;
+  if (SetEntry(m_art, g_artKeys.Intern(type), url))
     SetInvalid();
-  }
 }
 
 void CGUIListItem::SetArt(const ArtMap &art)
 {
-  m_art = art;
+  m_art.clear();
+  m_art.reserve(art.size());
+  for (ArtMap::const_iterator i = art.begin(); i != art.end(); ++i)
+    SetEntry(m_art, g_artKeys.Intern(i->first), i->second);
   SetInvalid();
 }
 
 void CGUIListItem::SetArtFallback(const std::string &from, const std::string &to)
 {
-  m_artFallbacks[from] = to;
+  SetEntry(m_artFallbacks, g_artKeys.Intern(from), g_artKeys.Intern(to));
 }
 
 void CGUIListItem::ClearArt()
@@ -144,22 +245,34 @@ void CGUIListItem::AppendArt(const ArtMap &art, const std::string &prefix)
 
 std::string CGUIListItem::GetArt(const std::string &type) const
 {
-  ArtMap::const_iterator i = m_art.find(type);
+  unsigned int key;
+  if (!g_artKeys.Find(type, key))
+    return ""; // nothing has ever been set for this type
+
+  ArtList::const_iterator i = FindEntry(m_art, key);
   if (i != m_art.end())
     return i->second;
-  i = m_artFallbacks.find(type);
-  if (i != m_artFallbacks.end())
+  ArtFallbackList::const_iterator j = FindEntry(m_artFallbacks, key);
+  if (j != m_artFallbacks.end())
   {
-    ArtMap::const_iterator j = m_art.find(i->second);
-    if (j != m_art.end())
-      return j->second;
+    i = FindEntry(m_art, j->second);
+    if (i != m_art.end())
+      return i->second;
   }
   return "";
 }
 
-const CGUIListItem::ArtMap &CGUIListItem::GetArt() const
+CGUIListItem::ArtMap CGUIListItem::GetArt() const
 {
-  return m_art;
+  ArtMap art;
+  for (ArtList::const_iterator i = m_art.begin(); i != m_art.end(); ++i)
+    art.insert(make_pair(g_artKeys.Name(i->first), i->second));
+  return art;
+}
+
+bool CGUIListItem::HasArt() const
+{
+  return !m_art.empty();
 }
 
 bool CGUIListItem::HasArt(const std::string &type) const
@@ -245,7 +358,7 @@ const CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_strIcon = item.m_strIcon;
   m_overlayIcon = item.m_overlayIcon;
   m_bIsFolder = item.m_bIsFolder;
-  m_mapProperties = item.m_mapProperties;
+  m_properties = item.m_properties;
   m_art = item.m_art;
   m_artFallbacks = item.m_artFallbacks;
   SetInvalid();
@@ -263,23 +376,23 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << m_strIcon;
     ar << m_bSelected;
     ar << m_overlayIcon;
-    ar << (int)m_mapProperties.size();
-    for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
+    ar << (int)m_properties.size();
+    for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); it++)
     {
-      ar << it->first;
+      ar << g_propertyKeys.Name(it->first);
       ar << it->second;
     }
     ar << (int)m_art.size();
-    for (ArtMap::const_iterator i = m_art.begin(); i != m_art.end(); i++)
+    for (ArtList::const_iterator i = m_art.begin(); i != m_art.end(); i++)
     {
-      ar << i->first;
+      ar << g_artKeys.Name(i->first);
       ar << i->second;
     }
     ar << (int)m_artFallbacks.size();
-    for (ArtMap::const_iterator i = m_artFallbacks.begin(); i != m_artFallbacks.end(); i++)
+    for (ArtFallbackList::const_iterator i = m_artFallbacks.begin(); i != m_artFallbacks.end(); i++)
     {
-      ar << i->first;
-      ar << i->second;
+      ar << g_artKeys.Name(i->first);
+      ar << g_artKeys.Name(i->second);
     }
   }
   else
@@ -311,7 +424,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_art.insert(make_pair(key, value));
+      SetEntry(m_art, g_artKeys.Intern(key), value);
     }
     ar >> mapSize;
     for (int i = 0; i < mapSize; i++)
@@ -319,7 +432,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_artFallbacks.insert(make_pair(key, value));
+      SetArtFallback(key, value);
     }
   }
 }
@@ -332,12 +445,12 @@ void CGUIListItem::Serialize(CVariant &value)
   value["strIcon"] = m_strIcon;
   value["selected"] = m_bSelected;
 
-  for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
+  for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); it++)
   {
-    value["properties"][it->first] = it->second;
+    value["properties"][g_propertyKeys.Name(it->first)] = it->second;
   }
-  for (ArtMap::const_iterator it = m_art.begin(); it != m_art.end(); it++)
-    value["art"][it->first] = it->second;
+  for (ArtList::const_iterator it = m_art.begin(); it != m_art.end(); it++)
+    value["art"][g_artKeys.Name(it->first)] = it->second;
 }
 
 void CGUIListItem::FreeIcons()
@@ -394,13 +507,22 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const CStdString &strKey, const CVariant &value)
 {
-  m_mapProperties[strKey] = value;
+  unsigned int key = g_propertyKeys.Intern(strKey);
+  PropertyList::iterator i = lower_bound(m_properties.begin(), m_properties.end(), key, KeyLess());
+  if (i != m_properties.end() && i->first == key)
+    i->second = value;
+  else
+    m_properties.insert(i, make_pair(key, value));
 }
 
 CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  unsigned int key;
+  if (!g_propertyKeys.Find(strKey, key))
+    return CVariant(CVariant::VariantTypeNull);
+
+  PropertyList::const_iterator iter = FindEntry(m_properties, key);
+  if (iter == m_properties.end())
     return CVariant(CVariant::VariantTypeNull);
 
   return iter->second;
@@ -408,23 +530,32 @@ CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
 
 bool CGUIListItem::HasProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  unsigned int key;
+  if (!g_propertyKeys.Find(strKey, key))
     return false;
 
-  return true;
+  return FindEntry(m_properties, key) != m_properties.end();
+}
+
+bool CGUIListItem::HasProperties() const
+{
+  return !m_properties.empty();
 }
 
 void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
-    m_mapProperties.erase(iter);
+  unsigned int key;
+  if (!g_propertyKeys.Find(strKey, key))
+    return;
+
+  PropertyList::iterator iter = FindEntry(m_properties, key);
+  if (iter != m_properties.end())
+    m_properties.erase(iter);
 }
 
 void CGUIListItem::ClearProperties()
 {
-  m_mapProperties.clear();
+  m_properties.clear();
 }
 
 void CGUIListItem::IncrementProperty(const CStdString &strKey, int nVal)
@@ -443,6 +574,12 @@ void CGUIListItem::IncrementProperty(const CStdString &strKey, double dVal)
 
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
-  for (PropertyMap::const_iterator i = item.m_mapProperties.begin(); i != item.m_mapProperties.end(); ++i)
-    SetProperty(i->first, i->second);
+  for (PropertyList::const_iterator i = item.m_properties.begin(); i != item.m_properties.end(); ++i)
+  {
+    PropertyList::iterator j = lower_bound(m_properties.begin(), m_properties.end(), i->first, KeyLess());
+    if (j != m_properties.end() && j->first == i->first)
+      j->second = i->second;
+    else
+      m_properties.insert(j, *i);
+  }
 }
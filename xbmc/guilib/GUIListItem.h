@@ -32,6 +32,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
@@ -119,7 +120,12 @@ public:
    \return a type:url map for artwork
    \sa SetArt
    */
-  const ArtMap &GetArt() const;
+  ArtMap GetArt() const;
+
+  /*! \brief Check whether an item has any art set
+   Equivalent to !GetArt().empty(), without building the map
+   */
+  bool HasArt() const;
 
   /*! \brief Check whether an item has a particular piece of art
    Equivalent to !GetArt(type).empty()
@@ -169,7 +175,7 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const CStdString &strKey) const;
-  bool       HasProperties() const { return m_mapProperties.size() > 0; };
+  bool       HasProperties() const;
   void       ClearProperty(const CStdString &strKey);
 
   CVariant   GetProperty(const CStdString &strKey) const;
@@ -183,22 +189,18 @@ protected:
   CGUIListItemLayout *m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
-  {
-    bool operator()(const CStdString &s1, const CStdString &s2) const
-    {
-      return s1.CompareNoCase(s2) < 0;
-    }
-  };
-
-  typedef std::map<CStdString, CVariant, icompare> PropertyMap;
-  PropertyMap m_mapProperties;
+  /* Property and art names are interned into process wide tables, so items only
+     store a small id per name. The lists are kept sorted by id. */
+  typedef std::vector<std::pair<unsigned int, CVariant> > PropertyList;
+  PropertyList m_properties;
 private:
   CStdStringW m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   CStdString m_strLabel;      // text of column1
 
-  ArtMap m_art;
-  ArtMap m_artFallbacks;
+  typedef std::vector<std::pair<unsigned int, std::string> > ArtList;
+  typedef std::vector<std::pair<unsigned int, unsigned int> > ArtFallbackList;
+  ArtList m_art;
+  ArtFallbackList m_artFallbacks;
 };
 #endif
 
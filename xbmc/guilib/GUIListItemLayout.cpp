@@ -91,6 +91,13 @@ void CGUIListItemLayout::Process(CGUIListItem *item, int parentID, unsigned int
   m_group.DoProcess(currentTime, dirtyregions);
 }
 
+void CGUIListItemLayout::GetBackgroundImages(CGUIListItem *item, std::vector<CStdString> &images) const
+{
+  // info labels evaluate art and thumbs from the fileitem, so there's nothing we can do for other items
+  if (item->IsFileItem())
+    m_group.GetBackgroundImages(item, images);
+}
+
 void CGUIListItemLayout::Render(CGUIListItem *item, int parentID)
 {
   m_group.DoRender();
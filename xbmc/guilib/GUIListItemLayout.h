@@ -45,6 +45,13 @@ public:
   void SetInvalid() { m_invalidated = true; };
   void FreeResources(bool immediately = false);
 
+  /*! \brief Get the images this layout would load in the background when showing the given item
+   Used to preload artwork for items that are about to scroll into view.
+   \param item the item to evaluate the layout against.
+   \param images [out] paths of the images.
+   */
+  void GetBackgroundImages(CGUIListItem *item, std::vector<CStdString> &images) const;
+
 //#ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
   void CreateListControlLayouts(float width, float height, bool focused, const CLabelInfo &labelInfo, const CLabelInfo &labelInfo2, const CTextureInfo &texture, const CTextureInfo &textureFocus, float texHeight, float iconWidth, float iconHeight, const CStdString &nofocusCondition, const CStdString &focusCondition);
 //#endif
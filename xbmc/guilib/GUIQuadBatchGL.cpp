@@ -0,0 +1,192 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIQuadBatchGL.h"
+
+#if defined(HAS_GL)
+
+#include "utils/GLUtils.h"
+#include "windowing/WindowingFactory.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+CGUIQuadBatchGL::CGUIQuadBatchGL()
+{
+  m_texture = 0;
+  m_diffuse = 0;
+  m_limitedColor = false;
+  m_drawCalls = 0;
+  m_vertexCount = 0;
+  m_lastDrawCalls = 0;
+  m_lastVertices = 0;
+  m_vertices.reserve(4 * 256);
+}
+
+CGUIQuadBatchGL &CGUIQuadBatchGL::Get()
+{
+  static CGUIQuadBatchGL batch;
+  return batch;
+}
+
+void CGUIQuadBatchGL::SetState(GLuint texture, GLuint diffuse)
+{
+  bool limitedColor = g_Windowing.UseLimitedColor();
+  if (texture == m_texture && diffuse == m_diffuse && limitedColor == m_limitedColor)
+    return;
+
+  Flush();
+  m_texture = texture;
+  m_diffuse = diffuse;
+  m_limitedColor = limitedColor;
+}
+
+CGUIQuadBatchGL::Vertex *CGUIQuadBatchGL::AddQuad()
+{
+  size_t size = m_vertices.size();
+  m_vertices.resize(size + 4);
+  return &m_vertices[size];
+}
+
+void CGUIQuadBatchGL::OnTextureChanged(GLuint texture)
+{
+  if (texture && (texture == m_texture || texture == m_diffuse))
+    Flush();
+}
+
+void CGUIQuadBatchGL::Flush()
+{
+  if (m_vertices.empty())
+    return;
+
+  // a texture deleted while its quads were batched, see OnTextureChanged()
+  assert(glIsTexture(m_texture) && (!m_diffuse || glIsTexture(m_diffuse)));
+
+  int unit = 0;
+  glActiveTexture(GL_TEXTURE0 + unit++);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glEnable(GL_TEXTURE_2D);
+
+  glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+  glEnable(GL_BLEND);          // Turn Blending On
+  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+  // diffuse coloring
+  glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PRIMARY_COLOR);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
+
+  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
+  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
+  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
+  VerifyGLState();
+
+  if (m_diffuse)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit++);
+    glBindTexture(GL_TEXTURE_2D, m_diffuse);
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PREVIOUS);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
+
+    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
+    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PREVIOUS);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
+    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
+    VerifyGLState();
+  }
+
+  if (m_limitedColor)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit++);
+    glBindTexture(GL_TEXTURE_2D, m_texture); // dummy bind
+    glEnable(GL_TEXTURE_2D);
+    const GLfloat rgba[4] = {16.0f / 255.0f, 16.0f / 255.0f, 16.0f / 255.0f, 0.0f};
+    glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE , GL_COMBINE);
+    glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, rgba);
+    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_RGB      , GL_ADD);
+    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_RGB      , GL_PREVIOUS);
+    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE1_RGB      , GL_CONSTANT);
+    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND0_RGB     , GL_SRC_COLOR);
+    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND1_RGB     , GL_SRC_COLOR);
+
+    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_ALPHA    , GL_REPLACE);
+    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_ALPHA    , GL_PREVIOUS);
+    VerifyGLState();
+  }
+
+  const char *base = (const char *)&m_vertices[0];
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, x));
+  glColorPointer (4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, r));
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+
+  glClientActiveTexture(GL_TEXTURE0);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, u1));
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  if (m_diffuse)
+  {
+    glClientActiveTexture(GL_TEXTURE1);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, u2));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  }
+
+  glDrawArrays(GL_QUADS, 0, m_vertices.size());
+  glPopClientAttrib();
+  glClientActiveTexture(GL_TEXTURE0);
+
+  // leave the texture units the way CGUITextureGL::End() used to
+  while (unit-- > 0)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glDisable(GL_TEXTURE_2D);
+  }
+
+  CountDraw(m_vertices.size());
+  m_vertices.clear();
+}
+
+void CGUIQuadBatchGL::CountDraw(unsigned int vertices)
+{
+  m_drawCalls++;
+  m_vertexCount += vertices;
+}
+
+void CGUIQuadBatchGL::EndFrame()
+{
+  Flush();
+  m_lastDrawCalls = m_drawCalls;
+  m_lastVertices = m_vertexCount;
+  m_drawCalls = 0;
+  m_vertexCount = 0;
+}
+
+#endif
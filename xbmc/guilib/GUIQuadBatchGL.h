@@ -0,0 +1,106 @@
+/*!
+\file GUIQuadBatchGL.h
+\brief
+*/
+
+#ifndef GUILIB_GUIQUADBATCHGL_H
+#define GUILIB_GUIQUADBATCHGL_H
+
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#if defined(HAS_GL)
+
+#include "system_gl.h"
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Collects GUI texture quads that share the same GL state and submits them in one draw.
+
+ Controls render in painter's order, so quads are never reordered. Consecutive quads
+ using the same texture, diffuse texture and color range are appended to a shared
+ vertex array and drawn with a single glDrawArrays() once the state changes, or when
+ anything else is about to touch the GL state (fonts, scissors, transforms, raw GL
+ rendering in players and visualisations, the end of a window layer or of the frame).
+ */
+class CGUIQuadBatchGL
+{
+public:
+  struct Vertex
+  {
+    float x, y, z;
+    unsigned char r, g, b, a;
+    float u1, v1;
+    float u2, v2;
+  };
+
+  static CGUIQuadBatchGL &Get();
+
+  /*! \brief Select the GL state for the following quads, flushing the batch if it differs
+   \param texture GL texture object for unit 0
+   \param diffuse GL texture object for unit 1, or 0 for none
+   */
+  void SetState(GLuint texture, GLuint diffuse);
+
+  /*! \brief Reserve room for a quad in the current batch
+   \return pointer to 4 vertices to be filled in by the caller
+   */
+  Vertex *AddQuad();
+
+  /*! \brief Submit all pending quads */
+  void Flush();
+
+  /*! \brief Submit pending quads that use a texture object about to be deleted or re-uploaded
+   The batch binds its textures only when flushed, so it must not outlive their contents.
+   \param texture GL texture object that is changing
+   */
+  void OnTextureChanged(GLuint texture);
+
+  /*! \brief Account for a draw issued outside of the batch, so counters cover the whole frame */
+  void CountDraw(unsigned int vertices);
+
+  /*! \brief Finish the frame, flushing pending quads and latching the frame counters */
+  void EndFrame();
+
+  unsigned int GetDrawCalls() const { return m_lastDrawCalls; };
+  unsigned int GetVertices() const { return m_lastVertices; };
+
+private:
+  CGUIQuadBatchGL();
+
+  std::vector<Vertex> m_vertices;
+  GLuint m_texture;
+  GLuint m_diffuse;
+  bool m_limitedColor;
+
+  unsigned int m_drawCalls;
+  unsigned int m_vertexCount;
+  unsigned int m_lastDrawCalls;
+  unsigned int m_lastVertices;
+};
+
+#endif
+
+#endif
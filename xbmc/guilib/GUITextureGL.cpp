@@ -21,6 +21,7 @@
 #include "system.h"
 #if defined(HAS_GL)
 #include "GUITextureGL.h"
+#include "GUIQuadBatchGL.h"
 #endif
 #include "Texture.h"
 #include "utils/log.h"
@@ -38,7 +39,7 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
 
 void CGUITextureGL::Begin(color_t color)
 {
-  int range, unit = 0;
+  int range;
   if(g_Windowing.UseLimitedColor())
     range = 235 - 16;
   else
@@ -54,125 +55,79 @@ void CGUITextureGL::Begin(color_t color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(unit++);
-
-  glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_BLEND);          // Turn Blending On
-  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-  // diffuse coloring
-  glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PRIMARY_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
-
-  glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
-  glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
-  glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
-  VerifyGLState();
-
-  if (m_diffuse.size())
-  {
-    m_diffuse.m_textures[0]->BindToUnit(unit++);
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PREVIOUS);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
-
-    glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE);
-    glTexEnvf(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PREVIOUS);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
-    glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
-    VerifyGLState();
-  }
-
-  if(g_Windowing.UseLimitedColor())
-  {
-    texture->BindToUnit(unit++); // dummy bind
-    const GLfloat rgba[4] = {16.0f / 255.0f, 16.0f / 255.0f, 16.0f / 255.0f, 0.0f};
-    glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE , GL_COMBINE);
-    glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, rgba);
-    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_RGB      , GL_ADD);
-    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_RGB      , GL_PREVIOUS);
-    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE1_RGB      , GL_CONSTANT);
-    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND0_RGB     , GL_SRC_COLOR);
-    glTexEnvi (GL_TEXTURE_ENV, GL_OPERAND1_RGB     , GL_SRC_COLOR);
-
-    glTexEnvi (GL_TEXTURE_ENV, GL_COMBINE_ALPHA    , GL_REPLACE);
-    glTexEnvi (GL_TEXTURE_ENV, GL_SOURCE0_ALPHA    , GL_PREVIOUS);
-    VerifyGLState();
-  }
-
-  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-  //glBegin(GL_LINE_LOOP);
-  glBegin(GL_QUADS);
+  // quads are queued and drawn together with those of following textures sharing the same state
+  CGUIQuadBatchGL::Get().SetState(static_cast<CGLTexture*>(texture)->GetTextureObject(),
+                                  m_diffuse.size() ? static_cast<CGLTexture*>(m_diffuse.m_textures[0])->GetTextureObject() : 0);
 }
 
 void CGUITextureGL::End()
 {
-  glEnd();
-  if (m_diffuse.size())
-    glDisable(GL_TEXTURE_2D);
-  glActiveTexture(GL_TEXTURE0_ARB);
-  glDisable(GL_TEXTURE_2D);
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
+  CGUIQuadBatchGL::Vertex *v = CGUIQuadBatchGL::Get().AddQuad();
+  for (int i = 0; i < 4; i++)
+  {
+    v[i].x = x[i];
+    v[i].y = y[i];
+    v[i].z = z[i];
+    v[i].r = m_col[0];
+    v[i].g = m_col[1];
+    v[i].b = m_col[2];
+    v[i].a = m_col[3];
+  }
+
   // Top-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y1);
-  glVertex3f(x[0], y[0], z[0]);
+  v[0].u1 = texture.x1; v[0].v1 = texture.y1;
+  v[0].u2 = diffuse.x1; v[0].v2 = diffuse.y1;
 
   // Top-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
+  {
+    v[1].u1 = texture.x1; v[1].v1 = texture.y2;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  if (m_diffuse.size())
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
+    v[1].u1 = texture.x2; v[1].v1 = texture.y1;
+  }
+  if (m_info.orientation & 4)
+  {
+    v[1].u2 = diffuse.x1; v[1].v2 = diffuse.y2;
+  }
+  else
+  {
+    v[1].u2 = diffuse.x2; v[1].v2 = diffuse.y1;
   }
-  glVertex3f(x[1], y[1], z[1]);
 
   // Bottom-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y2);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y2);
-  glVertex3f(x[2], y[2], z[2]);
+  v[2].u1 = texture.x2; v[2].v1 = texture.y2;
+  v[2].u2 = diffuse.x2; v[2].v2 = diffuse.y2;
 
   // Bottom-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
+  {
+    v[3].u1 = texture.x2; v[3].v1 = texture.y1;
+  }
   else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  if (m_diffuse.size())
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
+    v[3].u1 = texture.x1; v[3].v1 = texture.y2;
+  }
+  if (m_info.orientation & 4)
+  {
+    v[3].u2 = diffuse.x2; v[3].v2 = diffuse.y1;
+  }
+  else
+  {
+    v[3].u2 = diffuse.x1; v[3].v2 = diffuse.y2;
   }
-  glVertex3f(x[3], y[3], z[3]);
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUIQuadBatchGL::Get().Flush();
+  CGUIQuadBatchGL::Get().CountDraw(4);
+
   if (texture)
   {
     texture->LoadToGPU();
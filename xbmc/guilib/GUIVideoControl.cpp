@@ -21,6 +21,7 @@
 #include "system.h"
 #include "GUIVideoControl.h"
 #include "GUIWindowManager.h"
+#include "GUIQuadBatchGL.h"
 #include "Application.h"
 #include "Key.h"
 #include "WindowIDs.h"
@@ -65,6 +66,9 @@ void CGUIVideoControl::Render()
       g_application.ResetScreenSaver();
 
     g_graphicsContext.SetViewWindow(m_posX, m_posY, m_posX + m_width, m_posY + m_height);
+#if defined(HAS_GL)
+    CGUIQuadBatchGL::Get().Flush();
+#endif
 
 #ifdef HAS_VIDEO_PLAYBACK
     color_t alpha = g_graphicsContext.MergeAlpha(0xFF000000) >> 24;
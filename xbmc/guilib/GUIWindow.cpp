@@ -41,6 +41,7 @@
 #include "Application.h"
 #include "ApplicationMessenger.h"
 #include "utils/Variant.h"
+#include "TextureManager.h"
 
 #ifdef HAS_PERFORMANCE_SAMPLE
 #include "utils/PerformanceSample.h"
@@ -48,6 +49,22 @@
 
 using namespace std;
 
+// collect the static texture names used by the controls in a (resolved) window xml
+static void GetTexturesFromXML(const TiXmlElement *element, vector<CStdString> &textures)
+{
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    if (strstr(child->Value(), "texture") && child->FirstChild())
+    {
+      CStdString texture = child->FirstChild()->Value();
+      if (!texture.IsEmpty() && texture.Find('$') < 0)
+        textures.push_back(texture);
+    }
+    else
+      GetTexturesFromXML(child, textures);
+  }
+}
+
 CGUIWindow::CGUIWindow(int id, const CStdString &xmlFile)
 {
   SetID(id);
@@ -168,6 +185,12 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
 
   // Resolve any includes that may be present and save conditions used to do it
   g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+
+  // get the bundled textures unpacking in the background while the controls are created
+  vector<CStdString> textures;
+  GetTexturesFromXML(pRootElement, textures);
+  g_TextureManager.PrefetchTextures(textures);
+
   // now load in the skin file
   SetDefaults();
 
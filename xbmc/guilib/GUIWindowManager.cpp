@@ -774,6 +774,9 @@ void CGUIWindowManager::SendThreadMessage(CGUIMessage& message, int window /*= 0
 
   CGUIMessage* msg = new CGUIMessage(message);
   m_vecThreadMessages.push_back( pair<CGUIMessage*,int>(msg,window) );
+  lock.Leave();
+
+  g_application.WakeRenderLoop();
 }
 
 void CGUIWindowManager::DispatchThreadMessages()
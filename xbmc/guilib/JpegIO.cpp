@@ -29,6 +29,8 @@
 #include "JpegIO.h"
 
 #include <setjmp.h>
+#include <math.h>
+#include <algorithm>
 
 #define EXIF_TAG_ORIENTATION    0x0112
 
@@ -354,17 +356,28 @@ bool CJpegIO::Read(unsigned char* buffer, unsigned int bufSize, unsigned int min
     to decode a bigger one just to squish it back down. If the res is greater than
     the gpu can hold, use the previous one.*/
     if (minx == 0 || miny == 0)
-    {
-      miny = g_advancedSettings.m_imageRes;
-      if (g_advancedSettings.m_fanartRes > g_advancedSettings.m_imageRes)
-      { // a separate fanart resolution is specified - check if the image is exactly equal to this res
-        if (m_cinfo.image_width == (unsigned int)g_advancedSettings.m_fanartRes * 16/9 &&
-            m_cinfo.image_height == (unsigned int)g_advancedSettings.m_fanartRes)
-        { // special case for fanart res
-          miny = g_advancedSettings.m_fanartRes;
-        }
+    { // no size given, so decode for the texture cache: work out the size CPicture::CacheTexture()
+      // will scale the image to (fitted to the image or fanart res, keeping aspect) and decode
+      // at the smallest scale that covers that.
+      unsigned int width = m_cinfo.image_width;
+      unsigned int height = m_cinfo.image_height;
+      unsigned int maxHeight = g_advancedSettings.m_imageRes;
+      if (g_advancedSettings.m_fanartRes > g_advancedSettings.m_imageRes && height)
+      { // 16x9 images larger than the fanart res use that rather than the image res
+        if (fabsf((float)width / (float)height / (16.0f/9.0f) - 1.0f) <= 0.01f && height >= (unsigned int)g_advancedSettings.m_fanartRes)
+          maxHeight = g_advancedSettings.m_fanartRes;
+      }
+      unsigned int maxWidth = maxHeight * 16/9;
+
+      minx = std::min(width, maxWidth);
+      miny = std::min(height, maxHeight);
+      if (width && height)
+      {
+        if ((uint64_t)width * miny > (uint64_t)height * minx)
+          miny = (unsigned int)((uint64_t)height * minx / width);
+        else
+          minx = (unsigned int)((uint64_t)width * miny / height);
       }
-      minx = miny * 16/9;
     }
 
     m_cinfo.scale_denom = 8;
@@ -385,6 +398,10 @@ bool CJpegIO::Read(unsigned char* buffer, unsigned int bufSize, unsigned int min
     m_width  = m_cinfo.output_width;
     m_height = m_cinfo.output_height;
 
+    // when libjpeg is scaling down for us the chroma detail is lost anyway, so skip the fancy upsampling
+    if (m_cinfo.scale_num < m_cinfo.scale_denom)
+      m_cinfo.do_fancy_upsampling = FALSE;
+
     if (m_cinfo.marker_list)
       m_orientation = GetExifOrientation(m_cinfo.marker_list->data, m_cinfo.marker_list->data_length);
     return true;
@@ -406,14 +423,31 @@ bool CJpegIO::Decode(const unsigned char *pixels, unsigned int pitch, unsigned i
   }
   else
   {
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo can output straight into our texture format, saving the intermediate row and swizzle
+    if (format == XB_FMT_A8R8G8B8)
+      m_cinfo.out_color_space = JCS_EXT_BGRA;
+#endif
     jpeg_start_decompress(&m_cinfo);
 
+#ifdef JCS_EXTENSIONS
+    if (format == XB_FMT_RGB8 || format == XB_FMT_A8R8G8B8)
+#else
     if (format == XB_FMT_RGB8)
+#endif
     {
+      // hand libjpeg as many rows at once as it can produce, so it needn't buffer internally
+      JSAMPROW rows[16];
+      unsigned int maxRows = std::min(std::max(m_cinfo.rec_outbuf_height, 1), 16);
       while (m_cinfo.output_scanline < m_height)
       {
-        jpeg_read_scanlines(&m_cinfo, &dst, 1);
-        dst += pitch;
+        unsigned int count = std::min(maxRows, m_height - m_cinfo.output_scanline);
+        for (unsigned int i = 0; i < count; i++)
+          rows[i] = dst + i * pitch;
+        unsigned int read = jpeg_read_scanlines(&m_cinfo, rows, count);
+        if (!read)
+          break;
+        dst += read * pitch;
       }
     }
     else if (format == XB_FMT_A8R8G8B8)
@@ -36,10 +36,34 @@
 #pragma comment(lib,"liblzo2.lib")
 #endif
 
+// upper bound on unpacked texture data held for textures that have not been requested yet
+#define XBT_PREFETCH_MAX_SIZE (32 * 1024 * 1024)
+
+class CXBTFPrefetchJob : public CJob
+{
+public:
+  CXBTFPrefetchJob(CTextureBundleXBT *bundle, const CXBTFFrame &frame)
+  : m_bundle(bundle), m_frame(frame)
+  {
+  }
+
+  virtual const char *GetType() const { return "xbtprefetch"; }
+  virtual bool DoWork()
+  {
+    return m_bundle->PrefetchFrame(m_frame);
+  }
+
+private:
+  CTextureBundleXBT *m_bundle;
+  CXBTFFrame         m_frame;
+};
+
 CTextureBundleXBT::CTextureBundleXBT(void)
+: CJobQueue(false, 2, CJob::PRIORITY_NORMAL)
 {
   m_themeBundle = false;
   m_TimeStamp = 0;
+  m_prefetchedSize = 0;
 }
 
 CTextureBundleXBT::~CTextureBundleXBT(void)
@@ -51,6 +75,8 @@ bool CTextureBundleXBT::OpenBundle()
 {
   Cleanup();
 
+  CExclusiveLock lock(m_readerSection);
+
   // Find the correct texture file (skin or theme)
   CStdString strPath;
 
@@ -191,58 +217,157 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
   return nTextures;
 }
 
-bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
+void CTextureBundleXBT::PrefetchTextures(const std::vector<CStdString> &textures)
 {
-  // found texture - allocate the necessary buffers
-  squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  // anything still here from the previous window was never asked for, so don't let it pin memory
+  CancelJobs();
+  ClearPrefetched();
+
+  CSharedLock readerLock(m_readerSection);
+  if (!m_XBTFReader.IsOpen())
+    return;
+
+  uint64_t queued = 0;
+  for (std::vector<CStdString>::const_iterator i = textures.begin(); i != textures.end(); ++i)
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
+    CXBTFFile* file = m_XBTFReader.Find(*i);
+    if (!file)
+      continue;
+
+    std::vector<CXBTFFrame>& frames = file->GetFrames();
+    for (std::vector<CXBTFFrame>::const_iterator frame = frames.begin(); frame != frames.end(); ++frame)
+    {
+      // get the pages coming in from disk either way
+      m_XBTFReader.Prefetch(*frame);
+
+      if (!frame->IsPacked() || queued + frame->GetUnpackedSize() > XBT_PREFETCH_MAX_SIZE)
+        continue;
+
+      queued += frame->GetUnpackedSize();
+      AddJob(new CXBTFPrefetchJob(this, *frame));
+    }
+  }
+}
+
+bool CTextureBundleXBT::PrefetchFrame(const CXBTFFrame& frame)
+{
+  CSharedLock readerLock(m_readerSection);
+  if (!m_XBTFReader.IsOpen())
     return false;
+
+  {
+    CSingleLock lock(m_prefetchSection);
+    if (m_prefetched.find(frame.GetOffset()) != m_prefetched.end() ||
+        m_prefetchedSize + frame.GetUnpackedSize() > XBT_PREFETCH_MAX_SIZE)
+      return false;
   }
 
-  // load the compressed texture
-  if (!m_XBTFReader.Load(frame, buffer))
+  unsigned char *unpacked = UnpackFrame("", frame);
+  if (!unpacked)
+    return false;
+
+  CSingleLock lock(m_prefetchSection);
+  if (!m_prefetched.insert(std::make_pair(frame.GetOffset(), unpacked)).second)
   {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
+    delete[] unpacked;
     return false;
   }
+  m_prefetchedSize += frame.GetUnpackedSize();
+  return true;
+}
+
+unsigned char* CTextureBundleXBT::TakePrefetched(const CXBTFFrame& frame)
+{
+  CSingleLock lock(m_prefetchSection);
+  std::map<uint64_t, unsigned char*>::iterator i = m_prefetched.find(frame.GetOffset());
+  if (i == m_prefetched.end())
+    return NULL;
+
+  unsigned char *buffer = i->second;
+  m_prefetched.erase(i);
+  m_prefetchedSize -= frame.GetUnpackedSize();
+  return buffer;
+}
+
+void CTextureBundleXBT::ClearPrefetched()
+{
+  CSingleLock lock(m_prefetchSection);
+  for (std::map<uint64_t, unsigned char*>::iterator i = m_prefetched.begin(); i != m_prefetched.end(); ++i)
+    delete[] i->second;
+  m_prefetched.clear();
+  m_prefetchedSize = 0;
+}
+
+unsigned char* CTextureBundleXBT::UnpackFrame(const CStdString& name, const CXBTFFrame& frame)
+{
+  // the packed data is read straight out of the mapped bundle
+  const unsigned char *packed = m_XBTFReader.GetFrameData(frame);
+  if (!packed)
+  {
+    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+    return NULL;
+  }
+
+  squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
+  if (unpacked == NULL)
+  {
+    CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
+    return NULL;
+  }
+  lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
+  if (lzo1x_decompress_safe(packed, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
+      s != frame.GetUnpackedSize())
+  {
+    CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
+    delete[] unpacked;
+    return NULL;
+  }
+  return unpacked;
+}
+
+bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
+{
+  unsigned char *buffer = NULL;
+  bool ownsBuffer = true;
 
-  // check if it's packed with lzo
   if (frame.IsPacked())
-  { // unpack
-    squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
-    {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
-    }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
-    {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
-      return false;
-    }
-    delete[] buffer;
-    buffer = unpacked;
+  {
+    // check whether a prefetch job has already done the work for us
+    buffer = TakePrefetched(frame);
+    if (!buffer)
+      buffer = UnpackFrame(name, frame);
+  }
+  else
+  {
+    // unpacked frames can be uploaded directly from the mapping
+    buffer = (unsigned char *)m_XBTFReader.GetFrameData(frame);
+    ownsBuffer = false;
+    if (!buffer)
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
   }
 
+  if (!buffer)
+    return false;
+
   // create an xbmc texture
   *ppTexture = new CTexture();
   (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
 
-  delete[] buffer;
+  if (ownsBuffer)
+    delete[] buffer;
 
   return true;
 }
 
 void CTextureBundleXBT::Cleanup()
 {
+  // drop the queued prefetches, and wait for the running ones through the reader lock they
+  // hold. That leaves the queue empty, so ~CJobQueue has nothing to cancel with the job
+  // manager, which may be gone by the time the global bundles are destroyed.
+  CancelJobs();
+
+  CExclusiveLock lock(m_readerSection);
+  ClearPrefetched();
   if (m_XBTFReader.IsOpen())
   {
     m_XBTFReader.Close();
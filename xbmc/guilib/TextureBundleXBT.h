@@ -23,15 +23,21 @@
 #include "utils/StdString.h"
 #include <map>
 #include "XBTFReader.h"
+#include "threads/CriticalSection.h"
+#include "threads/SharedSection.h"
+#include "utils/JobManager.h"
 
 class CBaseTexture;
 
-class CTextureBundleXBT
+class CTextureBundleXBT : public CJobQueue
 {
 public:
   CTextureBundleXBT(void);
   ~CTextureBundleXBT(void);
 
+  /*! \brief Close the bundle, after cancelling its prefetch jobs and waiting for the running ones.
+   Must be called while the job manager still exists, CGUITextureManager::Cleanup() does so on skin unload.
+   */
   void Cleanup();
   void SetThemeBundle(bool themeBundle);
   bool HasFile(const CStdString& Filename);
@@ -44,14 +50,32 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Decompress the given textures in the background so a later LoadTexture() finds them ready.
+   Textures prefetched by the previous call that were never loaded are dropped.
+   \param textures normalized names of the textures that are about to be loaded.
+   */
+  void PrefetchTextures(const std::vector<CStdString> &textures);
+
+  /*! \brief Decompress a single frame into the prefetch cache. Called from the prefetch jobs.
+   */
+  bool PrefetchFrame(const CXBTFFrame& frame);
+
 private:
   bool OpenBundle();
   bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
+  unsigned char* UnpackFrame(const CStdString& name, const CXBTFFrame& frame);
+  unsigned char* TakePrefetched(const CXBTFFrame& frame);
+  void ClearPrefetched();
 
   time_t m_TimeStamp;
 
   bool m_themeBundle;
   CXBTFReader m_XBTFReader;
+
+  CSharedSection m_readerSection;   ///< held shared by prefetch jobs, exclusively while (re)opening the bundle
+  CCriticalSection m_prefetchSection;
+  std::map<uint64_t, unsigned char*> m_prefetched; ///< unpacked frames, keyed by their offset in the bundle
+  uint64_t m_prefetchedSize;
 };
 
 
@@ -23,6 +23,7 @@
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#include "GUIQuadBatchGL.h"
 
 #if defined(HAS_GL) || defined(HAS_GLES)
 
@@ -50,7 +51,12 @@ void CGLTexture::CreateTextureObject()
 void CGLTexture::DestroyTextureObject()
 {
   if (m_texture)
+  {
+#if defined(HAS_GL)
+    CGUIQuadBatchGL::Get().OnTextureChanged(m_texture);
+#endif
     glDeleteTextures(1, (GLuint*) &m_texture);
+  }
 }
 
 void CGLTexture::LoadToGPU()
@@ -66,6 +72,10 @@ void CGLTexture::LoadToGPU()
     // this happens only one time - the first time the texture is loaded
     CreateTextureObject();
   }
+#if defined(HAS_GL)
+  else
+    CGUIQuadBatchGL::Get().OnTextureChanged(m_texture);
+#endif
 
   // Bind the texture object
   glBindTexture(GL_TEXTURE_2D, m_texture);
@@ -39,6 +39,7 @@ public:
   virtual void DestroyTextureObject();
   void LoadToGPU();
   void BindToUnit(unsigned int unit);
+  GLuint GetTextureObject() const { return m_texture; };
 
 private:
   GLuint m_texture;
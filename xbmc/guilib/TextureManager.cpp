@@ -613,3 +613,30 @@ void CGUITextureManager::GetBundledTexturesFromPath(const CStdString& texturePat
   if (items.empty())
     m_TexBundle[1].GetTexturesFromPath(texturePath, items);
 }
+
+void CGUITextureManager::PrefetchTextures(const std::vector<CStdString> &textureNames)
+{
+  // sort the textures into the bundle that Load() would pick them from
+  std::vector<CStdString> bundled[2];
+  for (std::vector<CStdString>::const_iterator i = textureNames.begin(); i != textureNames.end(); ++i)
+  {
+    if (!CanLoad(*i) || CURL::IsFullPath(*i))
+      continue;
+
+    CStdString bundledName = CTextureBundle::Normalize(*i);
+    for (int bundle = 0; bundle < 2; bundle++)
+    {
+      if (m_TexBundle[bundle].HasFile(bundledName))
+      {
+        bundled[bundle].push_back(bundledName);
+        break;
+      }
+    }
+  }
+
+  for (int bundle = 0; bundle < 2; bundle++)
+  {
+    if (!bundled[bundle].empty())
+      m_TexBundle[bundle].PrefetchTextures(bundled[bundle]);
+  }
+}
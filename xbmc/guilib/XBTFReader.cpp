@@ -24,53 +24,161 @@
 #include "utils/CharsetConverter.h"
 #ifdef _WIN32
 #include "FileSystem/SpecialProtocol.h"
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 #include <string.h>
 #include "PlatformDefs.h"
 
-#define READ_STR(str, size, file) \
-  if (!fread(str, size, 1, file)) \
-    return false;
+#define READ_STR(str, size, pos) \
+  if (pos + size > m_size) \
+    return false; \
+  memcpy(str, m_data + pos, size); \
+  pos += size;
 
-#define READ_U32(i, file) \
-  if (!fread(&i, 4, 1, file)) \
+#define READ_U32(i, pos) \
+  if (pos + 4 > m_size) \
     return false; \
-  i = Endian_SwapLE32(i);
+  memcpy(&i, m_data + pos, 4); \
+  i = Endian_SwapLE32(i); \
+  pos += 4;
 
-#define READ_U64(i, file) \
-  if (!fread(&i, 8, 1, file)) \
+#define READ_U64(i, pos) \
+  if (pos + 8 > m_size) \
     return false; \
-  i = Endian_SwapLE64(i);
+  memcpy(&i, m_data + pos, 8); \
+  i = Endian_SwapLE64(i); \
+  pos += 8;
 
 CXBTFReader::CXBTFReader()
 {
-  m_file = NULL;
+  m_data = NULL;
+  m_size = 0;
+#ifdef _WIN32
+  m_fileHandle = INVALID_HANDLE_VALUE;
+  m_mapHandle = NULL;
+#else
+  m_fd = -1;
+#endif
+}
+
+CXBTFReader::~CXBTFReader()
+{
+  Close();
 }
 
 bool CXBTFReader::IsOpen() const
 {
-  return m_file != NULL;
+  return m_data != NULL;
 }
 
 bool CXBTFReader::Open(const CStdString& fileName)
 {
+  Close();
+
   m_fileName = fileName;
 
+  if (!Map())
+    return false;
+
+  if (!ParseHeader())
+  {
+    Close();
+    return false;
+  }
+
+  return true;
+}
+
+bool CXBTFReader::Map()
+{
 #ifdef _WIN32
   CStdStringW strPathW;
   g_charsetConverter.utf8ToW(CSpecialProtocol::TranslatePath(m_fileName), strPathW, false);
-  m_file = _wfopen(strPathW.c_str(), L"rb");
+  m_fileHandle = CreateFileW(strPathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m_fileHandle == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_fileHandle, &size) || size.QuadPart == 0)
+  {
+    Unmap();
+    return false;
+  }
+  m_size = size.QuadPart;
+
+  m_mapHandle = CreateFileMapping(m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (m_mapHandle == NULL)
+  {
+    Unmap();
+    return false;
+  }
+  m_data = (const unsigned char*)MapViewOfFile(m_mapHandle, FILE_MAP_READ, 0, 0, 0);
 #else
-  m_file = fopen(m_fileName.c_str(), "rb");
+  m_fd = open(m_fileName.c_str(), O_RDONLY);
+  if (m_fd == -1)
+    return false;
+
+  struct stat fileStat;
+  if (fstat(m_fd, &fileStat) == -1 || fileStat.st_size == 0)
+  {
+    Unmap();
+    return false;
+  }
+  m_size = fileStat.st_size;
+
+  // pages are read from the file as they are touched, so a bundle that is rewritten in place
+  // changes under us, and touching pages past the end of a truncated bundle raises SIGBUS.
+  // Bundles are normally replaced by a new file, which leaves this mapping alone, and
+  // GetFrameData() checks the file still holds a frame before handing it out.
+  void* data = mmap(NULL, (size_t)m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+  if (data == MAP_FAILED)
+  {
+    Unmap();
+    return false;
+  }
+  m_data = (const unsigned char*)data;
 #endif
-  if (m_file == NULL)
+  if (m_data == NULL)
   {
+    Unmap();
     return false;
   }
+  return true;
+}
+
+void CXBTFReader::Unmap()
+{
+#ifdef _WIN32
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapHandle)
+    CloseHandle(m_mapHandle);
+  if (m_fileHandle != INVALID_HANDLE_VALUE)
+    CloseHandle(m_fileHandle);
+  m_mapHandle = NULL;
+  m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+  if (m_data)
+    munmap((void*)m_data, (size_t)m_size);
+  if (m_fd != -1)
+    close(m_fd);
+  m_fd = -1;
+#endif
+  m_data = NULL;
+  m_size = 0;
+}
+
+bool CXBTFReader::ParseHeader()
+{
+  uint64_t pos = 0;
 
   char magic[4];
-  READ_STR(magic, 4, m_file);
+  READ_STR(magic, 4, pos);
 
   if (strncmp(magic, XBTF_MAGIC, sizeof(magic)) != 0)
   {
@@ -78,7 +186,7 @@ bool CXBTFReader::Open(const CStdString& fileName)
   }
 
   char version[1];
-  READ_STR(version, 1, m_file);
+  READ_STR(version, 1, pos);
 
   if (strncmp(version, XBTF_VERSION, sizeof(version)) != 0)
   {
@@ -86,50 +194,55 @@ bool CXBTFReader::Open(const CStdString& fileName)
   }
 
   unsigned int nofFiles;
-  READ_U32(nofFiles, m_file);
+  READ_U32(nofFiles, pos);
+  m_xbtf.GetFiles().reserve(nofFiles);
   for (unsigned int i = 0; i < nofFiles; i++)
   {
     CXBTFFile file;
     unsigned int u32;
     uint64_t u64;
 
-    READ_STR(file.GetPath(), 256, m_file);
-    READ_U32(u32, m_file);
+    READ_STR(file.GetPath(), 256, pos);
+    file.GetPath()[255] = '\0';
+    READ_U32(u32, pos);
     file.SetLoop(u32);
 
     unsigned int nofFrames;
-    READ_U32(nofFrames, m_file);
+    READ_U32(nofFrames, pos);
 
     for (unsigned int j = 0; j < nofFrames; j++)
     {
       CXBTFFrame frame;
 
-      READ_U32(u32, m_file);
+      READ_U32(u32, pos);
       frame.SetWidth(u32);
-      READ_U32(u32, m_file);
+      READ_U32(u32, pos);
       frame.SetHeight(u32);
-      READ_U32(u32, m_file);
+      READ_U32(u32, pos);
       frame.SetFormat(u32);
-      READ_U64(u64, m_file);
+      READ_U64(u64, pos);
       frame.SetPackedSize(u64);
-      READ_U64(u64, m_file);
+      READ_U64(u64, pos);
       frame.SetUnpackedSize(u64);
-      READ_U32(u32, m_file);
+      READ_U32(u32, pos);
       frame.SetDuration(u32);
-      READ_U64(u64, m_file);
+      READ_U64(u64, pos);
       frame.SetOffset(u64);
 
+      // frames are read straight from the mapping, so they have to lie within the file
+      if (frame.GetOffset() > m_size || frame.GetPackedSize() > m_size - frame.GetOffset())
+        return false;
+
       file.GetFrames().push_back(frame);
     }
 
     m_xbtf.GetFiles().push_back(file);
 
-    m_filesMap[file.GetPath()] = file;
+    m_filesIndex[file.GetPath()] = m_xbtf.GetFiles().size() - 1;
   }
 
   // Sanity check
-  int64_t pos = ftell(m_file);
-  if (pos != (int64_t)m_xbtf.GetHeaderSize())
+  if (pos != m_xbtf.GetHeaderSize())
   {
     printf("Expected header size (%"PRId64") != actual size (%"PRId64")\n", m_xbtf.GetHeaderSize(), pos);
     return false;
@@ -140,30 +253,45 @@ bool CXBTFReader::Open(const CStdString& fileName)
 
 void CXBTFReader::Close()
 {
-  if (m_file)
-  {
-    fclose(m_file);
-    m_file = NULL;
-  }
+  Unmap();
 
   m_xbtf.GetFiles().clear();
-  m_filesMap.clear();
+  m_filesIndex.clear();
 }
 
 time_t CXBTFReader::GetLastModificationTimestamp()
 {
-  if (!m_file)
+#ifdef _WIN32
+  if (m_fileHandle == INVALID_HANDLE_VALUE)
+  {
+    return 0;
+  }
+
+  FILETIME writeTime;
+  if (!GetFileTime(m_fileHandle, NULL, NULL, &writeTime))
+  {
+    return 0;
+  }
+
+  ULARGE_INTEGER ticks;
+  ticks.LowPart = writeTime.dwLowDateTime;
+  ticks.HighPart = writeTime.dwHighDateTime;
+  // FILETIME counts 100ns intervals since 1601-01-01
+  return (time_t)((ticks.QuadPart - 116444736000000000ULL) / 10000000ULL);
+#else
+  if (m_fd == -1)
   {
     return 0;
   }
 
   struct stat fileStat;
-  if (fstat(fileno(m_file), &fileStat) == -1)
+  if (fstat(m_fd, &fileStat) == -1)
   {
     return 0;
   }
 
   return fileStat.st_mtime;
+#endif
 }
 
 bool CXBTFReader::Exists(const CStdString& name)
@@ -173,36 +301,52 @@ bool CXBTFReader::Exists(const CStdString& name)
 
 CXBTFFile* CXBTFReader::Find(const CStdString& name)
 {
-  std::map<CStdString, CXBTFFile>::iterator iter = m_filesMap.find(name);
-  if (iter == m_filesMap.end())
+  FileIndex::const_iterator iter = m_filesIndex.find(name);
+  if (iter == m_filesIndex.end())
   {
     return NULL;
   }
 
-  return &(iter->second);
+  return &m_xbtf.GetFiles()[iter->second];
 }
 
-bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
+const unsigned char* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
 {
-  if (!m_file)
+  if (!m_data)
   {
-    return false;
+    return NULL;
   }
-#if defined(TARGET_DARWIN) || defined(__FreeBSD__) || defined(__ANDROID__)
-    if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
-#else
-    if (fseeko64(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
-#endif
+
+  if (frame.GetOffset() > m_size || frame.GetPackedSize() > m_size - frame.GetOffset())
   {
-    return false;
+    return NULL;
   }
 
-  if (fread(buffer, 1, (size_t)frame.GetPackedSize(), m_file) != frame.GetPackedSize())
+#ifndef _WIN32
+  // the file may have been truncated since it was mapped (windows doesn't allow that)
+  struct stat fileStat;
+  if (fstat(m_fd, &fileStat) == -1 || (uint64_t)fileStat.st_size < frame.GetOffset() + frame.GetPackedSize())
   {
-    return false;
+    return NULL;
   }
+#endif
 
-  return true;
+  return m_data + frame.GetOffset();
+}
+
+void CXBTFReader::Prefetch(const CXBTFFrame& frame) const
+{
+#ifndef _WIN32
+  const unsigned char* data = GetFrameData(frame);
+  if (!data)
+    return;
+
+  // madvise wants a page aligned start address
+  static const uintptr_t pageMask = ~((uintptr_t)sysconf(_SC_PAGESIZE) - 1);
+  uintptr_t start = (uintptr_t)data & pageMask;
+  size_t length = (size_t)((uintptr_t)data - start + frame.GetPackedSize());
+  madvise((void*)start, length, MADV_WILLNEED);
+#endif
 }
 
 std::vector<CXBTFFile>& CXBTFReader::GetFiles()
@@ -22,28 +22,60 @@
 #define XBTFREADER_H_
 
 #include <vector>
+#include <string>
 #include <map>
 #include "utils/StdString.h"
 #include "XBTF.h"
 
+/*!
+ \brief Read-only access to an XBTF texture bundle.
+
+ The bundle is memory mapped so that the index can be parsed in place and
+ frame data can be handed to the decompressor without an intermediate copy.
+ Bundles with frames outside of the file are rejected when opened.
+ */
 class CXBTFReader
 {
 public:
   CXBTFReader();
+  ~CXBTFReader();
   bool IsOpen() const;
   bool Open(const CStdString& fileName);
   void Close();
   time_t GetLastModificationTimestamp();
   bool Exists(const CStdString& name);
   CXBTFFile* Find(const CStdString& name);
-  bool Load(const CXBTFFrame& frame, unsigned char* buffer);
+
+  /*! \brief Get a pointer to the packed data of a frame inside the mapping.
+   \param frame the frame to retrieve.
+   \return pointer to GetPackedSize() bytes of frame data, or NULL if the frame lies outside the bundle
+           or the file on disk has been truncated since it was opened.
+   */
+  const unsigned char* GetFrameData(const CXBTFFrame& frame) const;
+
+  /*! \brief Hint to the OS that the given frame will be needed soon so it can be paged in asynchronously.
+   */
+  void Prefetch(const CXBTFFrame& frame) const;
+
   std::vector<CXBTFFile>&  GetFiles();
 
 private:
+  bool ParseHeader();
+  bool Map();
+  void Unmap();
+
   CXBTF      m_xbtf;
   CStdString m_fileName;
-  FILE*      m_file;
-  std::map<CStdString, CXBTFFile> m_filesMap;
+  const unsigned char* m_data;
+  uint64_t   m_size;
+#ifdef _WIN32
+  void*      m_fileHandle;
+  void*      m_mapHandle;
+#else
+  int        m_fd;
+#endif
+  typedef std::map<std::string, size_t> FileIndex;
+  FileIndex  m_filesIndex;
 };
 
 #endif
@@ -20,6 +20,7 @@
  */
 #include "cximage.h"
 #include "utils/log.h"
+#include "windowing/WindowingFactory.h"
 
 CXImage::CXImage(const std::string& strMimeType): m_strMimeType(strMimeType), m_thumbnailbuffer(NULL)
 {
@@ -50,6 +51,10 @@ bool CXImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, u
   if (nPos > -1)
     strExt.erase(0, nPos + 1);
 
+  // we can't scale while decoding, so use the full texture size for the texture cache size
+  if (width == 0 && height == 0)
+    width = height = g_Windowing.GetMaxTextureSize();
+
   if(!m_dll.LoadImageFromMemory(buffer, bufSize, strExt.c_str(), width, height, &m_image))
   {
     CLog::Log(LOGERROR, "Texture manager unable to load image from memory");
@@ -34,6 +34,8 @@ public:
    \param bufSize The size of the buffer
    \param width The ideal width of the texture
    \param height The ideal height of the texture
+   If width and height are both 0, the image is to be loaded at the size it will be stored at in the texture cache.
+   Loaders that can't scale while decoding should treat this as the maximum texture size.
    \return true if the image could be loaded
    */
   virtual bool LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height)=0;
@@ -24,6 +24,7 @@
 #include "MediaSource.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/FileStatistics.h"
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSourceSettings.h"
@@ -92,21 +93,21 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const CStdString &method, ITranspor
       return InvalidParams;
   }
 
-  CStdStringArray regexps;
+  std::vector<CRegExp> regexps;
   CStdString extensions = "";
   if (media.Equals("video"))
   {
-    regexps = g_advancedSettings.m_videoExcludeFromListingRegExps;
+    regexps = g_advancedSettings.m_videoExcludeFromListing;
     extensions = g_advancedSettings.m_videoExtensions;
   }
   else if (media.Equals("music"))
   {
-    regexps = g_advancedSettings.m_audioExcludeFromListingRegExps;
+    regexps = g_advancedSettings.m_audioExcludeFromListing;
     extensions = g_advancedSettings.m_musicExtensions;
   }
   else if (media.Equals("pictures"))
   {
-    regexps = g_advancedSettings.m_pictureExcludeFromListingRegExps;
+    regexps = g_advancedSettings.m_pictureExcludeFromListing;
     extensions = g_advancedSettings.m_pictureExtensions;
   }
 
@@ -238,6 +239,12 @@ JSONRPC_STATUS CFileOperations::Download(const CStdString &method, ITransportLay
   return transport->Download(parameterObject["path"].asString().c_str(), result) ? OK : InvalidParams;
 }
 
+JSONRPC_STATUS CFileOperations::GetStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CFileStatistics::Get().GetStatistics(result["statistics"], parameterObject["reset"].asBoolean());
+  return OK;
+}
+
 bool CFileOperations::FillFileItem(const CFileItemPtr &originalItem, CFileItemPtr &item, CStdString media /* = "" */, const CVariant &parameterObject /* = CVariant(CVariant::VariantTypeArray) */)
 {
   if (originalItem.get() == NULL)
@@ -303,21 +310,21 @@ bool CFileOperations::FillFileItemList(const CVariant &parameterObject, CFileIte
     {
       CFileItemList items;
       CStdString extensions = "";
-      CStdStringArray regexps;
+      std::vector<CRegExp> regexps;
 
       if (media.Equals("video"))
       {
-        regexps = g_advancedSettings.m_videoExcludeFromListingRegExps;
+        regexps = g_advancedSettings.m_videoExcludeFromListing;
         extensions = g_advancedSettings.m_videoExtensions;
       }
       else if (media.Equals("music"))
       {
-        regexps = g_advancedSettings.m_audioExcludeFromListingRegExps;
+        regexps = g_advancedSettings.m_audioExcludeFromListing;
         extensions = g_advancedSettings.m_musicExtensions;
       }
       else if (media.Equals("pictures"))
       {
-        regexps = g_advancedSettings.m_pictureExcludeFromListingRegExps;
+        regexps = g_advancedSettings.m_pictureExcludeFromListing;
         extensions = g_advancedSettings.m_pictureExtensions;
       }
 
@@ -22,7 +22,7 @@
 namespace JSONRPC
 {
   const char* const JSONRPC_SERVICE_ID          = "http://www.xbmc.org/jsonrpc/ServiceDescription.json";
-  const char* const JSONRPC_SERVICE_VERSION     = "6.5.1";
+  const char* const JSONRPC_SERVICE_VERSION     = "6.6.0";
   const char* const JSONRPC_SERVICE_DESCRIPTION = "JSON-RPC API of XBMC";
 
   const char* const JSONRPC_SERVICE_TYPES[] = {  
@@ -1778,6 +1778,42 @@ namespace JSONRPC
         "}"
       "}"
     "}",
+    "\"Files.GetStatistics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the I/O statistics of the virtual file system per protocol and host\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"reset\", \"type\": \"boolean\", \"default\": false, \"description\": \"Clear the statistics after retrieving them\" }"
+      "],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"statistics\": { \"type\": \"array\", \"required\": true,"
+            "\"items\": { \"type\": \"object\","
+              "\"properties\": {"
+                "\"protocol\": { \"type\": \"string\", \"required\": true },"
+                "\"host\": { \"type\": \"string\", \"required\": true },"
+                "\"bytesread\": { \"type\": \"integer\", \"required\": true },"
+                "\"cachehits\": { \"type\": \"integer\", \"required\": true, \"description\": \"Exists checks answered by the directory cache\" },"
+                "\"cachemisses\": { \"type\": \"integer\", \"required\": true },"
+                "\"operations\": { \"type\": \"object\", \"required\": true,"
+                  "\"description\": \"Statistics of the open, stat, read and seek operations\","
+                  "\"additionalProperties\": { \"type\": \"object\","
+                    "\"properties\": {"
+                      "\"calls\": { \"type\": \"integer\", \"required\": true },"
+                      "\"failures\": { \"type\": \"integer\", \"required\": true },"
+                      "\"time\": { \"type\": \"integer\", \"required\": true, \"description\": \"Total time in milliseconds\" },"
+                      "\"latency\": { \"type\": \"array\", \"required\": true, \"items\": { \"type\": \"integer\" }, \"description\": \"Calls that took less than 0.1ms, 1ms, 10ms, 100ms, 1s and longer\" }"
+                    "}"
+                  "}"
+                "}"
+              "}"
+            "}"
+          "}"
+        "}"
+      "}"
+    "}",
     "\"Files.PrepareDownload\": {"
       "\"type\": \"method\","
       "\"description\": \"Provides a way to download a given file (e.g. providing an URL to the real file location)\","
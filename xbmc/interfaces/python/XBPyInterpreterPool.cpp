@@ -0,0 +1,153 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// python.h should always be included first before any other includes
+#include "XBPyInterpreterPool.h"
+
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+XBPyInterpreterPool& XBPyInterpreterPool::Get()
+{
+  static XBPyInterpreterPool pool;
+  return pool;
+}
+
+bool XBPyInterpreterPool::IsEnabled(const std::string &addonId) const
+{
+  const std::vector<CStdString> &addons = g_advancedSettings.m_pythonPoolAddons;
+  return std::find(addons.begin(), addons.end(), addonId) != addons.end();
+}
+
+bool XBPyInterpreterPool::Acquire(const std::string &addonId, Interpreter &interpreter)
+{
+  CSingleLock lock(m_critSection);
+  // prefer the most recently used interpreter
+  for (std::vector<Interpreter>::reverse_iterator it = m_idle.rbegin(); it != m_idle.rend(); ++it)
+  {
+    if (it->addonId == addonId)
+    {
+      interpreter = *it;
+      m_idle.erase(--(it.base()));
+      return true;
+    }
+  }
+  return false;
+}
+
+void XBPyInterpreterPool::Release(Interpreter &interpreter)
+{
+  interpreter.runs++;
+  interpreter.lastUsed = XbmcThreads::SystemClockMillis();
+
+  if (interpreter.runs >= (unsigned int)g_advancedSettings.m_pythonPoolMaxRuns)
+  {
+    CLog::Log(LOGDEBUG, "%s - recycling interpreter of %s after %u runs", __FUNCTION__, interpreter.addonId.c_str(), interpreter.runs);
+    EndInterpreter(interpreter);
+    return;
+  }
+
+  Interpreter evicted;
+  {
+    CSingleLock lock(m_critSection);
+    m_idle.push_back(interpreter);
+    if (m_idle.size() <= (size_t)g_advancedSettings.m_pythonPoolSize)
+      return;
+
+    evicted = m_idle.front();
+    m_idle.erase(m_idle.begin());
+  }
+
+  CLog::Log(LOGDEBUG, "%s - pool full, shutting down interpreter of %s", __FUNCTION__, evicted.addonId.c_str());
+  EndInterpreter(evicted);
+}
+
+void XBPyInterpreterPool::Process()
+{
+  std::vector<Interpreter> expired;
+  {
+    CSingleLock lock(m_critSection);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    unsigned int idleTime = g_advancedSettings.m_pythonPoolIdleTime * 1000;
+    for (std::vector<Interpreter>::iterator it = m_idle.begin(); it != m_idle.end();)
+    {
+      if (now - it->lastUsed > idleTime)
+      {
+        expired.push_back(*it);
+        it = m_idle.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+
+  if (expired.empty())
+    return;
+
+  PyEval_AcquireLock();
+  for (std::vector<Interpreter>::iterator it = expired.begin(); it != expired.end(); ++it)
+  {
+    CLog::Log(LOGDEBUG, "%s - shutting down idle interpreter of %s", __FUNCTION__, it->addonId.c_str());
+    EndInterpreter(*it);
+  }
+  PyEval_ReleaseLock();
+}
+
+void XBPyInterpreterPool::Clear()
+{
+  std::vector<Interpreter> idle;
+  {
+    CSingleLock lock(m_critSection);
+    idle.swap(m_idle);
+  }
+
+  if (idle.empty())
+    return;
+
+  PyEval_AcquireLock();
+  for (std::vector<Interpreter>::iterator it = idle.begin(); it != idle.end(); ++it)
+    EndInterpreter(*it);
+  PyEval_ReleaseLock();
+}
+
+bool XBPyInterpreterPool::IsEmpty() const
+{
+  CSingleLock lock(m_critSection);
+  return m_idle.empty();
+}
+
+void XBPyInterpreterPool::EndInterpreter(Interpreter &interpreter)
+{
+  PyThreadState_Swap(interpreter.state);
+  Py_XDECREF(interpreter.mainDict);
+  interpreter.mainDict = NULL;
+
+  Py_EndInterpreter(interpreter.state);
+  interpreter.state = NULL;
+
+  if (interpreter.hook)
+    interpreter.hook->UnregisterMe();
+  interpreter.hook = LanguageHookRef();
+}
@@ -0,0 +1,116 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+// python.h should always be included first before any other includes
+#include <Python.h>
+
+#include "threads/CriticalSection.h"
+#include "interfaces/python/LanguageHook.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Keeps the sub-interpreters of opted-in plugins alive between invocations.
+ *
+ * Starting a plugin listing normally creates a new interpreter, re-imports
+ * every module the add-on uses and tears it all down again once the listing
+ * is done. Add-ons listed in advancedsettings.xml (<pythonpool>) instead hand
+ * their interpreter back here after a clean run, so the next listing of the
+ * same add-on skips the interpreter start and finds its modules already
+ * imported. Only idle interpreters live in the pool; a running script owns
+ * its interpreter exclusively.
+ *
+ * The pool is bounded by <size> idle interpreters (the least recently used is
+ * shut down first), interpreters are recycled after <maxruns> invocations to
+ * cap whatever the add-on leaks, and they are shut down after <idletime>
+ * seconds without use.
+ */
+class XBPyInterpreterPool
+{
+public:
+  typedef XBMCAddon::AddonClass::Ref<XBMCAddon::Python::LanguageHook> LanguageHookRef;
+
+  /**
+   * The state a pooled interpreter is handed out and returned with.
+   */
+  struct Interpreter
+  {
+    Interpreter() : state(NULL), mainDict(NULL), runs(0), lastUsed(0) {}
+
+    PyThreadState*  state;    // the only thread state of the interpreter
+    LanguageHookRef hook;     // registered for as long as the interpreter lives
+    PyObject*       mainDict; // copy of __main__ right after initialization
+    std::string     addonId;
+    unsigned int    runs;
+    unsigned int    lastUsed;
+  };
+
+  static XBPyInterpreterPool& Get();
+
+  /**
+   * Whether listings of this add-on should run in a pooled interpreter.
+   */
+  bool IsEnabled(const std::string &addonId) const;
+
+  /**
+   * Take an idle interpreter of the add-on out of the pool.
+   * Must be called with the GIL held.
+   * @return false if there is no idle interpreter for the add-on
+   */
+  bool Acquire(const std::string &addonId, Interpreter &interpreter);
+
+  /**
+   * Hand an interpreter back after a successful run. The calling thread's state
+   * must be the interpreter's only thread state and must be current with the
+   * GIL held. If the interpreter has been used up, or the pool has no room, an
+   * interpreter is shut down, after which no thread state is current.
+   */
+  void Release(Interpreter &interpreter);
+
+  /**
+   * Shut down interpreters that have been idle too long.
+   * Must be called without holding the GIL.
+   */
+  void Process();
+
+  /**
+   * Shut down all idle interpreters, before python itself is finalized.
+   * Must be called without holding the GIL.
+   */
+  void Clear();
+
+  bool IsEmpty() const;
+
+  /**
+   * Shut down an interpreter that isn't going back into the pool.
+   * Must be called with the GIL held, leaves no thread state current.
+   */
+  static void EndInterpreter(Interpreter &interpreter);
+
+private:
+  XBPyInterpreterPool() {}
+
+  mutable CCriticalSection m_critSection;
+  std::vector<Interpreter> m_idle; // least recently used first
+};
@@ -42,6 +42,7 @@
 
 #include "XBPyThread.h"
 #include "XBPython.h"
+#include "XBPyInterpreterPool.h"
 #include "LanguageHook.h"
 
 #include "interfaces/legacy/Exception.h"
@@ -52,6 +53,7 @@
 #include "interfaces/python/pythreadstate.h"
 #include "interfaces/python/swig.h"
 #include "utils/CharsetConverter.h"
+#include "utils/TimeUtils.h"
 #include "PyContext.h"
 
 #ifdef _WIN32
@@ -174,10 +176,34 @@ void XBPyThread::Process()
   CLog::Log(LOGDEBUG,"Python thread: start processing");
 
   int m_Py_file_input = Py_file_input;
+  int64_t startTime = CurrentHostCounter();
+
+  // plugins that opted in run in an interpreter that is kept around between invocations
+  bool pooled = m_type == 'F' && m_argv != NULL && addon.get() != NULL &&
+                XBPyInterpreterPool::Get().IsEnabled(addon->ID());
+  XBPyInterpreterPool::Interpreter interpreter;
+  bool warm = false;
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  PyThreadState* state = NULL;
+  if (pooled && XBPyInterpreterPool::Get().Acquire(addon->ID(), interpreter))
+  {
+    // take the interpreter over with a thread state of our own
+    state = PyThreadState_New(interpreter.state->interp);
+    if (state)
+    {
+      PyThreadState_Swap(state);
+      PyThreadState_Clear(interpreter.state);
+      PyThreadState_Delete(interpreter.state);
+      interpreter.state = state;
+      warm = true;
+    }
+    else
+      XBPyInterpreterPool::EndInterpreter(interpreter);
+  }
+  if (!state)
+    state = Py_NewInterpreter();
   if (!state)
   {
     PyEval_ReleaseLock();
@@ -187,10 +213,12 @@ void XBPyThread::Process()
   // swap in my thread state
   PyThreadState_Swap(state);
 
-  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::LanguageHook> languageHook(new XBMCAddon::Python::LanguageHook(state->interp));
-  languageHook->RegisterMe();
-
-  m_pExecuter->InitializeInterpreter(addon);
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::LanguageHook> languageHook(warm ? interpreter.hook.get() : new XBMCAddon::Python::LanguageHook(state->interp));
+  if (!warm)
+  {
+    languageHook->RegisterMe();
+    m_pExecuter->InitializeInterpreter(addon);
+  }
 
   CLog::Log(LOGDEBUG, "%s - The source file to load is %s", __FUNCTION__, m_source);
 
@@ -255,6 +283,22 @@ void XBPyThread::Process()
   PyObject* module = PyImport_AddModule((char*)"__main__");
   PyObject* moduleDict = PyModule_GetDict(module);
 
+  if (warm)
+  {
+    // start from the __main__ the interpreter had before its first run, imported modules stay loaded
+    PyDict_Clear(moduleDict);
+    PyDict_Update(moduleDict, interpreter.mainDict);
+
+    PyObject *m = PyImport_AddModule((char*)"xbmc");
+    if(!m || PyObject_SetAttrString(m, (char*)"abortRequested", PyBool_FromLong(0)))
+      CLog::Log(LOGERROR, "Python thread: failed to reset abortRequested");
+  }
+  else if (pooled)
+    interpreter.mainDict = PyDict_Copy(moduleDict);
+
+  CLog::Log(LOGDEBUG, "Python thread: %s interpreter ready in %.1f ms", warm ? "pooled" : "new",
+            1000.0 * (CurrentHostCounter() - startTime) / CurrentHostFrequency());
+
   // when we are done initing we store thread state so we can be aborted
   PyThreadState_Swap(NULL);
   PyEval_ReleaseLock();
@@ -321,6 +365,7 @@ void XBPyThread::Process()
   }
 
   bool systemExitThrown = false;
+  bool scriptFailed = false;
   if (!PyErr_Occurred())
     CLog::Log(LOGINFO, "Scriptresult: Success");
   else if (PyErr_ExceptionMatches(PyExc_SystemExit))
@@ -330,6 +375,7 @@ void XBPyThread::Process()
   }
   else
   {
+    scriptFailed = true;
     PythonBindings::PythonToCppException e;
     e.LogThrowMessage();
 
@@ -422,6 +468,23 @@ void XBPyThread::Process()
       PyRun_SimpleString(GC_SCRIPT) == -1)
     CLog::Log(LOGERROR,"Failed to run the gc to clean up after running prior to shutting down the Interpreter %s",m_source);
 
+  CLog::Log(LOGDEBUG, "Python thread: %s finished in %.1f ms", m_source,
+            1000.0 * (CurrentHostCounter() - startTime) / CurrentHostFrequency());
+
+  // only interpreters that ran cleanly and left nothing behind are worth keeping
+  if (pooled && !m_stopping && !systemExitThrown && !scriptFailed &&
+      !languageHook->HasRegisteredAddonClasses() && interpreter.mainDict)
+  {
+    interpreter.state   = state;
+    interpreter.hook    = languageHook;
+    interpreter.addonId = addon->ID();
+    XBPyInterpreterPool::Get().Release(interpreter);
+    PyThreadState_Swap(NULL);
+    PyEval_ReleaseLock();
+    return;
+  }
+
+  Py_XDECREF(interpreter.mainDict);
   Py_EndInterpreter(state);
 
   // If we still have objects left around, produce an error message detailing what's been left behind
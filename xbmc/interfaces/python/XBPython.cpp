@@ -32,6 +32,7 @@
 #include "cores/DllLoader/DllLoaderContainer.h"
 #include "GUIPassword.h"
 #include "XBPython.h"
+#include "XBPyInterpreterPool.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "guilib/GraphicContext.h"
@@ -582,6 +583,9 @@ void XBPython::Finalize()
     m_mainThreadState = NULL; // clear the main thread state before releasing the lock
     {
       CSingleExit exit(m_critSection);
+      // pooled interpreters have to go before python itself
+      XBPyInterpreterPool::Get().Clear();
+
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
@@ -654,8 +658,12 @@ void XBPython::Process()
     //delete scripts which are done
     tmpvec.clear(); // boost releases the XBPyThreads which, if deleted, calls FinalizeScript
 
+    XBPyInterpreterPool::Get().Process();
+
+    // keep python loaded for as long as there are warm interpreters
     CSingleLock l2(m_critSection);
-    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
+    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 &&
+       XBPyInterpreterPool::Get().IsEmpty())
     {
       Finalize();
     }
@@ -210,6 +210,9 @@ bool CMusicDatabase::CreateTables()
     m_pDS->exec("CREATE INDEX idxKaraNumber on karaokedata(iKaraNumber)");
     m_pDS->exec("CREATE INDEX idxKarSong on karaokedata(idSong)");
 
+    CLog::Log(LOGINFO, "create replaygain table");
+    m_pDS->exec("CREATE TABLE replaygain ( idSong integer primary key, iTrackGain integer, fTrackPeak float, iAlbumGain integer, fAlbumPeak float )\n");
+
     // Trigger
     CLog::Log(LOGINFO, "create albuminfo trigger");
     m_pDS->exec("CREATE TRIGGER tgrAlbumInfo AFTER delete ON albuminfo FOR EACH ROW BEGIN delete from albuminfosong where albuminfosong.idAlbumInfo=old.idAlbumInfo; END");
@@ -217,7 +220,7 @@ bool CMusicDatabase::CreateTables()
     CLog::Log(LOGINFO, "create art table, index and triggers");
     m_pDS->exec("CREATE TABLE art(art_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, type TEXT, url TEXT)");
     m_pDS->exec("CREATE INDEX ix_art ON art(media_id, media_type(20), type(20))");
-    m_pDS->exec("CREATE TRIGGER delete_song AFTER DELETE ON song FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idSong AND media_type='song'; END");
+    m_pDS->exec("CREATE TRIGGER delete_song AFTER DELETE ON song FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idSong AND media_type='song'; DELETE FROM replaygain WHERE idSong=old.idSong; END");
     m_pDS->exec("CREATE TRIGGER delete_album AFTER DELETE ON album FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album'; END");
     m_pDS->exec("CREATE TRIGGER delete_artist AFTER DELETE ON artist FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist'; END");
 
@@ -3777,6 +3780,12 @@ bool CMusicDatabase::UpdateOldVersion(int version)
       }
     }
   }
+  if (version < 37)
+  {
+    m_pDS->exec("CREATE TABLE replaygain ( idSong integer primary key, iTrackGain integer, fTrackPeak float, iAlbumGain integer, fAlbumPeak float )\n");
+    m_pDS->exec("DROP TRIGGER IF EXISTS delete_song");
+    m_pDS->exec("CREATE TRIGGER delete_song AFTER DELETE ON song FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idSong AND media_type='song'; DELETE FROM replaygain WHERE idSong=old.idSong; END");
+  }
   // always recreate the views after any table change
   CreateViews();
 
@@ -3785,7 +3794,7 @@ bool CMusicDatabase::UpdateOldVersion(int version)
 
 int CMusicDatabase::GetMinVersion() const
 {
-  return 36;
+  return 37;
 }
 
 unsigned int CMusicDatabase::GetSongIDs(const Filter &filter, vector<pair<int,int> > &songIDs)
@@ -4377,7 +4386,11 @@ bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so reset the infomanager cache
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
+    // (unless this only ended a nested transaction)
+    if (!InTransaction())
+    {
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
+    }
     return true;
   }
   return false;
@@ -5204,6 +5217,122 @@ int CMusicDatabase::GetKaraokeSongsCount()
   return 0;
 }
 
+bool CMusicDatabase::GetSongsWithoutReplayGain(VECSONGS &songs)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // the album gain needs every song of the album
+    CStdString strSQL = "SELECT song.idSong, song.idAlbum, path.strPath, song.strFileName, song.iStartOffset, song.iEndOffset "
+                        "FROM song JOIN path ON song.idPath=path.idPath "
+                        "WHERE song.idAlbum IN (SELECT song.idAlbum FROM song LEFT JOIN replaygain ON song.idSong=replaygain.idSong WHERE replaygain.idSong IS NULL) "
+                        "ORDER BY song.idAlbum, song.iTrack";
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    while (!m_pDS->eof())
+    {
+      CSong song;
+      song.idSong = m_pDS->fv(0).get_asInt();
+      song.idAlbum = m_pDS->fv(1).get_asInt();
+      song.strFileName = URIUtils::AddFileToFolder(m_pDS->fv(2).get_asString(), m_pDS->fv(3).get_asString());
+      song.iStartOffset = m_pDS->fv(4).get_asInt();
+      song.iEndOffset = m_pDS->fv(5).get_asInt();
+      songs.push_back(song);
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::SetReplayGain(int idSong, const MUSIC_INFO::CMusicInfoTag &tag)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // unknown values are stored as NULL, so the song isn't analyzed again
+    int info = tag.HasReplayGainInfo();
+    CStdString trackGain = "NULL", trackPeak = "NULL", albumGain = "NULL", albumPeak = "NULL";
+    if (info & REPLAY_GAIN_HAS_TRACK_INFO)
+      trackGain = PrepareSQL("%i", tag.GetReplayGainTrackGain());
+    if (info & REPLAY_GAIN_HAS_TRACK_PEAK)
+      trackPeak = PrepareSQL("%f", tag.GetReplayGainTrackPeak());
+    if (info & REPLAY_GAIN_HAS_ALBUM_INFO)
+      albumGain = PrepareSQL("%i", tag.GetReplayGainAlbumGain());
+    if (info & REPLAY_GAIN_HAS_ALBUM_PEAK)
+      albumPeak = PrepareSQL("%f", tag.GetReplayGainAlbumPeak());
+
+    CStdString strSQL = PrepareSQL("REPLACE INTO replaygain (idSong, iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak) VALUES (%i, ", idSong);
+    strSQL += trackGain + ", " + trackPeak + ", " + albumGain + ", " + albumPeak + ")";
+    m_pDS->exec(strSQL.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idSong);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetReplayGain(const CStdString& strFileName, int startOffset, MUSIC_INFO::CMusicInfoTag &tag)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL;
+    if (URIUtils::IsMusicDb(strFileName))
+    {
+      CStdString strFile = URIUtils::GetFileName(strFileName);
+      URIUtils::RemoveExtension(strFile);
+      strSQL = PrepareSQL("SELECT * FROM replaygain WHERE idSong=%i", atoi(strFile.c_str()));
+    }
+    else
+    {
+      CStdString strPath;
+      URIUtils::GetDirectory(strFileName, strPath);
+      URIUtils::AddSlashAtEnd(strPath);
+      strSQL = PrepareSQL("SELECT replaygain.* FROM replaygain "
+                          "JOIN song ON replaygain.idSong=song.idSong JOIN path ON song.idPath=path.idPath "
+                          "WHERE song.dwFileNameCRC='%ul' AND path.strPath='%s'",
+                          ComputeCRC(strFileName), strPath.c_str());
+      if (startOffset)
+        strSQL += PrepareSQL(" AND song.iStartOffset=%i", startOffset);
+    }
+
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    if (m_pDS->num_rows() == 0)
+    {
+      m_pDS->close();
+      return false;
+    }
+    if (!m_pDS->fv("iTrackGain").get_isNull())
+      tag.SetReplayGainTrackGain(m_pDS->fv("iTrackGain").get_asInt());
+    if (!m_pDS->fv("fTrackPeak").get_isNull())
+      tag.SetReplayGainTrackPeak(m_pDS->fv("fTrackPeak").get_asFloat());
+    if (!m_pDS->fv("iAlbumGain").get_isNull())
+      tag.SetReplayGainAlbumGain(m_pDS->fv("iAlbumGain").get_asInt());
+    if (!m_pDS->fv("fAlbumPeak").get_isNull())
+      tag.SetReplayGainAlbumPeak(m_pDS->fv("fAlbumPeak").get_asFloat());
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, strFileName.c_str());
+  }
+  return false;
+}
+
 void CMusicDatabase::SetPropertiesFromArtist(CFileItem& item, const CArtist& artist)
 {
   item.SetProperty("artist_instrument", StringUtils::Join(artist.instruments, g_advancedSettings.m_musicItemSeparator));
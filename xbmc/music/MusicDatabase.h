@@ -322,6 +322,30 @@ public:
   void ExportKaraokeInfo(const CStdString &outFile, bool asHTML );
   void ImportKaraokeInfo(const CStdString &inputFile );
 
+  /////////////////////////////////////////////////
+  // ReplayGain
+  /////////////////////////////////////////////////
+  /*! \brief Get the songs of every album with songs that have no stored ReplayGain
+   \param songs [out] the songs, ordered by album, with their id, album, full path and offsets set.
+   \return true on success.
+   */
+  bool GetSongsWithoutReplayGain(VECSONGS &songs);
+
+  /*! \brief Store the ReplayGain of a song, as read from its tags or measured
+   \param idSong the song.
+   \param tag a tag with the track and album gains and peaks that are known.
+   \return true on success.
+   */
+  bool SetReplayGain(int idSong, const MUSIC_INFO::CMusicInfoTag &tag);
+
+  /*! \brief Get the stored ReplayGain of a file
+   \param strFileName the file.
+   \param startOffset the start of the song in the file, for songs of a cue sheet.
+   \param tag [out] the tag to set the known gains and peaks on.
+   \return true if the file has a stored ReplayGain.
+   */
+  bool GetReplayGain(const CStdString& strFileName, int startOffset, MUSIC_INFO::CMusicInfoTag &tag);
+
   /////////////////////////////////////////////////
   // Filters
   /////////////////////////////////////////////////
@@ -23,9 +23,11 @@
 #include "music/tags/MusicInfoTagLoaderFactory.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "ReplayGainAnalyzer.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "Util.h"
+#include "utils/ScraperCache.h"
 #include "utils/md5.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
@@ -151,6 +153,9 @@ void CMusicInfoScanner::Process()
 
           m_musicDatabase.Compress(false);
         }
+
+        if (g_advancedSettings.m_bMusicLibraryAnalyzeReplayGain)
+          CReplayGainAnalyzer::Get().Start();
       }
 
       m_fileCountReader.StopThread();
@@ -219,6 +224,7 @@ void CMusicInfoScanner::Process()
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
   m_musicDatabase.Close();
+  CScraperCache::Get().LogStatistics();
   CLog::Log(LOGDEBUG, "%s - Finished scan", __FUNCTION__);
   
   m_bRunning = false;
@@ -379,7 +385,7 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
     m_handle->SetText(Prettify(strDirectory));
 
   // Discard all excluded files defined by m_musicExcludeRegExps
-  CStdStringArray regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
+  std::vector<CRegExp> regexps = g_advancedSettings.m_audioExcludeFromScan;
   if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
     return true;
 
@@ -454,7 +460,7 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
 
 INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList& scannedItems)
 {
-  CStdStringArray regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
+  std::vector<CRegExp> regexps = g_advancedSettings.m_audioExcludeFromScan;
 
   for (int i = 0; i < items.Size(); ++i)
   {
@@ -0,0 +1,339 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ReplayGainAnalyzer.h"
+#include "Application.h"
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "music/MusicDatabase.h"
+#include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
+#include "utils/LoudnessMeter.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <math.h>
+#include <memory>
+#include <string.h>
+
+using namespace std;
+using namespace MUSIC_INFO;
+
+#define ANALYZE_BUFFER_SIZE 65536
+
+/*! \brief ReplayGain is stored in hundredths of a dB */
+static int MathRound(double gain)
+{
+  return (int)floor(gain * 100.0 + 0.5);
+}
+
+CReplayGainAnalyzer::CReplayGainAnalyzer()
+  : m_running(0), m_startTime(0), m_stop(false), m_stopEvent(true),
+    m_songs(0), m_tagged(0), m_failed(0), m_duration(0.0), m_decodeTime(0.0)
+{
+}
+
+CReplayGainAnalyzer::~CReplayGainAnalyzer()
+{
+  Stop();
+}
+
+CReplayGainAnalyzer &CReplayGainAnalyzer::Get()
+{
+  static CReplayGainAnalyzer analyzer;
+  return analyzer;
+}
+
+void CReplayGainAnalyzer::Start()
+{
+  CSingleLock lock(m_critSection);
+  if (m_running)
+    return;
+  DeleteWorkers();
+
+  VECSONGS songs;
+  CMusicDatabase database;
+  if (!database.Open() || !database.GetSongsWithoutReplayGain(songs))
+    return;
+  database.Close();
+  if (songs.empty())
+    return;
+
+  VECSONGS::const_iterator begin = songs.begin();
+  while (begin != songs.end())
+  {
+    VECSONGS::const_iterator end = begin;
+    while (end != songs.end() && end->idAlbum == begin->idAlbum)
+      ++end;
+    m_albums.push_back(VECSONGS(begin, end));
+    begin = end;
+  }
+
+  m_startTime = XbmcThreads::SystemClockMillis();
+  m_songs = m_tagged = m_failed = 0;
+  m_duration = m_decodeTime = 0.0;
+  m_stop = false;
+  m_stopEvent.Reset();
+
+  // leave a cpu for the gui
+  unsigned int workers = std::max(g_cpuInfo.getCPUCount() - 1, 1);
+  workers = std::min(workers, (unsigned int)m_albums.size());
+  CLog::Log(LOGNOTICE, "%s - analyzing the ReplayGain of %u songs on %u threads", __FUNCTION__, (unsigned int)songs.size(), workers);
+  for (unsigned int i = 0; i < workers; i++)
+  {
+    CThread *worker = new CThread(this, "ReplayGainAnalyzer");
+    m_workers.push_back(worker);
+    m_running++;
+    worker->Create();
+  }
+}
+
+void CReplayGainAnalyzer::Stop()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_stop = true;
+    m_albums.clear();
+  }
+  m_stopEvent.Set();
+
+  // the workers take the lock, so wait for them without it
+  vector<CThread*> workers;
+  {
+    CSingleLock lock(m_critSection);
+    workers = m_workers;
+  }
+  for (vector<CThread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+    (*it)->StopThread();
+
+  CSingleLock lock(m_critSection);
+  DeleteWorkers();
+}
+
+void CReplayGainAnalyzer::DeleteWorkers()
+{
+  for (vector<CThread*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+  {
+    (*it)->StopThread();
+    delete *it;
+  }
+  m_workers.clear();
+}
+
+void CReplayGainAnalyzer::Run()
+{
+  CThread *thread = CThread::GetCurrentThread();
+  if (thread)
+    thread->SetPriority(thread->GetMinPriority());
+
+  while (true)
+  {
+    VECSONGS album;
+    {
+      CSingleLock lock(m_critSection);
+      if (m_stop || m_albums.empty())
+        break;
+      album.swap(m_albums.front());
+      m_albums.pop_front();
+    }
+    AnalyzeAlbum(album);
+  }
+
+  CSingleLock lock(m_critSection);
+  if (--m_running)
+    return;
+
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_startTime;
+  CLog::Log(LOGNOTICE, "%s - %s %u songs in %s: %u from tags, %u without a result, "
+            "%.0f s of audio decoded at %.1fx realtime per thread",
+            __FUNCTION__, m_stop ? "stopped after" : "analyzed", m_songs,
+            StringUtils::SecondsToTimeString(elapsed / 1000).c_str(), m_tagged, m_failed,
+            m_duration, m_decodeTime > 0.0 ? m_duration / m_decodeTime : 0.0);
+}
+
+bool CReplayGainAnalyzer::WaitForIdle()
+{
+  // leave the cpu and the disks to video playback
+  while (!m_stop && g_application.IsPlayingVideo())
+    m_stopEvent.WaitMSec(1000);
+  return !m_stop;
+}
+
+void CReplayGainAnalyzer::AnalyzeAlbum(const VECSONGS &songs)
+{
+  CLoudnessMeter album;
+  vector<CMusicInfoTag> tags(songs.size());
+  bool measured = true;
+  unsigned int tagged = 0, failed = 0;
+  unsigned int decodeTime = 0;
+  for (unsigned int i = 0; i < songs.size(); i++)
+  {
+    CLoudnessMeter track;
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    Result result = Analyze(songs[i], tags[i], track);
+    decodeTime += XbmcThreads::SystemClockMillis() - start;
+    if (result == CANCELLED)
+      return;
+
+    if (result == MEASURED)
+    {
+      album.Add(track);
+      double loudness = track.GetLoudness();
+      if (loudness > -HUGE_VAL)
+        tags[i].SetReplayGainTrackGain(MathRound(CLoudnessMeter::GetReplayGain(loudness)));
+      tags[i].SetReplayGainTrackPeak(track.GetPeak());
+      continue;
+    }
+
+    measured = false;
+    if (result == TAGGED)
+      tagged++;
+    else
+    { // stored without values, so the album isn't decoded again by every scan
+      tags[i] = CMusicInfoTag();
+      failed++;
+    }
+  }
+
+  // the album gain is only known when every song of the album was measured
+  double loudness = album.GetLoudness();
+  if (measured)
+  {
+    for (unsigned int i = 0; i < songs.size(); i++)
+    {
+      if (loudness > -HUGE_VAL)
+        tags[i].SetReplayGainAlbumGain(MathRound(CLoudnessMeter::GetReplayGain(loudness)));
+      tags[i].SetReplayGainAlbumPeak(album.GetPeak());
+    }
+  }
+
+  CMusicDatabase database;
+  if (!database.Open())
+    return;
+  database.BeginTransaction();
+  for (unsigned int i = 0; i < songs.size(); i++)
+    database.SetReplayGain(songs[i].idSong, tags[i]);
+  bool committed = database.CommitTransaction();
+  database.Close();
+
+  if (committed)
+  {
+    CSingleLock lock(m_critSection);
+    m_songs += songs.size();
+    m_tagged += tagged;
+    m_failed += failed;
+    m_duration += album.GetDuration();
+    m_decodeTime += decodeTime / 1000.0;
+  }
+}
+
+CReplayGainAnalyzer::Result CReplayGainAnalyzer::Analyze(const CSong &song, CMusicInfoTag &tag, CLoudnessMeter &meter)
+{
+  if (!WaitForIdle())
+    return CANCELLED;
+
+  // the tags of a file split by a cue sheet describe all of its songs
+  bool cue = song.iStartOffset || song.iEndOffset;
+  if (!cue)
+  {
+    auto_ptr<IMusicInfoTagLoader> loader(CMusicInfoTagLoaderFactory::CreateLoader(song.strFileName));
+    if (loader.get() && loader->Load(song.strFileName, tag))
+    {
+      int info = tag.HasReplayGainInfo();
+      if ((info & REPLAY_GAIN_HAS_TRACK_INFO) && (info & REPLAY_GAIN_HAS_ALBUM_INFO))
+        return TAGGED;
+    }
+    tag = CMusicInfoTag();
+  }
+
+  auto_ptr<ICodec> codec(CodecFactory::CreateCodecDemux(song.strFileName, "", 0));
+  if (!codec.get() || !codec->Init(song.strFileName, 0))
+  {
+    CLog::Log(LOGDEBUG, "%s - unable to open %s", __FUNCTION__, song.strFileName.c_str());
+    return FAILED;
+  }
+
+  CAEChannelInfo channelInfo = codec->GetChannelInfo();
+  unsigned int channels = channelInfo.Count();
+  unsigned int sampleSize = CAEUtil::DataFormatToBits(codec->m_DataFormat) >> 3;
+  CAEConvert::AEConvertToFn convert = CAEConvert::ToFloat(codec->m_DataFormat);
+  if (!channels || !codec->m_SampleRate || !sampleSize || (!convert && codec->m_DataFormat != AE_FMT_FLOAT))
+  {
+    CLog::Log(LOGDEBUG, "%s - can't measure the audio of %s", __FUNCTION__, song.strFileName.c_str());
+    return FAILED;
+  }
+
+  meter.Reset(codec->m_SampleRate, channels);
+  for (unsigned int channel = 0; channel < channels; channel++)
+  {
+    AEChannel type = channelInfo[channel];
+    if (type == AE_CH_LFE)
+      meter.SetChannelWeight(channel, 0.0);
+    else if (type == AE_CH_BL || type == AE_CH_BR || type == AE_CH_SL || type == AE_CH_SR)
+      meter.SetChannelWeight(channel, 1.41);
+  }
+
+  // offsets are in frames of 1/75 second
+  uint64_t frames = 0;
+  uint64_t endFrame = 0;
+  if (song.iStartOffset)
+    codec->Seek((int64_t)song.iStartOffset * 1000 / 75);
+  if (song.iEndOffset)
+    endFrame = (uint64_t)(song.iEndOffset - song.iStartOffset) * codec->m_SampleRate / 75;
+
+  unsigned int frameSize = sampleSize * channels;
+  vector<BYTE> buffer(ANALYZE_BUFFER_SIZE - ANALYZE_BUFFER_SIZE % frameSize);
+  vector<float> samples(buffer.size() / sampleSize);
+  while (!endFrame || frames < endFrame)
+  {
+    if (!WaitForIdle())
+      return CANCELLED;
+
+    int size = 0;
+    int result = codec->ReadPCM(&buffer[0], buffer.size(), &size);
+    if (result == READ_ERROR)
+    {
+      CLog::Log(LOGDEBUG, "%s - error decoding %s", __FUNCTION__, song.strFileName.c_str());
+      return FAILED;
+    }
+
+    unsigned int count = size / frameSize;
+    if (endFrame && frames + count > endFrame)
+      count = (unsigned int)(endFrame - frames);
+    if (count)
+    {
+      if (convert)
+        convert(&buffer[0], count * channels, &samples[0]);
+      else
+        memcpy(&samples[0], &buffer[0], count * frameSize);
+      meter.AddFrames(&samples[0], count);
+      frames += count;
+    }
+
+    if (result == READ_EOF)
+      break;
+  }
+  codec->DeInit();
+  return MEASURED;
+}
@@ -0,0 +1,91 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "music/Song.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <vector>
+
+class CLoudnessMeter;
+
+namespace MUSIC_INFO
+{
+  class CMusicInfoTag;
+
+  /*!
+   \brief Fills in the ReplayGain of library songs that have none stored.
+
+   Every album with a song missing from the replaygain table is analyzed on
+   one of a few threads at the lowest priority, one album per thread, using
+   all but one of the cpus. The threads are our own rather than job workers,
+   as a library takes hours and would hold the job manager's workers that
+   long. They wait while a video plays. Songs whose tags hold track and album gains are stored
+   as tagged. The others are decoded with the paplayer codecs and measured by
+   CLoudnessMeter against the -18 LUFS of ReplayGain 2.0. The album gain is
+   only stored when every song of the album was measured. Songs that can't be
+   measured are stored without values, so they aren't decoded again.
+   CAudioDecoder uses the stored gain of songs that have none in their tags.
+   */
+  class CReplayGainAnalyzer : public IRunnable
+  {
+  public:
+    static CReplayGainAnalyzer &Get();
+
+    /*! \brief Analyze the albums that need it, unless an analysis is running */
+    void Start();
+
+    /*! \brief Stop the analysis and wait for its threads */
+    void Stop();
+
+    virtual void Run();
+
+  private:
+    CReplayGainAnalyzer();
+    ~CReplayGainAnalyzer();
+
+    enum Result { FAILED = 0, CANCELLED, TAGGED, MEASURED };
+
+    /*! \brief Wait while a video plays
+     \return false if the analysis is being stopped.
+     */
+    bool WaitForIdle();
+    void DeleteWorkers();
+    void AnalyzeAlbum(const VECSONGS &songs);
+    Result Analyze(const CSong &song, CMusicInfoTag &tag, CLoudnessMeter &meter);
+
+    std::vector<CThread*> m_workers;
+    std::deque<VECSONGS> m_albums;  // waiting for a worker
+    unsigned int m_running;         // workers that haven't finished yet
+    unsigned int m_startTime;
+    bool m_stop;
+    CEvent m_stopEvent;
+
+    unsigned int m_songs;
+    unsigned int m_tagged;
+    unsigned int m_failed;
+    double m_duration;     // seconds of audio decoded
+    double m_decodeTime;   // seconds spent decoding
+    CCriticalSection m_critSection;
+  };
+}
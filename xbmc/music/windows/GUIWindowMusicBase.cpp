@@ -62,6 +62,7 @@
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "utils/ScraperCache.h"
 #include "video/VideoInfoTag.h"
 #include "utils/StringUtils.h"
 #include "URL.h"
@@ -363,8 +364,12 @@ void CGUIWindowMusicBase::ShowArtistInfo(const CFileItem *pItem, bool bShowInfo
   CQueryParams params;
   CDirectoryNode::GetDatabaseInfo(pItem->GetPath(), params);
   CMusicArtistInfo artistInfo;
+  bool refresh = false;
   while (1)
   {
+    // a refresh the user asked for fetches the current pages instead of cached ones
+    CScraperCache::CRefresh cacheRefresh(refresh);
+
     // Check if we have the information in the database first
     if (!m_musicdatabase.HasArtistInfo(params.GetArtistId()) ||
         !m_musicdatabase.GetArtistInfo(params.GetArtistId(), artistInfo.GetArtist()))
@@ -407,6 +412,7 @@ void CGUIWindowMusicBase::ShowArtistInfo(const CFileItem *pItem, bool bShowInfo
       if (pDlgArtistInfo->NeedRefresh())
       {
         m_musicdatabase.DeleteArtistInfo(params.GetArtistId());
+        refresh = true;
         continue;
       } 
       else if (pDlgArtistInfo->HasUpdatedThumb()) 
@@ -425,8 +431,12 @@ void CGUIWindowMusicBase::ShowAlbumInfo(const CFileItem *pItem, bool bShowInfo /
   CQueryParams params;
   CDirectoryNode::GetDatabaseInfo(pItem->GetPath(), params);
   CMusicAlbumInfo albumInfo;
+  bool refresh = false;
   while (1)
   {
+    // a refresh the user asked for fetches the current pages instead of cached ones
+    CScraperCache::CRefresh cacheRefresh(refresh);
+
     if (!m_musicdatabase.HasAlbumInfo(params.GetAlbumId()) || 
         !m_musicdatabase.GetAlbumInfo(params.GetAlbumId(), albumInfo.GetAlbum(), &albumInfo.GetAlbum().songs))
     {
@@ -468,6 +478,7 @@ void CGUIWindowMusicBase::ShowAlbumInfo(const CFileItem *pItem, bool bShowInfo /
       if (pDlgAlbumInfo->NeedRefresh())
       {
         m_musicdatabase.DeleteAlbumInfo(params.GetAlbumId());
+        refresh = true;
         continue;
       }
       else if (pDlgAlbumInfo->HasUpdatedThumb())
@@ -21,6 +21,7 @@
 #include "SlideShowPicture.h"
 #include "system.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUIQuadBatchGL.h"
 #include "guilib/Texture.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/DisplaySettings.h"
@@ -804,6 +805,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
     g_Windowing.Get3DDevice()->DrawPrimitiveUP( D3DPT_LINESTRIP, 4, vertex, sizeof(VERTEX) );
 
 #elif defined(HAS_GL)
+  CGUIQuadBatchGL::Get().Flush();
   g_graphicsContext.BeginPaint();
   if (pTexture)
   {
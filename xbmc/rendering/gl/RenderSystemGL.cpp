@@ -25,6 +25,7 @@
 
 #include "RenderSystemGL.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUIQuadBatchGL.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/DisplaySettings.h"
 #include "utils/log.h"
@@ -256,6 +257,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  CGUIQuadBatchGL::Get().EndFrame();
+
   return true;
 }
 
@@ -264,6 +267,8 @@ bool CRenderSystemGL::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  CGUIQuadBatchGL::Get().Flush();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -387,6 +392,9 @@ void CRenderSystemGL::CaptureStateBlock()
 {
   if (!m_bRenderCreated)
     return;
+
+  // anything capturing the state is about to draw with raw GL
+  CGUIQuadBatchGL::Get().Flush();
   
   glGetIntegerv(GL_VIEWPORT, m_viewPort);
 
@@ -429,6 +437,8 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::Get().Flush();
+
   g_graphicsContext.BeginPaint();
 
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
@@ -492,6 +502,8 @@ void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::Get().Flush();
+
   glMatrixMode(GL_MODELVIEW);
   glPushMatrix();
   GLfloat matrix[4][4];
@@ -513,6 +525,8 @@ void CRenderSystemGL::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::Get().Flush();
+
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
 }
@@ -582,6 +596,8 @@ void CRenderSystemGL::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  CGUIQuadBatchGL::Get().Flush();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
 }
@@ -590,6 +606,9 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUIQuadBatchGL::Get().Flush();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
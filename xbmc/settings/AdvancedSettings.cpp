@@ -110,6 +110,7 @@ void CAdvancedSettings::Initialize()
   m_allChannelStereo = false;
   m_streamSilence = false;
   m_audioSinkBufferDurationMsec = 50;
+  m_audioDecodeAhead = 2;
 
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
@@ -190,6 +191,7 @@ void CAdvancedSettings::Initialize()
 
   m_fullScreenOnMovieStart = true;
   m_cachePath = "special://temp/";
+  m_iScraperCacheTTL = 24;
 
   m_videoCleanDateTimeRegExp = "(.*[^ _\\,\\.\\(\\)\\[\\]\\-])[ _\\.\\(\\)\\[\\]\\-]+(19[0-9][0-9]|20[0-1][0-9])([ _\\,\\.\\(\\)\\[\\]\\-]|[^0-9]$)";
 
@@ -199,6 +201,7 @@ void CAdvancedSettings::Initialize()
   m_moviesExcludeFromScanRegExps.push_back("-trailer");
   m_moviesExcludeFromScanRegExps.push_back("[!-._ \\\\/]sample[-._ \\\\/]");
   m_tvshowExcludeFromScanRegExps.push_back("[!-._ \\\\/]sample[-._ \\\\/]");
+  CompileExcludeRegexps();
 
   m_folderStackRegExps.push_back("((cd|dvd|dis[ck])[0-9]+)$");
 
@@ -239,6 +242,11 @@ void CAdvancedSettings::Initialize()
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
   m_sambastatfiles = true;
+  m_sambaReadSize = 1024;
+  m_sambaReadAhead = 4;
+  m_nfsReadRequests = 8;
+  m_vfsStatistics = true;
+  m_vfsTraceFile = "";
 
   m_bHTTPDirectoryStatFilesize = false;
 
@@ -250,6 +258,7 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryHideAllItems = false;
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryAlbumsSortByArtistThenYear = false;
+  m_bMusicLibraryAnalyzeReplayGain = false;
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_strMusicLibraryAlbumFormatRight = "";
@@ -266,6 +275,8 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_iVideoScannerThreadsPerHost = 2;
+  m_iVideoScannerBatchSize = 50;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iTuxBoxStreamtsPort = 31339;
@@ -304,6 +315,10 @@ void CAdvancedSettings::Initialize()
   m_curlretries = 2;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
+  m_curlSegments = 0;
+  m_curlSegmentSize = 1024;
+  m_curlSegmentBuffer = 16384;
+  m_curlStatCacheTime = 10;
 
   m_fullScreen = m_startFullScreen = false;
   m_showExitButton = true;
@@ -354,6 +369,11 @@ void CAdvancedSettings::Initialize()
   m_cacheMemBufferSize = 1024 * 1024 * 20;
   m_addonPackageFolderSize = 200;
 
+  m_pythonPoolAddons.clear();
+  m_pythonPoolSize = 2;
+  m_pythonPoolIdleTime = 300;
+  m_pythonPoolMaxRuns = 50;
+
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
@@ -404,6 +424,7 @@ bool CAdvancedSettings::Load()
   for (unsigned int i = 0; i < m_settingsFiles.size(); i++)
     ParseSettingsFile(m_settingsFiles[i]);
   ParseSettingsFile(CProfilesManager::Get().GetUserDataItem("advancedsettings.xml"));
+  CompileExcludeRegexps();
   return true;
 }
 
@@ -467,6 +488,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "streamsilence", m_streamSilence);
     XMLUtils::GetString(pElement, "transcodeto", m_audioTranscodeTo);
     XMLUtils::GetInt(pElement, "audiosinkbufferdurationmsec", m_audioSinkBufferDurationMsec);
+    XMLUtils::GetInt(pElement, "decodeahead", m_audioDecodeAhead, 1, 30);
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
@@ -707,6 +729,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "prioritiseapetags", m_prioritiseAPEv2tags);
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "albumssortbyartistthenyear", m_bMusicLibraryAlbumsSortByArtistThenYear);
+    XMLUtils::GetBoolean(pElement, "analyzereplaygain", m_bMusicLibraryAnalyzeReplayGain);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
@@ -731,6 +754,10 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    // folders listed ahead of the scanner at once per host, 0 to disable
+    XMLUtils::GetInt(pElement, "threadsperhost", m_iVideoScannerThreadsPerHost, 0, 8);
+    // items added to the library per database transaction
+    XMLUtils::GetInt(pElement, "batchsize", m_iVideoScannerBatchSize, 1, 1000);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -754,6 +781,10 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetInt(pElement, "curlsegments", m_curlSegments, 0, 8);
+    XMLUtils::GetInt(pElement, "curlsegmentsize", m_curlSegmentSize, 128, 4096);
+    XMLUtils::GetInt(pElement, "curlsegmentbuffer", m_curlSegmentBuffer, 1024, 65536);
+    XMLUtils::GetInt(pElement, "curlstatcachetime", m_curlStatCacheTime, 0, 300);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
   }
 
@@ -770,6 +801,19 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pElement,  "doscodepage",   m_sambadoscodepage);
     XMLUtils::GetInt(pElement, "clienttimeout", m_sambaclienttimeout, 5, 100);
     XMLUtils::GetBoolean(pElement, "statfiles", m_sambastatfiles);
+    XMLUtils::GetInt(pElement, "readsize", m_sambaReadSize, 64, 16384);
+    XMLUtils::GetInt(pElement, "readahead", m_sambaReadAhead, 0, 32);
+  }
+
+  pElement = pRootElement->FirstChildElement("nfs");
+  if (pElement)
+    XMLUtils::GetInt(pElement, "readrequests", m_nfsReadRequests, 0, 64);
+
+  pElement = pRootElement->FirstChildElement("vfsstatistics");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "enabled", m_vfsStatistics);
+    XMLUtils::GetPath(pElement, "tracefile", m_vfsTraceFile);
   }
 
   pElement = pRootElement->FirstChildElement("httpdirectory");
@@ -920,6 +964,10 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     m_cachePath = tmp;
   URIUtils::AddSlashAtEnd(m_cachePath);
 
+  pElement = pRootElement->FirstChildElement("scrapercache");
+  if (pElement)
+    XMLUtils::GetInt(pElement, "ttl", m_iScraperCacheTTL, 0, 24 * 365);
+
   g_LangCodeExpander.LoadUserCodes(pRootElement->FirstChildElement("languagecodes"));
 
   // trailer matching regexps
@@ -1020,6 +1068,23 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     }
   }
 
+  // add-ons whose python interpreter is kept warm between plugin listings
+  pElement = pRootElement->FirstChildElement("pythonpool");
+  if (pElement)
+  {
+    m_pythonPoolAddons.clear();
+    TiXmlElement* pAddon = pElement->FirstChildElement("addon");
+    while (pAddon)
+    {
+      if (pAddon->GetText())
+        m_pythonPoolAddons.push_back(pAddon->GetText());
+      pAddon = pAddon->NextSiblingElement("addon");
+    }
+    XMLUtils::GetInt(pElement, "size", m_pythonPoolSize, 1, 8);
+    XMLUtils::GetInt(pElement, "idletime", m_pythonPoolIdleTime, 10, 3600);
+    XMLUtils::GetInt(pElement, "maxruns", m_pythonPoolMaxRuns, 1, 10000);
+  }
+
   TiXmlElement* pHostEntries = pRootElement->FirstChildElement("hosts");
   if (pHostEntries)
   {
@@ -1135,6 +1200,7 @@ void CAdvancedSettings::Clear()
   m_audioExcludeFromScanRegExps.clear();
   m_audioExcludeFromListingRegExps.clear();
   m_pictureExcludeFromListingRegExps.clear();
+  CompileExcludeRegexps();
 
   m_pictureExtensions.clear();
   m_musicExtensions.clear();
@@ -1202,6 +1268,31 @@ void CAdvancedSettings::GetCustomTVRegexps(TiXmlElement *pRootElement, SETTINGS_
   }
 }
 
+void CAdvancedSettings::CompileExcludeRegexps()
+{
+  CompileRegexps(m_videoExcludeFromListingRegExps, m_videoExcludeFromListing);
+  CompileRegexps(m_moviesExcludeFromScanRegExps, m_moviesExcludeFromScan);
+  CompileRegexps(m_tvshowExcludeFromScanRegExps, m_tvshowExcludeFromScan);
+  CompileRegexps(m_audioExcludeFromListingRegExps, m_audioExcludeFromListing);
+  CompileRegexps(m_audioExcludeFromScanRegExps, m_audioExcludeFromScan);
+  CompileRegexps(m_pictureExcludeFromListingRegExps, m_pictureExcludeFromListing);
+}
+
+void CAdvancedSettings::CompileRegexps(const CStdStringArray& regexps, std::vector<CRegExp>& compiled)
+{
+  compiled.clear();
+  for (unsigned int i = 0; i < regexps.size(); i++)
+  {
+    CRegExp regExp(true); // case insensitive regex
+    if (!regExp.RegComp(regexps[i].c_str()))
+    { // invalid regexp - complain in logs
+      CLog::Log(LOGERROR, "%s: Invalid RegExp:'%s'", __FUNCTION__, regexps[i].c_str());
+      continue;
+    }
+    compiled.push_back(regExp);
+  }
+}
+
 void CAdvancedSettings::GetCustomRegexps(TiXmlElement *pRootElement, CStdStringArray& settings)
 {
   TiXmlElement *pElement = pRootElement;
@@ -25,6 +25,7 @@
 #include "settings/ISettingsHandler.h"
 #include "utils/StdString.h"
 #include "utils/GlobalsHandling.h"
+#include "utils/RegExp.h"
 
 class TiXmlElement;
 namespace ADDON
@@ -110,6 +111,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     static void GetCustomRegexps(TiXmlElement *pRootElement, CStdStringArray& settings);
     static void GetCustomRegexpReplacers(TiXmlElement *pRootElement, CStdStringArray& settings);
     static void GetCustomExtensions(TiXmlElement *pRootElement, CStdString& extensions);
+    /*! \brief Compile a list of regexps case insensitively, invalid ones are logged and left out */
+    static void CompileRegexps(const CStdStringArray& regexps, std::vector<CRegExp>& compiled);
 
     int m_audioHeadRoom;
     float m_ac3Gain;
@@ -123,6 +126,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_allChannelStereo;
     bool m_streamSilence;
     int m_audioSinkBufferDurationMsec;
+    int m_audioDecodeAhead;
     CStdString m_audioTranscodeTo;
     float m_limiterHold;
     float m_limiterRelease;
@@ -202,6 +206,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_fullScreenOnMovieStart;
     CStdString m_cachePath;
+    int m_iScraperCacheTTL; ///< hours scraper web pages are cached for, 0 to disable
     CStdString m_videoCleanDateTimeRegExp;
     CStdStringArray m_videoCleanStringRegExps;
     CStdStringArray m_videoExcludeFromListingRegExps;
@@ -210,6 +215,13 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     CStdStringArray m_audioExcludeFromListingRegExps;
     CStdStringArray m_audioExcludeFromScanRegExps;
     CStdStringArray m_pictureExcludeFromListingRegExps;
+    // the exclude lists above, compiled once they are loaded, to pass to CUtil::ExcludeFileOrFolder()
+    std::vector<CRegExp> m_videoExcludeFromListing;
+    std::vector<CRegExp> m_moviesExcludeFromScan;
+    std::vector<CRegExp> m_tvshowExcludeFromScan;
+    std::vector<CRegExp> m_audioExcludeFromListing;
+    std::vector<CRegExp> m_audioExcludeFromScan;
+    std::vector<CRegExp> m_pictureExcludeFromListing;
     CStdStringArray m_videoStackRegExps;
     CStdStringArray m_folderStackRegExps;
     CStdStringArray m_trailerMatchRegExps;
@@ -234,6 +246,11 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_sambaclienttimeout;
     CStdString m_sambadoscodepage;
     bool m_sambastatfiles;
+    int m_sambaReadSize; ///< largest read sent to a samba server in one request, in KB
+    int m_sambaReadAhead; ///< blocks of m_sambaReadSize read ahead per samba file, 0 disables read-ahead
+    int m_nfsReadRequests; ///< read requests kept in flight per nfs file, 0 reads synchronously
+    bool m_vfsStatistics; ///< count the I/O done through CFile per protocol and host
+    CStdString m_vfsTraceFile; ///< file every I/O operation is written to, empty disables tracing
 
     bool m_bHTTPDirectoryStatFilesize;
 
@@ -246,6 +263,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iMusicLibraryRecentlyAddedItems;
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryAlbumsSortByArtistThenYear;
+    bool m_bMusicLibraryAnalyzeReplayGain;
     CStdString m_strMusicLibraryAlbumFormat;
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
@@ -263,6 +281,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_iVideoScannerThreadsPerHost;
+    int m_iVideoScannerBatchSize;
     int m_iVideoLibraryDateAdded;
 
     std::vector<CStdString> m_vecTokens; // cleaning strings tied to language
@@ -304,6 +324,10 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    int m_curlSegments; ///< parallel range requests per http file, 0 or 1 reads through a single request
+    int m_curlSegmentSize; ///< size of the first range requested per connection, in KB
+    int m_curlSegmentBuffer; ///< memory the ranges of one file may hold, in KB
+    int m_curlStatCacheTime; ///< seconds stat and exists are answered from recent responses, 0 disables
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -362,6 +386,11 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int  m_guiDirtyRegionNoFlipTimeout;
     unsigned int m_addonPackageFolderSize;
 
+    std::vector<CStdString> m_pythonPoolAddons; ///< plugins that keep a warm interpreter between listings
+    int m_pythonPoolSize;                       ///< maximum number of idle interpreters kept around
+    int m_pythonPoolIdleTime;                   ///< seconds before an idle interpreter is shut down
+    int m_pythonPoolMaxRuns;                    ///< invocations before an interpreter is recycled
+
     unsigned int m_cacheMemBufferSize;
 
     bool m_jsonOutputCompact;
@@ -370,6 +399,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_enableMultimediaKeys;
     std::vector<CStdString> m_settingsFiles;
     void ParseSettingsFile(const CStdString &file);
+    void CompileExcludeRegexps();
 
     float GetDisplayLatency(float refreshrate);
     bool m_initialized;
@@ -112,3 +112,56 @@ TEST(TestFileItem, GetBaseMoviePath)
     EXPECT_EQ(path, compare);
   }
 }
+
+TEST(TestFileItem, Properties)
+{
+  CFileItem item;
+  EXPECT_FALSE(item.HasProperties());
+  EXPECT_TRUE(item.GetProperty("TestFileItemNeverSet").isNull());
+
+  item.SetProperty("Rating", 5);
+  item.SetProperty("artist_description", "text");
+  EXPECT_TRUE(item.HasProperty("rating"));
+  EXPECT_EQ(5, item.GetProperty("RATING").asInteger());
+
+  item.SetProperty("rating", 7);
+  EXPECT_EQ(7, item.GetProperty("Rating").asInteger());
+
+  CFileItem other;
+  other.SetProperty("rating", 9);
+  other.SetProperty("year", 1999);
+  item.AppendProperties(other);
+  EXPECT_EQ(9, item.GetProperty("rating").asInteger());
+  EXPECT_EQ(1999, item.GetProperty("year").asInteger());
+  EXPECT_EQ("text", item.GetProperty("artist_description").asString());
+
+  item.ClearProperty("Year");
+  EXPECT_FALSE(item.HasProperty("year"));
+  item.ClearProperties();
+  EXPECT_FALSE(item.HasProperties());
+}
+
+TEST(TestFileItem, Art)
+{
+  CFileItem item;
+  EXPECT_FALSE(item.HasArt());
+
+  item.SetArt("thumb", "thumb.jpg");
+  item.SetArt("artist.fanart", "fanart.jpg");
+  item.SetArtFallback("fanart", "artist.fanart");
+  EXPECT_TRUE(item.HasArt());
+  EXPECT_EQ("thumb.jpg", item.GetArt("thumb"));
+  EXPECT_EQ("fanart.jpg", item.GetArt("fanart"));
+  EXPECT_EQ("", item.GetArt("Thumb"));
+
+  CGUIListItem::ArtMap art = item.GetArt();
+  EXPECT_EQ(2U, art.size());
+  EXPECT_EQ("fanart.jpg", art["artist.fanart"]);
+
+  item.SetArt("fanart", "own.jpg");
+  EXPECT_EQ("own.jpg", item.GetArt("fanart"));
+
+  item.ClearArt();
+  EXPECT_FALSE(item.HasArt());
+  EXPECT_EQ("", item.GetArt("fanart"));
+}
@@ -47,3 +47,109 @@ TEST(TestTextureCache, GetWrappedImageURL)
     EXPECT_EQ(out, expected);
   }
 }
+
+class CFakeTextureDatabase
+{
+public:
+  CFakeTextureDatabase() : nextID(1), transactions(0), failAdds(false) {}
+
+  void BeginTransaction() { transactions++; }
+  bool CommitTransaction() { return true; }
+
+  bool AddCachedTexture(const CStdString &url, CTextureDetails &details)
+  {
+    if (failAdds)
+      return false;
+    details.id = nextID++;
+    added[url] = details;
+    return true;
+  }
+  bool SetCachedTextureValid(const CStdString &url, bool updateable)
+  {
+    valid[url] = updateable;
+    return true;
+  }
+  bool IncrementUseCount(const CTextureDetails &details, unsigned int count)
+  {
+    useCounts[details.id] += count;
+    return true;
+  }
+
+  int nextID;
+  int transactions;
+  bool failAdds;
+  std::map<CStdString, CTextureDetails> added;
+  std::map<CStdString, bool> valid;
+  std::map<int, unsigned int> useCounts;
+};
+
+static CTextureDetails TextureDetails(int id, const std::string &file)
+{
+  CTextureDetails details;
+  details.id = id;
+  details.file = file;
+  return details;
+}
+
+TEST(TestTextureCache, UpdatesMergePerImage)
+{
+  CTextureUpdates updates;
+  updates.SetTextureValid("a.jpg", true);
+  updates.IncrementUseCount("a.jpg", TextureDetails(7, "a"));
+  updates.AddTexture("a.jpg", TextureDetails(-1, "a"));
+  updates.SetTextureValid("a.jpg", true);
+  updates.SetTextureValid("b.jpg", false);
+  for (int i = 0; i < 3; i++)
+    updates.IncrementUseCount("c.jpg", TextureDetails(9, "c"));
+  EXPECT_EQ(3U, updates.GetSize());
+
+  CFakeTextureDatabase database;
+  CTextureUpdates::IDMap ids;
+  EXPECT_EQ(0U, updates.Write(database, ids));
+  EXPECT_TRUE(updates.IsEmpty());
+  EXPECT_EQ(1, database.transactions);
+
+  // the addition replaces what came before it and takes what follows
+  ASSERT_EQ(1U, database.added.size());
+  EXPECT_TRUE(database.added["a.jpg"].updateable);
+  EXPECT_EQ(0U, database.useCounts.count(7));
+  ASSERT_EQ(1U, database.valid.size());
+  EXPECT_FALSE(database.valid["b.jpg"]);
+  EXPECT_EQ(3U, database.useCounts[9]);
+}
+
+TEST(TestTextureCache, UpdatesResolveIDsOfAddedTextures)
+{
+  CFakeTextureDatabase database;
+  CTextureUpdates::IDMap ids;
+  CTextureUpdates updates;
+
+  // counted before the texture had an id, in the same write
+  updates.AddTexture("a.jpg", TextureDetails(-1, "a"));
+  updates.IncrementUseCount("a.jpg", TextureDetails(-1, "a"));
+  EXPECT_EQ(0U, updates.Write(database, ids));
+  int id = database.added["a.jpg"].id;
+  EXPECT_EQ(1U, database.useCounts[id]);
+  EXPECT_EQ(id, ids["a.jpg"]);
+
+  // and in the next one
+  updates.IncrementUseCount("a.jpg", TextureDetails(-1, "a"));
+  updates.IncrementUseCount("unknown.jpg", TextureDetails(-1, "u"));
+  EXPECT_EQ(1U, updates.Write(database, ids));
+  EXPECT_EQ(2U, database.useCounts[id]);
+  EXPECT_TRUE(ids.empty());
+}
+
+TEST(TestTextureCache, UpdatesSkipFailedAdditions)
+{
+  CFakeTextureDatabase database;
+  database.failAdds = true;
+  CTextureUpdates::IDMap ids;
+  CTextureUpdates updates;
+
+  updates.AddTexture("a.jpg", TextureDetails(-1, "a"));
+  updates.IncrementUseCount("a.jpg", TextureDetails(-1, "a"));
+  EXPECT_EQ(1U, updates.Write(database, ids));
+  EXPECT_TRUE(ids.empty());
+  EXPECT_TRUE(database.useCounts.empty());
+}
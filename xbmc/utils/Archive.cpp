@@ -22,31 +22,42 @@
 #include "filesystem/File.h"
 #include "Variant.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 
-#define BUFFER_MAX 4096
+#define BUFFER_MAX 65536
 
 CArchive::CArchive(CFile* pFile, int mode)
 {
   m_pFile = pFile;
   m_iMode = mode;
 
-  m_pBuffer = new BYTE[BUFFER_MAX];
+  m_pBuffer = new uint8_t[BUFFER_MAX];
   memset(m_pBuffer, 0, BUFFER_MAX);
 
   m_BufferPos = 0;
+  m_BufferRemain = 0;
 }
 
 CArchive::~CArchive()
 {
-  FlushBuffer();
+  Close();
   delete[] m_pBuffer;
   m_BufferPos = 0;
 }
 
 void CArchive::Close()
 {
-  FlushBuffer();
+  if (m_iMode == store)
+    FlushBuffer();
+  else if (m_BufferRemain > 0)
+  {
+    // give back what was read ahead, so the file is positioned after the last value loaded
+    m_pFile->Seek(-(int64_t)m_BufferRemain, SEEK_CUR);
+    m_BufferPos = 0;
+    m_BufferRemain = 0;
+  }
 }
 
 bool CArchive::IsLoading()
@@ -59,184 +70,127 @@ bool CArchive::IsStoring()
   return (m_iMode == store);
 }
 
-CArchive& CArchive::operator<<(float f)
+CArchive& CArchive::streamout(const void* dataPtr, size_t size)
 {
-  int size = sizeof(float);
-  if (m_BufferPos + size >= BUFFER_MAX)
+  const uint8_t* ptr = (const uint8_t*)dataPtr;
+  if (m_BufferPos + size > BUFFER_MAX)
+  {
     FlushBuffer();
+    if (size > BUFFER_MAX)
+    {
+      // too large to stage, write it straight through
+      m_pFile->Write(ptr, size);
+      return *this;
+    }
+  }
 
-  memcpy(&m_pBuffer[m_BufferPos], &f, size);
+  memcpy(&m_pBuffer[m_BufferPos], ptr, size);
   m_BufferPos += size;
 
   return *this;
 }
 
-CArchive& CArchive::operator<<(double d)
+CArchive& CArchive::streamin(void* dataPtr, size_t size)
 {
-  int size = sizeof(double);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
+  uint8_t* ptr = (uint8_t*)dataPtr;
+  while (size > 0)
+  {
+    if (m_BufferRemain == 0)
+    {
+      if (size > BUFFER_MAX)
+      {
+        // too large to stage, read it straight through
+        if (m_pFile->Read(ptr, size) != size)
+          memset(ptr, 0, size);
+        return *this;
+      }
+
+      unsigned int read = m_pFile->Read(m_pBuffer, BUFFER_MAX);
+      if (read == 0 || read > BUFFER_MAX)
+      {
+        // truncated archive, hand out zeros rather than garbage
+        memset(ptr, 0, size);
+        return *this;
+      }
+      m_BufferPos = 0;
+      m_BufferRemain = (size_t)read;
+    }
 
-  memcpy(&m_pBuffer[m_BufferPos], &d, size);
-  m_BufferPos += size;
+    size_t chunk = std::min(size, m_BufferRemain);
+    memcpy(ptr, &m_pBuffer[m_BufferPos], chunk);
+    m_BufferPos += chunk;
+    m_BufferRemain -= chunk;
+    ptr += chunk;
+    size -= chunk;
+  }
 
   return *this;
 }
 
-CArchive& CArchive::operator<<(int i)
+CArchive& CArchive::operator<<(float f)
 {
-  int size = sizeof(int);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
+  return streamout(&f, sizeof(f));
+}
 
-  memcpy(&m_pBuffer[m_BufferPos], &i, size);
-  m_BufferPos += size;
+CArchive& CArchive::operator<<(double d)
+{
+  return streamout(&d, sizeof(d));
+}
 
-  return *this;
+CArchive& CArchive::operator<<(int i)
+{
+  return streamout(&i, sizeof(i));
 }
 
 CArchive& CArchive::operator<<(unsigned int i)
 {
-  int size = sizeof(unsigned int);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  memcpy(&m_pBuffer[m_BufferPos], &i, size);
-  m_BufferPos += size;
-
-  return *this;
+  return streamout(&i, sizeof(i));
 }
 
 CArchive& CArchive::operator<<(int64_t i64)
 {
-  int size = sizeof(int64_t);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  memcpy(&m_pBuffer[m_BufferPos], &i64, size);
-  m_BufferPos += size;
-
-  return *this;
+  return streamout(&i64, sizeof(i64));
 }
 
 CArchive& CArchive::operator<<(uint64_t ui64)
 {
-  int size = sizeof(uint64_t);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  memcpy(&m_pBuffer[m_BufferPos], &ui64, size);
-  m_BufferPos += size;
-
-  return *this;
+  return streamout(&ui64, sizeof(ui64));
 }
 
 CArchive& CArchive::operator<<(bool b)
 {
-  int size = sizeof(bool);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  memcpy(&m_pBuffer[m_BufferPos], &b, size);
-  m_BufferPos += size;
-
-  return *this;
+  return streamout(&b, sizeof(b));
 }
 
 CArchive& CArchive::operator<<(char c)
 {
-  int size = sizeof(char);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  memcpy(&m_pBuffer[m_BufferPos], &c, size);
-  m_BufferPos += size;
-
-  return *this;
+  return streamout(&c, sizeof(c));
 }
 
 CArchive& CArchive::operator<<(const std::string& str)
 {
   *this << (int)str.size();
 
-  int size = str.size();
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  int iBufferMaxParts=size/BUFFER_MAX;
-  for (int i=0; i<iBufferMaxParts; i++)
-  {
-    memcpy(&m_pBuffer[m_BufferPos], str.c_str()+(i*BUFFER_MAX), BUFFER_MAX);
-    m_BufferPos+=BUFFER_MAX;
-    FlushBuffer();
-  }
-
-  int iPos=iBufferMaxParts*BUFFER_MAX;
-  int iSizeLeft=size-iPos;
-  memcpy(&m_pBuffer[m_BufferPos], str.c_str()+iPos, iSizeLeft);
-  m_BufferPos+=iSizeLeft;
-
-  return *this;
+  return streamout(str.data(), str.size());
 }
 
 CArchive& CArchive::operator<<(const CStdString& str)
 {
   *this << str.GetLength();
 
-  int size = str.GetLength();
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  int iBufferMaxParts=size/BUFFER_MAX;
-  for (int i=0; i<iBufferMaxParts; i++)
-  {
-    memcpy(&m_pBuffer[m_BufferPos], str.c_str()+(i*BUFFER_MAX), BUFFER_MAX);
-    m_BufferPos+=BUFFER_MAX;
-    FlushBuffer();
-  }
-
-  int iPos=iBufferMaxParts*BUFFER_MAX;
-  int iSizeLeft=size-iPos;
-  memcpy(&m_pBuffer[m_BufferPos], str.c_str()+iPos, iSizeLeft);
-  m_BufferPos+=iSizeLeft;
-
-  return *this;
+  return streamout(str.c_str(), str.GetLength());
 }
 
 CArchive& CArchive::operator<<(const CStdStringW& str)
 {
   *this << str.GetLength();
 
-  int size = str.GetLength() * sizeof(wchar_t);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  int iBufferMaxParts=size/BUFFER_MAX;
-  for (int i=0; i<iBufferMaxParts; ++i)
-  {
-    memcpy(&m_pBuffer[m_BufferPos], str.c_str()+(i*BUFFER_MAX), BUFFER_MAX);
-    m_BufferPos+=BUFFER_MAX;
-    FlushBuffer();
-  }
-
-  int iPos=iBufferMaxParts*BUFFER_MAX;
-  int iSizeLeft=size-iPos;
-  memcpy(&m_pBuffer[m_BufferPos], str.c_str()+iPos, iSizeLeft);
-  m_BufferPos+=iSizeLeft;
-
-  return *this;
+  return streamout(str.c_str(), str.GetLength() * sizeof(wchar_t));
 }
 
 CArchive& CArchive::operator<<(const SYSTEMTIME& time)
 {
-  int size = sizeof(SYSTEMTIME);
-  if (m_BufferPos + size >= BUFFER_MAX)
-    FlushBuffer();
-
-  memcpy(&m_pBuffer[m_BufferPos], &time, size);
-  m_BufferPos += size;
-
-  return *this;
+  return streamout(&time, sizeof(SYSTEMTIME));
 }
 
 CArchive& CArchive::operator<<(IArchivable& obj)
@@ -308,58 +262,42 @@ CArchive& CArchive::operator<<(const std::vector<int>& iArray)
 
 CArchive& CArchive::operator>>(float& f)
 {
-  m_pFile->Read((void*)&f, sizeof(float));
-
-  return *this;
+  return streamin(&f, sizeof(f));
 }
 
 CArchive& CArchive::operator>>(double& d)
 {
-  m_pFile->Read((void*)&d, sizeof(double));
-
-  return *this;
+  return streamin(&d, sizeof(d));
 }
 
 CArchive& CArchive::operator>>(int& i)
 {
-  m_pFile->Read((void*)&i, sizeof(int));
-
-  return *this;
+  return streamin(&i, sizeof(i));
 }
 
 CArchive& CArchive::operator>>(unsigned int& i)
 {
-  m_pFile->Read((void*)&i, sizeof(unsigned int));
-
-  return *this;
+  return streamin(&i, sizeof(i));
 }
 
 CArchive& CArchive::operator>>(int64_t& i64)
 {
-  m_pFile->Read((void*)&i64, sizeof(int64_t));
-
-  return *this;
+  return streamin(&i64, sizeof(i64));
 }
 
 CArchive& CArchive::operator>>(uint64_t& ui64)
 {
-  m_pFile->Read((void*)&ui64, sizeof(uint64_t));
-
-  return *this;
+  return streamin(&ui64, sizeof(ui64));
 }
 
 CArchive& CArchive::operator>>(bool& b)
 {
-  m_pFile->Read((void*)&b, sizeof(bool));
-
-  return *this;
+  return streamin(&b, sizeof(b));
 }
 
 CArchive& CArchive::operator>>(char& c)
 {
-  m_pFile->Read((void*)&c, sizeof(char));
-
-  return *this;
+  return streamin(&c, sizeof(c));
 }
 
 CArchive& CArchive::operator>>(std::string& str)
@@ -367,10 +305,9 @@ CArchive& CArchive::operator>>(std::string& str)
   int iLength = 0;
   *this >> iLength;
 
-  char *s = new char[iLength];
-  m_pFile->Read(s, iLength);
-  str.assign(s, iLength);
-  delete[] s;
+  str.resize(std::max(iLength, 0));
+  if (!str.empty())
+    streamin(&str[0], str.size());
 
   return *this;
 }
@@ -379,11 +316,11 @@ CArchive& CArchive::operator>>(CStdString& str)
 {
   int iLength = 0;
   *this >> iLength;
+  iLength = std::max(iLength, 0);
 
-  m_pFile->Read((void*)str.GetBufferSetLength(iLength), iLength);
+  streamin(str.GetBufferSetLength(iLength), iLength);
   str.ReleaseBuffer();
 
-
   return *this;
 }
 
@@ -391,19 +328,17 @@ CArchive& CArchive::operator>>(CStdStringW& str)
 {
   int iLength = 0;
   *this >> iLength;
+  iLength = std::max(iLength, 0);
 
-  m_pFile->Read((void*)str.GetBufferSetLength(iLength), iLength * sizeof(wchar_t));
+  streamin(str.GetBufferSetLength(iLength), iLength * sizeof(wchar_t));
   str.ReleaseBuffer();
 
-
   return *this;
 }
 
 CArchive& CArchive::operator>>(SYSTEMTIME& time)
 {
-  m_pFile->Read((void*)&time, sizeof(SYSTEMTIME));
-
-  return *this;
+  return streamin(&time, sizeof(SYSTEMTIME));
 }
 
 CArchive& CArchive::operator>>(IArchivable& obj)
@@ -87,10 +87,13 @@ public:
   enum Mode {load = 0, store};
 
 protected:
+  CArchive& streamout(const void* dataPtr, size_t size);
+  CArchive& streamin(void* dataPtr, size_t size);
   void FlushBuffer();
   XFILE::CFile* m_pFile;
   int m_iMode;
   uint8_t *m_pBuffer;
-  int m_BufferPos;
+  size_t m_BufferPos;
+  size_t m_BufferRemain; // bytes read ahead but not consumed yet, when loading
 };
 
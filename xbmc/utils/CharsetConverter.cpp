@@ -29,6 +29,7 @@
 
 #include <errno.h>
 #include <iconv.h>
+#include <vector>
 
 #if defined(TARGET_DARWIN)
 #ifdef __POWERPC__
@@ -55,18 +56,23 @@
 #endif
 
 
-static iconv_t m_iconvStringCharsetToFontCharset = (iconv_t)-1;
-static iconv_t m_iconvSubtitleCharsetToW         = (iconv_t)-1;
-static iconv_t m_iconvUtf8ToStringCharset        = (iconv_t)-1;
-static iconv_t m_iconvStringCharsetToUtf8        = (iconv_t)-1;
-static iconv_t m_iconvUcs2CharsetToStringCharset = (iconv_t)-1;
-static iconv_t m_iconvUtf32ToStringCharset       = (iconv_t)-1;
-static iconv_t m_iconvWtoUtf8                    = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoW                 = (iconv_t)-1;
-static iconv_t m_iconvUtf16BEtoUtf8              = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoUtf8              = (iconv_t)-1;
-static iconv_t m_iconvUtf8toW                    = (iconv_t)-1;
-static iconv_t m_iconvUcs2CharsetToUtf8          = (iconv_t)-1;
+/* shared conversions, indexing the iconv handles of a CConverterState */
+enum ConverterId
+{
+  IconvStringCharsetToFontCharset = 0,
+  IconvSubtitleCharsetToW,
+  IconvUtf8ToStringCharset,
+  IconvStringCharsetToUtf8,
+  IconvUcs2CharsetToStringCharset,
+  IconvUtf32ToStringCharset,
+  IconvWtoUtf8,
+  IconvUtf16LEtoW,
+  IconvUtf16BEtoUtf8,
+  IconvUtf16LEtoUtf8,
+  IconvUtf8toW,
+  IconvUcs2CharsetToUtf8,
+  IconvCount
+};
 
 #if defined(FRIBIDI_CHAR_SET_NOT_FOUND)
 static FriBidiCharSet m_stringFribidiCharset     = FRIBIDI_CHAR_SET_NOT_FOUND;
@@ -78,7 +84,7 @@ static FriBidiCharSet m_stringFribidiCharset     = FRIBIDI_CHARSET_NOT_FOUND;
 #define FRIBIDI_NOTFOUND FRIBIDI_CHARSET_NOT_FOUND
 #endif
 
-static CCriticalSection            m_critSection;
+static CCriticalSection            m_critSection; // fribidi is not thread safe
 
 static struct SFribidMapping
 {
@@ -142,6 +148,61 @@ static struct SCharsetMapping
 #define ICONV_PREPARE(iconv) iconv=(iconv_t)-1
 #define ICONV_SAFE_CLOSE(iconv) if (iconv!=(iconv_t)-1) { iconv_close(iconv); iconv=(iconv_t)-1; }
 
+/* iconv handles can't be shared between threads. Instead of serialising every conversion
+   through one lock, each conversion borrows a set of handles from a pool and returns it
+   when done, so there are as many sets as threads converting at the same time. reset()
+   bumps the generation, which makes stale sets close their handles when next borrowed. */
+struct CConverterState
+{
+  iconv_t      handles[IconvCount];
+  unsigned int generation;
+};
+
+static CCriticalSection              m_poolSection;
+static std::vector<CConverterState*> m_freeStates;
+static unsigned int                  m_generation = 0;
+
+class CConverterLease
+{
+public:
+  CConverterLease()
+  {
+    CSingleLock lock(m_poolSection);
+    if (m_freeStates.empty())
+    {
+      m_state = new CConverterState;
+      for (int i = 0; i < IconvCount; i++)
+        m_state->handles[i] = (iconv_t)-1;
+      m_state->generation = m_generation;
+    }
+    else
+    {
+      m_state = m_freeStates.back();
+      m_freeStates.pop_back();
+    }
+    bool stale = m_state->generation != m_generation;
+    m_state->generation = m_generation;
+    lock.Leave();
+
+    if (stale)
+    {
+      for (int i = 0; i < IconvCount; i++)
+        ICONV_SAFE_CLOSE(m_state->handles[i]);
+    }
+  }
+
+  ~CConverterLease()
+  {
+    CSingleLock lock(m_poolSection);
+    m_freeStates.push_back(m_state);
+  }
+
+  iconv_t &operator[](ConverterId id) { return m_state->handles[id]; }
+
+private:
+  CConverterState *m_state;
+};
+
 size_t iconv_const (void* cd, const char** inbuf, size_t *inbytesleft,
                     char* * outbuf, size_t *outbytesleft)
 {
@@ -275,8 +336,160 @@ static void convert(iconv_t& type, int multiplier, const CStdString& strFromChar
 
 using namespace std;
 
+#define ASCII_WORD_MASK 0x8080808080808080ULL
+#define ASCII_WORD_ONES 0x0101010101010101ULL
+
+// length of the leading run of non-NUL 7-bit characters, checked 8 bytes at a time
+static size_t asciiRunLength(const unsigned char *s, const unsigned char *end)
+{
+  const unsigned char *start = s;
+  while (end - s >= 8)
+  {
+    uint64_t word;
+    memcpy(&word, s, sizeof(word));
+    // a set high bit is either a non-ASCII byte, or the borrow from a NUL byte
+    if ((word | (word - ASCII_WORD_ONES)) & ASCII_WORD_MASK)
+      break;
+    s += 8;
+  }
+  while (s < end && *s && *s < 0x80)
+    s++;
+  return s - start;
+}
+
+#if !defined(TARGET_DARWIN)
+/* UTF-8 <-> wchar_t without iconv. The output matches the iconv based conversion: it stops
+   at the first NUL and skips a byte wherever the input is not a valid UTF-8 sequence
+   (bad continuation bytes, overlong forms, surrogates and code points above U+10FFFF).
+   Darwin is left to iconv as it needs to compose decomposed UTF-8-MAC input. */
+static void utf8ToWNative(const CStdStringA& strSource, CStdStringW& strDest)
+{
+  const unsigned char *s   = (const unsigned char *)strSource.c_str();
+  const unsigned char *end = s + strSource.length();
+
+  // every code point takes at least as many bytes as wchar_t units
+  wchar_t *buffer = strDest.GetBuffer(strSource.length() + 1);
+  wchar_t *d = buffer;
+
+  while (s < end)
+  {
+    size_t run = asciiRunLength(s, end);
+    for (size_t i = 0; i < run; i++)
+      *d++ = s[i];
+    s += run;
+    if (s >= end || *s == 0)
+      break;
+
+    unsigned int c = *s;
+    unsigned int cp, min;
+    int len;
+    if (c >= 0xC2 && c <= 0xDF)
+    {
+      len = 2; cp = c & 0x1F; min = 0x80;
+    }
+    else if ((c & 0xF0) == 0xE0)
+    {
+      len = 3; cp = c & 0x0F; min = 0x800;
+    }
+    else if (c >= 0xF0 && c <= 0xF4)
+    {
+      len = 4; cp = c & 0x07; min = 0x10000;
+    }
+    else
+    {
+      s++; // invalid lead byte
+      continue;
+    }
+
+    bool valid = end - s >= len;
+    for (int i = 1; valid && i < len; i++)
+    {
+      if ((s[i] & 0xC0) != 0x80)
+        valid = false;
+      else
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    if (!valid || cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+    {
+      s++;
+      continue;
+    }
+    s += len;
+
+    if (sizeof(wchar_t) == 2 && cp >= 0x10000)
+    {
+      cp -= 0x10000;
+      *d++ = (wchar_t)(0xD800 | (cp >> 10));
+      *d++ = (wchar_t)(0xDC00 | (cp & 0x3FF));
+    }
+    else
+      *d++ = (wchar_t)cp;
+  }
+
+  strDest.ReleaseBuffer(d - buffer);
+}
+
+static void wToUTF8Native(const CStdStringW& strSource, CStdStringA& strDest)
+{
+  const wchar_t *s   = strSource.c_str();
+  const wchar_t *end = s + strSource.length();
+
+  // 4 bytes per code point at most, which is 2 units when wchar_t is UTF-16
+  char *buffer = strDest.GetBuffer(strSource.length() * 4 + 1);
+  char *d = buffer;
+
+  while (s < end && *s)
+  {
+    uint32_t cp = (uint32_t)*s++;
+    if (cp < 0x80)
+    {
+      *d++ = (char)cp;
+      continue;
+    }
+    if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp <= 0xDBFF && s < end &&
+        (uint32_t)*s >= 0xDC00 && (uint32_t)*s <= 0xDFFF)
+      cp = 0x10000 + ((cp - 0xD800) << 10) + ((uint32_t)*s++ - 0xDC00);
+    else if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF)
+      continue; // lone surrogate or out of range
+
+    if (cp < 0x800)
+    {
+      *d++ = (char)(0xC0 | (cp >> 6));
+    }
+    else if (cp < 0x10000)
+    {
+      *d++ = (char)(0xE0 | (cp >> 12));
+      *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+    }
+    else
+    {
+      *d++ = (char)(0xF0 | (cp >> 18));
+      *d++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+      *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+    }
+    *d++ = (char)(0x80 | (cp & 0x3F));
+  }
+
+  strDest.ReleaseBuffer(d - buffer);
+}
+#endif
+
 static void logicalToVisualBiDi(const CStdStringA& strSource, CStdStringA& strDest, FriBidiCharSet fribidiCharset, FriBidiCharType base = FRIBIDI_TYPE_LTR, bool* bWasFlipped =NULL)
 {
+  // plain ASCII has nothing to reorder in a left to right paragraph, and all of the bidi
+  // charsets are ASCII supersets. Right to left paragraphs still reorder ASCII punctuation
+  // and words, and strings with line breaks still go through fribidi, which drops empty lines.
+  const unsigned char *source = (const unsigned char *)strSource.c_str();
+  if (base != FRIBIDI_TYPE_RTL &&
+      asciiRunLength(source, source + strSource.length()) == strSource.length() &&
+      strSource.find('\n') == CStdStringA::npos)
+  {
+    strDest = strSource;
+    if (bWasFlipped)
+      *bWasFlipped = false;
+    return;
+  }
+
   // libfribidi is not threadsafe, so make sure we make it so
   CSingleLock lock(m_critSection);
 
@@ -356,6 +569,15 @@ void CCharsetConverter::OnSettingChanged(const CSetting *setting)
 
 void CCharsetConverter::clear()
 {
+  // close the handles of every set that isn't borrowed, sets still in use go back to the pool
+  CSingleLock lock(m_poolSection);
+  for (std::vector<CConverterState*>::iterator it = m_freeStates.begin(); it != m_freeStates.end(); ++it)
+  {
+    for (int i = 0; i < IconvCount; i++)
+      ICONV_SAFE_CLOSE((*it)->handles[i]);
+    delete *it;
+  }
+  m_freeStates.clear();
 }
 
 vector<CStdString> CCharsetConverter::getCharsetLabels()
@@ -401,20 +623,13 @@ bool CCharsetConverter::isBidiCharset(const CStdString& charset)
 
 void CCharsetConverter::reset(void)
 {
-  CSingleLock lock(m_critSection);
-
-  ICONV_SAFE_CLOSE(m_iconvStringCharsetToFontCharset);
-  ICONV_SAFE_CLOSE(m_iconvUtf8ToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvStringCharsetToUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvSubtitleCharsetToW);
-  ICONV_SAFE_CLOSE(m_iconvWtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16BEtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16LEtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf32ToStringCharset);
-  ICONV_SAFE_CLOSE(m_iconvUtf8toW);
-  ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToUtf8);
+  {
+    // handles in use finish their conversion, all of them get reopened on their next use
+    CSingleLock poolLock(m_poolSection);
+    m_generation++;
+  }
 
+  CSingleLock lock(m_critSection);
 
   m_stringFribidiCharset = FRIBIDI_NOTFOUND;
 
@@ -436,21 +651,29 @@ void CCharsetConverter::utf8ToW(const CStdStringA& utf8String, CStdStringW &wStr
     CStdStringA strFlipped;
     FriBidiCharType charset = forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF;
     logicalToVisualBiDi(utf8String, strFlipped, FRIBIDI_UTF8, charset, bWasFlipped);
-    CSingleLock lock(m_critSection);
-    convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strFlipped,wString);
+#if defined(TARGET_DARWIN)
+    CConverterLease converters;
+    convert(converters[IconvUtf8toW],sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strFlipped,wString);
+#else
+    utf8ToWNative(strFlipped, wString);
+#endif
   }
   else
   {
-    CSingleLock lock(m_critSection);
-    convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,utf8String,wString);
+#if defined(TARGET_DARWIN)
+    CConverterLease converters;
+    convert(converters[IconvUtf8toW],sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,utf8String,wString);
+#else
+    utf8ToWNative(utf8String, wString);
+#endif
   }
 }
 
 void CCharsetConverter::subtitleCharsetToW(const CStdStringA& strSource, CStdStringW& strDest)
 {
   // No need to flip hebrew/arabic as mplayer does the flipping
-  CSingleLock lock(m_critSection);
-  convert(m_iconvSubtitleCharsetToW,sizeof(wchar_t),g_langInfo.GetSubtitleCharSet(),WCHAR_CHARSET,strSource,strDest);
+  CConverterLease converters;
+  convert(converters[IconvSubtitleCharsetToW],sizeof(wchar_t),g_langInfo.GetSubtitleCharSet(),WCHAR_CHARSET,strSource,strDest);
 }
 
 void CCharsetConverter::fromW(const CStdStringW& strSource,
@@ -473,8 +696,8 @@ void CCharsetConverter::toW(const CStdStringA& strSource,
 
 void CCharsetConverter::utf8ToStringCharset(const CStdStringA& strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
-  convert(m_iconvUtf8ToStringCharset,1,UTF8_SOURCE,g_langInfo.GetGuiCharSet(),strSource,strDest);
+  CConverterLease converters;
+  convert(converters[IconvUtf8ToStringCharset],1,UTF8_SOURCE,g_langInfo.GetGuiCharSet(),strSource,strDest);
 }
 
 void CCharsetConverter::utf8ToStringCharset(CStdStringA& strSourceDest)
@@ -536,43 +759,47 @@ void CCharsetConverter::unknownToUTF8(const CStdStringA &source, CStdStringA &de
     dest = source;
   else
   {
-    CSingleLock lock(m_critSection);
-    convert(m_iconvStringCharsetToUtf8, UTF8_DEST_MULTIPLIER, g_langInfo.GetGuiCharSet(), "UTF-8", source, dest);
+    CConverterLease converters;
+    convert(converters[IconvStringCharsetToUtf8], UTF8_DEST_MULTIPLIER, g_langInfo.GetGuiCharSet(), "UTF-8", source, dest);
   }
 }
 
 void CCharsetConverter::wToUTF8(const CStdStringW& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  convert(m_iconvWtoUtf8,UTF8_DEST_MULTIPLIER,WCHAR_CHARSET,"UTF-8",strSource,strDest);
+#if defined(TARGET_DARWIN)
+  CConverterLease converters;
+  convert(converters[IconvWtoUtf8],UTF8_DEST_MULTIPLIER,WCHAR_CHARSET,"UTF-8",strSource,strDest);
+#else
+  wToUTF8Native(strSource, strDest);
+#endif
 }
 
 void CCharsetConverter::utf16BEtoUTF8(const CStdString16& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16BEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16BE","UTF-8",strSource,strDest))
+  CConverterLease converters;
+  if(!convert_checked(converters[IconvUtf16BEtoUtf8],UTF8_DEST_MULTIPLIER,"UTF-16BE","UTF-8",strSource,strDest))
     strDest.clear();
 }
 
 void CCharsetConverter::utf16LEtoUTF8(const CStdString16& strSource,
                                       CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16LEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16LE","UTF-8",strSource,strDest))
+  CConverterLease converters;
+  if(!convert_checked(converters[IconvUtf16LEtoUtf8],UTF8_DEST_MULTIPLIER,"UTF-16LE","UTF-8",strSource,strDest))
     strDest.clear();
 }
 
 void CCharsetConverter::ucs2ToUTF8(const CStdString16& strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUcs2CharsetToUtf8,UTF8_DEST_MULTIPLIER,"UCS-2LE","UTF-8",strSource,strDest))
+  CConverterLease converters;
+  if(!convert_checked(converters[IconvUcs2CharsetToUtf8],UTF8_DEST_MULTIPLIER,"UCS-2LE","UTF-8",strSource,strDest))
     strDest.clear();
 }
 
 void CCharsetConverter::utf16LEtoW(const CStdString16& strSource, CStdStringW &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16LEtoW,sizeof(wchar_t),"UTF-16LE",WCHAR_CHARSET,strSource,strDest))
+  CConverterLease converters;
+  if(!convert_checked(converters[IconvUtf16LEtoW],sizeof(wchar_t),"UTF-16LE",WCHAR_CHARSET,strSource,strDest))
     strDest.clear();
 }
 
@@ -593,22 +820,23 @@ void CCharsetConverter::ucs2CharsetToStringCharset(const CStdStringW& strSource,
       s++;
     }
   }
-  CSingleLock lock(m_critSection);
-  convert(m_iconvUcs2CharsetToStringCharset,4,"UTF-16LE",
+  CConverterLease converters;
+  convert(converters[IconvUcs2CharsetToStringCharset],4,"UTF-16LE",
           g_langInfo.GetGuiCharSet(),strCopy,strDest);
 }
 
 void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CStdStringA& strDest)
 {
-  CSingleLock lock(m_critSection);
+  CConverterLease converters;
+  iconv_t &iconvUtf32ToStringCharset = converters[IconvUtf32ToStringCharset];
 
-  if (m_iconvUtf32ToStringCharset == (iconv_t) - 1)
+  if (iconvUtf32ToStringCharset == (iconv_t) - 1)
   {
     CStdString strCharset=g_langInfo.GetGuiCharSet();
-    m_iconvUtf32ToStringCharset = iconv_open(strCharset.c_str(), "UTF-32LE");
+    iconvUtf32ToStringCharset = iconv_open(strCharset.c_str(), "UTF-32LE");
   }
 
-  if (m_iconvUtf32ToStringCharset != (iconv_t) - 1)
+  if (iconvUtf32ToStringCharset != (iconv_t) - 1)
   {
     const unsigned long* ptr=strSource;
     while (*ptr) ptr++;
@@ -618,7 +846,7 @@ void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CSt
     char *dst = strDest.GetBuffer(inBytes);
     size_t outBytes = inBytes;
 
-    if (iconv_const(m_iconvUtf32ToStringCharset, &src, &inBytes, &dst, &outBytes) == (size_t)-1)
+    if (iconv_const(iconvUtf32ToStringCharset, &src, &inBytes, &dst, &outBytes) == (size_t)-1)
     {
       CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
       strDest.ReleaseBuffer();
@@ -626,7 +854,7 @@ void CCharsetConverter::utf32ToStringCharset(const unsigned long* strSource, CSt
       return;
     }
 
-    if (iconv(m_iconvUtf32ToStringCharset, NULL, NULL, &dst, &outBytes) == (size_t)-1)
+    if (iconv(iconvUtf32ToStringCharset, NULL, NULL, &dst, &outBytes) == (size_t)-1)
     {
       CLog::Log(LOGERROR, "%s failed cleanup", __FUNCTION__);
       strDest.ReleaseBuffer();
@@ -47,12 +47,10 @@ using namespace XFILE;
 
 CEdenVideoArtUpdater::CEdenVideoArtUpdater() : CThread("VideoArtUpdater")
 {
-  m_textureDB.Open();
 }
 
 CEdenVideoArtUpdater::~CEdenVideoArtUpdater()
 {
-  m_textureDB.Close();
 }
 
 void CEdenVideoArtUpdater::Start()
@@ -320,7 +318,7 @@ bool CEdenVideoArtUpdater::CacheTexture(std::string &originalUrl, const std::str
       details.height = height;
       type = CVideoInfoScanner::GetArtTypeFromSize(details.width, details.height);
       delete texture;
-      m_textureDB.AddCachedTexture(originalUrl, details);
+      CTextureCache::Get().AddCachedTexture(originalUrl, details);
       return true;
     }
   }
@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LoudnessMeter.h"
+
+#include <algorithm>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// mean square of a block at the absolute gate of -70 LUFS
+static const double AbsoluteGate = pow(10.0, (-70.0 + 0.691) / 10.0);
+
+CLoudnessMeter::CLoudnessMeter()
+{
+  Reset(48000, 2);
+}
+
+void CLoudnessMeter::Reset(unsigned int sampleRate, unsigned int channels)
+{
+  m_sampleRate = sampleRate ? sampleRate : 48000;
+  m_channels = channels ? channels : 1;
+
+  // the K-weighting filters of BS.1770 for any sample rate, the first
+  // models the head as a high shelf, the second is the RLB high pass
+  double K = tan(M_PI * 1681.974450955533 / m_sampleRate);
+  double Q = 0.7071752369554196;
+  double Vh = pow(10.0, 3.999843853973347 / 20.0);
+  double Vb = pow(Vh, 0.4996667741545416);
+  double a0 = 1.0 + K / Q + K * K;
+  m_shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+  m_shelf.b1 = 2.0 * (K * K - Vh) / a0;
+  m_shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+  m_shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+  m_shelf.a2 = (1.0 - K / Q + K * K) / a0;
+
+  K = tan(M_PI * 38.13547087602444 / m_sampleRate);
+  Q = 0.5003270373238773;
+  a0 = 1.0 + K / Q + K * K;
+  m_highpass.b0 = 1.0;
+  m_highpass.b1 = -2.0;
+  m_highpass.b2 = 1.0;
+  m_highpass.a1 = 2.0 * (K * K - 1.0) / a0;
+  m_highpass.a2 = (1.0 - K / Q + K * K) / a0;
+
+  m_state.assign(m_channels * 4, 0.0);
+  m_weights.assign(m_channels, 1.0);
+  m_sums.assign(m_channels, 0.0);
+
+  m_stepFrames = (m_sampleRate + 5) / 10;
+  m_frames = 0;
+  for (int i = 0; i < 4; i++)
+    m_steps[i] = 0.0;
+  m_stepCount = 0;
+  m_duration = 0.0;
+
+  m_blocks.clear();
+  m_peak = 0.0f;
+}
+
+void CLoudnessMeter::SetChannelWeight(unsigned int channel, double weight)
+{
+  if (channel < m_channels)
+    m_weights[channel] = weight;
+}
+
+void CLoudnessMeter::AddFrames(const float *samples, unsigned int frames)
+{
+  const Biquad shelf = m_shelf;
+  const Biquad highpass = m_highpass;
+  m_duration += (double)frames / m_sampleRate;
+
+  while (frames)
+  {
+    unsigned int count = std::min(frames, m_stepFrames - m_frames);
+
+    // filter a channel at a time, so its state stays in registers
+    for (unsigned int channel = 0; channel < m_channels; channel++)
+    {
+      double *state = &m_state[channel * 4];
+      double s1 = state[0], s2 = state[1], h1 = state[2], h2 = state[3];
+      double sum = 0.0;
+      float peak = m_peak;
+      const float *sample = samples + channel;
+      for (unsigned int i = 0; i < count; i++, sample += m_channels)
+      {
+        double x = *sample;
+        if (fabs(x) > peak)
+          peak = (float)fabs(x);
+
+        // transposed direct form II
+        double y = shelf.b0 * x + s1;
+        s1 = shelf.b1 * x - shelf.a1 * y + s2;
+        s2 = shelf.b2 * x - shelf.a2 * y;
+
+        double z = highpass.b0 * y + h1;
+        h1 = highpass.b1 * y - highpass.a1 * z + h2;
+        h2 = highpass.b2 * y - highpass.a2 * z;
+
+        sum += z * z;
+      }
+      state[0] = s1; state[1] = s2; state[2] = h1; state[3] = h2;
+      m_sums[channel] += sum;
+      m_peak = peak;
+    }
+
+    samples += count * m_channels;
+    frames -= count;
+    m_frames += count;
+    if (m_frames == m_stepFrames)
+      EndStep();
+  }
+}
+
+void CLoudnessMeter::EndStep()
+{
+  double energy = 0.0;
+  for (unsigned int channel = 0; channel < m_channels; channel++)
+  {
+    energy += m_weights[channel] * m_sums[channel];
+    m_sums[channel] = 0.0;
+  }
+  m_frames = 0;
+
+  m_steps[m_stepCount % 4] = energy;
+  m_stepCount++;
+  if (m_stepCount >= 4)
+    m_blocks.push_back((m_steps[0] + m_steps[1] + m_steps[2] + m_steps[3]) / (4.0 * m_stepFrames));
+}
+
+void CLoudnessMeter::Add(const CLoudnessMeter &meter)
+{
+  m_blocks.insert(m_blocks.end(), meter.m_blocks.begin(), meter.m_blocks.end());
+  m_peak = std::max(m_peak, meter.m_peak);
+  m_duration += meter.m_duration;
+}
+
+double CLoudnessMeter::GetLoudness() const
+{
+  double sum = 0.0;
+  unsigned int count = 0;
+  for (std::vector<double>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (*it > AbsoluteGate)
+    {
+      sum += *it;
+      count++;
+    }
+  }
+  if (!count)
+    return -HUGE_VAL;
+
+  // the relative gate is 10 LU below the loudness of the blocks above the absolute one
+  double relativeGate = sum / count * 0.1;
+  sum = 0.0;
+  count = 0;
+  for (std::vector<double>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (*it > AbsoluteGate && *it > relativeGate)
+    {
+      sum += *it;
+      count++;
+    }
+  }
+  return -0.691 + 10.0 * log10(sum / count);
+}
+
+double CLoudnessMeter::GetDuration() const
+{
+  return m_duration;
+}
@@ -0,0 +1,89 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/*!
+ \brief Measures the integrated loudness of audio as defined by EBU R128.
+
+ Samples are K-weighted, averaged over 400ms blocks overlapping by 75% and
+ gated at -70 LUFS and then 10 LU below the loudness of what remains
+ (ITU-R BS.1770).
+ The loudness of several tracks, an album, is measured by adding their
+ meters together.
+ */
+class CLoudnessMeter
+{
+public:
+  CLoudnessMeter();
+
+  /*! \brief Start measuring audio of a format, forgetting what was measured */
+  void Reset(unsigned int sampleRate, unsigned int channels);
+
+  /*! \brief Set how much a channel counts, 1 by default.
+   The LFE channel should be 0 and surround channels 1.41.
+   */
+  void SetChannelWeight(unsigned int channel, double weight);
+
+  /*! \brief Measure interleaved samples */
+  void AddFrames(const float *samples, unsigned int frames);
+
+  /*! \brief Add the blocks measured by another meter */
+  void Add(const CLoudnessMeter &meter);
+
+  /*! \brief The integrated loudness in LUFS, or -HUGE_VAL if everything was below the gate */
+  double GetLoudness() const;
+
+  /*! \brief The highest absolute sample value */
+  float GetPeak() const { return m_peak; }
+
+  /*! \brief Seconds of audio measured */
+  double GetDuration() const;
+
+  /*! \brief The ReplayGain 2.0 gain in dB that brings a loudness to -18 LUFS */
+  static double GetReplayGain(double loudness) { return -18.0 - loudness; }
+
+private:
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  void EndStep();
+
+  unsigned int m_sampleRate;
+  unsigned int m_channels;
+  Biquad m_shelf;
+  Biquad m_highpass;
+  std::vector<double> m_state;   // 4 filter states per channel
+  std::vector<double> m_weights;
+  std::vector<double> m_sums;    // squared filtered samples of the current step, per channel
+
+  // a block is 4 steps of 100ms
+  unsigned int m_stepFrames;
+  unsigned int m_frames;         // in the current step
+  double m_steps[4];
+  unsigned int m_stepCount;
+  double m_duration;
+
+  std::vector<double> m_blocks;  // mean square of every block
+  float m_peak;
+};
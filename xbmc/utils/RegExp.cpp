@@ -20,15 +20,43 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <map>
 #include "RegExp.h"
 #include "StdString.h"
 #include "log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 
 using namespace PCRE;
 
+// the number of compiled patterns kept around while no CRegExp uses them
+#define MAX_CACHED_PATTERNS 1024
+
+struct CRegExp::Pattern
+{
+  Pattern() : re(NULL), sd(NULL) {}
+  ~Pattern()
+  {
+    if (sd)
+#ifdef PCRE_CONFIG_JIT
+      pcre_free_study(sd);
+#else
+      pcre_free(sd);
+#endif
+    if (re)
+      pcre_free(re);
+  }
+
+  pcre*       re;
+  pcre_extra* sd;
+};
+
+static CCriticalSection s_patternSection;
+
 CRegExp::CRegExp(bool caseless)
 {
   m_re          = NULL;
+  m_sd          = NULL;
   m_iOptions    = PCRE_DOTALL;
   if(caseless)
     m_iOptions |= PCRE_CASELESS;
@@ -42,29 +70,28 @@ CRegExp::CRegExp(bool caseless)
 CRegExp::CRegExp(const CRegExp& re)
 {
   m_re = NULL;
+  m_sd = NULL;
   m_iOptions = re.m_iOptions;
   *this = re;
 }
 
 const CRegExp& CRegExp::operator=(const CRegExp& re)
 {
-  size_t size;
+  if (this == &re)
+    return *this;
+
   Cleanup();
   m_pattern = re.m_pattern;
   if (re.m_re)
   {
-    if (pcre_fullinfo(re.m_re, NULL, PCRE_INFO_SIZE, &size) >= 0)
-    {
-      if ((m_re = (pcre*)malloc(size)))
-      {
-        memcpy(m_re, re.m_re, size);
-        memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
-        m_iMatchCount = re.m_iMatchCount;
-        m_bMatched = re.m_bMatched;
-        m_subject = re.m_subject;
-        m_iOptions = re.m_iOptions;
-      }
-    }
+    m_compiled = re.m_compiled;
+    m_re = re.m_re;
+    m_sd = re.m_sd;
+    memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
+    m_iMatchCount = re.m_iMatchCount;
+    m_bMatched = re.m_bMatched;
+    m_subject = re.m_subject;
+    m_iOptions = re.m_iOptions;
   }
   return *this;
 }
@@ -74,6 +101,56 @@ CRegExp::~CRegExp()
   Cleanup();
 }
 
+void CRegExp::Cleanup()
+{
+  m_compiled.reset();
+  m_re = NULL;
+  m_sd = NULL;
+}
+
+CRegExp::PatternPtr CRegExp::Compile(const char *re, int options)
+{
+  CSingleLock lock(s_patternSection);
+  static std::map<std::pair<int, std::string>, PatternPtr> patterns;
+
+  std::pair<int, std::string> key(options, re);
+  std::map<std::pair<int, std::string>, PatternPtr>::const_iterator it = patterns.find(key);
+  if (it != patterns.end())
+    return it->second;
+
+  const char *errMsg = NULL;
+  int errOffset      = 0;
+
+  PatternPtr pattern(new Pattern);
+  pattern->re = pcre_compile(re, options, &errMsg, &errOffset, NULL);
+  if (!pattern->re)
+  {
+    CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
+              errMsg, errOffset, re);
+    return PatternPtr();
+  }
+
+  // without study data the pattern is still usable, just slower
+#ifdef PCRE_STUDY_JIT_COMPILE
+  pattern->sd = pcre_study(pattern->re, PCRE_STUDY_JIT_COMPILE, &errMsg);
+#else
+  pattern->sd = pcre_study(pattern->re, 0, &errMsg);
+#endif
+
+  if (patterns.size() >= MAX_CACHED_PATTERNS)
+  { // drop the patterns no CRegExp refers to anymore
+    for (std::map<std::pair<int, std::string>, PatternPtr>::iterator i = patterns.begin(); i != patterns.end();)
+    {
+      if (i->second.unique())
+        patterns.erase(i++);
+      else
+        ++i;
+    }
+  }
+  patterns.insert(make_pair(key, pattern));
+  return pattern;
+}
+
 CRegExp* CRegExp::RegComp(const char *re)
 {
   if (!re)
@@ -81,20 +158,18 @@ CRegExp* CRegExp::RegComp(const char *re)
 
   m_bMatched         = false;
   m_iMatchCount      = 0;
-  const char *errMsg = NULL;
-  int errOffset      = 0;
 
   Cleanup();
 
-  m_re = pcre_compile(re, m_iOptions, &errMsg, &errOffset, NULL);
-  if (!m_re)
+  m_compiled = Compile(re, m_iOptions);
+  if (!m_compiled)
   {
     m_pattern.clear();
-    CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
-              errMsg, errOffset, re);
     return NULL;
   }
 
+  m_re = m_compiled->re;
+  m_sd = m_compiled->sd;
   m_pattern = re;
 
   return this;
@@ -117,8 +192,7 @@ int CRegExp::RegFind(const char* str, int startoffset)
     return -1;
   }
 
-  m_subject = str;
-  int rc = pcre_exec(m_re, NULL, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+  int rc = pcre_exec(m_re, m_sd, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
 
   if (rc<1)
   {
@@ -136,11 +210,36 @@ int CRegExp::RegFind(const char* str, int startoffset)
       return -1;
     }
   }
+  // the subject is only needed to extract the match
+  m_subject = str;
   m_bMatched = true;
   m_iMatchCount = rc;
   return m_iOvector[0];
 }
 
+int CRegExp::Match(const char *str, int startoffset, int *ovector, int ovecsize) const
+{
+  if (!m_re || !str)
+    return -1;
+
+  int match[3];
+  if (!ovector)
+  {
+    ovector = match;
+    ovecsize = 3;
+  }
+
+  int rc = pcre_exec(m_re, m_sd, str, strlen(str), startoffset, 0, ovector, ovecsize);
+  if (rc < 0)
+  {
+    if (rc != PCRE_ERROR_NOMATCH)
+      CLog::Log(LOGERROR, "PCRE: Match failed with error %d", rc);
+    return -1;
+  }
+  // rc == 0 means not all sub patterns fit in ovector, the match itself is there
+  return ovector[0];
+}
+
 int CRegExp::GetCaptureTotal()
 {
   int c = -1;
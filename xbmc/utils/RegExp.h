@@ -24,6 +24,7 @@
 
 #include <string>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 namespace PCRE {
 #ifdef _WIN32
@@ -38,6 +39,15 @@ namespace PCRE {
 // OVEVCOUNT must be a multiple of 3
 const int OVECCOUNT=(20+1)*3;
 
+/*!
+ \brief Perl compatible regular expression.
+
+ Compiled patterns are shared between all CRegExp objects using the same
+ pattern and options, and are studied (and JIT compiled where PCRE supports it)
+ once. Copying a CRegExp or compiling a pattern that is in use elsewhere is
+ therefore cheap. The match state of RegFind() belongs to the object, use
+ Match() to test a shared object from several threads.
+ */
 class CRegExp
 {
 public:
@@ -49,6 +59,16 @@ public:
   CRegExp* RegComp(const std::string& re) { return RegComp(re.c_str()); }
   int RegFind(const char *str, int startoffset = 0);
   int RegFind(const std::string& str, int startoffset = 0) { return RegFind(str.c_str(), startoffset); }
+  /*! \brief Match without storing the match in the object
+   Doesn't allocate and may be called from several threads at once.
+   \param str the string to match.
+   \param startoffset offset in str to start matching at.
+   \param ovector [out] optional, receives the offsets of the match and its sub patterns.
+   \param ovecsize size of ovector, a multiple of 3.
+   \return the offset of the match, -1 if it doesn't match.
+   */
+  int Match(const char *str, int startoffset = 0, int *ovector = NULL, int ovecsize = 0) const;
+  int Match(const std::string& str, int startoffset = 0, int *ovector = NULL, int ovecsize = 0) const { return Match(str.c_str(), startoffset, ovector, ovecsize); }
   std::string GetReplaceString( const char* sReplaceExp );
   int GetFindLen()
   {
@@ -62,16 +82,22 @@ public:
   int GetSubLength(int iSub) { return (m_iOvector[(iSub*2)+1] - m_iOvector[(iSub*2)]); } // correct spelling
   int GetCaptureTotal();
   std::string GetMatch(int iSub = 0);
-  const std::string& GetPattern() { return m_pattern; }
+  const std::string& GetPattern() const { return m_pattern; }
   bool GetNamedSubPattern(const char* strName, std::string& strMatch);
   void DumpOvector(int iLog);
   const CRegExp& operator= (const CRegExp& re);
 
 private:
-  void Cleanup() { if (m_re) { PCRE::pcre_free(m_re); m_re = NULL; } }
+  struct Pattern;
+  typedef boost::shared_ptr<Pattern> PatternPtr;
+
+  void Cleanup();
+  static PatternPtr Compile(const char *re, int options);
 
 private:
+  PatternPtr  m_compiled;
   PCRE::pcre* m_re;
+  PCRE::pcre_extra* m_sd;
   int         m_iOvector[OVECCOUNT];
   int         m_iMatchCount;
   int         m_iOptions;
@@ -0,0 +1,239 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ScraperCache.h"
+#include "FileItem.h"
+#include "XBDateTime.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "utils/md5.h"
+
+#include <time.h>
+
+using namespace XFILE;
+
+CScraperCache::CScraperCache()
+  : m_useSettings(true), m_ttl(0), m_lastClean(0), m_tempFiles(0), m_refreshes(0), m_refreshTime(0)
+{
+}
+
+CScraperCache::CScraperCache(const CStdString &path, unsigned int ttl)
+  : m_useSettings(false), m_path(path), m_ttl(ttl), m_lastClean(0), m_tempFiles(0), m_refreshes(0), m_refreshTime(0)
+{
+  URIUtils::AddSlashAtEnd(m_path);
+}
+
+CScraperCache &CScraperCache::Get()
+{
+  static CScraperCache cache;
+  return cache;
+}
+
+CScraperCache::CRefresh::CRefresh(bool active /* = true */, CScraperCache &cache /* = CScraperCache::Get() */)
+  : m_active(active), m_cache(cache)
+{
+  if (m_active)
+    m_cache.BeginRefresh();
+}
+
+CScraperCache::CRefresh::~CRefresh()
+{
+  if (m_active)
+    m_cache.EndRefresh();
+}
+
+void CScraperCache::BeginRefresh()
+{
+  CSingleLock lock(m_critSection);
+  m_refreshes++;
+  m_refreshTime = (int64_t)time(NULL);
+}
+
+void CScraperCache::EndRefresh()
+{
+  CSingleLock lock(m_critSection);
+  if (m_refreshes && --m_refreshes == 0)
+    m_refreshTime = 0;
+}
+
+CStdString CScraperCache::GetPath() const
+{
+  if (!m_useSettings)
+    return m_path;
+
+  // the settings are read on every call, advancedsettings.xml is reloaded with the profile
+  CStdString path = URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "scrapers/http");
+  URIUtils::AddSlashAtEnd(path);
+  return path;
+}
+
+unsigned int CScraperCache::GetTTL() const
+{
+  if (!m_useSettings)
+    return m_ttl;
+  return g_advancedSettings.m_iScraperCacheTTL * 3600;
+}
+
+CStdString CScraperCache::GetKey(const CStdString &url, bool post, const CStdString &referer, bool gzip)
+{
+  XBMC::XBMC_MD5 md5state;
+  md5state.append(post ? "POST " : "GET ");
+  md5state.append(url);
+  md5state.append("\nReferer: " + referer);
+  md5state.append(gzip ? "\ngzip" : "\n");
+
+  CStdString key;
+  md5state.getDigest(key);
+  return key.ToLower();
+}
+
+CStdString CScraperCache::GetCacheFile(const CStdString &key) const
+{
+  return GetPath() + key;
+}
+
+bool CScraperCache::Lookup(const CStdString &scraperId, const CStdString &key, std::string &data)
+{
+  if (!IsEnabled())
+    return false;
+
+  int64_t refreshTime;
+  {
+    CSingleLock lock(m_critSection);
+    refreshTime = m_refreshTime;
+  }
+
+  bool found = false;
+  CStdString cacheFile = GetCacheFile(key);
+  struct __stat64 buffer;
+  if (CFile::Stat(cacheFile, &buffer) == 0 && (int64_t)time(NULL) - (int64_t)buffer.st_mtime < (int64_t)GetTTL() &&
+      (!refreshTime || (int64_t)buffer.st_mtime > refreshTime))
+  {
+    CFile file;
+    if (file.Open(cacheFile))
+    {
+      int64_t length = file.GetLength();
+      data.resize((size_t)length);
+      found = length > 0 && file.Read(&data[0], length) == length;
+      file.Close();
+    }
+  }
+
+  CSingleLock lock(m_critSection);
+  std::pair<unsigned int, unsigned int> &statistics = m_statistics[scraperId];
+  if (found)
+    statistics.first++;
+  else
+    statistics.second++;
+  return found;
+}
+
+void CScraperCache::Store(const CStdString &key, const std::string &data)
+{
+  if (!IsEnabled() || data.empty())
+    return;
+
+  CStdString path = GetPath();
+  if (!CDirectory::Exists(path))
+  {
+    CStdString parent = URIUtils::GetParentPath(path);
+    if (!CDirectory::Exists(parent))
+      CDirectory::Create(parent);
+    CDirectory::Create(path);
+  }
+
+  unsigned int id;
+  {
+    CSingleLock lock(m_critSection);
+    id = m_tempFiles++;
+  }
+
+  // write to a temporary file first, so a concurrent lookup never reads half a response
+  CStdString cacheFile = GetCacheFile(key);
+  CStdString tempFile;
+  tempFile.Format("%s.%u.tmp", cacheFile.c_str(), id);
+  CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+    return;
+  bool written = file.Write(data.data(), data.size()) == (int)data.size();
+  file.Close();
+
+  if (written && !CFile::Rename(tempFile, cacheFile))
+  { // not every platform replaces an existing file
+    CFile::Delete(cacheFile);
+    written = CFile::Rename(tempFile, cacheFile);
+  }
+  if (!written)
+  {
+    CFile::Delete(tempFile);
+    CLog::Log(LOGDEBUG, "%s - unable to cache %s", __FUNCTION__, cacheFile.c_str());
+  }
+}
+
+void CScraperCache::Clean()
+{
+  if (!IsEnabled())
+    return;
+
+  {
+    CSingleLock lock(m_critSection);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    if (m_lastClean && now - m_lastClean < 3600 * 1000)
+      return;
+    m_lastClean = now;
+  }
+
+  CStdString path = GetPath();
+  if (!CDirectory::Exists(path))
+    return;
+
+  CFileItemList items;
+  CDirectory::GetDirectory(path, items, "", DIR_FLAG_NO_FILE_DIRS);
+  CDateTime expired = CDateTime::GetCurrentDateTime() - CDateTimeSpan(0, 0, 0, GetTTL());
+  int removed = 0;
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    if (!items[i]->m_bIsFolder && items[i]->m_dateTime < expired && CFile::Delete(items[i]->GetPath()))
+      removed++;
+  }
+  if (removed)
+    CLog::Log(LOGDEBUG, "%s - removed %i expired responses", __FUNCTION__, removed);
+}
+
+void CScraperCache::GetStatistics(const CStdString &scraperId, unsigned int &hits, unsigned int &misses) const
+{
+  CSingleLock lock(m_critSection);
+  Statistics::const_iterator it = m_statistics.find(scraperId);
+  hits = it != m_statistics.end() ? it->second.first : 0;
+  misses = it != m_statistics.end() ? it->second.second : 0;
+}
+
+void CScraperCache::LogStatistics()
+{
+  CSingleLock lock(m_critSection);
+  for (Statistics::const_iterator it = m_statistics.begin(); it != m_statistics.end(); ++it)
+    CLog::Log(LOGNOTICE, "Scraper cache: %s - %u hits, %u misses", it->first.c_str(), it->second.first, it->second.second);
+  m_statistics.clear();
+}
@@ -0,0 +1,128 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdString.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <string>
+
+/*!
+ \brief On-disk cache of the web pages fetched for scrapers.
+
+ Rescanning a library or refreshing an item makes the scrapers fetch the same
+ search and detail pages again. Responses are stored under
+ <cachepath>/scrapers/http, named after the MD5 of the request, and are reused
+ until they are older than <scrapercache><ttl> hours. Pages a scraper caches
+ explicitly (the cache attribute of <url>) aren't stored here again.
+ */
+class CScraperCache
+{
+public:
+  /*! \brief A cache that follows the cache path and TTL of advancedsettings.xml */
+  CScraperCache();
+
+  /*!
+   \param path folder the responses are stored in.
+   \param ttl seconds a response stays valid, 0 disables the cache.
+   */
+  CScraperCache(const CStdString &path, unsigned int ttl);
+
+  /*! \brief The cache used for scraper fetches */
+  static CScraperCache &Get();
+
+  /*!
+   \brief Ignores the responses cached before it was created, for as long as it exists.
+
+   Used while the user refreshes an item, so its scrapers fetch the current pages.
+   Responses fetched meanwhile are cached as usual.
+   */
+  class CRefresh
+  {
+  public:
+    /*!
+     \param active whether to ignore the cached responses, so a caller can scope it unconditionally.
+     \param cache the cache to refresh.
+     */
+    CRefresh(bool active = true, CScraperCache &cache = CScraperCache::Get());
+    ~CRefresh();
+
+  private:
+    CRefresh(const CRefresh &);
+    CRefresh &operator=(const CRefresh &);
+
+    bool m_active;
+    CScraperCache &m_cache;
+  };
+
+  /*! \brief Build the cache key of a request
+   \param url the url, including the options.
+   \param post whether the options are sent as POST data.
+   \param referer the referer sent with the request.
+   \param gzip whether the response is gzip encoded.
+   \return the key under which the response is cached.
+   */
+  static CStdString GetKey(const CStdString &url, bool post, const CStdString &referer, bool gzip);
+
+  /*! \brief Look up a cached response
+   \param scraperId the scraper doing the fetch, used for statistics.
+   \param key the key of the request.
+   \param data [out] the cached response.
+   \return true if a valid response was found.
+   */
+  bool Lookup(const CStdString &scraperId, const CStdString &key, std::string &data);
+
+  /*! \brief Store a response
+   \param key the key of the request.
+   \param data the response.
+   */
+  void Store(const CStdString &key, const std::string &data);
+
+  /*! \brief Remove expired responses, at most once an hour */
+  void Clean();
+
+  /*! \brief Get the number of lookups served from the cache and fetched from the web for a scraper */
+  void GetStatistics(const CStdString &scraperId, unsigned int &hits, unsigned int &misses) const;
+
+  /*! \brief Log the hits and misses of each scraper, then reset them */
+  void LogStatistics();
+
+  bool IsEnabled() const { return GetTTL() > 0; }
+
+private:
+  CStdString GetPath() const;
+  unsigned int GetTTL() const;
+  CStdString GetCacheFile(const CStdString &key) const;
+  void BeginRefresh();
+  void EndRefresh();
+
+  bool m_useSettings;
+  CStdString m_path;
+  unsigned int m_ttl;
+  unsigned int m_lastClean;
+  unsigned int m_tempFiles;
+  unsigned int m_refreshes;
+  int64_t m_refreshTime;
+
+  typedef std::map<CStdString, std::pair<unsigned int, unsigned int> > Statistics;
+  Statistics m_statistics;
+  mutable CCriticalSection m_critSection;
+};
@@ -79,6 +79,7 @@ CScraperParser::~CScraperParser()
 
 void CScraperParser::Clear()
 {
+  ClearCompiled();
   m_pRootElement = NULL;
   delete m_document;
 
@@ -190,230 +191,318 @@ void CScraperParser::ReplaceBuffers(CStdString& strDest)
     strDest.replace(strDest.begin()+iIndex,strDest.begin()+iIndex+2,"\n");
 }
 
-void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest, TiXmlElement* element, bool bAppend)
+void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest, const CompiledRegExp& regexp, bool bAppend)
 {
-  CStdString strOutput = element->Attribute("output");
+  if (!regexp.hasExpression)
+    return;
 
-  TiXmlElement* pExpression = element->FirstChildElement("expression");
-  if (pExpression)
-  {
-    bool bInsensitive=true;
-    const char* sensitive = pExpression->Attribute("cs");
-    if (sensitive)
-      if (stricmp(sensitive,"yes") == 0)
-        bInsensitive=false; // match case sensitive
-
-    CRegExp reg(bInsensitive);
-    CStdString strExpression;
-    if (pExpression->FirstChild())
-      strExpression = pExpression->FirstChild()->Value();
-    else
-      strExpression = "(.*)";
+  CStdString strExpression = regexp.expression;
+  if (regexp.dynamicExpression)
     ReplaceBuffers(strExpression);
+  CStdString strOutput = regexp.output;
+  if (regexp.dynamicOutput)
+  {
     ReplaceBuffers(strOutput);
+    InsertTokens(strOutput, regexp);
+  }
 
-    if (!reg.RegComp(strExpression.c_str()))
-    {
-      return;
-    }
-
-    bool bRepeat = false;
-    const char* szRepeat = pExpression->Attribute("repeat");
-    if (szRepeat)
-      if (stricmp(szRepeat,"yes") == 0)
-        bRepeat = true;
-
-    const char* szClear = pExpression->Attribute("clear");
-    if (szClear)
-      if (stricmp(szClear,"yes") == 0)
-        dest=""; // clear no matter if regexp fails
-
-    bool bClean[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bClean,pExpression->Attribute("noclean"),true);
-
-    bool bTrim[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bTrim,pExpression->Attribute("trim"),false);
-
-    bool bFixChars[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bFixChars,pExpression->Attribute("fixchars"),false);
-
-    bool bEncode[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bEncode,pExpression->Attribute("encode"),false);
+  CRegExp* reg = GetRegExp(strExpression, regexp.caseless);
+  if (!reg)
+    return;
 
-    int iOptional = -1;
-    pExpression->QueryIntAttribute("optional",&iOptional);
+  if (regexp.clear)
+    dest=""; // clear no matter if regexp fails
 
-    int iCompare = -1;
-    pExpression->QueryIntAttribute("compare",&iCompare);
-    if (iCompare > -1)
-      m_param[iCompare-1].ToLower();
-    CStdString curInput = input;
-    for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  int iOptional = regexp.optional;
+  int iCompare = regexp.compare;
+  if (iCompare > -1)
+    m_param[iCompare-1].ToLower();
+  CStdString curInput = input;
+  int i = reg->RegFind(curInput.c_str());
+  while (i > -1 && (i < (int)curInput.size() || curInput.size() == 0))
+  {
+    if (!bAppend)
     {
-      if (bClean[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
-      if (bTrim[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
-      if (bFixChars[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
-      if (bEncode[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+      dest = "";
+      bAppend = true;
     }
-    int i = reg.RegFind(curInput.c_str());
-    while (i > -1 && (i < (int)curInput.size() || curInput.size() == 0))
-    {
-      if (!bAppend)
-      {
-        dest = "";
-        bAppend = true;
-      }
-      CStdString strCurOutput=strOutput;
+    CStdString strCurOutput=strOutput;
 
-      if (iOptional > -1) // check that required param is there
+    if (iOptional > -1) // check that required param is there
+    {
+      char temp[4];
+      sprintf(temp,"\\%i",iOptional);
+      std::string szParam = reg->GetReplaceString(temp);
+      CRegExp* reg2 = GetRegExp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)", false);
+      int i2=reg2->RegFind(strCurOutput.c_str());
+      while (i2 > -1)
       {
-        char temp[4];
-        sprintf(temp,"\\%i",iOptional);
-        std::string szParam = reg.GetReplaceString(temp);
-        CRegExp reg2;
-        reg2.RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
-        int i2=reg2.RegFind(strCurOutput.c_str());
-        while (i2 > -1)
+        std::string szRemove = reg2->GetReplaceString("\\2");
+        int iRemove = szRemove.size();
+        int i3 = strCurOutput.find(szRemove);
+        if (!szParam.empty())
         {
-          std::string szRemove = reg2.GetReplaceString("\\2");
-          int iRemove = szRemove.size();
-          int i3 = strCurOutput.find(szRemove);
-          if (!szParam.empty())
-          {
-            strCurOutput.erase(i3+iRemove,2);
-            strCurOutput.erase(i3,2);
-          }
-          else
-            strCurOutput.replace(strCurOutput.begin()+i3,strCurOutput.begin()+i3+iRemove+2,"");
-
-          i2 = reg2.RegFind(strCurOutput.c_str());
+          strCurOutput.erase(i3+iRemove,2);
+          strCurOutput.erase(i3,2);
         }
+        else
+          strCurOutput.replace(strCurOutput.begin()+i3,strCurOutput.begin()+i3+iRemove+2,"");
+
+        i2 = reg2->RegFind(strCurOutput.c_str());
       }
+    }
 
-      int iLen = reg.GetFindLen();
-      // nasty hack #1 - & means \0 in a replace string
-      strCurOutput.Replace("&","!!!AMPAMP!!!");
-      std::string result = reg.GetReplaceString(strCurOutput.c_str());
-      if (!result.empty())
+    int iLen = reg->GetFindLen();
+    // nasty hack #1 - & means \0 in a replace string
+    strCurOutput.Replace("&","!!!AMPAMP!!!");
+    std::string result = reg->GetReplaceString(strCurOutput.c_str());
+    if (!result.empty())
+    {
+      CStdString strResult(result);
+      strResult.Replace("!!!AMPAMP!!!","&");
+      Clean(strResult);
+      ReplaceBuffers(strResult);
+      if (iCompare > -1)
       {
-        CStdString strResult(result);
-        strResult.Replace("!!!AMPAMP!!!","&");
-        Clean(strResult);
-        ReplaceBuffers(strResult);
-        if (iCompare > -1)
-        {
-          CStdString strResultNoCase = strResult;
-          strResultNoCase.ToLower();
-          if (strResultNoCase.Find(m_param[iCompare-1]) != -1)
-            dest += strResult;
-        }
-        else
+        CStdString strResultNoCase = strResult;
+        strResultNoCase.ToLower();
+        if (strResultNoCase.Find(m_param[iCompare-1]) != -1)
           dest += strResult;
       }
-      if (bRepeat && iLen > 0)
-      {
-        curInput.erase(0,i+iLen>(int)curInput.size()?curInput.size():i+iLen);
-        i = reg.RegFind(curInput.c_str());
-      }
       else
-        i = -1;
+        dest += strResult;
     }
+    if (regexp.repeat && iLen > 0)
+    {
+      curInput.erase(0,i+iLen>(int)curInput.size()?curInput.size():i+iLen);
+      i = reg->RegFind(curInput.c_str());
+    }
+    else
+      i = -1;
   }
 }
 
-void CScraperParser::ParseNext(TiXmlElement* element)
+void CScraperParser::ParseNext(const vector<CompiledRegExp>& regexps)
 {
-  TiXmlElement* pReg = element;
-  while (pReg)
+  for (vector<CompiledRegExp>::const_iterator it = regexps.begin(); it != regexps.end(); ++it)
   {
-    TiXmlElement* pChildReg = pReg->FirstChildElement("RegExp");
-    if (pChildReg)
-      ParseNext(pChildReg);
-    else
+    const CompiledRegExp& regexp = *it;
+    ParseNext(regexp.children);
+
+    CStdString strInput;
+    if (regexp.hasInput)
     {
-      TiXmlElement* pChildReg = pReg->FirstChildElement("clear");
-      if (pChildReg)
-        ParseNext(pChildReg);
+      strInput = regexp.input;
+      ReplaceBuffers(strInput);
     }
+    else
+      strInput = m_param[0];
 
-    int iDest = 1;
-    bool bAppend = false;
-    const char* szDest = pReg->Attribute("dest");
-    if (szDest)
-      if (strlen(szDest))
-      {
-        if (szDest[strlen(szDest)-1] == '+')
-          bAppend = true;
-
-        iDest = atoi(szDest);
-      }
+    bool bExecute = true;
+    if (regexp.hasConditional)
+    {
+      CStdString strSetting;
+      if (m_scraper && m_scraper->HasSettings())
+         strSetting = m_scraper->GetSetting(regexp.conditional);
+      bExecute = regexp.inverse != strSetting.Equals("true");
+    }
 
-      const char *szInput = pReg->Attribute("input");
-      CStdString strInput;
-      if (szInput)
-      {
-        strInput = szInput;
-        ReplaceBuffers(strInput);
-      }
+    if (bExecute)
+    {
+      if (regexp.dest-1 < MAX_SCRAPER_BUFFERS && regexp.dest-1 > -1)
+        ParseExpression(strInput, m_param[regexp.dest-1], regexp, regexp.append);
       else
-        strInput = m_param[0];
-
-      const char* szConditional = pReg->Attribute("conditional");
-      bool bExecute = true;
-      if (szConditional)
-      {
-        bool bInverse=false;
-        if (szConditional[0] == '!')
-        {
-          bInverse = true;
-          szConditional++;
-        }
-        CStdString strSetting;
-        if (m_scraper && m_scraper->HasSettings())
-           strSetting = m_scraper->GetSetting(szConditional);
-        bExecute = bInverse != strSetting.Equals("true");
-      }
-
-      if (bExecute)
-      {
-        if (iDest-1 < MAX_SCRAPER_BUFFERS && iDest-1 > -1)
-          ParseExpression(strInput, m_param[iDest-1],pReg,bAppend);
-        else
-          CLog::Log(LOGERROR,"CScraperParser::ParseNext: destination buffer "
-                             "out of bounds, skipping expression");
-      }
-
-      pReg = pReg->NextSiblingElement("RegExp");
+        CLog::Log(LOGERROR,"CScraperParser::ParseNext: destination buffer "
+                           "out of bounds, skipping expression");
+    }
   }
 }
 
 const CStdString CScraperParser::Parse(const CStdString& strTag,
                                        CScraper* scraper)
 {
-  TiXmlElement* pChildElement = m_pRootElement->FirstChildElement(strTag.c_str());
-  if(pChildElement == NULL)
+  // patterns built from buffers differ per item, so don't let them pile up
+  if (m_regexps.size() > 512)
+  {
+    for (RegExpCache::iterator it = m_regexps.begin(); it != m_regexps.end(); ++it)
+      delete it->second;
+    m_regexps.clear();
+  }
+
+  const CompiledFunction* function = GetFunction(strTag);
+  if (function == NULL)
   {
     CLog::Log(LOGERROR,"%s: Could not find scraper function %s",__FUNCTION__,strTag.c_str());
     return "";
   }
-  int iResult = 1; // default to param 1
-  pChildElement->QueryIntAttribute("dest",&iResult);
-  TiXmlElement* pChildStart = pChildElement->FirstChildElement("RegExp");
   m_scraper = scraper;
-  ParseNext(pChildStart);
-  CStdString tmp = m_param[iResult-1];
+  ParseNext(function->regexps);
+  CStdString tmp = m_param[function->dest-1];
 
-  const char* szClearBuffers = pChildElement->Attribute("clearbuffers");
-  if (!szClearBuffers || stricmp(szClearBuffers,"no") != 0)
+  if (function->clearBuffers)
     ClearBuffers();
 
   return tmp;
 }
 
+const CScraperParser::CompiledFunction* CScraperParser::GetFunction(const CStdString& strTag)
+{
+  map<CStdString, CompiledFunction>::const_iterator it = m_functions.find(strTag);
+  if (it != m_functions.end())
+    return &it->second;
+
+  TiXmlElement* pChildElement = m_pRootElement ? m_pRootElement->FirstChildElement(strTag.c_str()) : NULL;
+  if (pChildElement == NULL)
+    return NULL;
+
+  CompiledFunction& function = m_functions[strTag];
+  function.dest = 1; // default to param 1
+  pChildElement->QueryIntAttribute("dest",&function.dest);
+  const char* szClearBuffers = pChildElement->Attribute("clearbuffers");
+  function.clearBuffers = !szClearBuffers || stricmp(szClearBuffers,"no") != 0;
+  CompileNext(pChildElement->FirstChildElement("RegExp"), function.regexps);
+  return &function;
+}
+
+CScraperParser::CompiledRegExp::CompiledRegExp()
+  : dest(1), append(false), hasInput(false), hasConditional(false), inverse(false),
+    hasExpression(false), dynamicExpression(false), dynamicOutput(false),
+    caseless(true), repeat(false), clear(false), optional(-1), compare(-1)
+{
+}
+
+// whether ReplaceBuffers() depends on the buffers, settings or strings for this string
+static bool IsDynamic(const CStdString& str)
+{
+  return str.find("$$") != CStdString::npos ||
+         str.find("$INFO[") != CStdString::npos ||
+         str.find("$LOCALIZE[") != CStdString::npos;
+}
+
+void CScraperParser::CompileNext(TiXmlElement* element, vector<CompiledRegExp>& regexps)
+{
+  for (TiXmlElement* pReg = element; pReg; pReg = pReg->NextSiblingElement("RegExp"))
+  {
+    regexps.push_back(CompiledRegExp());
+    CompiledRegExp& regexp = regexps.back();
+
+    TiXmlElement* pChildReg = pReg->FirstChildElement("RegExp");
+    if (!pChildReg)
+      pChildReg = pReg->FirstChildElement("clear");
+    if (pChildReg)
+      CompileNext(pChildReg, regexp.children);
+
+    const char* szDest = pReg->Attribute("dest");
+    if (szDest && strlen(szDest))
+    {
+      if (szDest[strlen(szDest)-1] == '+')
+        regexp.append = true;
+
+      regexp.dest = atoi(szDest);
+    }
+
+    const char* szInput = pReg->Attribute("input");
+    if (szInput)
+    {
+      regexp.hasInput = true;
+      regexp.input = szInput;
+    }
+
+    const char* szConditional = pReg->Attribute("conditional");
+    if (szConditional)
+    {
+      regexp.hasConditional = true;
+      if (szConditional[0] == '!')
+      {
+        regexp.inverse = true;
+        szConditional++;
+      }
+      regexp.conditional = szConditional;
+    }
+
+    TiXmlElement* pExpression = pReg->FirstChildElement("expression");
+    if (!pExpression)
+      continue;
+
+    regexp.hasExpression = true;
+    const char* sensitive = pExpression->Attribute("cs");
+    if (sensitive && stricmp(sensitive,"yes") == 0)
+      regexp.caseless = false; // match case sensitive
+
+    if (pExpression->FirstChild())
+      regexp.expression = pExpression->FirstChild()->Value();
+    else
+      regexp.expression = "(.*)";
+    regexp.dynamicExpression = IsDynamic(regexp.expression);
+    if (!regexp.dynamicExpression)
+      ReplaceBuffers(regexp.expression);
+
+    const char* szRepeat = pExpression->Attribute("repeat");
+    regexp.repeat = szRepeat && stricmp(szRepeat,"yes") == 0;
+
+    const char* szClear = pExpression->Attribute("clear");
+    regexp.clear = szClear && stricmp(szClear,"yes") == 0;
+
+    GetBufferParams(regexp.clean,pExpression->Attribute("noclean"),true);
+    GetBufferParams(regexp.trim,pExpression->Attribute("trim"),false);
+    GetBufferParams(regexp.fixChars,pExpression->Attribute("fixchars"),false);
+    GetBufferParams(regexp.encode,pExpression->Attribute("encode"),false);
+
+    pExpression->QueryIntAttribute("optional",&regexp.optional);
+    pExpression->QueryIntAttribute("compare",&regexp.compare);
+
+    const char* szOutput = pReg->Attribute("output");
+    if (szOutput)
+      regexp.output = szOutput;
+    regexp.dynamicOutput = IsDynamic(regexp.output);
+    if (!regexp.dynamicOutput)
+    {
+      ReplaceBuffers(regexp.output);
+      InsertTokens(regexp.output, regexp);
+    }
+  }
+}
+
+void CScraperParser::InsertTokens(CStdString& strOutput, const CompiledRegExp& regexp)
+{
+  for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  {
+    if (regexp.clean[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
+    if (regexp.trim[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
+    if (regexp.fixChars[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
+    if (regexp.encode[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+  }
+}
+
+CRegExp* CScraperParser::GetRegExp(const CStdString& pattern, bool caseless)
+{
+  std::pair<bool, CStdString> key(caseless, pattern);
+  RegExpCache::const_iterator it = m_regexps.find(key);
+  if (it != m_regexps.end())
+    return it->second;
+
+  CRegExp* reg = new CRegExp(caseless);
+  if (!reg->RegComp(pattern.c_str()))
+  { // remember the failure, so it is only logged once
+    delete reg;
+    reg = NULL;
+  }
+  m_regexps.insert(make_pair(key, reg));
+  return reg;
+}
+
+void CScraperParser::ClearCompiled()
+{
+  m_functions.clear();
+  for (RegExpCache::iterator it = m_regexps.begin(); it != m_regexps.end(); ++it)
+    delete it->second;
+  m_regexps.clear();
+}
+
 void CScraperParser::Clean(CStdString& strDirty)
 {
   int i=0;
@@ -495,29 +584,27 @@ void CScraperParser::RemoveWhiteSpace(CStdString &string)
 
 void CScraperParser::ConvertJSON(CStdString &string)
 {
-  CRegExp reg;
-  reg.RegComp("\\\\u([0-f]{4})");
-  while (reg.RegFind(string.c_str()) > -1)
+  CRegExp* reg = GetRegExp("\\\\u([0-f]{4})", false);
+  while (reg->RegFind(string.c_str()) > -1)
   {
-    int pos = reg.GetSubStart(1);
-    std::string szReplace = reg.GetReplaceString("\\1");
+    int pos = reg->GetSubStart(1);
+    std::string szReplace = reg->GetReplaceString("\\1");
 
     CStdString replace;
     replace.Format("&#x%s;", szReplace.c_str());
     string.replace(string.begin()+pos-2, string.begin()+pos+4, replace);
   }
 
-  CRegExp reg2;
-  reg2.RegComp("\\\\x([0-9]{2})([^\\\\]+;)");
-  while (reg2.RegFind(string.c_str()) > -1)
+  CRegExp* reg2 = GetRegExp("\\\\x([0-9]{2})([^\\\\]+;)", false);
+  while (reg2->RegFind(string.c_str()) > -1)
   {
-    int pos1 = reg2.GetSubStart(1);
-    int pos2 = reg2.GetSubStart(2);
-    std::string szHexValue = reg2.GetReplaceString("\\1");
+    int pos1 = reg2->GetSubStart(1);
+    int pos2 = reg2->GetSubStart(2);
+    std::string szHexValue = reg2->GetReplaceString("\\1");
 
     CStdString replace;
     replace.Format("%c", strtol(szHexValue.c_str(), NULL, 16));
-    string.replace(string.begin()+pos1-2, string.begin()+pos2+reg2.GetSubLength(2), replace);
+    string.replace(string.begin()+pos1-2, string.begin()+pos2+reg2->GetSubLength(2), replace);
   }
 
   string.Replace("\\\"","\"");
@@ -563,6 +650,9 @@ void CScraperParser::InsertToken(CStdString& strOutput, int buf, const char* tok
 
 void CScraperParser::AddDocument(const CXBMCTinyXML* doc)
 {
+  // functions may be extended or replaced by the new document
+  m_functions.clear();
+
   const TiXmlNode* node = doc->RootElement()->FirstChild();
   while (node)
   {
@@ -21,6 +21,7 @@
  *
  */
 
+#include <map>
 #include <vector>
 #include "StdString.h"
 #include "addons/IAddon.h"
@@ -34,6 +35,7 @@ namespace ADDON
 
 class TiXmlElement;
 class CXBMCTinyXML;
+class CRegExp;
 
 class CScraperSettings;
 
@@ -59,10 +61,59 @@ public:
   CStdString m_param[MAX_SCRAPER_BUFFERS];
 
 private:
+  /*! \brief A <RegExp> element of a scraper function with its attributes parsed.
+   Strings that don't refer to buffers, settings or localized strings are prepared
+   once, the others are expanded every time the element is run.
+   */
+  struct CompiledRegExp
+  {
+    CompiledRegExp();
+
+    std::vector<CompiledRegExp> children; ///< nested <RegExp> (or <clear>) elements, run first
+    int dest;
+    bool append;
+    bool hasInput;
+    CStdString input;
+    bool hasConditional;
+    bool inverse;
+    CStdString conditional;
+    bool hasExpression;
+    CStdString expression;
+    bool dynamicExpression;
+    CStdString output;
+    bool dynamicOutput;
+    bool caseless;
+    bool repeat;
+    bool clear;
+    bool clean[MAX_SCRAPER_BUFFERS];
+    bool trim[MAX_SCRAPER_BUFFERS];
+    bool fixChars[MAX_SCRAPER_BUFFERS];
+    bool encode[MAX_SCRAPER_BUFFERS];
+    int optional;
+    int compare;
+  };
+
+  struct CompiledFunction
+  {
+    int dest;
+    bool clearBuffers;
+    std::vector<CompiledRegExp> regexps;
+  };
+
+  typedef std::map<std::pair<bool, CStdString>, CRegExp*> RegExpCache;
+
   bool LoadFromXML();
   void ReplaceBuffers(CStdString& strDest);
-  void ParseExpression(const CStdString& input, CStdString& dest, TiXmlElement* element, bool bAppend);
-  void ParseNext(TiXmlElement* element);
+  void ParseExpression(const CStdString& input, CStdString& dest, const CompiledRegExp& regexp, bool bAppend);
+  void ParseNext(const std::vector<CompiledRegExp>& regexps);
+  const CompiledFunction* GetFunction(const CStdString& strTag);
+  void CompileNext(TiXmlElement* element, std::vector<CompiledRegExp>& regexps);
+  void InsertTokens(CStdString& strOutput, const CompiledRegExp& regexp);
+  /*! \brief Get a compiled regular expression, compiling it on first use
+   \return the expression, NULL if it doesn't compile.
+   */
+  CRegExp* GetRegExp(const CStdString& pattern, bool caseless);
+  void ClearCompiled();
   void Clean(CStdString& strDirty);
   /*! \brief Remove spaces, tabs, and newlines from a string
    \param string the string in question, which will be modified.
@@ -81,6 +132,9 @@ private:
 
   CStdString m_strFile;
   ADDON::CScraper* m_scraper;
+
+  std::map<CStdString, CompiledFunction> m_functions;
+  RegExpCache m_regexps;
 };
 
 #endif
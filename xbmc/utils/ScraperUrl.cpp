@@ -20,6 +20,7 @@
 
 #include "XMLUtils.h"
 #include "ScraperUrl.h"
+#include "ScraperCache.h"
 #include "settings/AdvancedSettings.h"
 #include "HTMLUtil.h"
 #include "CharsetConverter.h"
@@ -201,6 +202,7 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
   CURL url(scrURL.m_url);
   http.SetReferer(scrURL.m_spoof);
   CStdString strCachePath;
+  CStdString strCacheKey;
 
   if (scrURL.m_isgz)
     http.SetContentEncoding("gzip");
@@ -224,6 +226,12 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
       }
     }
   }
+  else if (CScraperCache::Get().IsEnabled())
+  { // pages the scraper doesn't cache itself go into the shared cache
+    strCacheKey = CScraperCache::GetKey(scrURL.m_url, scrURL.m_post, scrURL.m_spoof, scrURL.m_isgz);
+    if (CScraperCache::Get().Lookup(cacheContext, strCacheKey, strHTML))
+      return true;
+  }
 
   CStdString strHTML1(strHTML);
 
@@ -263,6 +271,8 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
       file.Write(strHTML.data(),strHTML.size());
     file.Close();
   }
+  else if (!strCacheKey.IsEmpty())
+    CScraperCache::Get().Store(strCacheKey, strHTML);
   return true;
 }
 
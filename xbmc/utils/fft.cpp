@@ -26,8 +26,16 @@
 
 
 #include <math.h>
+#include <map>
 
 #include "fft.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#if defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP > 0)
+#define FFT_SSE
+#include <xmmintrin.h>
+#endif
 
 #ifndef M_PI
 #define M_PI  3.1415926535897932384626433832795
@@ -172,3 +180,219 @@ void twochanwithwindow(float data[], int n)
   }
 }
 
+// twiddle factors of a radix-4 stage are stored for pairs of butterflies,
+// for each of w^k, w^2k and w^3k as { wr0, wr0, wr1, wr1, -wi0, wi0, -wi1, wi1 }
+#define TWIDDLES_PER_PAIR 24
+
+class CFFTPlanCache
+{
+public:
+  ~CFFTPlanCache()
+  {
+    for (std::map<int, CFFTPlan*>::iterator it = m_plans.begin(); it != m_plans.end(); ++it)
+      delete it->second;
+  }
+
+  std::map<int, CFFTPlan*> m_plans;
+  CCriticalSection m_critSection;
+};
+
+const CFFTPlan &CFFTPlan::Get(int n)
+{
+  static CFFTPlanCache cache;
+
+  CSingleLock lock(cache.m_critSection);
+  std::map<int, CFFTPlan*>::iterator it = cache.m_plans.find(n);
+  if (it != cache.m_plans.end())
+    return *it->second;
+
+  CFFTPlan *plan = new CFFTPlan(n);
+  cache.m_plans.insert(std::make_pair(n, plan));
+  return *plan;
+}
+
+CFFTPlan::CFFTPlan(int n)
+{
+  m_size = n;
+
+  int bits = 0;
+  while ((1 << bits) < n)
+    bits++;
+  m_radix2 = (bits & 1) != 0;
+
+  for (int i = 0; i < n; i++)
+  {
+    int j = 0;
+    for (int bit = 0; bit < bits; bit++)
+      j |= ((i >> bit) & 1) << (bits - 1 - bit);
+    if (j > i)
+    {
+      m_swaps.push_back(i);
+      m_swaps.push_back(j);
+    }
+  }
+
+  // stages of a span of 1 need no twiddles
+  for (int span = m_radix2 ? 2 : 4; span * 4 <= n; span *= 4)
+  {
+    for (int k = 0; k < span; k += 2)
+    {
+      for (int j = 1; j <= 3; j++)
+      {
+        double theta0 = 2.0 * M_PI * j * k / (4 * span);
+        double theta1 = 2.0 * M_PI * j * (k + 1) / (4 * span);
+        float w[8] = { (float)cos(theta0), (float)cos(theta0), (float)cos(theta1), (float)cos(theta1),
+                       (float)-sin(theta0), (float)sin(theta0), (float)-sin(theta1), (float)sin(theta1) };
+        m_twiddles.insert(m_twiddles.end(), w, w + 8);
+      }
+    }
+  }
+
+  m_window.resize(n);
+  for (int i = 0; i < n; i++)
+    m_window[i] = (float)(0.5 * (1 - cos(2.0 * M_PI * i / n)));
+}
+
+void CFFTPlan::Transform(float data[]) const
+{
+  const int n = m_size;
+
+  for (std::vector<int>::const_iterator it = m_swaps.begin(); it != m_swaps.end(); it += 2)
+  {
+    float *a = data + 2 * it[0];
+    float *b = data + 2 * it[1];
+    swap(a[0], b[0]);
+    swap(a[1], b[1]);
+  }
+
+  int span = 1;
+  if (m_radix2)
+  {
+    for (int i = 0; i < 2 * n; i += 4)
+    {
+      float re = data[i + 2], im = data[i + 3];
+      data[i + 2] = data[i] - re;
+      data[i + 3] = data[i + 1] - im;
+      data[i] += re;
+      data[i + 1] += im;
+    }
+    span = 2;
+  }
+  else if (n >= 4)
+  {
+    for (int i = 0; i < 2 * n; i += 8)
+    {
+      float *x = data + i;
+      float t0r = x[0] + x[2], t0i = x[1] + x[3];
+      float t1r = x[0] - x[2], t1i = x[1] - x[3];
+      float t2r = x[4] + x[6], t2i = x[5] + x[7];
+      float t3r = x[4] - x[6], t3i = x[5] - x[7];
+      x[0] = t0r + t2r; x[1] = t0i + t2i;
+      x[4] = t0r - t2r; x[5] = t0i - t2i;
+      x[2] = t1r - t3i; x[3] = t1i + t3r;
+      x[6] = t1r + t3i; x[7] = t1i - t3r;
+    }
+    span = 4;
+  }
+
+  // each radix-4 stage joins 4 transforms of span points, in bit reversed
+  // order a, b, c and d, into one of 4 * span:
+  //   X[k]          = (a + w^2k b) + (w^k c + w^3k d)
+  //   X[k + span]   = (a - w^2k b) + i (w^k c - w^3k d)
+  //   X[k + 2 span] = (a + w^2k b) - (w^k c + w^3k d)
+  //   X[k + 3 span] = (a - w^2k b) - i (w^k c - w^3k d)
+  const float *twiddles = m_twiddles.empty() ? NULL : &m_twiddles[0];
+  for (; span * 4 <= n; span *= 4)
+  {
+    const int stride = 2 * span;
+    for (int group = 0; group < 2 * n; group += 4 * stride)
+    {
+      const float *w = twiddles;
+      float *x = data + group;
+#ifdef FFT_SSE
+      const __m128 negateReal = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+      for (int k = 0; k < span; k += 2, w += TWIDDLES_PER_PAIR, x += 4)
+      {
+        __m128 a = _mm_loadu_ps(x);
+        __m128 b = _mm_loadu_ps(x + stride);
+        __m128 c = _mm_loadu_ps(x + 2 * stride);
+        __m128 d = _mm_loadu_ps(x + 3 * stride);
+
+        // complex products as v * wr + swapped(v) * wi
+        c = _mm_add_ps(_mm_mul_ps(c, _mm_loadu_ps(w)),
+                       _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 3, 0, 1)), _mm_loadu_ps(w + 4)));
+        b = _mm_add_ps(_mm_mul_ps(b, _mm_loadu_ps(w + 8)),
+                       _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), _mm_loadu_ps(w + 12)));
+        d = _mm_add_ps(_mm_mul_ps(d, _mm_loadu_ps(w + 16)),
+                       _mm_mul_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)), _mm_loadu_ps(w + 20)));
+
+        __m128 t0 = _mm_add_ps(a, b);
+        __m128 t1 = _mm_sub_ps(a, b);
+        __m128 t2 = _mm_add_ps(c, d);
+        __m128 t3 = _mm_sub_ps(c, d);
+        t3 = _mm_mul_ps(_mm_shuffle_ps(t3, t3, _MM_SHUFFLE(2, 3, 0, 1)), negateReal); // i * t3
+
+        _mm_storeu_ps(x, _mm_add_ps(t0, t2));
+        _mm_storeu_ps(x + stride, _mm_add_ps(t1, t3));
+        _mm_storeu_ps(x + 2 * stride, _mm_sub_ps(t0, t2));
+        _mm_storeu_ps(x + 3 * stride, _mm_sub_ps(t1, t3));
+      }
+#else
+      for (int k = 0; k < span; k++, x += 2)
+      {
+        const float *wk = w + (k >> 1) * TWIDDLES_PER_PAIR + 2 * (k & 1);
+        float *a = x, *b = x + stride, *c = x + 2 * stride, *d = x + 3 * stride;
+
+        float cr = c[0] * wk[0] - c[1] * wk[5];
+        float ci = c[1] * wk[0] + c[0] * wk[5];
+        float br = b[0] * wk[8] - b[1] * wk[13];
+        float bi = b[1] * wk[8] + b[0] * wk[13];
+        float dr = d[0] * wk[16] - d[1] * wk[21];
+        float di = d[1] * wk[16] + d[0] * wk[21];
+
+        float t0r = a[0] + br, t0i = a[1] + bi;
+        float t1r = a[0] - br, t1i = a[1] - bi;
+        float t2r = cr + dr, t2i = ci + di;
+        float t3r = cr - dr, t3i = ci - di;
+
+        a[0] = t0r + t2r; a[1] = t0i + t2i;
+        c[0] = t0r - t2r; c[1] = t0i - t2i;
+        b[0] = t1r - t3i; b[1] = t1i + t3r;
+        d[0] = t1r + t3i; d[1] = t1i - t3r;
+      }
+#endif
+    }
+    twiddles += span / 2 * TWIDDLES_PER_PAIR;
+  }
+}
+
+void CFFTPlan::TwoChannelWithWindow(float data[]) const
+{
+  const int n = m_size;
+  const int nn = n + n;
+  const int nn1 = nn + 1;
+
+  for (int i = 0; i < n; i++)
+  {
+    data[2 * i] *= m_window[i];
+    data[2 * i + 1] *= m_window[i];
+  }
+
+  Transform(data);
+
+  // unpack the spectra of the two channels, as twochanwithwindow()
+  data[0] = data[0] * data[0];
+  data[1] = data[1] * data[1];
+  data[n] = data[n] * data[n];
+  data[n + 1] = data[n + 1] * data[n + 1];
+
+  for (int j = 2; j < n; j += 2)
+  {
+    float rep = data[j] + data[nn - j];
+    float rem = data[j] - data[nn - j];
+    float aip = data[j + 1] + data[nn1 - j];
+    float aim = data[j + 1] - data[nn1 - j];
+    data[j] = 0.5f * (rep * rep + aim * aim);
+    data[j + 1] = 0.5f * (rem * rem + aip * aip);
+  }
+}
@@ -48,5 +48,34 @@ void fft( float data[], int nn, int isign );
 void twochannelrfft(float data[], int n);
 void twochanwithwindow(float data[], int n); // test
 
+#include <vector>
+
+// The transform of fft() for one size, with the bit reversal and twiddle
+// factors computed up front and radix-4 butterflies (SSE where available).
+// Plans are built once per size and shared, use them from any thread.
+
+class CFFTPlan
+{
+public:
+  static const CFFTPlan &Get(int n);
+
+  int GetSize() const { return m_size; }
+
+  // fft(data - 1, n, +1), data[] holds n interleaved complex numbers
+  void Transform(float data[]) const;
+
+  // twochanwithwindow(data, n)
+  void TwoChannelWithWindow(float data[]) const;
+
+private:
+  explicit CFFTPlan(int n);
+
+  int m_size;
+  bool m_radix2;                 // log2(n) is odd, the first stage is radix-2
+  std::vector<int> m_swaps;      // pairs of complex indices to swap for bit reversal
+  std::vector<float> m_twiddles; // per radix-4 stage from a span of 2
+  std::vector<float> m_window;   // Hann
+};
+
 
 #endif
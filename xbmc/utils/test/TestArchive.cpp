@@ -398,3 +398,52 @@ TEST_F(TestArchive, MultiTypeArchive)
   EXPECT_EQ(2, iArray_var.at(2));
   EXPECT_EQ(3, iArray_var.at(3));
 }
+
+TEST_F(TestArchive, LargeStringArchive)
+{
+  ASSERT_TRUE(file);
+  // larger than the archive buffer, so it is read and written in one go
+  CStdString CStdString_ref(200000, 'x'), CStdString_var;
+  CStdStringW CStdStringW_ref(100000, L'y'), CStdStringW_var;
+  int int_ref = 42, int_var = 0;
+
+  CArchive arstore(file, CArchive::store);
+  arstore << int_ref;
+  arstore << CStdString_ref;
+  arstore << CStdStringW_ref;
+  arstore << int_ref;
+  arstore.Close();
+
+  ASSERT_TRUE((file->Seek(0, SEEK_SET) == 0));
+  CArchive arload(file, CArchive::load);
+  arload >> int_var;
+  arload >> CStdString_var;
+  arload >> CStdStringW_var;
+  EXPECT_EQ(int_ref, int_var);
+  int_var = 0;
+  arload >> int_var;
+  arload.Close();
+
+  EXPECT_EQ(int_ref, int_var);
+  EXPECT_TRUE(CStdString_ref == CStdString_var);
+  EXPECT_TRUE(CStdStringW_ref == CStdStringW_var);
+}
+
+TEST_F(TestArchive, LoadLeavesFilePosition)
+{
+  ASSERT_TRUE(file);
+  int int_ref = 1, int_var = 0;
+
+  CArchive arstore(file, CArchive::store);
+  arstore << int_ref;
+  arstore << int_ref;
+  arstore.Close();
+
+  // the archive reads ahead, closing it must hand back what wasn't consumed
+  ASSERT_TRUE((file->Seek(0, SEEK_SET) == 0));
+  CArchive arload(file, CArchive::load);
+  arload >> int_var;
+  arload.Close();
+
+  EXPECT_EQ((int64_t)sizeof(int), file->GetPosition());
+}
@@ -20,9 +20,14 @@
 
 #include "settings/Settings.h"
 #include "utils/CharsetConverter.h"
+#include "utils/TimeUtils.h"
 
 #include "gtest/gtest.h"
 
+#include <iconv.h>
+#include <stdio.h>
+#include <vector>
+
 static const uint16_t refutf16LE1[] = { 0xff54, 0xff45, 0xff53, 0xff54,
                                         0xff3f, 0xff55, 0xff54, 0xff46,
                                         0xff11, 0xff16, 0xff2c, 0xff25,
@@ -124,6 +129,25 @@ TEST_F(TestCharsetConverter, utf8ToW)
   EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
 }
 
+TEST_F(TestCharsetConverter, utf8ToW_multibyte)
+{
+  refstra1 = "test \xc3\xa9\xe2\x82\xac utf8ToW with a longer ASCII tail";
+  refstrw1 = L"test \u00e9\u20ac utf8ToW with a longer ASCII tail";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
+}
+
+TEST_F(TestCharsetConverter, utf8ToW_invalid)
+{
+  /* invalid bytes are skipped, the rest of the string is kept */
+  refstra1 = "te\xff" "st\xc0\xaf" "utf8\xed\xa0\x80" "ToW";
+  refstrw1 = L"testutf8ToW";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
+}
+
 TEST_F(TestCharsetConverter, utf16LEtoW)
 {
   refstrw1 = L"ｔｅｓｔ＿ｕｔｆ１６ＬＥｔｏｗ";
@@ -247,6 +271,16 @@ TEST_F(TestCharsetConverter, wToUTF8)
   EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 }
 
+TEST_F(TestCharsetConverter, wToUTF8_roundtrip)
+{
+  refstra1 = "test \xc3\xa9\xe2\x82\xac\xf0\x9f\x90\xad wToUTF8";
+  varstrw1.clear();
+  varstra1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  g_charsetConverter.wToUTF8(varstrw1, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+}
+
 TEST_F(TestCharsetConverter, utf16BEtoUTF8)
 {
   refstr16_1.assign(refutf16BE);
@@ -395,3 +429,50 @@ TEST_F(TestCharsetConverter, fromW)
   g_charsetConverter.fromW(refstrw1, varstra1, "UTF-16LE");
   EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 }
+
+// compares the native UTF-8 decoder with converting through a reused iconv
+// handle, as utf8ToW() did before. Run with --gtest_also_run_disabled_tests
+TEST_F(TestCharsetConverter, DISABLED_utf8ToW_Benchmark)
+{
+  static const char *labels[] = { "ascii", "latin", "cjk" };
+  static const char *strings[] = {
+    "The Quick Brown Fox Jumps Over The Lazy Dog (2013) [1080p].mkv",
+    "Caf\xc3\xa9 del Mar - Les Fr\xc3\xa8res \xc3\x89l\xc3\xa9gants - Sch\xc3\xb6ne Gr\xc3\xbc\xc3\x9f""e",
+    "\xe6\x9d\xb1\xe4\xba\xac\xe3\x83\x86\xe3\x83\xac\xe3\x83\x93 \xe6\x98\xa0\xe7\x94\xbb "
+    "\xe9\x9f\xb3\xe6\xa5\xbd \xe3\x83\x8b\xe3\x83\xa5\xe3\x83\xbc\xe3\x82\xb9"
+  };
+  const int iterations = 200000;
+
+  iconv_t cd = iconv_open("WCHAR_T", "UTF-8");
+  ASSERT_NE((iconv_t)-1, cd);
+  for (unsigned int s = 0; s < sizeof(strings) / sizeof(strings[0]); s++)
+  {
+    CStdStringA utf8 = strings[s];
+    CStdStringW native, converted;
+
+    int64_t start = CurrentHostCounter();
+    for (int i = 0; i < iterations; i++)
+      g_charsetConverter.utf8ToW(utf8, native, false);
+    int64_t nativeTime = CurrentHostCounter() - start;
+
+    std::vector<wchar_t> buffer(utf8.size() + 1);
+    start = CurrentHostCounter();
+    for (int i = 0; i < iterations; i++)
+    {
+      const char *in = utf8.c_str();
+      size_t inBytes = utf8.size();
+      char *out = (char *)&buffer[0];
+      size_t outBytes = buffer.size() * sizeof(wchar_t);
+      iconv(cd, NULL, NULL, NULL, NULL);
+      iconv_const(cd, &in, &inBytes, &out, &outBytes);
+      converted.assign(&buffer[0], (wchar_t *)out - &buffer[0]);
+    }
+    int64_t iconvTime = CurrentHostCounter() - start;
+    EXPECT_STREQ(converted.c_str(), native.c_str());
+
+    printf("%-5s: native %6.3f us, iconv %6.3f us per string\n", labels[s],
+           (double)nativeTime * 1000000 / CurrentHostFrequency() / iterations,
+           (double)iconvTime * 1000000 / CurrentHostFrequency() / iterations);
+  }
+  iconv_close(cd);
+}
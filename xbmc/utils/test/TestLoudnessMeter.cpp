@@ -0,0 +1,93 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/LoudnessMeter.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <vector>
+
+/* adds seconds of a stereo 1kHz sine at a level in dBFS */
+static void AddSine(CLoudnessMeter &meter, unsigned int sampleRate, double level, unsigned int seconds)
+{
+  double amplitude = pow(10.0, level / 20.0);
+  std::vector<float> samples(sampleRate * 2);
+  for (unsigned int second = 0; second < seconds; second++)
+  {
+    for (unsigned int i = 0; i < sampleRate; i++)
+      samples[i * 2] = samples[i * 2 + 1] = (float)(amplitude * sin(2.0 * 3.14159265358979323846 * 1000.0 * i / sampleRate));
+    meter.AddFrames(&samples[0], sampleRate);
+  }
+}
+
+// the test signals of EBU Tech 3341
+TEST(TestLoudnessMeter, Sine)
+{
+  CLoudnessMeter meter;
+  meter.Reset(48000, 2);
+  AddSine(meter, 48000, -23.0, 20);
+  EXPECT_NEAR(-23.0, meter.GetLoudness(), 0.1);
+  EXPECT_NEAR(pow(10.0, -23.0 / 20.0), meter.GetPeak(), 0.001);
+  EXPECT_NEAR(20.0, meter.GetDuration(), 0.001);
+  EXPECT_NEAR(5.0, CLoudnessMeter::GetReplayGain(meter.GetLoudness()), 0.1);
+
+  meter.Reset(44100, 2);
+  AddSine(meter, 44100, -33.0, 20);
+  EXPECT_NEAR(-33.0, meter.GetLoudness(), 0.1);
+}
+
+TEST(TestLoudnessMeter, Gating)
+{
+  CLoudnessMeter meter;
+  meter.Reset(48000, 2);
+  AddSine(meter, 48000, -36.0, 10);
+  AddSine(meter, 48000, -23.0, 60);
+  AddSine(meter, 48000, -36.0, 10);
+  EXPECT_NEAR(-23.0, meter.GetLoudness(), 0.1);
+
+  meter.Reset(48000, 2);
+  AddSine(meter, 48000, -72.0, 10);
+  AddSine(meter, 48000, -26.0, 10);
+  AddSine(meter, 48000, -20.0, 10);
+  AddSine(meter, 48000, -26.0, 10);
+  AddSine(meter, 48000, -72.0, 10);
+  EXPECT_NEAR(-23.0, meter.GetLoudness(), 0.1);
+
+  meter.Reset(48000, 2);
+  AddSine(meter, 48000, -80.0, 10);
+  EXPECT_EQ(-HUGE_VAL, meter.GetLoudness());
+}
+
+TEST(TestLoudnessMeter, Add)
+{
+  CLoudnessMeter album, track;
+  album.Reset(48000, 2);
+  track.Reset(48000, 2);
+  AddSine(track, 48000, -20.0, 10);
+  album.Add(track);
+  track.Reset(44100, 2);
+  AddSine(track, 44100, -20.0, 10);
+  album.Add(track);
+
+  EXPECT_NEAR(-20.0, album.GetLoudness(), 0.1);
+  EXPECT_NEAR(20.0, album.GetDuration(), 0.001);
+  EXPECT_NEAR(pow(10.0, -20.0 / 20.0), album.GetPeak(), 0.001);
+}
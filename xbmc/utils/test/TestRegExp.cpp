@@ -132,6 +132,50 @@ TEST(TestRegExp, operatorEqual)
   EXPECT_STREQ("string", match.c_str());
 }
 
+TEST(TestRegExp, Match)
+{
+  CRegExp regex;
+  int ovector[9];
+
+  EXPECT_EQ(-1, regex.Match("Test string."));
+  EXPECT_TRUE(regex.RegComp("(Test)\\s*(.*)\\."));
+  EXPECT_EQ(8, regex.Match("Another Test string."));
+  EXPECT_EQ(8, regex.Match("Another Test string.", 0, ovector, 9));
+  EXPECT_EQ(8, ovector[2]);
+  EXPECT_EQ(12, ovector[3]);
+  EXPECT_EQ(13, ovector[4]);
+  EXPECT_EQ(19, ovector[5]);
+  EXPECT_EQ(-1, regex.Match("Another Test string.", 9));
+
+  // Match() leaves the state of the last RegFind() alone
+  EXPECT_EQ(0, regex.RegFind("Test string."));
+  EXPECT_EQ(-1, regex.Match("No match"));
+  EXPECT_STREQ("string", regex.GetMatch(2).c_str());
+}
+
+TEST(TestRegExp, SharedPattern)
+{
+  CRegExp regex(true), regex2(true), regexcase;
+
+  EXPECT_TRUE(regex.RegComp("^test"));
+  EXPECT_TRUE(regex2.RegComp("^test"));
+  EXPECT_TRUE(regexcase.RegComp("^test"));
+  EXPECT_EQ(0, regex.RegFind("Test string."));
+  EXPECT_EQ(0, regex2.RegFind("TEST string."));
+  EXPECT_EQ(-1, regexcase.RegFind("Test string."));
+
+  {
+    CRegExp regexcopy(regex);
+    EXPECT_STREQ("Test", regexcopy.GetMatch().c_str());
+  }
+  // the copy going away doesn't affect the original
+  EXPECT_EQ(0, regex.RegFind("test string."));
+  EXPECT_STREQ("test", regex.GetMatch().c_str());
+
+  EXPECT_FALSE(regex.RegComp("(unbalanced"));
+  EXPECT_EQ(0, regex2.RegFind("test string."));
+}
+
 class TestRegExpLog : public testing::Test
 {
 protected:
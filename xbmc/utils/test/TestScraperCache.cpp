@@ -0,0 +1,103 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/ScraperCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+
+#include "gtest/gtest.h"
+
+#define CACHE_PATH "special://temp/scrapercachetest/"
+
+TEST(TestScraperCache, GetKey)
+{
+  CStdString key = CScraperCache::GetKey("http://example.com/search?q=a", false, "", false);
+  EXPECT_EQ(32u, key.size());
+  EXPECT_STREQ(key.c_str(), CScraperCache::GetKey("http://example.com/search?q=a", false, "", false).c_str());
+  EXPECT_STRNE(key.c_str(), CScraperCache::GetKey("http://example.com/search?q=b", false, "", false).c_str());
+  EXPECT_STRNE(key.c_str(), CScraperCache::GetKey("http://example.com/search?q=a", true, "", false).c_str());
+  EXPECT_STRNE(key.c_str(), CScraperCache::GetKey("http://example.com/search?q=a", false, "http://example.com", false).c_str());
+  EXPECT_STRNE(key.c_str(), CScraperCache::GetKey("http://example.com/search?q=a", false, "", true).c_str());
+}
+
+TEST(TestScraperCache, StoreLookup)
+{
+  CScraperCache cache(CACHE_PATH, 3600);
+  CStdString key = CScraperCache::GetKey("http://example.com/details/1", false, "", false);
+  std::string data;
+  unsigned int hits, misses;
+
+  EXPECT_FALSE(cache.Lookup("metadata.test", key, data));
+  cache.GetStatistics("metadata.test", hits, misses);
+  EXPECT_EQ(0u, hits);
+  EXPECT_EQ(1u, misses);
+
+  cache.Store(key, "<details><title>test</title></details>");
+  EXPECT_TRUE(cache.Lookup("metadata.test", key, data));
+  EXPECT_STREQ("<details><title>test</title></details>", data.c_str());
+  cache.GetStatistics("metadata.test", hits, misses);
+  EXPECT_EQ(1u, hits);
+  EXPECT_EQ(1u, misses);
+
+  cache.Store(key, "<details><title>replaced</title></details>");
+  EXPECT_TRUE(cache.Lookup("metadata.test", key, data));
+  EXPECT_STREQ("<details><title>replaced</title></details>", data.c_str());
+
+  cache.LogStatistics();
+  cache.GetStatistics("metadata.test", hits, misses);
+  EXPECT_EQ(0u, hits);
+  EXPECT_EQ(0u, misses);
+
+  EXPECT_TRUE(XFILE::CFile::Delete(CACHE_PATH + key));
+  EXPECT_TRUE(XFILE::CDirectory::Remove(CACHE_PATH));
+}
+
+TEST(TestScraperCache, Refresh)
+{
+  CScraperCache cache(CACHE_PATH, 3600);
+  CStdString key = CScraperCache::GetKey("http://example.com/details/3", false, "", false);
+  std::string data;
+
+  cache.Store(key, "<details/>");
+  {
+    CScraperCache::CRefresh inactive(false, cache);
+    EXPECT_TRUE(cache.Lookup("metadata.test", key, data));
+  }
+  {
+    CScraperCache::CRefresh refresh(true, cache);
+    EXPECT_FALSE(cache.Lookup("metadata.test", key, data));
+  }
+  EXPECT_TRUE(cache.Lookup("metadata.test", key, data));
+
+  EXPECT_TRUE(XFILE::CFile::Delete(CACHE_PATH + key));
+  EXPECT_TRUE(XFILE::CDirectory::Remove(CACHE_PATH));
+}
+
+TEST(TestScraperCache, Disabled)
+{
+  CScraperCache cache(CACHE_PATH, 0);
+  CStdString key = CScraperCache::GetKey("http://example.com/details/2", false, "", false);
+  std::string data;
+
+  EXPECT_FALSE(cache.IsEnabled());
+  cache.Store(key, "<details/>");
+  EXPECT_FALSE(cache.Lookup("metadata.test", key, data));
+  EXPECT_FALSE(XFILE::CDirectory::Exists(CACHE_PATH));
+}
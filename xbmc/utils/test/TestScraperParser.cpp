@@ -19,6 +19,7 @@
  */
 
 #include "utils/ScraperParser.h"
+#include "utils/XBMCTinyXML.h"
 
 #include "test/TestUtils.h"
 
@@ -37,3 +38,46 @@ TEST(TestScraperParser, General)
     a.GetFilename().c_str());
   EXPECT_STREQ("UTF-8", a.GetSearchStringEncoding().c_str());
 }
+
+TEST(TestScraperParser, CompiledFunctions)
+{
+  CScraperParser a;
+  ASSERT_TRUE(
+    a.Load(XBMC_REF_FILE_PATH("/addons/metadata.themoviedb.org/tmdb.xml")));
+
+  CStdString functions =
+    "<scraper>"
+    "  <GetTitles dest=\"3\">"
+    "    <RegExp input=\"$$2\" output=\"&lt;titles&gt;\\1&lt;/titles&gt;\" dest=\"3\">"
+    "      <RegExp input=\"$$1\" output=\"&lt;title&gt;\\1&lt;/title&gt;\" dest=\"2\">"
+    "        <expression repeat=\"yes\">&lt;h1&gt;([^&lt;]*)&lt;/h1&gt;</expression>"
+    "      </RegExp>"
+    "      <expression noclean=\"1\"/>"
+    "    </RegExp>"
+    "  </GetTitles>"
+    "  <FindTitle dest=\"3\">"
+    "    <RegExp input=\"$$1\" output=\"\\1\" dest=\"3\">"
+    "      <expression>&lt;h1&gt;($$2)&lt;/h1&gt;</expression>"
+    "    </RegExp>"
+    "  </FindTitle>"
+    "</scraper>";
+  CXBMCTinyXML doc;
+  doc.Parse(functions);
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  EXPECT_STREQ("", a.Parse("GetTitles", NULL).c_str());
+  a.AddDocument(&doc);
+
+  // run each function twice, the second run uses the compiled expressions
+  for (int i = 0; i < 2; i++)
+  {
+    a.m_param[0] = "<h1>Title A</h1><h1>Title B</h1>";
+    EXPECT_STREQ("<titles><title>Title A</title><title>Title B</title></titles>",
+                 a.Parse("GetTitles", NULL).c_str());
+    EXPECT_TRUE(a.m_param[0].empty());
+
+    a.m_param[0] = "<h1>Title A</h1><h1>Title B</h1>";
+    a.m_param[1] = i == 0 ? "Title B" : "Title A";
+    EXPECT_STREQ(i == 0 ? "Title B" : "Title A", a.Parse("FindTitle", NULL).c_str());
+  }
+}
@@ -20,9 +20,13 @@
 
 #include "utils/fft.h"
 #include "utils/StdString.h"
+#include "utils/TimeUtils.h"
 
 #include "gtest/gtest.h"
 
+#include <math.h>
+#include <stdio.h>
+
 /* refdata[] below was generated using the following Python script.
 
 import math
@@ -316,3 +320,78 @@ TEST(Testfft, twochanwithwindow)
     EXPECT_STREQ(refstr.c_str(), varstr.c_str());
   }
 }
+
+static void FillNoise(float data[], int count)
+{
+  unsigned int seed = 1;
+  for (int i = 0; i < count; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    data[i] = (float)((seed >> 16) & 0x7fff) / 16384.0f - 1.0f;
+  }
+}
+
+TEST(Testfft, PlanTransform)
+{
+  for (int n = 1; n <= 4096; n *= 2)
+  {
+    std::vector<float> refdata(2 * n), vardata(2 * n);
+    FillNoise(&refdata[0], 2 * n);
+    vardata = refdata;
+
+    fft(&refdata[0] - 1, n, +1);
+    CFFTPlan::Get(n).Transform(&vardata[0]);
+    for (int i = 0; i < 2 * n; i++)
+      EXPECT_NEAR(refdata[i], vardata[i], 1e-5 * n) << "size " << n << " index " << i;
+  }
+}
+
+TEST(Testfft, PlanTwoChannelWithWindow)
+{
+  int i;
+  float vardata[REFDATA_NUMELEMENTS];
+
+  memcpy(vardata, refdata, sizeof(refdata));
+  CFFTPlan::Get(REFDATA_NUMELEMENTS/2).TwoChannelWithWindow(vardata);
+  for (i = 0; i < REFDATA_NUMELEMENTS/2 + 2; i++)
+    EXPECT_NEAR(reftwochanwithwindowdata[i], vardata[i], 1e-4 * (1.0f + fabs(reftwochanwithwindowdata[i])));
+}
+
+TEST(Testfft, PlanCache)
+{
+  EXPECT_EQ(&CFFTPlan::Get(512), &CFFTPlan::Get(512));
+  EXPECT_NE(&CFFTPlan::Get(512), &CFFTPlan::Get(1024));
+  EXPECT_EQ(1024, CFFTPlan::Get(1024).GetSize());
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(Testfft, DISABLED_Benchmark)
+{
+  for (int n = 512; n <= 4096; n *= 2)
+  {
+    std::vector<float> input(2 * n), data(2 * n);
+    FillNoise(&input[0], 2 * n);
+    const CFFTPlan &plan = CFFTPlan::Get(n);
+    int iterations = 2000000 / n;
+
+    int64_t start = CurrentHostCounter();
+    for (int i = 0; i < iterations; i++)
+    {
+      data = input;
+      twochanwithwindow(&data[0], n);
+    }
+    int64_t scalar = CurrentHostCounter() - start;
+
+    start = CurrentHostCounter();
+    for (int i = 0; i < iterations; i++)
+    {
+      data = input;
+      plan.TwoChannelWithWindow(&data[0]);
+    }
+    int64_t planned = CurrentHostCounter() - start;
+
+    printf("size %4d: twochanwithwindow %7.2f us, CFFTPlan %7.2f us\n", n,
+           (double)scalar * 1000000 / CurrentHostFrequency() / iterations,
+           (double)planned * 1000000 / CurrentHostFrequency() / iterations);
+  }
+}
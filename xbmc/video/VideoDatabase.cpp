@@ -2073,6 +2073,7 @@ int CVideoDatabase::SetDetailsForMovie(const CStdString& strFilenameAndPath, con
   }
   catch (...)
   {
+    RollbackTransaction();
     CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strFilenameAndPath.c_str());
   }
   return -1;
@@ -2157,6 +2158,7 @@ int CVideoDatabase::SetDetailsForTvShow(const CStdString& strPath, const CVideoI
   }
   catch (...)
   {
+    RollbackTransaction();
     CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strPath.c_str());
   }
 
@@ -2251,6 +2253,7 @@ int CVideoDatabase::SetDetailsForEpisode(const CStdString& strFilenameAndPath, c
   }
   catch (...)
   {
+    RollbackTransaction();
     CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strFilenameAndPath.c_str());
   }
   return -1;
@@ -2356,6 +2359,7 @@ int CVideoDatabase::SetDetailsForMusicVideo(const CStdString& strFilenameAndPath
   }
   catch (...)
   {
+    RollbackTransaction();
     CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strFilenameAndPath.c_str());
   }
   return -1;
@@ -2822,6 +2826,7 @@ void CVideoDatabase::DeleteMovie(const CStdString& strFilenameAndPath, bool bKee
   }
   catch (...)
   {
+    RollbackTransaction();
     CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
   }
 }
@@ -2893,6 +2898,7 @@ void CVideoDatabase::DeleteTvShow(const CStdString& strPath, bool bKeepId /* = f
   }
   catch (...)
   {
+    RollbackTransaction();
     CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, strPath.c_str());
   }
 }
@@ -3019,6 +3025,7 @@ void CVideoDatabase::DeleteMusicVideo(const CStdString& strFilenameAndPath, bool
   }
   catch (...)
   {
+    RollbackTransaction();
     CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
   }
 }
@@ -4327,7 +4334,8 @@ bool CVideoDatabase::UpdateOldVersion(int iVersion)
       while (!m_pDS->eof())
       {
         CTextureDetails details;
-        if (db.GetCachedTexture(m_pDS->fv(1).get_asString(), details))
+        CDateTime lastCheck;
+        if (db.GetCachedTexture(m_pDS->fv(1).get_asString(), details, lastCheck))
         {
           CArtItem item;
           item.art_id = m_pDS->fv(0).get_asInt();
@@ -9129,9 +9137,13 @@ bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+    // (unless this only ended a nested transaction)
+    if (!InTransaction())
+    {
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+    }
     return true;
   }
   return false;
@@ -26,6 +26,7 @@
 #include "Util.h"
 #include "NfoFile.h"
 #include "utils/RegExp.h"
+#include "utils/ScraperCache.h"
 #include "utils/md5.h"
 #include "filesystem/StackDirectory.h"
 #include "VideoInfoDownloader.h"
@@ -67,6 +68,13 @@ namespace VIDEO
     m_itemCount = 0;
     m_bClean = false;
     m_scanAll = false;
+    m_bPipelined = false;
+    m_batchOpen = false;
+    m_batchItems = 0;
+    m_batchAdded = 0;
+    m_batchLost = false;
+    m_itemsAdded = 0;
+    m_scanStart = 0;
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
@@ -97,6 +105,10 @@ namespace VIDEO
       // Reset progress vars
       m_currentItem = 0;
       m_itemCount = -1;
+      m_itemsAdded = 0;
+      m_batchLost = false;
+      m_scanStart = tick;
+      m_bPipelined = true;
 
       SetPriority(GetMinPriority());
 
@@ -129,6 +141,10 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      CommitBatch();
+      m_bPipelined = false;
+      m_prefetcher.Cancel();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -145,10 +161,16 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      if (m_itemsAdded > 0)
+        CLog::Log(LOGNOTICE, "VideoInfoScanner: Added %u items (%.1f items per minute)", m_itemsAdded, m_itemsAdded * 60000.0 / std::max(tick, 1u));
+      CScraperCache::Get().LogStatistics();
     }
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      CommitBatch();
+      m_bPipelined = false;
+      m_prefetcher.Cancel();
     }
     
     m_bRunning = false;
@@ -199,6 +221,7 @@ namespace VIDEO
     if (m_bCanInterrupt)
       m_database.Interupt();
 
+    m_prefetcher.Cancel();
     StopThread(false);
   }
 
@@ -244,8 +267,8 @@ namespace VIDEO
     CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
 
     // exclude folders that match our exclude regexps
-    CStdStringArray regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
-                                                         : g_advancedSettings.m_moviesExcludeFromScanRegExps;
+    std::vector<CRegExp> regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScan
+                                                              : g_advancedSettings.m_moviesExcludeFromScan;
 
     if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
       return true;
@@ -255,6 +278,7 @@ namespace VIDEO
       return true;
 
     CStdString hash, dbHash;
+    bool showHashStored = false;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
       if (m_handle)
@@ -263,17 +287,25 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str), info->Name().c_str()));
       }
 
-      CStdString fastHash = GetFastHash(strDirectory);
+      // the folder may have been listed ahead of us
+      CStdString fastHash;
+      bool listed = m_prefetcher.GetListing(strDirectory, items, fastHash);
+      if (!listed && fastHash.IsEmpty())
+        fastHash = GetFastHash(strDirectory);
       if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
       { // fast hashes match - no need to process anything
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
         hash = fastHash;
         bSkip = true;
+        items.Clear();
       }
       if (!bSkip)
       { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
-        items.Stack();
+        if (!listed)
+        {
+          CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+          items.Stack();
+        }
         // compute hash
         GetPathHash(items, hash);
         if (hash != dbHash && !hash.IsEmpty())
@@ -314,7 +346,7 @@ namespace VIDEO
         bSkip = true;
         if (!m_database.GetPathHash(strDirectory, dbHash) || dbHash != hash)
         {
-          m_database.SetPathHash(strDirectory, hash);
+          showHashStored = m_database.SetPathHash(strDirectory, hash);
           bSkip = false;
         }
         else
@@ -336,7 +368,7 @@ namespace VIDEO
       {
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
         {
-          m_database.SetPathHash(strDirectory, hash);
+          SetPathHash(strDirectory, hash);
           m_pathsToClean.insert(m_database.GetPathId(strDirectory));
           CLog::Log(LOGDEBUG, "VideoInfoScanner: Finished adding information from dir %s", strDirectory.c_str());
         }
@@ -349,12 +381,31 @@ namespace VIDEO
     }
     else if (hash != dbHash && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
     { // update the hash either way - we may have changed the hash to a fast version
-      m_database.SetPathHash(strDirectory, hash);
+      SetPathHash(strDirectory, hash);
     }
+    CommitBatch();
+    if (m_batchLost && showHashStored)
+      m_database.SetPathHash(strDirectory, ""); // stored before its episodes were lost
 
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    if (m_bPipelined && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+    { // list the subfolders ahead of us. They are queued in reverse as
+      // they're picked up last in, first out.
+      for (int i = items.Size() - 1; i >= 0 && !m_bStop; --i)
+      {
+        CFileItemPtr pItem = items[i];
+        if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() &&
+            !CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
+        {
+          CStdString subHash;
+          m_database.GetPathHash(pItem->GetPath(), subHash);
+          m_prefetcher.QueueListing(pItem->GetPath(), subHash);
+        }
+      }
+    }
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -392,6 +443,16 @@ namespace VIDEO
 
     m_database.Open();
 
+    if (m_bPipelined && content == CONTENT_TVSHOWS && fetchEpisodes)
+    { // list the episodes of each show ahead of us, queued in reverse as
+      // they're picked up last in, first out.
+      for (int i = items.Size() - 1; i >= 0; --i)
+      {
+        if (items[i]->m_bIsFolder)
+          m_prefetcher.QueueRecursiveListing(items[i]->GetPath());
+      }
+    }
+
     bool FoundSomeInfo = false;
     vector<int> seenPaths;
     for (int i = 0; i < (int)items.Size(); ++i)
@@ -405,8 +466,8 @@ namespace VIDEO
         continue;
 
       // Discard all exclude files defined by regExExclude
-      if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), (content == CONTENT_TVSHOWS) ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
-                                                                                    : g_advancedSettings.m_moviesExcludeFromScanRegExps))
+      if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), (content == CONTENT_TVSHOWS) ? g_advancedSettings.m_tvshowExcludeFromScan
+                                                                                    : g_advancedSettings.m_moviesExcludeFromScan))
         continue;
 
       if (info2->Content() == CONTENT_MOVIES || info2->Content() == CONTENT_MUSICVIDEOS)
@@ -431,6 +492,8 @@ namespace VIDEO
         FoundSomeInfo = false;
         break;
       }
+      if (info2->Content() == CONTENT_TVSHOWS)
+        CommitBatch(); // one show at a time
       if (ret == INFO_CANCELLED || ret == INFO_ERROR)
       {
         FoundSomeInfo = false;
@@ -481,7 +544,7 @@ namespace VIDEO
     {
       INFO_RET ret = RetrieveInfoForEpisodes(pItem, idTvShow, info2, useLocal, pDlgProgress);
       if (ret == INFO_ADDED)
-        m_database.SetPathHash(pItem->GetPath(), pItem->GetProperty("hash").asString());
+        SetPathHash(pItem->GetPath(), pItem->GetProperty("hash").asString());
       return ret;
     }
 
@@ -489,7 +552,7 @@ namespace VIDEO
       return INFO_CANCELLED;
 
     if (m_handle)
-      m_handle->SetText(pItem->GetMovieName(bDirNames));
+      m_handle->SetText(GetProgressText(pItem->GetMovieName(bDirNames)));
 
     CNfoFile::NFOResult result=CNfoFile::NO_NFO;
     CScraperUrl scrUrl;
@@ -515,7 +578,7 @@ namespace VIDEO
       {
         INFO_RET ret = RetrieveInfoForEpisodes(pItem, lResult, info2, useLocal, pDlgProgress);
         if (ret == INFO_ADDED)
-          m_database.SetPathHash(pItem->GetPath(), pItem->GetProperty("hash").asString());
+          SetPathHash(pItem->GetPath(), pItem->GetProperty("hash").asString());
         return ret;
       }
       return INFO_ADDED;
@@ -540,7 +603,7 @@ namespace VIDEO
     {
       INFO_RET ret = RetrieveInfoForEpisodes(pItem, lResult, info2, useLocal, pDlgProgress);
       if (ret == INFO_ADDED)
-        m_database.SetPathHash(pItem->GetPath(), pItem->GetProperty("hash").asString());
+        SetPathHash(pItem->GetPath(), pItem->GetProperty("hash").asString());
     }
     return INFO_ADDED;
   }
@@ -558,7 +621,7 @@ namespace VIDEO
       return INFO_HAVE_ALREADY;
 
     if (m_handle)
-      m_handle->SetText(pItem->GetMovieName(bDirNames));
+      m_handle->SetText(GetProgressText(pItem->GetMovieName(bDirNames)));
 
     CNfoFile::NFOResult result=CNfoFile::NO_NFO;
     CScraperUrl scrUrl;
@@ -607,7 +670,7 @@ namespace VIDEO
       return INFO_HAVE_ALREADY;
 
     if (m_handle)
-      m_handle->SetText(pItem->GetMovieName(bDirNames));
+      m_handle->SetText(GetProgressText(pItem->GetMovieName(bDirNames)));
 
     CNfoFile::NFOResult result=CNfoFile::NO_NFO;
     CScraperUrl scrUrl;
@@ -665,7 +728,9 @@ namespace VIDEO
 
     if (item->m_bIsFolder)
     {
-      CUtil::GetRecursiveListing(item->GetPath(), items, g_advancedSettings.m_videoExtensions, true);
+      CStdString fastHash;
+      if (!m_prefetcher.GetListing(item->GetPath(), items, fastHash))
+        CUtil::GetRecursiveListing(item->GetPath(), items, g_advancedSettings.m_videoExtensions, true);
       CStdString hash, dbHash;
       int numFilesInFolder = GetPathHash(items, hash);
 
@@ -741,7 +806,7 @@ namespace VIDEO
     }
 
     // enumerate
-    CStdStringArray regexps = g_advancedSettings.m_tvshowExcludeFromScanRegExps;
+    std::vector<CRegExp> regexps = g_advancedSettings.m_tvshowExcludeFromScan;
 
     for (int i=0;i<items.Size();++i)
     {
@@ -862,7 +927,7 @@ namespace VIDEO
 
   bool CVideoInfoScanner::EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList)
   {
-    SETTINGS_TVSHOWLIST expression = g_advancedSettings.m_tvshowEnumRegExps;
+    const SETTINGS_TVSHOWLIST &expression = g_advancedSettings.m_tvshowEnumRegExps;
 
     CStdString strLabel=item->GetPath();
     // URLDecode in case an episode is on a http/https/dav/davs:// source and URL-encoded like foo%201x01%20bar.avi
@@ -1056,6 +1121,8 @@ namespace VIDEO
     if (art.empty())
       art["thumb"] = "";
 
+    BeginBatch();
+
     CVideoInfoTag &movieDetails = *pItem->GetVideoInfoTag();
     if (movieDetails.m_basePath.IsEmpty())
       movieDetails.m_basePath = pItem->GetBaseMoviePath(videoFolder);
@@ -1151,11 +1218,70 @@ namespace VIDEO
 
     m_database.Close();
 
+    if (lResult > -1)
+      m_itemsAdded++;
+
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
-    ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", itemCopy);
+    if (m_batchOpen)
+    { // announce once the batch is committed, so listeners can find the item in the library
+      if (lResult > -1)
+        m_batchAdded++;
+      m_batchUpdates.push_back(itemCopy);
+      if (++m_batchItems >= (unsigned int)g_advancedSettings.m_iVideoScannerBatchSize)
+        CommitBatch();
+    }
+    else
+      ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", itemCopy);
     return lResult;
   }
 
+  void CVideoInfoScanner::BeginBatch()
+  {
+    if (!m_bPipelined || m_batchOpen)
+      return;
+
+    m_database.BeginTransaction();
+    m_batchOpen = true;
+    m_batchItems = 0;
+    m_batchAdded = 0;
+  }
+
+  void CVideoInfoScanner::CommitBatch()
+  {
+    if (!m_batchOpen)
+      return;
+
+    m_batchOpen = false;
+    if (!m_database.CommitTransaction())
+    {
+      CLog::Log(LOGERROR, "VideoInfoScanner: Failed to commit %u items, they will be scanned again", (unsigned int)m_batchUpdates.size());
+      m_itemsAdded -= m_batchAdded;
+      m_batchUpdates.clear();
+      m_batchLost = true;
+      return;
+    }
+
+    for (vector<CFileItemPtr>::const_iterator i = m_batchUpdates.begin(); i != m_batchUpdates.end(); ++i)
+      ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", *i);
+    m_batchUpdates.clear();
+  }
+
+  void CVideoInfoScanner::SetPathHash(const CStdString &path, const CStdString &hash)
+  {
+    if (!m_batchLost)
+      m_database.SetPathHash(path, hash);
+  }
+
+  CStdString CVideoInfoScanner::GetProgressText(const CStdString &line) const
+  {
+    // wait a little for the rate to settle
+    unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_scanStart;
+    if (!m_bPipelined || m_itemsAdded == 0 || elapsed < 10000)
+      return line;
+
+    return StringUtils::Format(g_localizeStrings.Get(20470).c_str(), line.c_str(), (int)(m_itemsAdded * 60000.0 / elapsed));
+  }
+
   string ContentToMediaType(CONTENT_TYPE content, bool folder)
   {
     switch (content)
@@ -1376,6 +1502,7 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          CommitBatch(); // don't keep the library locked while waiting on the scraper
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -1603,8 +1730,10 @@ namespace VIDEO
   {
     CVideoInfoTag movieDetails;
 
+    CommitBatch(); // don't keep the library locked while waiting on the scraper
+
     if (m_handle && !url.strTitle.IsEmpty())
-      m_handle->SetText(url.strTitle);
+      m_handle->SetText(GetProgressText(url.strTitle));
 
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
@@ -1615,7 +1744,7 @@ namespace VIDEO
         nfoFile->GetDetails(movieDetails,NULL,true);
 
       if (m_handle && url.strTitle.IsEmpty())
-        m_handle->SetText(movieDetails.m_strTitle);
+        m_handle->SetText(GetProgressText(movieDetails.m_strTitle));
 
       if (pDialog)
       {
@@ -1669,7 +1798,7 @@ namespace VIDEO
     return items.GetFolderCount() == 0;
   }
 
-  CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory) const
+  CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory)
   {
     struct __stat64 buffer;
     if (XFILE::CFile::Stat(directory, &buffer) == 0)
@@ -1886,6 +2015,7 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const CStdString &videoName, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    CommitBatch(); // don't keep the library locked while waiting on the scraper
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(videoName, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
@@ -22,6 +22,7 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 #include "NfoFile.h"
+#include "VideoScanPrefetcher.h"
 
 class CRegExp;
 class CFileItem;
@@ -120,6 +121,15 @@ namespace VIDEO
     static std::string GetImage(CFileItem *pItem, bool useLocal, bool bApplyToDir, const std::string &type = "");
     static std::string GetFanart(CFileItem *pItem, bool useLocal);
 
+    /*! \brief Retrieve a "fast" hash of the given directory (if available)
+     Performs a stat() on the directory, and uses modified time to create a "fast"
+     hash of the folder. If no modified time is available, the create time is used,
+     and if neither are available, an empty hash is returned.
+     \param directory folder to hash
+     \return the hash of the folder of the form "fast<datetime>"
+     */
+    static CStdString GetFastHash(const CStdString &directory);
+
   protected:
     virtual void Process();
     bool DoScan(const CStdString& strDirectory);
@@ -181,15 +191,6 @@ namespace VIDEO
 
     static int GetPathHash(const CFileItemList &items, CStdString &hash);
 
-    /*! \brief Retrieve a "fast" hash of the given directory (if available)
-     Performs a stat() on the directory, and uses modified time to create a "fast"
-     hash of the folder. If no modified time is available, the create time is used,
-     and if neither are available, an empty hash is returned.
-     \param directory folder to hash
-     \return the hash of the folder of the form "fast<datetime>"
-     */
-    CStdString GetFastHash(const CStdString &directory) const;
-
     /*! \brief Decide whether a folder listing could use the "fast" hash
      Fast hashing can be done whenever the folder contains no scannable subfolders, as the
      fast hash technique uses modified time to determine when folder content changes, which
@@ -224,6 +225,30 @@ namespace VIDEO
      */
     CStdString GetParentDir(const CFileItem &item) const;
 
+    /*! \brief Start a batch of library writes, if the scan thread isn't in one already.
+     Items added while a batch is open share one database transaction.
+     */
+    void BeginBatch();
+
+    /*! \brief Commit the current batch of library writes, if any.
+     Called once a batch is full, at the end of each folder and before waiting on a
+     scraper, so other database users aren't locked out for long. If the commit
+     fails, the items of the batch aren't announced and no more folder hashes are
+     stored in this scan, so the lost items are found again by the next one.
+     */
+    void CommitBatch();
+
+    /*! \brief Store the hash of a folder, unless items were lost with a batch.
+     \sa CommitBatch
+     */
+    void SetPathHash(const CStdString &path, const CStdString &hash);
+
+    /*! \brief Append the current scan rate to a progress line
+     \param line the text to show in the progress dialog
+     \return the text including the number of items added per minute, once known
+     */
+    CStdString GetProgressText(const CStdString &line) const;
+
     bool m_showDialog;
     CGUIDialogProgressBarHandle* m_handle;
     int m_currentItem;
@@ -238,6 +263,15 @@ namespace VIDEO
     std::set<CStdString> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+    CVideoScanPrefetcher m_prefetcher;
+    bool m_bPipelined; ///< scanning on our own thread: list folders ahead and batch the library writes
+    bool m_batchOpen;
+    unsigned int m_batchItems;
+    unsigned int m_batchAdded;   ///< items of the batch counted in m_itemsAdded
+    bool m_batchLost;            ///< a batch failed to commit during this scan
+    std::vector<CFileItemPtr> m_batchUpdates;
+    unsigned int m_itemsAdded;
+    unsigned int m_scanStart;
   };
 }
 
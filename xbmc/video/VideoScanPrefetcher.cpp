@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "VideoScanPrefetcher.h"
+#include "VideoInfoScanner.h"
+#include "URL.h"
+#include "Util.h"
+#include "filesystem/Directory.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+
+using namespace std;
+using namespace XFILE;
+
+namespace VIDEO
+{
+  class CVideoScanPrefetcher::CListingJob : public CJob
+  {
+  public:
+    CListingJob(const ListingPtr &listing) : m_listing(listing)
+    {
+    }
+
+    virtual const char *GetType() const { return "videoscanlisting"; }
+
+    virtual bool DoWork()
+    {
+      {
+        CSingleLock lock(m_listing->section);
+        if (m_listing->claimed || m_listing->cancelled)
+          return false;
+        m_listing->started = true;
+      }
+
+      CFileItemList items;
+      CStdString fastHash;
+      bool listed = false;
+      if (m_listing->recursive)
+      {
+        CUtil::GetRecursiveListing(m_listing->path, items, g_advancedSettings.m_videoExtensions, true);
+        listed = true;
+      }
+      else
+      {
+        fastHash = CVideoInfoScanner::GetFastHash(m_listing->path);
+        if (fastHash.IsEmpty() || fastHash != m_listing->dbHash)
+        {
+          CDirectory::GetDirectory(m_listing->path, items, g_advancedSettings.m_videoExtensions);
+          items.Stack();
+          listed = true;
+        }
+      }
+
+      CSingleLock lock(m_listing->section);
+      m_listing->items.Assign(items);
+      m_listing->fastHash = fastHash;
+      m_listing->listed = listed;
+      m_listing->done.Set();
+      return true;
+    }
+
+  private:
+    ListingPtr m_listing;
+  };
+
+  CVideoScanPrefetcher::CVideoScanPrefetcher()
+  {
+  }
+
+  CVideoScanPrefetcher::~CVideoScanPrefetcher()
+  {
+    Cancel();
+    for (map<CStdString, CJobQueue*>::iterator it = m_hosts.begin(); it != m_hosts.end(); ++it)
+      delete it->second;
+  }
+
+  unsigned int CVideoScanPrefetcher::GetJobsPerHost()
+  {
+    return (unsigned int)g_advancedSettings.m_iVideoScannerThreadsPerHost;
+  }
+
+  void CVideoScanPrefetcher::QueueListing(const CStdString &path, const CStdString &dbHash)
+  {
+    Queue(path, dbHash, false);
+  }
+
+  void CVideoScanPrefetcher::QueueRecursiveListing(const CStdString &path)
+  {
+    Queue(path, "", true);
+  }
+
+  void CVideoScanPrefetcher::Queue(const CStdString &path, const CStdString &dbHash, bool recursive)
+  {
+    unsigned int jobsPerHost = GetJobsPerHost();
+    if (jobsPerHost == 0)
+      return;
+
+    CSingleLock lock(m_section);
+    if (m_listings.find(path) != m_listings.end())
+      return;
+
+    ListingPtr listing(new Listing);
+    listing->path = path;
+    listing->dbHash = dbHash;
+    listing->recursive = recursive;
+    m_listings.insert(make_pair(path, listing));
+
+    CStdString host = CURL(path).GetHostName();
+    map<CStdString, CJobQueue*>::iterator it = m_hosts.find(host);
+    if (it == m_hosts.end())
+      it = m_hosts.insert(make_pair(host, new CJobQueue(true, jobsPerHost, CJob::PRIORITY_LOW))).first;
+    it->second->AddJob(new CListingJob(listing));
+  }
+
+  bool CVideoScanPrefetcher::GetListing(const CStdString &path, CFileItemList &items, CStdString &fastHash)
+  {
+    ListingPtr listing;
+    {
+      CSingleLock lock(m_section);
+      map<CStdString, ListingPtr>::iterator it = m_listings.find(path);
+      if (it == m_listings.end())
+        return false;
+      listing = it->second;
+      m_listings.erase(it);
+    }
+
+    {
+      CSingleLock lock(listing->section);
+      if (!listing->started)
+      { // still queued, it isn't worth waiting for
+        listing->claimed = true;
+        return false;
+      }
+    }
+
+    listing->done.Wait();
+
+    CSingleLock lock(listing->section);
+    if (listing->cancelled)
+      return false;
+
+    fastHash = listing->fastHash;
+    if (!listing->listed)
+      return false;
+
+    items.Assign(listing->items);
+    return true;
+  }
+
+  void CVideoScanPrefetcher::Cancel()
+  {
+    CSingleLock lock(m_section);
+    for (map<CStdString, CJobQueue*>::iterator it = m_hosts.begin(); it != m_hosts.end(); ++it)
+      it->second->CancelJobs();
+
+    for (map<CStdString, ListingPtr>::iterator it = m_listings.begin(); it != m_listings.end(); ++it)
+    {
+      CSingleLock listingLock(it->second->section);
+      it->second->cancelled = true;
+      it->second->done.Set();
+    }
+    m_listings.clear();
+  }
+}
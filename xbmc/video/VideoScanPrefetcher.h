@@ -0,0 +1,108 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <boost/shared_ptr.hpp>
+
+class CJobQueue;
+
+namespace VIDEO
+{
+  /*!
+   \brief Lists the folders a video scan is about to visit ahead of the scanner.
+
+   The scanner walks a source on a single thread, and on network shares most of
+   that time goes into waiting for directory listings. Folders the scanner is going
+   to descend into are queued here and listed on job workers, with at most
+   <threadsperhost> listings running against the same host at once. The scanner
+   then collects the listing instead of fetching it itself. Everything that touches
+   the database or a scraper stays on the scanner thread.
+
+   Queue folders in the reverse order they are going to be visited; each host is
+   processed last in, first out, which keeps the listings in the order of a depth
+   first walk.
+   */
+  class CVideoScanPrefetcher
+  {
+  public:
+    CVideoScanPrefetcher();
+    ~CVideoScanPrefetcher();
+
+    /*! \brief Queue a stacked listing of a single folder
+     \param path folder to list.
+     \param dbHash hash of the folder stored in the database. The folder isn't listed if its fast hash matches.
+     */
+    void QueueListing(const CStdString &path, const CStdString &dbHash);
+
+    /*! \brief Queue a recursive listing of a folder, as used for tv shows
+     \param path folder to list.
+     */
+    void QueueRecursiveListing(const CStdString &path);
+
+    /*! \brief Collect a listing queued earlier
+     Waits for the listing if it is being fetched. A listing that hasn't been started
+     yet is dropped instead, as the caller can fetch it just as quickly itself.
+     \param path folder that was queued.
+     \param items [out] the listing, if the folder was listed.
+     \param fastHash [out] the fast hash of the folder (single folder listings only).
+     \return true if the folder was listed, false if the caller has to list it
+     */
+    bool GetListing(const CStdString &path, CFileItemList &items, CStdString &fastHash);
+
+    /*! \brief Drop all queued and unclaimed listings */
+    void Cancel();
+
+    /*! \brief The number of listings started per host, 0 if prefetching is disabled */
+    static unsigned int GetJobsPerHost();
+
+  private:
+    class CListingJob;
+
+    struct Listing
+    {
+      Listing() : recursive(false), started(false), claimed(false), listed(false), cancelled(false), done(true) {}
+
+      CStdString path;
+      CStdString dbHash;
+      bool recursive;
+      bool started;   // a worker has picked it up
+      bool claimed;   // the scanner doesn't want it anymore
+      bool listed;
+      bool cancelled;
+      CFileItemList items;
+      CStdString fastHash;
+      CEvent done;
+      CCriticalSection section; // shared with the job, which may outlive the prefetcher
+    };
+    typedef boost::shared_ptr<Listing> ListingPtr;
+
+    void Queue(const CStdString &path, const CStdString &dbHash, bool recursive);
+
+    CCriticalSection m_section;
+    std::map<CStdString, ListingPtr> m_listings;
+    std::map<CStdString, CJobQueue*> m_hosts;
+  };
+}
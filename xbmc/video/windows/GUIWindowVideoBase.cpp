@@ -67,6 +67,7 @@
 #include "pvr/PVRManager.h"
 #include "pvr/recordings/PVRRecordings.h"
 #include "utils/URIUtils.h"
+#include "utils/ScraperCache.h"
 #include "GUIUserMessages.h"
 #include "addons/Skin.h"
 #include "storage/MediaManager.h"
@@ -76,6 +77,7 @@
 #include "GUIInfoManager.h"
 #include "utils/GroupUtils.h"
 #include "filesystem/File.h"
+#include "TextureCache.h"
 
 using namespace std;
 using namespace XFILE;
@@ -315,7 +317,7 @@ void CGUIWindowVideoBase::OnInfo(CFileItem* pItem, const ADDON::ScraperPtr& scra
         CFileItemPtr item2 = items[i];
 
         if (item2->IsVideo() && !item2->IsPlayList() &&
-            !CUtil::ExcludeFileOrFolder(item2->GetPath(), g_advancedSettings.m_moviesExcludeFromScanRegExps))
+            !CUtil::ExcludeFileOrFolder(item2->GetPath(), g_advancedSettings.m_moviesExcludeFromScan))
         {
           item.SetPath(item2->GetPath());
           item.m_bIsFolder = false;
@@ -504,6 +506,9 @@ bool CGUIWindowVideoBase::ShowIMDB(CFileItem *item, const ScraperPtr &info2)
   // 3. Run a loop so that if we Refresh we re-run this block
   do
   {
+    // a refresh the user asked for fetches the current pages instead of cached ones
+    CScraperCache::CRefresh cacheRefresh(needsRefresh);
+
     if (!ignoreNfo)
     {
       CNfoFile::NFOResult nfoResult = scanner.CheckForNFOFile(item,settings.parent_name_root,info,scrUrl);
@@ -617,13 +622,9 @@ bool CGUIWindowVideoBase::ShowIMDB(CFileItem *item, const ScraperPtr &info2)
       // show dialog that we're downloading the movie info
 
       // clear artwork and invalidate hashes
-      CTextureDatabase db;
-      if (db.Open())
-      {
-        for (CGUIListItem::ArtMap::const_iterator i = item->GetArt().begin(); i != item->GetArt().end(); ++i)
-          db.InvalidateCachedTexture(i->second);
-        db.Close();
-      }
+      CGUIListItem::ArtMap art = item->GetArt();
+      for (CGUIListItem::ArtMap::const_iterator i = art.begin(); i != art.end(); ++i)
+        CTextureCache::Get().InvalidateCachedImage(i->second);
       item->ClearArt();
 
       CFileItemList list;
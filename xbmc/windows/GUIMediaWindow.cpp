@@ -703,15 +703,15 @@ bool CGUIMediaWindow::GetDirectory(const CStdString &strDirectory, CFileItemList
   }
 
   int iWindow = GetID();
-  CStdStringArray regexps;
+  std::vector<CRegExp> regexps;
 
   // TODO: Do we want to limit the directories we apply the video ones to?
   if (iWindow == WINDOW_VIDEO_NAV)
-    regexps = g_advancedSettings.m_videoExcludeFromListingRegExps;
+    regexps = g_advancedSettings.m_videoExcludeFromListing;
   if (iWindow == WINDOW_MUSIC_FILES)
-    regexps = g_advancedSettings.m_audioExcludeFromListingRegExps;
+    regexps = g_advancedSettings.m_audioExcludeFromListing;
   if (iWindow == WINDOW_PICTURES)
-    regexps = g_advancedSettings.m_pictureExcludeFromListingRegExps;
+    regexps = g_advancedSettings.m_pictureExcludeFromListing;
 
   if (regexps.size())
   {
@@ -31,7 +31,9 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
 #include "GUIInfoManager.h"
+#include "Application.h"
 #include "utils/Variant.h"
+#include "filesystem/FileStatistics.h"
 
 #include <climits>
 
@@ -110,6 +112,18 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sxbmc.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_advancedSettings.m_logFolder.c_str(),
                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+    const CApplication::FrameStats &frame = g_application.GetFrameStats();
+    CStdString frameInfo;
+    frameInfo.Format("\nFRAME: process %2.2f ms - render %2.2f ms - present %2.2f ms - dirty %2.1f%% - %u draws / %u vertices",
+                     frame.processTime, frame.renderTime, frame.presentTime, frame.dirtyArea, frame.drawCalls, frame.vertices);
+    info += frameInfo;
+
+    if (XFILE::CFileStatistics::IsEnabled())
+    {
+      CStdString vfsInfo = XFILE::CFileStatistics::Get().GetSummary(3);
+      if (!vfsInfo.IsEmpty())
+        info += "\n" + vfsInfo;
+    }
   }
 
   // render the skin debug info